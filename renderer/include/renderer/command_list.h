@@ -0,0 +1,119 @@
+/**
+ * @file command_list.h
+ * @author khalilhenoud@gmail.com
+ * @brief records renderer calls on any thread for later replay on the thread
+ * owning the opengl context. each recorded command keeps a copy of the
+ * pipeline modelview top matrix and of the small arrays (lines, points, glyph
+ * runs, lights), meshes are referenced and must outlive the replay.
+ * a list is not thread safe, use one list per recording thread.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef COMMAND_LIST_H
+#define COMMAND_LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/internal/module.h>
+#include <renderer/renderer_opengl.h>
+
+
+/// @brief commands are packed back to back in a single growable buffer.
+typedef
+struct command_list_t {
+  uint8_t* data;
+  uint32_t size;            // in bytes.
+  uint32_t capacity;
+  uint32_t count;           // number of commands.
+} command_list_t;
+
+RENDERER_API
+void
+command_list_initialize(command_list_t* list, uint32_t capacity);
+
+RENDERER_API
+void
+command_list_cleanup(command_list_t* list);
+
+/// @brief empties the list, keeps the allocated memory.
+RENDERER_API
+void
+command_list_clear(command_list_t* list);
+
+/// @brief records draw_meshes, the mesh_render_data_t structures and texture
+/// ids are copied, the geometry they point to is not.
+RENDERER_API
+void
+command_list_draw_meshes(
+  command_list_t* list,
+  const mesh_render_data_t* mesh,
+  const uint32_t* texture_data,
+  uint32_t mesh_count,
+  const pipeline_t* pipeline);
+
+RENDERER_API
+void
+command_list_draw_lines(
+  command_list_t* list,
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float width,
+  const pipeline_t* pipeline);
+
+RENDERER_API
+void
+command_list_draw_points(
+  command_list_t* list,
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float size,
+  const pipeline_t* pipeline);
+
+RENDERER_API
+void
+command_list_draw_unit_quads(
+  command_list_t* list,
+  const unit_quad_t* uvs,
+  uint32_t uvs_count,
+  int32_t texture_id,
+  color_t tint,
+  const pipeline_t* pipeline);
+
+RENDERER_API
+void
+command_list_set_light_properties(
+  command_list_t* list,
+  uint32_t index,
+  const renderer_light_t* light,
+  const pipeline_t* pipeline);
+
+RENDERER_API
+void
+command_list_enable_light(command_list_t* list, uint32_t index);
+
+RENDERER_API
+void
+command_list_disable_light(command_list_t* list, uint32_t index);
+
+/// @brief issues the commands of @a lists on the calling thread (the one that
+/// owns the context), list after list in array order and each list in
+/// recording order, so the result does not depend on thread timing. the lists
+/// must no longer be recorded into. the projection and viewport are whatever
+/// was set on the calling thread.
+RENDERER_API
+void
+command_list_replay(const command_list_t* lists, uint32_t list_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
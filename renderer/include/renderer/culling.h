@@ -0,0 +1,74 @@
+/**
+ * @file culling.h
+ * @author khalilhenoud@gmail.com
+ * @brief view frustum culling of mesh bounding boxes against the pipeline
+ * frustum and modelview. the boxes are computed once from the mesh vertices
+ * and kept by the user code next to the meshes (the same way texture ids are),
+ * the test runs over whole arrays several boxes at a time.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef CULLING_H
+#define CULLING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/internal/module.h>
+#include <renderer/renderer_opengl.h>
+
+
+/// @brief object space axis aligned bounding box.
+typedef
+struct renderer_bounds_t {
+  float min[3];
+  float max[3];
+} renderer_bounds_t;
+
+/// @brief computes the bounds of each mesh from its vertices (interleaved or
+/// not), do it once at load time and keep the result.
+RENDERER_API
+void
+compute_mesh_bounds(
+  const mesh_render_data_t* mesh,
+  uint32_t mesh_count,
+  renderer_bounds_t* bounds);
+
+/// @brief tests the boxes against the frustum of @a pipeline (the projection
+/// parameters) placed by its modelview top, the test is conservative.
+/// @param visible receives the indices of the boxes that are at least
+/// partially inside, in increasing order. must hold @a count entries.
+/// @return the number of visible indices.
+RENDERER_API
+uint32_t
+cull_bounds(
+  const renderer_bounds_t* bounds,
+  uint32_t count,
+  const pipeline_t* pipeline,
+  uint32_t* visible);
+
+/// @brief cull_bounds followed by the compaction of the visible meshes and
+/// their texture ids into @a visible_mesh and @a visible_texture_data, ready
+/// to be passed to draw_meshes.
+/// @return the number of visible meshes.
+RENDERER_API
+uint32_t
+cull_meshes(
+  const mesh_render_data_t* mesh,
+  const uint32_t* texture_data,
+  const renderer_bounds_t* bounds,
+  uint32_t mesh_count,
+  const pipeline_t* pipeline,
+  mesh_render_data_t* visible_mesh,
+  uint32_t* visible_texture_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
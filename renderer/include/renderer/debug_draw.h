@@ -0,0 +1,62 @@
+/**
+ * @file debug_draw.h
+ * @author khalilhenoud@gmail.com
+ * @brief frame wide accumulator for debug lines and points. primitives are
+ * transformed by the pipeline at record time and kept in growable buffers per
+ * primitive type and width/size class, the whole frame is then drawn with a
+ * handful of vertex array draws by debug_draw_flush().
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef DEBUG_DRAW_H
+#define DEBUG_DRAW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/internal/module.h>
+#include <renderer/renderer_opengl.h>
+
+
+/// @brief same semantics as draw_lines, the vertices form a strip.
+RENDERER_API
+void
+debug_draw_lines(
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float width,
+  pipeline_t* pipeline);
+
+/// @brief same semantics as draw_points.
+RENDERER_API
+void
+debug_draw_points(
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float size,
+  pipeline_t* pipeline);
+
+/// @brief draws everything recorded since the last flush and empties the
+/// batches (their memory is kept), call once at the end of the frame. the
+/// recorded primitives are in view space so only the projection applies.
+RENDERER_API
+void
+debug_draw_flush();
+
+/// @brief releases the batches memory.
+RENDERER_API
+void
+debug_draw_cleanup();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file backend.h
+ * @author khalilhenoud@gmail.com
+ * @brief alternative implementations of the renderer_opengl.h api (internal
+ * use only). the entry points forward to the active backend if any and run
+ * the opengl code otherwise, a backend is selected by its own initialize
+ * function in place of renderer_initialize.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/renderer_opengl.h>
+
+
+/// @brief a view space vertex of the debug draw batches, see debug_draw.h.
+typedef
+struct debug_vertex_t {
+  float position[3];
+  uint8_t color[4];
+} debug_vertex_t;
+
+/// @brief same semantics as the entry points of the same name, the pipeline
+/// can be NULL in which case the modelview is the identity. the mesh handle
+/// entries can be NULL, upload_mesh then returns 0.
+typedef
+struct renderer_backend_t {
+  void (*cleanup)(void);
+  void (*set_depth_test)(int32_t enable);
+  void (*clear_color_and_depth_buffers)(void);
+  void (*flush_operations)(void);
+  void (*update_viewport)(const pipeline_t* pipeline);
+  void (*update_projection)(const pipeline_t* pipeline);
+  void (*set_light)(uint32_t index, int32_t enable);
+  void (*set_light_properties)(
+    uint32_t index,
+    renderer_light_t* light,
+    pipeline_t* pipeline);
+  void (*draw_grid)(
+    pipeline_t* pipeline,
+    float width,
+    int32_t lines_per_axis);
+  void (*draw_points)(
+    const float* vertices,
+    uint32_t vertices_count,
+    color_t color,
+    float size,
+    pipeline_t* pipeline);
+  void (*draw_lines)(
+    const float* vertices,
+    uint32_t vertices_count,
+    color_t color,
+    float width,
+    pipeline_t* pipeline);
+  /// @brief a whole debug draw batch in one call, GL_LINES or GL_POINTS of
+  /// @a width, the segments are pairs of @a indices.
+  void (*draw_debug_batch)(
+    GLenum mode,
+    const debug_vertex_t* vertices,
+    uint32_t vertices_count,
+    const uint32_t* indices,
+    uint32_t indices_count,
+    float width);
+  void (*draw_unit_quads)(
+    const unit_quad_t* uvs,
+    uint32_t uvs_count,
+    int32_t texture_id,
+    color_t tint,
+    pipeline_t* pipeline);
+  void (*draw_meshes_wireframe)(
+    const mesh_render_data_t* mesh,
+    uint32_t mesh_count,
+    color_t color,
+    float width,
+    pipeline_t* pipeline);
+  void (*draw_meshes)(
+    const mesh_render_data_t* mesh,
+    const uint32_t* texture_data,
+    uint32_t mesh_count,
+    pipeline_t* pipeline);
+  void (*draw_meshes_instanced)(
+    const mesh_render_data_t* mesh,
+    uint32_t texture_id,
+    const matrix4f* instances,
+    const color_t* tints,
+    uint32_t instance_count,
+    pipeline_t* pipeline);
+  uint32_t (*upload_mesh)(const mesh_render_data_t* mesh);
+  uint32_t (*evict_mesh)(uint32_t mesh_handle);
+  void (*draw_mesh_handles)(
+    const uint32_t* mesh_handles,
+    const uint32_t* texture_data,
+    uint32_t mesh_count,
+    pipeline_t* pipeline);
+  uint32_t (*upload_to_gpu)(
+    const char* path,
+    const uint8_t* buffer,
+    uint32_t width,
+    uint32_t height,
+    renderer_image_format_t format);
+  uint32_t (*evict_from_gpu)(uint32_t texture_id);
+  void (*read_pixels)(
+    int32_t x,
+    int32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint8_t* buffer);
+  int32_t opengl;           // draws through the context, the gpu is timed.
+} renderer_backend_t;
+
+/// @brief NULL when rendering through opengl.
+extern const renderer_backend_t* renderer_backend;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file frame_pacing.h
+ * @author khalilhenoud@gmail.com
+ * @brief bounds the number of frames queued on the gpu with fences, the end
+ * of frame wait of flush_operations (internal use only).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef FRAME_PACING_H
+#define FRAME_PACING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/renderer_opengl.h>
+
+
+/// @brief the settings survive renderer_cleanup, only the fences do not.
+void
+frame_pacing_set(renderer_frame_pacing_t pacing, uint32_t frames_in_flight);
+
+/// @brief fences the frame just submitted, then waits for the oldest ones
+/// until the allowed number of frames is left in flight.
+void
+frame_pacing_end_frame(void);
+
+/// @brief deletes the pending fences without waiting on them.
+void
+frame_pacing_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file frame_stats.h
+ * @author khalilhenoud@gmail.com
+ * @brief the recording side of renderer_stats.h (internal use only). the
+ * counters are bumped unconditionally, the timers only run while the stats are
+ * enabled.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/renderer_stats.h>
+
+
+typedef
+struct frame_counters_t {
+  uint64_t draw_calls;
+  uint64_t triangles;
+  uint64_t vertices;
+  uint64_t texture_binds;
+  uint64_t uploaded_bytes;
+} frame_counters_t;
+
+extern frame_counters_t frame_counters;
+
+static inline
+void
+stats_count_draw(uint64_t vertices, uint64_t triangles)
+{
+  ++frame_counters.draw_calls;
+  frame_counters.vertices += vertices;
+  frame_counters.triangles += triangles;
+}
+
+static inline
+void
+stats_count_upload(uint64_t bytes)
+{
+  frame_counters.uploaded_bytes += bytes;
+}
+
+/// @brief 0 while the stats are disabled, hand it to stats_timer_end.
+uint64_t
+stats_timer_begin(void);
+
+void
+stats_timer_end(renderer_timer_t timer, uint64_t start);
+
+/// @brief closes the frame, called last by flush_operations. @a opengl when
+/// the frame was drawn by the opengl backend (gpu timer queries).
+void
+stats_end_frame(int32_t opengl);
+
+/// @brief deletes the timer queries, if any.
+void
+stats_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
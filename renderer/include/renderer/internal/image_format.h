@@ -0,0 +1,68 @@
+/**
+ * @file image_format.h
+ * @author khalilhenoud@gmail.com
+ * @brief component counts of the image formats and the FNV-1a hash the
+ * texture sources key images with (internal use only).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef IMAGE_FORMAT_H
+#define IMAGE_FORMAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <renderer/renderer_opengl.h>
+
+
+/// @brief the seed of image_hash_bytes, chained calls pass the last result.
+#define IMAGE_HASH_SEED           0xcbf29ce484222325ull
+#define IMAGE_HASH_PRIME          0x100000001b3ull
+
+/// @brief FNV-1a over @a size bytes, starting from @a hash.
+static inline
+uint64_t
+image_hash_bytes(uint64_t hash, const uint8_t* bytes, size_t size)
+{
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= IMAGE_HASH_PRIME;
+  }
+  return hash;
+}
+
+/// @brief bytes per texel, 0 for the compressed formats (they are sized per
+/// block, see texture_compression_size).
+static inline
+uint32_t
+image_format_components(renderer_image_format_t format)
+{
+  switch (format)
+  {
+  case RENDERER_OPENGL_RGBA:
+  case RENDERER_OPENGL_BGRA:
+    return 4;
+  case RENDERER_OPENGL_RGB:
+  case RENDERER_OPENGL_BGR:
+    return 3;
+  case RENDERER_OPENGL_LA:
+    return 2;
+  case RENDERER_OPENGL_L:
+  case RENDERER_OPENGL_A:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * @file jobs.h
+ * @author khalilhenoud@gmail.com
+ * @brief fixed pool of worker threads running parallel for loops (internal use
+ * only). the calling thread takes part in the loop, so a pool of n threads
+ * starts n - 1 workers.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef JOBS_H
+#define JOBS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+
+typedef void (*job_function_t)(void* data, uint32_t index);
+
+/// @brief starts the pool, 0 uses the hardware concurrency. the loops run on
+/// the calling thread alone until this is called.
+void
+jobs_initialize(uint32_t thread_count);
+
+void
+jobs_cleanup(void);
+
+/// @brief number of threads taking part in a loop, the caller included.
+uint32_t
+jobs_thread_count(void);
+
+/// @brief calls @a function for every index in [0, count) spread over the
+/// pool and returns once they are all done. indices are handed out in order
+/// one at a time, keep the work per index coarse. not reentrant.
+void
+jobs_parallel_for(uint32_t count, job_function_t function, void* data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * @file light_clusters.h
+ * @author khalilhenoud@gmail.com
+ * @brief eye space lights and their binning into a froxel grid (internal use
+ * only). the grid is LIGHT_CLUSTERS_X by LIGHT_CLUSTERS_Y tiles of the
+ * normalized device coordinates, by LIGHT_CLUSTERS_Z depth slices between the
+ * near and far planes (exponential for perspective, linear for orthographic).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef LIGHT_CLUSTERS_H
+#define LIGHT_CLUSTERS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/renderer_opengl.h>
+
+
+#define LIGHT_CLUSTERS_X          16
+#define LIGHT_CLUSTERS_Y          9
+#define LIGHT_CLUSTERS_Z          24
+#define LIGHT_CLUSTERS_COUNT      \
+  (LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z)
+// lights past this count in a cluster are dropped, in submission order.
+#define LIGHT_CLUSTERS_CAPACITY   128
+
+/// @brief a light in eye space, laid out as a std140 array element.
+typedef
+struct eye_light_t {
+  float position[4];        // w = 0 for directional lights.
+  float direction[4];       // w is the cosine of the cutoff, -1 for no cone.
+  float ambient[4];
+  float diffuse[4];
+  float specular[4];
+  float attenuation[4];     // w is the range, FLT_MAX for no falloff.
+} eye_light_t;
+
+/// @brief clusters are indexed (z * LIGHT_CLUSTERS_Y + y) * LIGHT_CLUSTERS_X
+/// + x, each record is the offset and count of its run in indices.
+typedef
+struct light_clusters_t {
+  eye_light_t* lights;
+  uint32_t light_count;     // 0 when the clustered lights are off.
+  uint32_t lights_capacity;
+  uint32_t records[LIGHT_CLUSTERS_COUNT][2];
+  uint16_t* indices;
+  uint32_t index_count;
+  int32_t perspective;
+  float near_plane;
+  float depth_scale;        // slices per log depth unit, or per depth unit.
+  float projection[4];      // x and y scale and offset, eye to ndc.
+  uint32_t version;         // bumped by every light_clusters_set.
+} light_clusters_t;
+
+extern light_clusters_t light_clusters;
+
+/// @brief the same values the opengl path hands to glLightfv, with the
+/// position and direction transformed by @a modelview (row major).
+void
+eye_light_set(
+  eye_light_t* target,
+  const renderer_light_t* light,
+  const float* modelview);
+
+/// @brief the opengl defaults of light @a index, only the first is white.
+void
+eye_light_set_default(eye_light_t* target, uint32_t index);
+
+/// @brief converts the lights with the modelview top of @a pipeline and bins
+/// them in the froxels of its frustum, one depth slice per job.
+void
+light_clusters_set(
+  const renderer_light_t* lights,
+  uint32_t light_count,
+  const pipeline_t* pipeline);
+
+void
+light_clusters_cleanup(void);
+
+/// @brief the cluster holding the eye space point @a eye, clamped to the grid.
+uint32_t
+light_clusters_find(const float* eye);
+
+/// @brief writes the indices of the (up to) @a max lights reaching @a eye the
+/// strongest, strongest first, and returns their count.
+uint32_t
+light_clusters_strongest(const float* eye, uint32_t max, uint32_t* selected);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
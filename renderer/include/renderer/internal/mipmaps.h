@@ -0,0 +1,111 @@
+/**
+ * @file mipmaps.h
+ * @author khalilhenoud@gmail.com
+ * @brief cpu side mip chain construction for 8 bit per component images
+ * (internal use only), no opengl calls so it can run on any thread.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef MIPMAPS_H
+#define MIPMAPS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define MIPMAPS_MAX_LEVELS        32
+
+/// @brief levels are tightly packed back to back, level 0 first.
+typedef
+struct mipmaps_chain_t {
+  uint32_t level_count;
+  uint32_t width[MIPMAPS_MAX_LEVELS];
+  uint32_t height[MIPMAPS_MAX_LEVELS];
+  size_t offset[MIPMAPS_MAX_LEVELS];
+  size_t size;              // in bytes, all levels.
+} mipmaps_chain_t;
+
+/// @brief the srgb filters average in linear space, the _ALPHA variant keeps
+/// the last component (alpha) linear.
+typedef
+enum {
+  MIPMAPS_FILTER_BOX,
+  MIPMAPS_FILTER_SRGB,
+  MIPMAPS_FILTER_SRGB_ALPHA
+} mipmaps_filter_t;
+
+/// @brief builds the srgb conversion tables, call once before any thread uses
+/// the srgb filters.
+void
+mipmaps_initialize(void);
+
+/// @brief the largest power of 2 not above @a size, clamped to @a max_size.
+uint32_t
+mipmaps_power_of_2(uint32_t size, uint32_t max_size);
+
+/// @brief fills the level sizes and offsets of a full chain (down to 1x1).
+void
+mipmaps_layout(
+  mipmaps_chain_t* chain,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components);
+
+/// @brief swaps the first and third components in place (BGR(A) to RGB(A)),
+/// @a components is 3 or 4.
+void
+mipmaps_swizzle(uint8_t* pixels, size_t pixel_count, uint32_t components);
+
+/// @brief bilinear resampling of @a source into @a target.
+void
+mipmaps_resize(
+  const uint8_t* source,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components,
+  uint8_t* target,
+  uint32_t target_width,
+  uint32_t target_height);
+
+/// @brief 2x2 filter of rows [first_row, first_row + row_count) of the next
+/// level. a dimension of 1 stays 1 and the last row/column of an odd dimension
+/// is dropped.
+void
+mipmaps_downsample(
+  const uint8_t* source,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components,
+  mipmaps_filter_t filter,
+  uint8_t* target,
+  uint32_t first_row,
+  uint32_t row_count);
+
+/// @brief level 0 from @a pixels (resized to the chain level 0 size if needed
+/// and swizzled if asked), then every level below it. @a pixels can be level 0
+/// of @a levels itself when no resizing is needed. @a parallel spreads each
+/// level over the jobs pool, only from the thread that owns the pool.
+void
+mipmaps_generate(
+  const mipmaps_chain_t* chain,
+  const uint8_t* pixels,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components,
+  int32_t swizzle,
+  mipmaps_filter_t filter,
+  int32_t parallel,
+  uint8_t* levels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
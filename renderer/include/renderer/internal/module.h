@@ -1,6 +1,12 @@
 #if !defined(RENDERER_API)
 	#define RENDERER_API /* NOTHING */
 
+	// the library is built with hidden visibility, only the api is exported.
+	#if defined(__GNUC__) && !defined(WIN32) && !defined(WIN64)
+		#undef RENDERER_API
+		#define RENDERER_API __attribute__((visibility("default")))
+	#endif
+
 	#if defined(WIN32) || defined(WIN64)
 		#undef RENDERER_API
 		#if defined(renderer_EXPORTS)
@@ -12,3 +18,13 @@
 
 #endif // !defined(RENDERER_API)
 
+
+// functions shared between the sources of the library, not part of its api.
+// hidden even when the sources are built without the visibility preset.
+#if !defined(RENDERER_INTERNAL)
+	#if defined(__GNUC__) && !defined(WIN32) && !defined(WIN64)
+		#define RENDERER_INTERNAL __attribute__((visibility("hidden")))
+	#else
+		#define RENDERER_INTERNAL /* NOTHING */
+	#endif
+#endif // !defined(RENDERER_INTERNAL)
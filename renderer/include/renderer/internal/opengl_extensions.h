@@ -0,0 +1,354 @@
+/**
+ * @file opengl_extensions.h
+ * @author khalilhenoud@gmail.com
+ * @brief loads the opengl entry points beyond 1.1 (internal use only, do not
+ * include outside of the renderer sources). the entry points are exposed
+ * through their usual gl names so the calling code reads like plain opengl.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef OPENGL_EXTENSIONS_H
+#define OPENGL_EXTENSIONS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <renderer/platform/opengl_platform.h>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+typedef ptrdiff_t renderer_glsizeiptr_t;
+typedef ptrdiff_t renderer_glintptr_t;
+typedef struct renderer_glsync_opaque_t* renderer_glsync_t;
+
+// buffer objects, core in 1.5.
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER                   0x8892
+#endif
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+#define GL_ELEMENT_ARRAY_BUFFER           0x8893
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW                    0x88E0
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW                    0x88E4
+#endif
+#ifndef GL_DYNAMIC_DRAW
+#define GL_DYNAMIC_DRAW                   0x88E8
+#endif
+#ifndef GL_WRITE_ONLY
+#define GL_WRITE_ONLY                     0x88B9
+#endif
+
+// pixel buffer objects, core in 2.1.
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER            0x88EC
+#endif
+
+// block compressed textures, S3TC and RGTC (core in 3.0).
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT  0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT  0x83F3
+#endif
+#ifndef GL_COMPRESSED_RED_RGTC1
+#define GL_COMPRESSED_RED_RGTC1           0x8DBB
+#endif
+#ifndef GL_COMPRESSED_RG_RGTC2
+#define GL_COMPRESSED_RG_RGTC2            0x8DBD
+#endif
+
+// queries, core in 1.5, and timer queries, core in 3.3.
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT                   0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE         0x8867
+#endif
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED                   0x88BF
+#endif
+
+// sync objects, core in 3.2.
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE     0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT        0x00000001
+#endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED               0x911A
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED                0x911B
+#endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED            0x911C
+#endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED                    0x911D
+#endif
+
+// the extension list of core contexts, 3.0.
+#ifndef GL_NUM_EXTENSIONS
+#define GL_NUM_EXTENSIONS                 0x821D
+#endif
+
+// shaders, vertex arrays, uniform buffers and instancing, core in 3.3.
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER                0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER                  0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS                 0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS                    0x8B82
+#endif
+#ifndef GL_UNIFORM_BUFFER
+#define GL_UNIFORM_BUFFER                 0x8A11
+#endif
+#ifndef GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT  0x8A34
+#endif
+#ifndef GL_INVALID_INDEX
+#define GL_INVALID_INDEX                  0xFFFFFFFFu
+#endif
+#ifndef GL_COPY_WRITE_BUFFER
+#define GL_COPY_WRITE_BUFFER              0x8F37
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT                  0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+#define GL_MAP_INVALIDATE_RANGE_BIT       0x0004
+#endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+#define GL_MAP_UNSYNCHRONIZED_BIT         0x0020
+#endif
+#ifndef GL_FRONT_AND_BACK
+#define GL_FRONT_AND_BACK                 0x0408
+#endif
+#ifndef GL_LINE
+#define GL_LINE                           0x1B01
+#endif
+#ifndef GL_FILL
+#define GL_FILL                           0x1B02
+#endif
+
+// texture buffers, core in 3.1, read by the clustered lighting.
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0                       0x84C0
+#endif
+#ifndef GL_TEXTURE_BUFFER
+#define GL_TEXTURE_BUFFER                 0x8C2A
+#endif
+#ifndef GL_RGBA32F
+#define GL_RGBA32F                        0x8814
+#endif
+#ifndef GL_R16UI
+#define GL_R16UI                          0x8234
+#endif
+#ifndef GL_RG32UI
+#define GL_RG32UI                         0x823C
+#endif
+
+typedef void (APIENTRY *gl_gen_buffers_t)(GLsizei, GLuint*);
+typedef void (APIENTRY *gl_delete_buffers_t)(GLsizei, const GLuint*);
+typedef void (APIENTRY *gl_bind_buffer_t)(GLenum, GLuint);
+typedef void (APIENTRY *gl_buffer_data_t)(
+  GLenum, renderer_glsizeiptr_t, const void*, GLenum);
+typedef void (APIENTRY *gl_buffer_sub_data_t)(
+  GLenum, renderer_glintptr_t, renderer_glsizeiptr_t, const void*);
+typedef void* (APIENTRY *gl_map_buffer_t)(GLenum, GLenum);
+typedef GLboolean (APIENTRY *gl_unmap_buffer_t)(GLenum);
+typedef void (APIENTRY *gl_compressed_tex_image_2d_t)(
+  GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const void*);
+typedef void (APIENTRY *gl_gen_queries_t)(GLsizei, GLuint*);
+typedef void (APIENTRY *gl_delete_queries_t)(GLsizei, const GLuint*);
+typedef void (APIENTRY *gl_begin_query_t)(GLenum, GLuint);
+typedef void (APIENTRY *gl_end_query_t)(GLenum);
+typedef void (APIENTRY *gl_get_query_objectiv_t)(GLuint, GLenum, GLint*);
+typedef void (APIENTRY *gl_get_query_objectui64v_t)(
+  GLuint, GLenum, uint64_t*);
+typedef renderer_glsync_t (APIENTRY *gl_fence_sync_t)(GLenum, GLbitfield);
+typedef GLenum (APIENTRY *gl_client_wait_sync_t)(
+  renderer_glsync_t, GLbitfield, uint64_t);
+typedef void (APIENTRY *gl_delete_sync_t)(renderer_glsync_t);
+typedef const GLubyte* (APIENTRY *gl_get_stringi_t)(GLenum, GLuint);
+typedef GLuint (APIENTRY *gl_create_shader_t)(GLenum);
+typedef void (APIENTRY *gl_shader_source_t)(
+  GLuint, GLsizei, const char* const*, const GLint*);
+typedef void (APIENTRY *gl_compile_shader_t)(GLuint);
+typedef void (APIENTRY *gl_get_shaderiv_t)(GLuint, GLenum, GLint*);
+typedef void (APIENTRY *gl_delete_shader_t)(GLuint);
+typedef GLuint (APIENTRY *gl_create_program_t)(void);
+typedef void (APIENTRY *gl_attach_shader_t)(GLuint, GLuint);
+typedef void (APIENTRY *gl_bind_attrib_location_t)(
+  GLuint, GLuint, const char*);
+typedef void (APIENTRY *gl_link_program_t)(GLuint);
+typedef void (APIENTRY *gl_get_programiv_t)(GLuint, GLenum, GLint*);
+typedef void (APIENTRY *gl_use_program_t)(GLuint);
+typedef void (APIENTRY *gl_delete_program_t)(GLuint);
+typedef GLint (APIENTRY *gl_get_uniform_location_t)(GLuint, const char*);
+typedef void (APIENTRY *gl_uniform_1i_t)(GLint, GLint);
+typedef GLuint (APIENTRY *gl_get_uniform_block_index_t)(GLuint, const char*);
+typedef void (APIENTRY *gl_uniform_block_binding_t)(GLuint, GLuint, GLuint);
+typedef void (APIENTRY *gl_bind_buffer_range_t)(
+  GLenum, GLuint, GLuint, renderer_glintptr_t, renderer_glsizeiptr_t);
+typedef void* (APIENTRY *gl_map_buffer_range_t)(
+  GLenum, renderer_glintptr_t, renderer_glsizeiptr_t, GLbitfield);
+typedef void (APIENTRY *gl_gen_vertex_arrays_t)(GLsizei, GLuint*);
+typedef void (APIENTRY *gl_bind_vertex_array_t)(GLuint);
+typedef void (APIENTRY *gl_delete_vertex_arrays_t)(GLsizei, const GLuint*);
+typedef void (APIENTRY *gl_vertex_attrib_pointer_t)(
+  GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+typedef void (APIENTRY *gl_enable_vertex_attrib_array_t)(GLuint);
+typedef void (APIENTRY *gl_disable_vertex_attrib_array_t)(GLuint);
+typedef void (APIENTRY *gl_vertex_attrib_4fv_t)(GLuint, const GLfloat*);
+typedef void (APIENTRY *gl_vertex_attrib_divisor_t)(GLuint, GLuint);
+typedef void (APIENTRY *gl_draw_elements_instanced_t)(
+  GLenum, GLsizei, GLenum, const void*, GLsizei);
+typedef void (APIENTRY *gl_active_texture_t)(GLenum);
+typedef void (APIENTRY *gl_tex_buffer_t)(GLenum, GLenum, GLuint);
+
+extern gl_gen_buffers_t renderer_glGenBuffers;
+extern gl_delete_buffers_t renderer_glDeleteBuffers;
+extern gl_bind_buffer_t renderer_glBindBuffer;
+extern gl_buffer_data_t renderer_glBufferData;
+extern gl_buffer_sub_data_t renderer_glBufferSubData;
+extern gl_map_buffer_t renderer_glMapBuffer;
+extern gl_unmap_buffer_t renderer_glUnmapBuffer;
+extern gl_compressed_tex_image_2d_t renderer_glCompressedTexImage2D;
+extern gl_gen_queries_t renderer_glGenQueries;
+extern gl_delete_queries_t renderer_glDeleteQueries;
+extern gl_begin_query_t renderer_glBeginQuery;
+extern gl_end_query_t renderer_glEndQuery;
+extern gl_get_query_objectiv_t renderer_glGetQueryObjectiv;
+extern gl_get_query_objectui64v_t renderer_glGetQueryObjectui64v;
+extern gl_fence_sync_t renderer_glFenceSync;
+extern gl_client_wait_sync_t renderer_glClientWaitSync;
+extern gl_delete_sync_t renderer_glDeleteSync;
+extern gl_get_stringi_t renderer_glGetStringi;
+extern gl_create_shader_t renderer_glCreateShader;
+extern gl_shader_source_t renderer_glShaderSource;
+extern gl_compile_shader_t renderer_glCompileShader;
+extern gl_get_shaderiv_t renderer_glGetShaderiv;
+extern gl_delete_shader_t renderer_glDeleteShader;
+extern gl_create_program_t renderer_glCreateProgram;
+extern gl_attach_shader_t renderer_glAttachShader;
+extern gl_bind_attrib_location_t renderer_glBindAttribLocation;
+extern gl_link_program_t renderer_glLinkProgram;
+extern gl_get_programiv_t renderer_glGetProgramiv;
+extern gl_use_program_t renderer_glUseProgram;
+extern gl_delete_program_t renderer_glDeleteProgram;
+extern gl_get_uniform_location_t renderer_glGetUniformLocation;
+extern gl_uniform_1i_t renderer_glUniform1i;
+extern gl_get_uniform_block_index_t renderer_glGetUniformBlockIndex;
+extern gl_uniform_block_binding_t renderer_glUniformBlockBinding;
+extern gl_bind_buffer_range_t renderer_glBindBufferRange;
+extern gl_map_buffer_range_t renderer_glMapBufferRange;
+extern gl_gen_vertex_arrays_t renderer_glGenVertexArrays;
+extern gl_bind_vertex_array_t renderer_glBindVertexArray;
+extern gl_delete_vertex_arrays_t renderer_glDeleteVertexArrays;
+extern gl_vertex_attrib_pointer_t renderer_glVertexAttribPointer;
+extern gl_enable_vertex_attrib_array_t renderer_glEnableVertexAttribArray;
+extern gl_disable_vertex_attrib_array_t renderer_glDisableVertexAttribArray;
+extern gl_vertex_attrib_4fv_t renderer_glVertexAttrib4fv;
+extern gl_vertex_attrib_divisor_t renderer_glVertexAttribDivisor;
+extern gl_draw_elements_instanced_t renderer_glDrawElementsInstanced;
+extern gl_active_texture_t renderer_glActiveTexture;
+extern gl_tex_buffer_t renderer_glTexBuffer;
+
+#define glGenBuffers            renderer_glGenBuffers
+#define glDeleteBuffers         renderer_glDeleteBuffers
+#define glBindBuffer            renderer_glBindBuffer
+#define glBufferData            renderer_glBufferData
+#define glBufferSubData         renderer_glBufferSubData
+#define glMapBuffer             renderer_glMapBuffer
+#define glUnmapBuffer           renderer_glUnmapBuffer
+#define glCompressedTexImage2D  renderer_glCompressedTexImage2D
+#define glGenQueries            renderer_glGenQueries
+#define glDeleteQueries         renderer_glDeleteQueries
+#define glBeginQuery            renderer_glBeginQuery
+#define glEndQuery              renderer_glEndQuery
+#define glGetQueryObjectiv      renderer_glGetQueryObjectiv
+#define glGetQueryObjectui64v   renderer_glGetQueryObjectui64v
+#define glFenceSync             renderer_glFenceSync
+#define glClientWaitSync        renderer_glClientWaitSync
+#define glDeleteSync            renderer_glDeleteSync
+#define glGetStringi            renderer_glGetStringi
+#define glCreateShader          renderer_glCreateShader
+#define glShaderSource          renderer_glShaderSource
+#define glCompileShader         renderer_glCompileShader
+#define glGetShaderiv           renderer_glGetShaderiv
+#define glDeleteShader          renderer_glDeleteShader
+#define glCreateProgram         renderer_glCreateProgram
+#define glAttachShader          renderer_glAttachShader
+#define glBindAttribLocation    renderer_glBindAttribLocation
+#define glLinkProgram           renderer_glLinkProgram
+#define glGetProgramiv          renderer_glGetProgramiv
+#define glUseProgram            renderer_glUseProgram
+#define glDeleteProgram         renderer_glDeleteProgram
+#define glGetUniformLocation    renderer_glGetUniformLocation
+#define glUniform1i             renderer_glUniform1i
+#define glGetUniformBlockIndex  renderer_glGetUniformBlockIndex
+#define glUniformBlockBinding   renderer_glUniformBlockBinding
+#define glBindBufferRange       renderer_glBindBufferRange
+#define glMapBufferRange        renderer_glMapBufferRange
+#define glGenVertexArrays       renderer_glGenVertexArrays
+#define glBindVertexArray       renderer_glBindVertexArray
+#define glDeleteVertexArrays    renderer_glDeleteVertexArrays
+#define glVertexAttribPointer   renderer_glVertexAttribPointer
+#define glEnableVertexAttribArray   renderer_glEnableVertexAttribArray
+#define glDisableVertexAttribArray  renderer_glDisableVertexAttribArray
+#define glVertexAttrib4fv       renderer_glVertexAttrib4fv
+#define glVertexAttribDivisor   renderer_glVertexAttribDivisor
+#define glDrawElementsInstanced renderer_glDrawElementsInstanced
+#define glActiveTexture         renderer_glActiveTexture
+#define glTexBuffer             renderer_glTexBuffer
+
+/// @brief what the current context supports, filled by
+/// opengl_extensions_load().
+typedef
+struct opengl_features_t {
+  int32_t major;
+  int32_t minor;
+  int32_t buffer_objects;
+  int32_t pixel_buffer_objects;   // also requires mapping.
+  int32_t npot_textures;          // non power of 2 sizes with mipmaps.
+  int32_t max_texture_size;
+  int32_t s3tc_textures;          // BC1/BC3.
+  int32_t rgtc_textures;          // BC4/BC5.
+  int32_t timer_queries;          // GL_TIME_ELAPSED.
+  int32_t sync_objects;           // fences.
+  int32_t core_profile;           // the 3.3 entry points of renderer_core.c.
+} opengl_features_t;
+
+extern opengl_features_t opengl_features;
+
+/// @brief requires a current context, called from renderer_initialize().
+void
+opengl_extensions_load(void);
+
+/// @brief returns non-zero if @a name is in the extension string.
+int32_t
+opengl_has_extension(const char* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * @file renderer_internal.h
+ * @author khalilhenoud@gmail.com
+ * @brief helpers of renderer_opengl.c shared with the other renderer sources
+ * (internal use only).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef RENDERER_INTERNAL_H
+#define RENDERER_INTERNAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <renderer/renderer_opengl.h>
+
+
+/// @brief state for the unlit entry points (grid, points, lines, wireframe),
+/// every client array but the vertex array is disabled.
+RENDERER_INTERNAL
+void
+renderer_internal_set_unlit_state(void);
+
+/// @brief client side arrays are ignored while a buffer object is bound.
+RENDERER_INTERNAL
+void
+renderer_internal_unbind_buffers(void);
+
+/// @brief @a color multiplied by @a tint, component wise.
+RENDERER_INTERNAL
+color_t
+renderer_internal_modulate_color(const color_t* color, const color_t* tint);
+
+/// @brief the matrix glFrustum/glOrtho would build for the projection of
+/// @a pipeline, row major (same layout as matrix4f).
+RENDERER_INTERNAL
+void
+renderer_internal_get_projection_matrix(
+  const pipeline_t* pipeline,
+  float* matrix);
+
+/// @brief converts @a count texels of any uncompressed format to RGBA8, the
+/// values are chosen so GL_MODULATE behaves the same (luminance replicates,
+/// alpha only textures are white).
+RENDERER_INTERNAL
+void
+renderer_internal_convert_texels(
+  const uint8_t* source,
+  uint32_t count,
+  renderer_image_format_t format,
+  uint8_t* target);
+
+/// @brief the upload_to_gpu opengl path without the stats timer, the core
+/// backend shares it. the formats have to be valid for the context.
+RENDERER_INTERNAL
+uint32_t
+renderer_internal_upload_texture(
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * @file software_raster.h
+ * @author khalilhenoud@gmail.com
+ * @brief tiled triangle rasterizer of the software backend (internal use only).
+ * triangles are queued in window space, flushing bins them into screen tiles
+ * and rasterizes the tiles in parallel, each tile keeping the submission order.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef SOFTWARE_RASTER_H
+#define SOFTWARE_RASTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/renderer_software.h>
+
+
+#define RASTER_TILE_SIZE          64
+
+typedef
+enum raster_blend_t {
+  RASTER_BLEND_NONE,
+  RASTER_BLEND_ALPHA,       // GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA.
+  RASTER_BLEND_COLOR        // GL_SRC_COLOR, GL_ONE_MINUS_SRC_COLOR.
+} raster_blend_t;
+
+/// @brief RGBA8 texels, sampled bilinearly with repeat wrapping.
+typedef
+struct raster_texture_t {
+  uint8_t* texels;
+  uint32_t width;
+  uint32_t height;
+} raster_texture_t;
+
+/// @brief window space triangle (bottom left origin, pixel centers at .5), the
+/// color and uv are pre-divided by w for perspective correct interpolation.
+/// the rasterizer fills the setup part when binning.
+typedef
+struct raster_triangle_t {
+  float x[3];
+  float y[3];
+  float z[3];               // window depth in [0, 1].
+  float inv_w[3];
+  float color[3][4];
+  float uv[3][2];
+  const raster_texture_t* texture;    // NULL if untextured.
+  uint8_t blend;            // raster_blend_t.
+  uint8_t depth_test;       // GL_LESS test and depth writes.
+
+  // setup, edge i is opposite to vertex i.
+  int32_t min_x;
+  int32_t min_y;
+  int32_t max_x;
+  int32_t max_y;
+  float edge_dx[3];         // edge increments per pixel in x and y.
+  float edge_dy[3];
+  float edge_origin[3];     // edge values at the (min_x, min_y) pixel center.
+  float inv_area;
+} raster_triangle_t;
+
+void
+raster_initialize(const renderer_software_target_t* target);
+
+void
+raster_cleanup(void);
+
+/// @brief returns room for @a count triangles at the end of the queue, the
+/// pointer is invalidated by the next call.
+raster_triangle_t*
+raster_append(uint32_t count);
+
+uint32_t
+raster_pending(void);
+
+/// @brief drops the queued triangles (they would be overwritten) and clears
+/// the whole target at the start of the next flush.
+void
+raster_clear(const float color[4]);
+
+/// @brief bins and rasterizes the queued triangles, empties the queue.
+void
+raster_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file state_cache.h
+ * @author khalilhenoud@gmail.com
+ * @brief shadow copy of the opengl state the renderer touches (internal use
+ * only). calls are only forwarded to opengl on actual transitions, state that
+ * has not been seen yet (after a reset) is treated as unknown and always set.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef STATE_CACHE_H
+#define STATE_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/pipeline.h>
+#include <renderer/platform/opengl_platform.h>
+
+
+/// @brief forgets everything, the next call for any state reaches opengl.
+void
+state_cache_reset(void);
+
+/// @brief glEnable/glDisable, capabilities that are not tracked are always
+/// forwarded.
+void
+state_set(GLenum cap, int32_t enable);
+
+void
+state_enable(GLenum cap);
+
+void
+state_disable(GLenum cap);
+
+/// @brief glEnableClientState/glDisableClientState.
+void
+state_set_client(GLenum array, int32_t enable);
+
+void
+state_blend_func(GLenum source, GLenum destination);
+
+void
+state_line_width(float width);
+
+void
+state_point_size(float size);
+
+/// @brief GL_TEXTURE_2D binding.
+void
+state_bind_texture(GLuint texture);
+
+/// @brief call before deleting a texture, opengl resets the binding to 0 if
+/// it was bound.
+void
+state_forget_texture(GLuint texture);
+
+/// @brief GL_ARRAY_BUFFER/GL_ELEMENT_ARRAY_BUFFER bindings.
+void
+state_bind_buffer(GLenum target, GLuint buffer);
+
+void
+state_forget_buffer(GLuint buffer);
+
+void
+state_matrix_mode(GLenum mode);
+
+/// @brief loads the modelview top of @a pipeline (NULL for the identity) in
+/// the opengl modelview. the matrix is identified by the pipeline, its
+/// generation, its stack slot and the version of that slot, it is only
+/// transposed and sent when one of them differs from the last load.
+void
+state_load_modelview(const pipeline_t* pipeline);
+
+/// @brief loads @a matrix (row major, like the pipeline) in the opengl
+/// modelview. it belongs to no pipeline slot, the next state_load_modelview
+/// always goes through.
+void
+state_load_modelview_matrix(const matrix4f* matrix);
+
+/// @brief glViewport.
+void
+state_viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/// @brief loads the projection described by the frustum parameters of
+/// @a pipeline (glFrustum/glOrtho), skipped if they match the last load.
+void
+state_load_projection(const pipeline_t* pipeline);
+
+/// @brief glLightfv, GL_POSITION and GL_SPOT_DIRECTION are also compared
+/// against the modelview they were last sent under.
+void
+state_light(GLenum light, GLenum pname, const float* params);
+
+void
+state_get_counters(uint64_t* issued, uint64_t* skipped);
+
+/// @brief viewport, projection and glLightfv updates dropped because nothing
+/// changed, also part of the skipped count.
+void
+state_get_skipped_updates(
+  uint64_t* viewports,
+  uint64_t* projections,
+  uint64_t* lights);
+
+void
+state_reset_counters(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file texture_streaming.h
+ * @author khalilhenoud@gmail.com
+ * @brief asynchronous texture uploads (internal use only). a worker thread
+ * prepares the level 0 pixels and the mip chain, the thread owning the context
+ * then streams the levels into the texture through pixel buffer objects, a
+ * few each frame.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef TEXTURE_STREAMING_H
+#define TEXTURE_STREAMING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/internal/mipmaps.h>
+#include <renderer/platform/opengl_platform.h>
+
+
+/// @brief queues @a texture (already generated) for streaming, @a pixels are
+/// copied. @a format is the opengl pixel format of the 8 bit components once
+/// swizzled (see mipmaps_generate).
+void
+texture_streaming_request(
+  GLuint texture,
+  const uint8_t* pixels,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components,
+  GLenum format,
+  int32_t swizzle,
+  mipmaps_filter_t filter);
+
+/// @brief non-zero while some level of @a texture is not uploaded yet.
+int32_t
+texture_streaming_is_pending(GLuint texture);
+
+/// @brief drops the pending work of @a texture, call before deleting it.
+void
+texture_streaming_cancel(GLuint texture);
+
+/// @brief uploads prepared levels until @a byte_budget is spent, at least one
+/// level goes through if any is ready.
+void
+texture_streaming_pump(uint32_t byte_budget);
+
+/// @brief stops the worker and drops everything still pending.
+void
+texture_streaming_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
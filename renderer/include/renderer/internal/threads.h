@@ -0,0 +1,77 @@
+/**
+ * @file threads.h
+ * @author khalilhenoud@gmail.com
+ * @brief minimal threading primitives (internal use only), implemented per
+ * platform in source/platform/threads_*.c.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef THREADS_H
+#define THREADS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+
+typedef struct thread_t thread_t;
+typedef struct mutex_t mutex_t;
+typedef struct condition_t condition_t;
+
+typedef void (*thread_function_t)(void* data);
+
+/// @brief returns NULL if the thread could not be started.
+thread_t*
+thread_create(thread_function_t function, void* data);
+
+/// @brief waits for the thread to exit and releases it.
+void
+thread_join(thread_t* thread);
+
+/// @brief number of hardware threads, at least 1.
+uint32_t
+thread_hardware_concurrency(void);
+
+/// @brief atomically adds 1 and returns the new value.
+int32_t
+thread_atomic_increment(volatile int32_t* value);
+
+mutex_t*
+mutex_create(void);
+
+void
+mutex_destroy(mutex_t* mutex);
+
+void
+mutex_lock(mutex_t* mutex);
+
+void
+mutex_unlock(mutex_t* mutex);
+
+condition_t*
+condition_create(void);
+
+void
+condition_destroy(condition_t* condition);
+
+/// @brief @a mutex must be locked, it is released while waiting. spurious
+/// wake ups are possible.
+void
+condition_wait(condition_t* condition, mutex_t* mutex);
+
+void
+condition_signal(condition_t* condition);
+
+void
+condition_broadcast(condition_t* condition);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
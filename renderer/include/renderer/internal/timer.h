@@ -0,0 +1,30 @@
+/**
+ * @file timer.h
+ * @author khalilhenoud@gmail.com
+ * @brief platform monotonic clock (internal use only).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef TIMER_H
+#define TIMER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+
+/// @brief nanoseconds from an arbitrary origin, only differences mean
+/// anything.
+uint64_t
+timer_nanoseconds(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+/**
+ * @file unit_quads.h
+ * @author khalilhenoud@gmail.com
+ * @brief expands unit quads (glyph runs) into a single vertex/uv array that can
+ * be drawn in one call (internal use only, does not depend on opengl).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef UNIT_QUADS_H
+#define UNIT_QUADS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/renderer_opengl.h>
+
+
+#define UNIT_QUAD_VERTICES      4
+#define UNIT_QUAD_INDICES       6
+
+/// @brief writes 4 vertices (3 floats each) and 4 uvs (2 floats each) per
+/// quad, quads are laid out left to right starting at x = 0.
+void
+expand_unit_quads(
+  const unit_quad_t* uvs,
+  uint32_t uvs_count,
+  float* vertices,
+  float* tex_coords);
+
+/// @brief writes the shared index pattern for quads [first, first + count).
+void
+build_unit_quad_indices(uint32_t* indices, uint32_t first, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -20,6 +20,19 @@ extern "C" {
 #include <stdio.h>
 #include <string.h>
 #include <math/matrix4f.h>
+#include <renderer/internal/module.h>
+
+#if defined(__AVX__)
+#define PIPELINE_AVX
+#include <immintrin.h>
+#endif
+
+#if \
+  defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define PIPELINE_SSE
+#include <xmmintrin.h>
+#endif
 
 
 // TODO: implement a texture stack.
@@ -65,6 +78,13 @@ struct pipeline_t {
   int32_t modelview_index;
   matrix4f projection_stack[PROJECTION_STACK];
   int32_t projection_index;
+
+  // bumped every time the matrix in the slot changes, the renderer uses them
+  // to skip uploading a matrix it has already loaded. they only mean something
+  // within a generation.
+  uint32_t generation;
+  uint32_t modelview_version[MODELVIEW_STACK];
+  uint32_t projection_version[PROJECTION_STACK];
   projection_mode_t projection_mode;
   float frustum[FRUSTUM_COUNT];
   float viewport[VIEWPORT_COUNT];
@@ -72,16 +92,156 @@ struct pipeline_t {
   // internal use.
   matrix4f* current_stack;
   int32_t* current_index;
+  uint32_t* current_version;
   int32_t current_max_index;
 } pipeline_t;
 
 
 ////////////////////////////////////////////////////////////////////////////////
-inline
+/// @brief @a result = @a a * @a b on the raw row major data, @a result can
+/// alias either operand.
+static inline
+void
+pipeline_multiply(const float* a, const float* b, float* result)
+{
+#if defined(PIPELINE_AVX)
+  // two rows of the result per iteration.
+  __m256 b0 = _mm256_broadcast_ps((const __m128*)(b + 0));
+  __m256 b1 = _mm256_broadcast_ps((const __m128*)(b + 4));
+  __m256 b2 = _mm256_broadcast_ps((const __m128*)(b + 8));
+  __m256 b3 = _mm256_broadcast_ps((const __m128*)(b + 12));
+  __m256 rows[2];
+  for (uint32_t i = 0; i < 2; ++i) {
+    const float* r0 = a + i * 8;
+    const float* r1 = r0 + 4;
+    __m256 row = _mm256_mul_ps(
+      _mm256_set_m128(_mm_set1_ps(r1[0]), _mm_set1_ps(r0[0])), b0);
+    row = _mm256_add_ps(row, _mm256_mul_ps(
+      _mm256_set_m128(_mm_set1_ps(r1[1]), _mm_set1_ps(r0[1])), b1));
+    row = _mm256_add_ps(row, _mm256_mul_ps(
+      _mm256_set_m128(_mm_set1_ps(r1[2]), _mm_set1_ps(r0[2])), b2));
+    row = _mm256_add_ps(row, _mm256_mul_ps(
+      _mm256_set_m128(_mm_set1_ps(r1[3]), _mm_set1_ps(r0[3])), b3));
+    rows[i] = row;
+  }
+  _mm256_storeu_ps(result + 0, rows[0]);
+  _mm256_storeu_ps(result + 8, rows[1]);
+#elif defined(PIPELINE_SSE)
+  __m128 b0 = _mm_loadu_ps(b + 0);
+  __m128 b1 = _mm_loadu_ps(b + 4);
+  __m128 b2 = _mm_loadu_ps(b + 8);
+  __m128 b3 = _mm_loadu_ps(b + 12);
+  __m128 rows[4];
+  for (uint32_t i = 0; i < 4; ++i) {
+    const float* r = a + i * 4;
+    __m128 row = _mm_mul_ps(_mm_set1_ps(r[0]), b0);
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(r[1]), b1));
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(r[2]), b2));
+    row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(r[3]), b3));
+    rows[i] = row;
+  }
+  for (uint32_t i = 0; i < 4; ++i)
+    _mm_storeu_ps(result + i * 4, rows[i]);
+#else
+  float rows[16];
+  for (uint32_t i = 0; i < 4; ++i) {
+    for (uint32_t j = 0; j < 4; ++j)
+      rows[i * 4 + j] =
+        a[i * 4 + 0] * b[0 * 4 + j] +
+        a[i * 4 + 1] * b[1 * 4 + j] +
+        a[i * 4 + 2] * b[2 * 4 + j] +
+        a[i * 4 + 3] * b[3 * 4 + j];
+  }
+  memcpy(result, rows, sizeof(rows));
+#endif
+}
+
+/// @brief row @a i += @a factor * row @a j of the raw row major data.
+static inline
+void
+pipeline_add_row(float* m, uint32_t i, uint32_t j, float factor)
+{
+#if defined(PIPELINE_SSE)
+  _mm_storeu_ps(
+    m + i * 4,
+    _mm_add_ps(
+      _mm_loadu_ps(m + i * 4),
+      _mm_mul_ps(_mm_set1_ps(factor), _mm_loadu_ps(m + j * 4))));
+#else
+  for (uint32_t k = 0; k < 4; ++k)
+    m[i * 4 + k] += factor * m[j * 4 + k];
+#endif
+}
+
+static inline
+void
+pipeline_scale_row(float* m, uint32_t i, float factor)
+{
+#if defined(PIPELINE_SSE)
+  _mm_storeu_ps(
+    m + i * 4, _mm_mul_ps(_mm_set1_ps(factor), _mm_loadu_ps(m + i * 4)));
+#else
+  for (uint32_t k = 0; k < 4; ++k)
+    m[i * 4 + k] *= factor;
+#endif
+}
+
+/// @brief m = r * m where r only differs from the identity in the 2x2 block
+/// of rows/columns @a i and @a j (rotations around an axis).
+static inline
+void
+pipeline_post_rotate_block(float* m, const float* r, uint32_t i, uint32_t j)
+{
+  float rii = r[i * 4 + i], rij = r[i * 4 + j];
+  float rji = r[j * 4 + i], rjj = r[j * 4 + j];
+#if defined(PIPELINE_SSE)
+  __m128 row_i = _mm_loadu_ps(m + i * 4);
+  __m128 row_j = _mm_loadu_ps(m + j * 4);
+  _mm_storeu_ps(
+    m + i * 4,
+    _mm_add_ps(
+      _mm_mul_ps(_mm_set1_ps(rii), row_i),
+      _mm_mul_ps(_mm_set1_ps(rij), row_j)));
+  _mm_storeu_ps(
+    m + j * 4,
+    _mm_add_ps(
+      _mm_mul_ps(_mm_set1_ps(rji), row_i),
+      _mm_mul_ps(_mm_set1_ps(rjj), row_j)));
+#else
+  for (uint32_t k = 0; k < 4; ++k) {
+    float a = m[i * 4 + k], b = m[j * 4 + k];
+    m[i * 4 + k] = rii * a + rij * b;
+    m[j * 4 + k] = rji * a + rjj * b;
+  }
+#endif
+}
+
+/// @brief m = m * r, same restriction on r as pipeline_post_rotate_block.
+static inline
+void
+pipeline_pre_rotate_block(float* m, const float* r, uint32_t i, uint32_t j)
+{
+  float rii = r[i * 4 + i], rij = r[i * 4 + j];
+  float rji = r[j * 4 + i], rjj = r[j * 4 + j];
+  for (uint32_t k = 0; k < 4; ++k) {
+    float a = m[k * 4 + i], b = m[k * 4 + j];
+    m[k * 4 + i] = a * rii + b * rji;
+    m[k * 4 + j] = a * rij + b * rjj;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a value never returned before (process wide), see
+/// pipeline_set_default.
+RENDERER_API
+uint32_t
+pipeline_next_generation(void);
+
+static inline
 void
 set_matrix_mode(pipeline_t*, stack_mode_t);
 
-inline
+static inline
 void
 pipeline_set_default(pipeline_t* dst)
 {
@@ -91,11 +251,17 @@ pipeline_set_default(pipeline_t* dst)
   memset(dst->frustum, 0, sizeof(float) * 6);
   memset(dst->viewport, 0, sizeof(float) * 4);
 
+  // a pipeline set up again at the same address (even zeroed in between)
+  // must not match what the renderer remembers of the previous one.
+  dst->generation = pipeline_next_generation();
+  memset(dst->modelview_version, 0, sizeof(dst->modelview_version));
+  memset(dst->projection_version, 0, sizeof(dst->projection_version));
+
   set_matrix_mode(dst, MODELVIEW);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-inline
+static inline
 projection_mode_t
 get_projection_type(const pipeline_t* pipeline)
 {
@@ -104,7 +270,7 @@ get_projection_type(const pipeline_t* pipeline)
 
 /// @brief given the pipeline populate the parameters with the viewport
 /// properties.
-inline
+static inline
 void
 get_viewport_info(
   const pipeline_t* pipeline,
@@ -119,7 +285,7 @@ get_viewport_info(
   *height = pipeline->viewport[HEIGHT];
 }
 
-inline
+static inline
 void
 set_viewport(
   pipeline_t* dst,
@@ -142,7 +308,7 @@ set_viewport(
 /// @param top The top frustum clipping plane on the near plane.
 /// @param near_z The near clipping plane distance (positive value).
 /// @param far_z The far clipping plane distance (positive value).
-inline
+static inline
 void
 set_perspective(
   pipeline_t* dst,
@@ -163,7 +329,7 @@ set_perspective(
 }
 
 /// @brief the equivalent to set_perspective, but uses orthographic projection.
-inline
+static inline
 void
 set_orthographic(
   pipeline_t* dst,
@@ -184,7 +350,7 @@ set_orthographic(
 }
 
 /// @brief retrieves the information set by set_perspective or set_orthographic.
-inline
+static inline
 void
 get_frustum(
   const pipeline_t* pipeline,
@@ -205,7 +371,7 @@ get_frustum(
 
 /// @brief sets the current stack mode of the pipeline, along with a few helper
 /// variables.
-inline
+static inline
 void
 set_matrix_mode(pipeline_t* dst, stack_mode_t mode)
 {
@@ -213,26 +379,46 @@ set_matrix_mode(pipeline_t* dst, stack_mode_t mode)
   if (mode == MODELVIEW) {
     dst->current_stack = dst->modelview_stack;
     dst->current_index = &dst->modelview_index;
+    dst->current_version = dst->modelview_version;
     dst->current_max_index = MODELVIEW_STACK;
   } else if (mode == PROJECTION) {
     dst->current_stack = dst->projection_stack;
     dst->current_index = &dst->projection_index;
+    dst->current_version = dst->projection_version;
     dst->current_max_index = PROJECTION_STACK;
   }
 }
 
 /// @brief returns the current top of the stack matrix.
-inline
+static inline
 matrix4f
 get_matrix(const pipeline_t* pipeline)
 {
   return pipeline->current_stack[*pipeline->current_index];
 }
 
+/// @brief version of the current top of the stack, changes whenever the top
+/// matrix does.
+static inline
+uint32_t
+get_matrix_version(const pipeline_t* pipeline)
+{
+  return pipeline->current_version[*pipeline->current_index];
+}
+
+/// @brief returns the top matrix data for modification, bumps its version.
+static inline
+float*
+pipeline_modify_top(pipeline_t* dst)
+{
+  ++dst->current_version[*dst->current_index];
+  return dst->current_stack[*dst->current_index].data;
+}
+
 /// @brief dupliate the matrix at the top of the stack and push it on top. this
 /// effectively makes the matrix at the top of the stack identical to the one
 /// just below it. this is useful for throwaway transformation cases.
-inline
+static inline
 void
 push_matrix(pipeline_t* dst)
 {
@@ -240,30 +426,33 @@ push_matrix(pipeline_t* dst)
   dst->current_stack[*dst->current_index + 1] =
     dst->current_stack[*dst->current_index];
   ++*dst->current_index;
+  ++dst->current_version[*dst->current_index];
 }
 
 /// @brief removes and returns the top matrix.
-inline
+static inline
 matrix4f
 pop_matrix(pipeline_t* dst)
 {
-  assert(dst->current_index > 0);
+  assert(*dst->current_index > 0);
   return dst->current_stack[(*dst->current_index)--];
 }
 
 /// @brief loads the identity matrix at the top of the stack.
-inline
+static inline
 void
 load_identity(pipeline_t* dst)
 {
+  pipeline_modify_top(dst);
   matrix4f_set_identity(&dst->current_stack[*dst->current_index]);
 }
 
 /// @brief replaces the top matrix with src.
-inline
+static inline
 void
 replace(pipeline_t* dst, const matrix4f* src)
 {
+  pipeline_modify_top(dst);
   matrix4f_copy(&dst->current_stack[*dst->current_index], src);
 }
 
@@ -272,112 +461,188 @@ replace(pipeline_t* dst, const matrix4f* src)
 /// applied after the transformation represented by the matrix on top of the
 /// stack.
 /// @param matrix the transformation to post apply to the top of the stack.
-inline
+static inline
 void
 post_multiply(pipeline_t* dst, const matrix4f* matrix)
 {
-  matrix4f result = mult_m4f(matrix, dst->current_stack + *dst->current_index);
-  matrix4f_copy(dst->current_stack + *dst->current_index, &result);
+  float* top = pipeline_modify_top(dst);
+  pipeline_multiply(matrix->data, top, top);
 }
 
-inline
+/// @brief the rotations only touch 2 rows of the top matrix, the angle still
+/// goes through matrix4f_rotation_* so the conventions stay in one place.
+static inline
 void
 post_rotate_x(pipeline_t* dst, float angle_radian)
 {
   matrix4f result;
   matrix4f_rotation_x(&result, angle_radian);
-  post_multiply(dst, &result);
+  pipeline_post_rotate_block(pipeline_modify_top(dst), result.data, 1, 2);
 }
 
-inline
+static inline
 void
 post_rotate_y(pipeline_t* dst, float angle_radian)
 {
   matrix4f result;
   matrix4f_rotation_y(&result, angle_radian);
-  post_multiply(dst, &result);
+  pipeline_post_rotate_block(pipeline_modify_top(dst), result.data, 0, 2);
 }
 
-inline
+static inline
 void
 post_rotate_z(pipeline_t* dst, float angle_radian)
 {
   matrix4f result;
   matrix4f_rotation_z(&result, angle_radian);
-  post_multiply(dst, &result);
+  pipeline_post_rotate_block(pipeline_modify_top(dst), result.data, 0, 1);
 }
 
-inline
+/// @brief translation * top, adds a multiple of the last row to the others.
+static inline
 void
 post_translate(pipeline_t* dst, float x, float y, float z)
 {
-  matrix4f result;
-  matrix4f_translation(&result, x, y, z);
-  post_multiply(dst, &result);
+  float* top = pipeline_modify_top(dst);
+  pipeline_add_row(top, 0, 3, x);
+  pipeline_add_row(top, 1, 3, y);
+  pipeline_add_row(top, 2, 3, z);
 }
 
-inline
+static inline
 void
 post_scale(pipeline_t* dst, float x, float y, float z)
 {
-  matrix4f result;
-  matrix4f_scale(&result, x, y, z);
-  post_multiply(dst, &result);
+  float* top = pipeline_modify_top(dst);
+  pipeline_scale_row(top, 0, x);
+  pipeline_scale_row(top, 1, y);
+  pipeline_scale_row(top, 2, z);
 }
 
 /// @brief pre-multiply the top of the stack with @a matrix. @a matrix
 /// transformation is applied before that represented by the top matrix.
 /// @param matrix the pre-transformation to apply.
-inline
+static inline
 void
 pre_multiply(pipeline_t* dst, const matrix4f* matrix)
 {
-  mult_set_m4f(dst->current_stack + *dst->current_index, matrix);
+  float* top = pipeline_modify_top(dst);
+  pipeline_multiply(top, matrix->data, top);
 }
 
-inline
+static inline
 void
 pre_rotate_x(pipeline_t* dst, float angle_radian)
 {
   matrix4f result;
   matrix4f_rotation_x(&result, angle_radian);
-  pre_multiply(dst, &result);
+  pipeline_pre_rotate_block(pipeline_modify_top(dst), result.data, 1, 2);
 }
 
-inline
+static inline
 void
 pre_rotate_y(pipeline_t* dst, float angle_radian)
 {
   matrix4f result;
   matrix4f_rotation_y(&result, angle_radian);
-  pre_multiply(dst, &result);
+  pipeline_pre_rotate_block(pipeline_modify_top(dst), result.data, 0, 2);
 }
 
-inline
+static inline
 void
 pre_rotate_z(pipeline_t* dst, float angle_radian)
 {
   matrix4f result;
   matrix4f_rotation_z(&result, angle_radian);
-  pre_multiply(dst, &result);
+  pipeline_pre_rotate_block(pipeline_modify_top(dst), result.data, 0, 1);
 }
 
-inline
+/// @brief top * translation, only the last column changes.
+static inline
 void
 pre_translate(pipeline_t* dst, float x, float y, float z)
 {
-  matrix4f result;
-  matrix4f_translation(&result, x, y, z);
-  pre_multiply(dst, &result);
+  float* top = pipeline_modify_top(dst);
+  for (uint32_t row = 0; row < 4; ++row)
+    top[row * 4 + 3] +=
+      top[row * 4 + 0] * x + top[row * 4 + 1] * y + top[row * 4 + 2] * z;
 }
 
-inline
+static inline
 void
 pre_scale(pipeline_t* dst, float x, float y, float z)
 {
-  matrix4f result;
-  matrix4f_scale(&result, x, y, z);
-  pre_multiply(dst, &result);
+  float* top = pipeline_modify_top(dst);
+  for (uint32_t row = 0; row < 4; ++row) {
+    top[row * 4 + 0] *= x;
+    top[row * 4 + 1] *= y;
+    top[row * 4 + 2] *= z;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief transforms @a count points (w = 1) by the top of the current stack,
+/// the w of the result is dropped. strides are in floats and can be 0 for
+/// tightly packed points, @a result can alias @a points with the same stride.
+static inline
+void
+transform_points(
+  const pipeline_t* pipeline,
+  const float* points,
+  uint32_t stride,
+  uint32_t count,
+  float* result,
+  uint32_t result_stride)
+{
+  const float* m = pipeline->current_stack[*pipeline->current_index].data;
+  stride = stride ? stride : 3;
+  result_stride = result_stride ? result_stride : 3;
+
+#if defined(PIPELINE_SSE)
+  {
+    // columns of the matrix, the result is a sum of scaled columns.
+    __m128 c0 = _mm_set_ps(m[12], m[8], m[4], m[0]);
+    __m128 c1 = _mm_set_ps(m[13], m[9], m[5], m[1]);
+    __m128 c2 = _mm_set_ps(m[14], m[10], m[6], m[2]);
+    __m128 c3 = _mm_set_ps(m[15], m[11], m[7], m[3]);
+    for (uint32_t i = 0; i < count; ++i) {
+      __m128 p = _mm_add_ps(
+        _mm_add_ps(
+          _mm_mul_ps(_mm_set1_ps(points[0]), c0),
+          _mm_mul_ps(_mm_set1_ps(points[1]), c1)),
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(points[2]), c2), c3));
+      _mm_storel_pi((__m64*)result, p);
+      _mm_store_ss(result + 2, _mm_movehl_ps(p, p));
+      points += stride;
+      result += result_stride;
+    }
+  }
+#else
+  for (uint32_t i = 0; i < count; ++i) {
+    float x = points[0], y = points[1], z = points[2];
+    for (uint32_t row = 0; row < 3; ++row)
+      result[row] =
+        m[row * 4 + 0] * x + m[row * 4 + 1] * y + m[row * 4 + 2] * z +
+        m[row * 4 + 3];
+    points += stride;
+    result += result_stride;
+  }
+#endif
+}
+
+/// @brief result[i] = top of the current stack * matrices[i], @a result can
+/// alias @a matrices.
+static inline
+void
+transform_matrices(
+  const pipeline_t* pipeline,
+  const matrix4f* matrices,
+  uint32_t count,
+  matrix4f* result)
+{
+  const float* top = pipeline->current_stack[*pipeline->current_index].data;
+  for (uint32_t i = 0; i < count; ++i)
+    pipeline_multiply(top, matrices[i].data, result[i].data);
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,24 @@
+/**
+ * @file opengl_parameters.h
+ * @author khalilhenoud@gmail.com
+ * @brief platform specific parameter define, the linux backend is headless and
+ * renders into an offscreen framebuffer of the requested size.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef LINUX_OPENGL_PARAMETERS_H
+#define LINUX_OPENGL_PARAMETERS_H
+
+#include <stdint.h>
+
+
+typedef
+struct opengl_parameters_t {
+  uint32_t width;
+  uint32_t height;
+} opengl_parameters_t;
+
+#endif
@@ -20,17 +20,28 @@ extern "C" {
 #if defined(WIN32) || defined(WIN64)
 #include <windows.h>  // order dependent, cannot be moved
 #include <GL/gl.h>
-#include <GL/glu.h>
 #include <renderer/platform/win32/opengl_parameters.h>
+#elif defined(__linux__)
+#include <GL/gl.h>
+#include <renderer/platform/linux/opengl_parameters.h>
 #else
 // TODO: Implement static assert for C using negative indices array.
 #endif
 
 
+/// @brief creates the context and makes it current. returns 0 and creates
+/// nothing if that fails (no EGL driver, display or config on linux).
 RENDERER_API
-void
+int32_t
 opengl_initialize(const opengl_parameters_t *params);
 
+/// @brief same as opengl_initialize but the context is a 3.3 core profile
+/// one, for renderer_initialize_core. returns 0 and creates nothing if the
+/// driver does not support it.
+RENDERER_API
+int32_t
+opengl_initialize_core(const opengl_parameters_t *params);
+
 RENDERER_API
 void
 opengl_swapbuffer();
@@ -39,6 +50,12 @@ RENDERER_API
 void
 opengl_cleanup();
 
+/// @brief returns the address of an opengl entry point (extensions and
+/// anything beyond 1.1), NULL if the implementation does not export it.
+RENDERER_API
+void*
+opengl_get_proc_address(const char* name);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,83 @@
+/**
+ * @file render_queue.h
+ * @author khalilhenoud@gmail.com
+ * @brief sorts a batch of meshes by 64 bits keys (opaque/transparent, texture,
+ * material, depth) so that submission can skip redundant state changes.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/internal/module.h>
+#include <renderer/renderer_opengl.h>
+
+
+/// key layout, most significant bit first:
+/// opaque:       0 | texture (16) | material (16) | depth (31, front to back)
+/// transparent:  1 | depth (31, back to front) | texture (16) | material (16)
+typedef
+struct render_queue_item_t {
+  uint64_t key;
+  const mesh_render_data_t* mesh;
+  uint32_t texture_id;
+} render_queue_item_t;
+
+typedef
+struct render_queue_t {
+  render_queue_item_t* items;
+  render_queue_item_t* scratch;   // ping-pong buffer for the radix sort.
+  uint32_t count;
+  uint32_t capacity;
+} render_queue_t;
+
+RENDERER_API
+void
+render_queue_initialize(render_queue_t* queue, uint32_t capacity);
+
+RENDERER_API
+void
+render_queue_cleanup(render_queue_t* queue);
+
+/// @brief empties the queue, keeps the allocated memory.
+RENDERER_API
+void
+render_queue_clear(render_queue_t* queue);
+
+/// @brief appends a batch of meshes, the queue grows as needed. the meshes are
+/// referenced and not copied, they must outlive the submission.
+/// @param depths optional view space distance per mesh (positive is in front of
+/// the camera), NULL treats every mesh as being at distance 0.
+RENDERER_API
+void
+render_queue_push(
+  render_queue_t* queue,
+  const mesh_render_data_t* mesh,
+  const uint32_t* texture_data,
+  const float* depths,
+  uint32_t mesh_count);
+
+/// @brief stable radix sort of the items by key.
+RENDERER_API
+void
+render_queue_sort(render_queue_t* queue);
+
+/// @brief draws the items in queue order with @a pipeline top matrix, material,
+/// blending and texture state is only changed between items that differ.
+RENDERER_API
+void
+render_queue_submit(const render_queue_t* queue, pipeline_t* pipeline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file renderer_core.h
+ * @author khalilhenoud@gmail.com
+ * @brief opengl 3.3 core profile backend behind the renderer_opengl.h api.
+ * meshes are lit per fragment with the light model of the fixed function
+ * pipeline, the lights and the per draw material live in uniform buffers and
+ * the client arrays are streamed through buffer objects. draw_meshes_instanced
+ * is a single instanced draw, the lights of set_clustered_lights are read per
+ * fragment from texture buffers.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef RENDERER_CORE_H
+#define RENDERER_CORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/internal/module.h>
+
+
+/// @brief the light indices enable_light/set_light_properties accept.
+#define RENDERER_CORE_LIGHT_COUNT     64
+
+/// @brief selects the core backend, call instead of renderer_initialize with
+/// a 3.3 core context current (see opengl_initialize_core). returns 0 and
+/// selects nothing if the context is older or the shaders do not build.
+/// renderer_cleanup releases the backend.
+/// @note upload_to_gpu_async uploads right away, the luminance and alpha
+/// formats are expanded to RGBA.
+RENDERER_API
+int32_t
+renderer_initialize_core();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -34,6 +34,8 @@ struct color_t {
   float data[4];
 } color_t;
 
+/// @brief the BC formats are block compressed, the buffer holds the blocks of
+/// the whole mip chain (see texture_compression.h).
 typedef
 enum renderer_image_format_t {
   RENDERER_OPENGL_RGBA,
@@ -43,20 +45,36 @@ enum renderer_image_format_t {
   RENDERER_OPENGL_LA,           /// Luminance/Alpha.
   RENDERER_OPENGL_L,
   RENDERER_OPENGL_A,
+  RENDERER_OPENGL_BC1,          /// RGB and 1 bit alpha, 8 bytes per block.
+  RENDERER_OPENGL_BC3,          /// RGBA, 16 bytes per block.
+  RENDERER_OPENGL_BC4,          /// Red, 8 bytes per block.
+  RENDERER_OPENGL_BC5,          /// Red/Green, 16 bytes per block.
   RENDERER_OPENGL_IMAGE_FORMAT_COUNT
 } renderer_image_format_t;
 
+/// @brief interleaved vertex layout, position/normal/uv share a single 32
+/// bytes stride and the uv is packed into the 2 meaningful components.
+typedef
+struct renderer_vertex_t {
+  float position[3];
+  float normal[3];
+  float uv[2];
+} renderer_vertex_t;
+
+/// @note interleaved comes last so the initializers written before it existed
+/// keep their meaning, it has to be NULL unless used (zero initialize).
 typedef
 struct mesh_render_data_t {
   float* vertices;    // 3 floats per vertex.
   float* normals;     // 3 floats per vertex.
   float* uv_coords;   // 3 floats per vertex.
-  uint32_t vertex_count;    // applies to the previous 3 arrays.
+  uint32_t vertex_count;    // applies to the previous arrays.
   uint32_t* indices;
   uint32_t indices_count;
   color_t ambient;
   color_t diffuse;
   color_t specular;
+  renderer_vertex_t* interleaved;   // replaces the 3 arrays above if not NULL.
 } mesh_render_data_t;
 
 typedef
@@ -83,6 +101,30 @@ struct renderer_light_t {
   renderer_light_type_t type;
 } renderer_light_t;
 
+/// @brief number of state changes (enable/disable, client arrays, blending,
+/// line/point sizes, texture and buffer bindings, matrices, viewport, light
+/// parameters) that reached opengl and that were dropped because the state was
+/// already set. the last three break down the skipped count, reset them every
+/// frame to get per frame numbers.
+typedef
+struct renderer_state_counters_t {
+  uint64_t issued;
+  uint64_t skipped;
+  uint64_t viewport_skipped;      // update_viewport calls.
+  uint64_t projection_skipped;    // update_projection calls.
+  uint64_t light_skipped;         // individual glLightfv parameters.
+} renderer_state_counters_t;
+
+/// @brief how flush_operations keeps the cpu from running ahead of the gpu.
+typedef
+enum renderer_frame_pacing_t {
+  RENDERER_FRAME_PACING_FENCES,   /// at most n frames queued on the gpu.
+  RENDERER_FRAME_PACING_FINISH,   /// glFinish, the gpu is drained every frame.
+  RENDERER_FRAME_PACING_COUNT
+} renderer_frame_pacing_t;
+
+#define RENDERER_MAX_FRAMES_IN_FLIGHT     4
+
 RENDERER_API
 void
 renderer_initialize();
@@ -103,10 +145,21 @@ RENDERER_API
 void
 clear_color_and_depth_buffers();
 
+/// @brief ends the frame, call it before swapping the buffers. paces the cpu
+/// against the gpu, see set_frame_pacing.
 RENDERER_API
 void
 flush_operations();
 
+/// @brief fences by default with 2 frames in flight, falls back to glFinish
+/// when the context has no sync objects (GL 3.2 or ARB_sync). with fences,
+/// flush_operations returns once no more than @a frames_in_flight (1 to
+/// RENDERER_MAX_FRAMES_IN_FLIGHT) frames are left for the gpu to complete.
+/// ignored by the software backend.
+RENDERER_API
+void
+set_frame_pacing(renderer_frame_pacing_t pacing, uint32_t frames_in_flight);
+
 RENDERER_API
 void
 update_viewport(const pipeline_t* pipeline);
@@ -123,6 +176,8 @@ RENDERER_API
 void
 enable_light(uint32_t index);
 
+/// @brief the position and direction are transformed by the modelview top of
+/// @a pipeline, they are taken in eye space if it is NULL.
 RENDERER_API
 void
 set_light_properties(
@@ -130,6 +185,29 @@ set_light_properties(
   renderer_light_t* light,
   pipeline_t* pipeline);
 
+/// @brief many lights at once, they replace the lights of enable_light until
+/// this is called with no lights (set those again then). positions and
+/// directions are taken under the modelview top, like set_light_properties,
+/// call it again whenever the view or projection moves. the lights are binned
+/// into the froxels of the @a pipeline frustum, what reads the bins depends on
+/// the backend:
+/// - core: clustered shading, each fragment is lit by the lights of its
+///   cluster.
+/// - software: each vertex is lit by the lights of its cluster.
+/// - fixed function: NOT clustered. each draw is lit by at most the 8 lights
+///   strongest at the origin of its modelview, a mesh spanning many clusters
+///   misses the lights away from its origin.
+/// @param light_count up to 65535, a light reaches as far as its attenuation
+/// keeps it above 1/256 (everywhere for directional lights).
+RENDERER_API
+void
+set_clustered_lights(
+  const renderer_light_t* lights,
+  uint32_t light_count,
+  const pipeline_t* pipeline);
+
+/// @brief a NULL @a pipeline (here and in the draw calls below) draws under
+/// the identity modelview, not under whatever matrix opengl has loaded.
 RENDERER_API
 void
 draw_grid(
@@ -137,6 +215,7 @@ draw_grid(
   float width,
   int32_t lines_per_axis);
 
+/// @brief @a pipeline can be NULL, see draw_grid.
 RENDERER_API
 void
 draw_points(
@@ -146,6 +225,7 @@ draw_points(
   float size,
   pipeline_t* pipeline);
 
+/// @brief @a pipeline can be NULL, see draw_grid.
 RENDERER_API
 void
 draw_lines(
@@ -155,6 +235,7 @@ draw_lines(
   float width,
   pipeline_t* pipeline);
 
+/// @brief @a pipeline can be NULL, see draw_grid.
 RENDERER_API
 void
 draw_unit_quads(
@@ -164,6 +245,7 @@ draw_unit_quads(
   color_t tint,
   pipeline_t* pipeline);
 
+/// @brief @a pipeline can be NULL, see draw_grid.
 RENDERER_API
 void
 draw_meshes_wireframe(
@@ -173,6 +255,7 @@ draw_meshes_wireframe(
   float width,
   pipeline_t* pipeline);
 
+/// @brief @a pipeline can be NULL, see draw_grid.
 RENDERER_API
 void
 draw_meshes(
@@ -181,7 +264,67 @@ draw_meshes(
   uint32_t mesh_count,
   pipeline_t* pipeline);
 
-/// @brief bookkeeping is left to the user code.
+/// @brief draws @a mesh once per instance, as if pre_multiply(pipeline,
+/// instances + i) preceded each draw. @a tints is NULL or holds one color per
+/// instance, the material colors are multiplied by it. the arrays and the
+/// material are only set once, each instance costs a modelview load and a
+/// draw. a NULL @a pipeline applies the instances alone.
+RENDERER_API
+void
+draw_meshes_instanced(
+  const mesh_render_data_t* mesh,
+  uint32_t texture_id,
+  const matrix4f* instances,
+  const color_t* tints,
+  uint32_t instance_count,
+  pipeline_t* pipeline);
+
+/// @brief converts the separate vertices/normals/uv_coords arrays of @a mesh
+/// into the interleaved layout, @a vertices must hold vertex_count elements.
+/// point mesh->interleaved at the result to have it used for rendering.
+RENDERER_API
+void
+interleave_mesh_vertices(
+  const mesh_render_data_t* mesh,
+  renderer_vertex_t* vertices);
+
+/// @brief uploads the mesh geometry into gpu buffer objects so it does not
+/// cross the bus every frame, the materials are copied along. returns a handle
+/// to use with draw_mesh_handles, 0 if buffer objects are not supported (and
+/// with the software backend). bookkeeping is left to the user code.
+RENDERER_API
+uint32_t
+upload_mesh(const mesh_render_data_t* mesh);
+
+RENDERER_API
+uint32_t
+evict_mesh(uint32_t mesh_handle);
+
+/// @brief the equivalent of draw_meshes for meshes uploaded via upload_mesh,
+/// @a pipeline can be NULL as well.
+RENDERER_API
+void
+draw_mesh_handles(
+  const uint32_t* mesh_handles,
+  const uint32_t* texture_data,
+  uint32_t mesh_count,
+  pipeline_t* pipeline);
+
+/// @brief averages the color components of the mip levels in linear space
+/// (the images are assumed srgb) for the textures uploaded from now on, alpha
+/// stays a plain average. off by default.
+RENDERER_API
+void
+enable_gamma_correct_mipmaps();
+
+RENDERER_API
+void
+disable_gamma_correct_mipmaps();
+
+/// @brief bookkeeping is left to the user code (see texture_cache.h for shared
+/// textures). the mip chain is built on the cpu, spread over the renderer
+/// worker threads. the BC formats upload their blocks as they are, they are
+/// decompressed first if the context does not support them.
 RENDERER_API
 uint32_t
 upload_to_gpu(
@@ -191,10 +334,67 @@ upload_to_gpu(
   uint32_t height,
   renderer_image_format_t format);
 
+/// @brief returns the texture id right away, the pixels are copied and the
+/// mip chain is built on a worker thread then streamed by stream_textures().
+/// until is_texture_ready() the texture has no storage, opengl ignores it and
+/// draws using it come out untextured (black on the core backend), pass a
+/// fallback id to show something else meanwhile. the BC formats have their
+/// mip chain already, they go through upload_to_gpu. the software backend has
+/// no gpu to stream to, it falls back on upload_to_gpu and its textures are
+/// ready right away.
+RENDERER_API
+uint32_t
+upload_to_gpu_async(
+  const char* path,
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format);
+
+/// @brief non-zero once every level of the texture is uploaded, always true
+/// for the textures from upload_to_gpu.
+RENDERER_API
+int32_t
+is_texture_ready(uint32_t texture_id);
+
+/// @brief call once a frame, uploads the levels prepared by the worker until
+/// @a byte_budget is spent (at least one level if any is ready).
+RENDERER_API
+void
+stream_textures(uint32_t byte_budget);
+
+/// @brief also cancels the pending streaming of the texture.
 RENDERER_API
 uint32_t
 evict_from_gpu(uint32_t texture_id);
 
+RENDERER_API
+void
+get_state_counters(renderer_state_counters_t* counters);
+
+RENDERER_API
+void
+reset_state_counters();
+
+/// @brief the renderer keeps a shadow copy of the opengl state it touches and
+/// entry points leave their state set on exit, call this after changing the
+/// opengl state outside of the renderer.
+RENDERER_API
+void
+invalidate_state_cache();
+
+/// @brief reads back a block of the color buffer as tightly packed RGBA8,
+/// rows are bottom to top (opengl convention). @a buffer must hold at least
+/// width * height * 4 bytes.
+RENDERER_API
+void
+read_pixels(
+  int32_t x,
+  int32_t y,
+  uint32_t width,
+  uint32_t height,
+  uint8_t* buffer);
+
 #ifdef __cplusplus
 }
 #endif
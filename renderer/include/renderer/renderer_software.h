@@ -0,0 +1,50 @@
+/**
+ * @file renderer_software.h
+ * @author khalilhenoud@gmail.com
+ * @brief cpu rasterizer behind the renderer_opengl.h api, for machines without
+ * a gpu. draws are transformed, lit (per vertex, same model as the fixed
+ * function pipeline) and clipped as they are issued, the frame is then binned
+ * into screen tiles and rasterized in parallel by flush_operations.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef RENDERER_SOFTWARE_H
+#define RENDERER_SOFTWARE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/internal/module.h>
+
+
+/// @brief caller owned render target, rows are bottom to top (opengl
+/// convention) so read_pixels and direct access agree.
+typedef
+struct renderer_software_target_t {
+  uint8_t* color;         // RGBA8, width * height * 4 bytes.
+  float* depth;           // width * height, cleared to 1.
+  uint32_t width;
+  uint32_t height;
+} renderer_software_target_t;
+
+/// @brief selects the software backend, call instead of renderer_initialize
+/// (no opengl context is needed). the target must outlive the renderer,
+/// renderer_cleanup releases the backend. @a thread_count threads rasterize
+/// the tiles, 0 uses the hardware concurrency.
+/// @note mesh handles are not supported, upload_mesh returns 0.
+RENDERER_API
+void
+renderer_initialize_software(
+  const renderer_software_target_t* target,
+  uint32_t thread_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file renderer_stats.h
+ * @author khalilhenoud@gmail.com
+ * @brief per frame counters and timings, a frame ends with flush_operations.
+ * the last RENDERER_STATS_FRAMES frames are kept for percentiles. the entry
+ * point timers cover every backend, the counters and the gpu time the opengl
+ * and core ones (the software backend counts nothing).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef RENDERER_STATS_H
+#define RENDERER_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/internal/module.h>
+
+
+#define RENDERER_STATS_FRAMES     128
+
+/// @brief the public entry points are timed in groups, the timings are
+/// inclusive (the evictions done by flush_operations count in both).
+typedef
+enum renderer_timer_t {
+  RENDERER_TIMER_CLEAR,           // clear_color_and_depth_buffers.
+  RENDERER_TIMER_FLUSH,           // flush_operations, waits for the gpu.
+  RENDERER_TIMER_VIEW,            // update_viewport/update_projection.
+  RENDERER_TIMER_STATE,           // depth test and lights.
+  RENDERER_TIMER_LIGHT_CLUSTERS,  // set_clustered_lights.
+  RENDERER_TIMER_GRID,
+  RENDERER_TIMER_POINTS,
+  RENDERER_TIMER_LINES,
+  RENDERER_TIMER_UNIT_QUADS,
+  RENDERER_TIMER_WIREFRAME,
+  RENDERER_TIMER_MESHES,          // draw_meshes.
+  RENDERER_TIMER_INSTANCES,       // draw_meshes_instanced.
+  RENDERER_TIMER_RENDER_QUEUE,    // render_queue_submit.
+  RENDERER_TIMER_MESH_HANDLES,    // draw_mesh_handles.
+  RENDERER_TIMER_MESH_UPLOADS,    // upload_mesh/evict_mesh.
+  RENDERER_TIMER_TEXTURE_UPLOADS, // upload_to_gpu(_async)/evict_from_gpu.
+  RENDERER_TIMER_STREAMING,       // stream_textures.
+  RENDERER_TIMER_READ_PIXELS,
+  RENDERER_TIMER_COUNT
+} renderer_timer_t;
+
+typedef
+enum renderer_stat_t {
+  RENDERER_STAT_DRAW_CALLS,
+  RENDERER_STAT_TRIANGLES,
+  RENDERER_STAT_VERTICES,
+  RENDERER_STAT_STATE_CHANGES,
+  RENDERER_STAT_TEXTURE_BINDS,
+  RENDERER_STAT_UPLOADED_BYTES,
+  RENDERER_STAT_CPU_TIME,
+  RENDERER_STAT_GPU_TIME,
+  RENDERER_STAT_COUNT
+} renderer_stat_t;
+
+typedef
+struct renderer_frame_stats_t {
+  uint64_t frame;                 // counted from enable_renderer_stats.
+  uint64_t draw_calls;
+  uint64_t triangles;
+  uint64_t vertices;              // the index count for indexed draws.
+  uint64_t state_changes;         // opengl state calls not skipped.
+  uint64_t texture_binds;
+  uint64_t uploaded_bytes;        // texture levels and buffer objects.
+  uint64_t cpu_ns;                // since the previous flush_operations.
+  uint64_t gpu_ns;                // 0 until the timer query is resolved.
+  uint64_t timer_ns[RENDERER_TIMER_COUNT];
+  uint32_t timer_calls[RENDERER_TIMER_COUNT];
+} renderer_frame_stats_t;
+
+/// @brief starts recording from the next frame on. the gpu times need timer
+/// queries (GL_TIME_ELAPSED), they come back a few frames late.
+/// renderer_cleanup disables the stats.
+RENDERER_API
+void
+enable_renderer_stats();
+
+RENDERER_API
+void
+disable_renderer_stats();
+
+/// @brief drops the recorded frames.
+RENDERER_API
+void
+reset_renderer_stats();
+
+/// @brief copies up to @a count of the last frames, the most recent first.
+/// @return the number of frames copied.
+RENDERER_API
+uint32_t
+get_frame_stats(renderer_frame_stats_t* frames, uint32_t count);
+
+/// @brief nearest rank @a percentile (0 to 100) of @a stat over the recorded
+/// frames. the frames without a gpu time are left out of
+/// RENDERER_STAT_GPU_TIME.
+RENDERER_API
+uint64_t
+get_stats_percentile(renderer_stat_t stat, float percentile);
+
+/// @brief same as get_stats_percentile for the nanoseconds of a timer.
+RENDERER_API
+uint64_t
+get_timer_percentile(renderer_timer_t timer, float percentile);
+
+RENDERER_API
+const char*
+get_timer_name(renderer_timer_t timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file texture_cache.h
+ * @author khalilhenoud@gmail.com
+ * @brief shared textures keyed by path (or by content when there is no path).
+ * acquiring a texture that is already resident only bumps its reference count,
+ * released textures stay resident until the byte budget is exceeded, then the
+ * least recently drawn ones are evicted. deletions only happen at collection
+ * time (flush_operations or texture_cache_collect), never in the middle of a
+ * frame.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <renderer/internal/module.h>
+#include <renderer/renderer_opengl.h>
+
+
+typedef
+struct texture_cache_stats_t {
+  uint32_t textures;        // resident, referenced or not.
+  uint32_t referenced;
+  uint64_t resident_bytes;  // estimated, mip levels included.
+  uint64_t budget;
+  uint64_t hits;            // acquisitions served without an upload.
+  uint64_t misses;
+  uint64_t evictions;
+} texture_cache_stats_t;
+
+/// @brief returns the texture for @a path with one more reference, uploads
+/// @a buffer only if it is not resident yet (asynchronously if @a async, see
+/// upload_to_gpu_async). @a path can be NULL, the pixels are hashed instead.
+/// @a buffer can be NULL to only look up a resident texture.
+/// @return the texture id, 0 if @a buffer is NULL and the path is unknown.
+RENDERER_API
+uint32_t
+texture_cache_acquire(
+  const char* path,
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format,
+  int32_t async);
+
+/// @brief drops a reference, the texture stays resident (and can be acquired
+/// again for free) until it gets evicted.
+RENDERER_API
+void
+texture_cache_release(uint32_t texture_id);
+
+/// @brief marks the texture as drawn this frame, the renderer does it for the
+/// textures it draws with. ids not owned by the cache are ignored.
+RENDERER_API
+void
+texture_cache_touch(uint32_t texture_id);
+
+/// @brief the budget the released textures are evicted down to, unlimited by
+/// default. referenced textures are never evicted, they can exceed it.
+RENDERER_API
+void
+texture_cache_set_budget(uint64_t bytes);
+
+/// @brief evicts released textures, least recently drawn first, until the
+/// resident bytes fit the budget, then deletes the evicted textures. called by
+/// flush_operations, call it at the end of the frame otherwise.
+RENDERER_API
+void
+texture_cache_collect();
+
+RENDERER_API
+void
+texture_cache_get_stats(texture_cache_stats_t* stats);
+
+/// @brief deletes every texture of the cache, referenced or not. called by
+/// renderer_cleanup.
+RENDERER_API
+void
+texture_cache_cleanup();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
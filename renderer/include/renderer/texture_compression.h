@@ -0,0 +1,85 @@
+/**
+ * @file texture_compression.h
+ * @author khalilhenoud@gmail.com
+ * @brief cpu encoder/decoder for the block compressed formats (BC1/BC3/BC4/
+ * BC5, aka S3TC/RGTC). an encoded texture is its whole mip chain, level 0
+ * first, each level a row major run of 4x4 blocks (partial blocks are padded
+ * by repeating the last row/column). that is what upload_to_gpu expects for
+ * these formats.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef TEXTURE_COMPRESSION_H
+#define TEXTURE_COMPRESSION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <renderer/internal/module.h>
+#include <renderer/renderer_opengl.h>
+
+
+RENDERER_API
+int32_t
+texture_compression_is_compressed(renderer_image_format_t format);
+
+/// @brief bytes taken by the encoded chain of a @a width x @a height image.
+RENDERER_API
+size_t
+texture_compression_size(
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format);
+
+/// @brief builds the mip chain of @a pixels (any uncompressed format) and
+/// encodes it as @a target into @a blocks, texture_compression_size() bytes.
+/// BC4 keeps the red component and BC5 red and green, luminance counts as red.
+/// the work is spread over the renderer worker threads, a tool without a
+/// context can get them through renderer_initialize_software.
+RENDERER_API
+void
+texture_compress(
+  const uint8_t* pixels,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format,
+  renderer_image_format_t target,
+  uint8_t* blocks);
+
+/// @brief texture_compress, except the result is looked up first in
+/// @a directory (which must exist) under a hash of the pixels and formats, and
+/// stored there when it was not.
+/// @return non-zero if the blocks were read from the cache.
+RENDERER_API
+int32_t
+texture_compress_cached(
+  const char* directory,
+  const uint8_t* pixels,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format,
+  renderer_image_format_t target,
+  uint8_t* blocks);
+
+/// @brief decodes level 0 of @a blocks to RGBA8, sampled the way opengl does
+/// (BC4 is (r, 0, 0, 1), BC5 is (r, g, 0, 1)).
+RENDERER_API
+void
+texture_decompress(
+  const uint8_t* blocks,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format,
+  uint8_t* pixels);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,326 @@
+/**
+ * @file command_list.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/command_list.h>
+
+
+#define COMMAND_ALIGNMENT         16
+
+typedef
+enum command_type_t {
+  COMMAND_DRAW_MESHES,
+  COMMAND_DRAW_LINES,
+  COMMAND_DRAW_POINTS,
+  COMMAND_DRAW_UNIT_QUADS,
+  COMMAND_SET_LIGHT_PROPERTIES,
+  COMMAND_ENABLE_LIGHT,
+  COMMAND_DISABLE_LIGHT
+} command_type_t;
+
+/// @brief fixed header, the payload (arrays) follows it.
+typedef
+struct command_t {
+  uint32_t type;
+  uint32_t size;            // header and payload, multiple of the alignment.
+  uint32_t count;
+  uint32_t index;           // light index or texture id.
+  int32_t has_matrix;       // 0 if recorded with a NULL pipeline.
+  float value;              // line width or point size.
+  color_t color;
+  matrix4f matrix;
+} command_t;
+
+// loaded with the recorded matrix before each command.
+static pipeline_t replay_pipeline;
+
+static
+uint32_t
+align_size(uint32_t size)
+{
+  return (size + COMMAND_ALIGNMENT - 1) & ~(uint32_t)(COMMAND_ALIGNMENT - 1);
+}
+
+static
+void*
+get_payload(command_t* command)
+{
+  return (uint8_t*)command + align_size(sizeof(command_t));
+}
+
+/// @brief appends a command with room for @a payload_size bytes of payload.
+static
+command_t*
+push_command(
+  command_list_t* list,
+  command_type_t type,
+  uint32_t payload_size,
+  const pipeline_t* pipeline)
+{
+  command_t* command = NULL;
+  uint32_t size = align_size(sizeof(command_t)) + align_size(payload_size);
+
+  if (list->size + size > list->capacity) {
+    uint32_t capacity = list->capacity ? list->capacity : 4096;
+    uint8_t* data = NULL;
+    while (capacity < list->size + size)
+      capacity *= 2;
+
+    data = realloc(list->data, capacity);
+    assert(data);
+    list->data = data;
+    list->capacity = capacity;
+  }
+
+  command = (command_t*)(list->data + list->size);
+  memset(command, 0, sizeof(command_t));
+  command->type = type;
+  command->size = size;
+
+  // the modelview top, regardless of the current mode of the pipeline.
+  if (pipeline) {
+    command->has_matrix = 1;
+    command->matrix = pipeline->modelview_stack[pipeline->modelview_index];
+  }
+
+  list->size += size;
+  ++list->count;
+  return command;
+}
+
+void
+command_list_initialize(command_list_t* list, uint32_t capacity)
+{
+  memset(list, 0, sizeof(command_list_t));
+  if (capacity) {
+    list->data = malloc(capacity);
+    assert(list->data);
+    list->capacity = capacity;
+  }
+}
+
+void
+command_list_cleanup(command_list_t* list)
+{
+  free(list->data);
+  memset(list, 0, sizeof(command_list_t));
+}
+
+void
+command_list_clear(command_list_t* list)
+{
+  list->size = 0;
+  list->count = 0;
+}
+
+void
+command_list_draw_meshes(
+  command_list_t* list,
+  const mesh_render_data_t* mesh,
+  const uint32_t* texture_data,
+  uint32_t mesh_count,
+  const pipeline_t* pipeline)
+{
+  uint32_t meshes_size = align_size(sizeof(mesh_render_data_t) * mesh_count);
+  command_t* command = push_command(
+    list,
+    COMMAND_DRAW_MESHES,
+    meshes_size + sizeof(uint32_t) * mesh_count,
+    pipeline);
+  uint8_t* payload = get_payload(command);
+
+  command->count = mesh_count;
+  memcpy(payload, mesh, sizeof(mesh_render_data_t) * mesh_count);
+  memcpy(payload + meshes_size, texture_data, sizeof(uint32_t) * mesh_count);
+}
+
+static
+void
+push_vertices(
+  command_list_t* list,
+  command_type_t type,
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float value,
+  const pipeline_t* pipeline)
+{
+  command_t* command = push_command(
+    list, type, sizeof(float) * 3 * vertices_count, pipeline);
+  command->count = vertices_count;
+  command->color = color;
+  command->value = value;
+  memcpy(get_payload(command), vertices, sizeof(float) * 3 * vertices_count);
+}
+
+void
+command_list_draw_lines(
+  command_list_t* list,
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float width,
+  const pipeline_t* pipeline)
+{
+  push_vertices(
+    list,
+    COMMAND_DRAW_LINES,
+    vertices,
+    vertices_count,
+    color,
+    width,
+    pipeline);
+}
+
+void
+command_list_draw_points(
+  command_list_t* list,
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float size,
+  const pipeline_t* pipeline)
+{
+  push_vertices(
+    list,
+    COMMAND_DRAW_POINTS,
+    vertices,
+    vertices_count,
+    color,
+    size,
+    pipeline);
+}
+
+void
+command_list_draw_unit_quads(
+  command_list_t* list,
+  const unit_quad_t* uvs,
+  uint32_t uvs_count,
+  int32_t texture_id,
+  color_t tint,
+  const pipeline_t* pipeline)
+{
+  command_t* command = push_command(
+    list, COMMAND_DRAW_UNIT_QUADS, sizeof(unit_quad_t) * uvs_count, pipeline);
+  command->count = uvs_count;
+  command->index = (uint32_t)texture_id;
+  command->color = tint;
+  memcpy(get_payload(command), uvs, sizeof(unit_quad_t) * uvs_count);
+}
+
+void
+command_list_set_light_properties(
+  command_list_t* list,
+  uint32_t index,
+  const renderer_light_t* light,
+  const pipeline_t* pipeline)
+{
+  command_t* command = push_command(
+    list, COMMAND_SET_LIGHT_PROPERTIES, sizeof(renderer_light_t), pipeline);
+  command->index = index;
+  memcpy(get_payload(command), light, sizeof(renderer_light_t));
+}
+
+void
+command_list_enable_light(command_list_t* list, uint32_t index)
+{
+  push_command(list, COMMAND_ENABLE_LIGHT, 0, NULL)->index = index;
+}
+
+void
+command_list_disable_light(command_list_t* list, uint32_t index)
+{
+  push_command(list, COMMAND_DISABLE_LIGHT, 0, NULL)->index = index;
+}
+
+static
+void
+replay_command(command_t* command)
+{
+  pipeline_t* pipeline = NULL;
+  uint8_t* payload = get_payload(command);
+
+  // consecutive commands recorded under the same matrix keep the slot version
+  // unchanged, the renderer does not upload it again.
+  if (command->has_matrix) {
+    pipeline = &replay_pipeline;
+    set_matrix_mode(pipeline, MODELVIEW);
+    if (memcmp(
+      pipeline->modelview_stack + pipeline->modelview_index,
+      &command->matrix,
+      sizeof(matrix4f)))
+      replace(pipeline, &command->matrix);
+  }
+
+  switch (command->type) {
+  case COMMAND_DRAW_MESHES:
+    draw_meshes(
+      (const mesh_render_data_t*)payload,
+      (const uint32_t*)(payload +
+        align_size(sizeof(mesh_render_data_t) * command->count)),
+      command->count,
+      pipeline);
+    break;
+  case COMMAND_DRAW_LINES:
+    draw_lines(
+      (const float*)payload,
+      command->count,
+      command->color,
+      command->value,
+      pipeline);
+    break;
+  case COMMAND_DRAW_POINTS:
+    draw_points(
+      (const float*)payload,
+      command->count,
+      command->color,
+      command->value,
+      pipeline);
+    break;
+  case COMMAND_DRAW_UNIT_QUADS:
+    draw_unit_quads(
+      (const unit_quad_t*)payload,
+      command->count,
+      (int32_t)command->index,
+      command->color,
+      pipeline);
+    break;
+  case COMMAND_SET_LIGHT_PROPERTIES:
+    set_light_properties(
+      command->index, (renderer_light_t*)payload, pipeline);
+    break;
+  case COMMAND_ENABLE_LIGHT:
+    enable_light(command->index);
+    break;
+  case COMMAND_DISABLE_LIGHT:
+    disable_light(command->index);
+    break;
+  default:
+    assert(0);
+    break;
+  }
+}
+
+void
+command_list_replay(const command_list_t* lists, uint32_t list_count)
+{
+  pipeline_set_default(&replay_pipeline);
+
+  for (uint32_t i = 0; i < list_count; ++i) {
+    uint32_t offset = 0;
+    while (offset < lists[i].size) {
+      command_t* command = (command_t*)(lists[i].data + offset);
+      replay_command(command);
+      offset += command->size;
+    }
+  }
+}
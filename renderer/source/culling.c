@@ -0,0 +1,288 @@
+/**
+ * @file culling.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <renderer/culling.h>
+
+#if defined(__AVX__)
+#define CULLING_AVX
+#include <immintrin.h>
+#elif \
+  defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+
+#define PLANE_COUNT               6
+
+/// @brief a, b, c, d with the inside positive, and the absolute values of the
+/// normal used to project the box extent.
+typedef
+struct culling_plane_t {
+  float data[4];
+  float abs_normal[3];
+} culling_plane_t;
+
+/// @brief view space planes of the pipeline frustum (the same volume glFrustum
+/// and glOrtho clip against), moved into object space by the modelview. for a
+/// plane p and a modelview m, the object space plane is transpose(m) * p.
+static
+void
+get_object_planes(const pipeline_t* pipeline, culling_plane_t* planes)
+{
+  const float* m =
+    pipeline->modelview_stack[pipeline->modelview_index].data;
+  float l, r, b, t, n, f;
+  float view[PLANE_COUNT][4];
+
+  get_frustum(pipeline, &l, &r, &b, &t, &n, &f);
+  if (get_projection_type(pipeline) == PERSPECTIVE) {
+    float left[4] = { n, 0.f, l, 0.f };
+    float right[4] = { -n, 0.f, -r, 0.f };
+    float bottom[4] = { 0.f, n, b, 0.f };
+    float top[4] = { 0.f, -n, -t, 0.f };
+    memcpy(view[0], left, sizeof(left));
+    memcpy(view[1], right, sizeof(right));
+    memcpy(view[2], bottom, sizeof(bottom));
+    memcpy(view[3], top, sizeof(top));
+  } else {
+    float left[4] = { 1.f, 0.f, 0.f, -l };
+    float right[4] = { -1.f, 0.f, 0.f, r };
+    float bottom[4] = { 0.f, 1.f, 0.f, -b };
+    float top[4] = { 0.f, -1.f, 0.f, t };
+    memcpy(view[0], left, sizeof(left));
+    memcpy(view[1], right, sizeof(right));
+    memcpy(view[2], bottom, sizeof(bottom));
+    memcpy(view[3], top, sizeof(top));
+  }
+
+  // the camera looks down -z.
+  {
+    float near_plane[4] = { 0.f, 0.f, -1.f, -n };
+    float far_plane[4] = { 0.f, 0.f, 1.f, f };
+    memcpy(view[4], near_plane, sizeof(near_plane));
+    memcpy(view[5], far_plane, sizeof(far_plane));
+  }
+
+  for (uint32_t i = 0; i < PLANE_COUNT; ++i) {
+    for (uint32_t column = 0; column < 4; ++column)
+      planes[i].data[column] =
+        m[0 * 4 + column] * view[i][0] +
+        m[1 * 4 + column] * view[i][1] +
+        m[2 * 4 + column] * view[i][2] +
+        m[3 * 4 + column] * view[i][3];
+
+    for (uint32_t j = 0; j < 3; ++j)
+      planes[i].abs_normal[j] = fabsf(planes[i].data[j]);
+  }
+}
+
+void
+compute_mesh_bounds(
+  const mesh_render_data_t* mesh,
+  uint32_t mesh_count,
+  renderer_bounds_t* bounds)
+{
+  for (uint32_t i = 0; i < mesh_count; ++i) {
+    const float* position = mesh[i].interleaved ?
+      mesh[i].interleaved->position : mesh[i].vertices;
+    uint32_t stride = mesh[i].interleaved ?
+      sizeof(renderer_vertex_t) / sizeof(float) : 3;
+
+    for (uint32_t j = 0; j < 3; ++j) {
+      bounds[i].min[j] = FLT_MAX;
+      bounds[i].max[j] = -FLT_MAX;
+    }
+
+    for (uint32_t v = 0; v < mesh[i].vertex_count; ++v, position += stride) {
+      for (uint32_t j = 0; j < 3; ++j) {
+        bounds[i].min[j] = fminf(bounds[i].min[j], position[j]);
+        bounds[i].max[j] = fmaxf(bounds[i].max[j], position[j]);
+      }
+    }
+
+    // empty meshes get a degenerate box at the origin.
+    if (!mesh[i].vertex_count) {
+      for (uint32_t j = 0; j < 3; ++j)
+        bounds[i].min[j] = bounds[i].max[j] = 0.f;
+    }
+  }
+}
+
+/// @brief a box is out if its center is further out of a plane than its
+/// extent projected on the plane normal.
+static
+int32_t
+is_box_visible(const renderer_bounds_t* box, const culling_plane_t* planes)
+{
+  float center[3], extent[3];
+  for (uint32_t j = 0; j < 3; ++j) {
+    center[j] = (box->max[j] + box->min[j]) * 0.5f;
+    extent[j] = (box->max[j] - box->min[j]) * 0.5f;
+  }
+
+  for (uint32_t i = 0; i < PLANE_COUNT; ++i) {
+    const culling_plane_t* plane = planes + i;
+    float distance =
+      plane->data[0] * center[0] +
+      plane->data[1] * center[1] +
+      plane->data[2] * center[2] +
+      plane->data[3] +
+      plane->abs_normal[0] * extent[0] +
+      plane->abs_normal[1] * extent[1] +
+      plane->abs_normal[2] * extent[2];
+    if (distance < 0.f)
+      return 0;
+  }
+
+  return 1;
+}
+
+#if defined(CULLING_AVX)
+
+#define CULLING_WIDTH             8
+
+/// @brief returns a bit per visible box for the 8 boxes at @a bounds.
+static
+uint32_t
+cull_block(const renderer_bounds_t* bounds, const culling_plane_t* planes)
+{
+  const renderer_bounds_t* b = bounds;
+  __m256 half = _mm256_set1_ps(0.5f);
+  __m256 center[3], extent[3];
+  __m256 out = _mm256_setzero_ps();
+
+  for (uint32_t j = 0; j < 3; ++j) {
+    __m256 min = _mm256_set_ps(
+      b[7].min[j], b[6].min[j], b[5].min[j], b[4].min[j],
+      b[3].min[j], b[2].min[j], b[1].min[j], b[0].min[j]);
+    __m256 max = _mm256_set_ps(
+      b[7].max[j], b[6].max[j], b[5].max[j], b[4].max[j],
+      b[3].max[j], b[2].max[j], b[1].max[j], b[0].max[j]);
+    center[j] = _mm256_mul_ps(_mm256_add_ps(max, min), half);
+    extent[j] = _mm256_mul_ps(_mm256_sub_ps(max, min), half);
+  }
+
+  for (uint32_t i = 0; i < PLANE_COUNT; ++i) {
+    const culling_plane_t* plane = planes + i;
+    __m256 distance = _mm256_set1_ps(plane->data[3]);
+    for (uint32_t j = 0; j < 3; ++j) {
+      distance = _mm256_add_ps(
+        distance,
+        _mm256_mul_ps(_mm256_set1_ps(plane->data[j]), center[j]));
+      distance = _mm256_add_ps(
+        distance,
+        _mm256_mul_ps(_mm256_set1_ps(plane->abs_normal[j]), extent[j]));
+    }
+    out = _mm256_or_ps(
+      out, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+  }
+
+  return ~(uint32_t)_mm256_movemask_ps(out) & 0xff;
+}
+
+#elif defined(CULLING_SSE)
+
+#define CULLING_WIDTH             4
+
+/// @brief returns a bit per visible box for the 4 boxes at @a bounds.
+static
+uint32_t
+cull_block(const renderer_bounds_t* bounds, const culling_plane_t* planes)
+{
+  const renderer_bounds_t* b = bounds;
+  __m128 half = _mm_set1_ps(0.5f);
+  __m128 center[3], extent[3];
+  __m128 out = _mm_setzero_ps();
+
+  for (uint32_t j = 0; j < 3; ++j) {
+    __m128 min = _mm_set_ps(
+      b[3].min[j], b[2].min[j], b[1].min[j], b[0].min[j]);
+    __m128 max = _mm_set_ps(
+      b[3].max[j], b[2].max[j], b[1].max[j], b[0].max[j]);
+    center[j] = _mm_mul_ps(_mm_add_ps(max, min), half);
+    extent[j] = _mm_mul_ps(_mm_sub_ps(max, min), half);
+  }
+
+  for (uint32_t i = 0; i < PLANE_COUNT; ++i) {
+    const culling_plane_t* plane = planes + i;
+    __m128 distance = _mm_set1_ps(plane->data[3]);
+    for (uint32_t j = 0; j < 3; ++j) {
+      distance = _mm_add_ps(
+        distance, _mm_mul_ps(_mm_set1_ps(plane->data[j]), center[j]));
+      distance = _mm_add_ps(
+        distance, _mm_mul_ps(_mm_set1_ps(plane->abs_normal[j]), extent[j]));
+    }
+    out = _mm_or_ps(out, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+  }
+
+  return ~(uint32_t)_mm_movemask_ps(out) & 0xf;
+}
+
+#endif
+
+uint32_t
+cull_bounds(
+  const renderer_bounds_t* bounds,
+  uint32_t count,
+  const pipeline_t* pipeline,
+  uint32_t* visible)
+{
+  culling_plane_t planes[PLANE_COUNT];
+  uint32_t visible_count = 0;
+  uint32_t i = 0;
+
+  get_object_planes(pipeline, planes);
+
+#if defined(CULLING_WIDTH)
+  for (; i + CULLING_WIDTH <= count; i += CULLING_WIDTH) {
+    uint32_t mask = cull_block(bounds + i, planes);
+    for (uint32_t j = 0; mask; ++j, mask >>= 1) {
+      if (mask & 1)
+        visible[visible_count++] = i + j;
+    }
+  }
+#endif
+
+  for (; i < count; ++i) {
+    if (is_box_visible(bounds + i, planes))
+      visible[visible_count++] = i;
+  }
+
+  return visible_count;
+}
+
+uint32_t
+cull_meshes(
+  const mesh_render_data_t* mesh,
+  const uint32_t* texture_data,
+  const renderer_bounds_t* bounds,
+  uint32_t mesh_count,
+  const pipeline_t* pipeline,
+  mesh_render_data_t* visible_mesh,
+  uint32_t* visible_texture_data)
+{
+  // the indices go in the texture output, index i is always >= i so the
+  // compaction never overwrites an index it still has to read.
+  uint32_t count = cull_bounds(
+    bounds, mesh_count, pipeline, visible_texture_data);
+
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t index = visible_texture_data[i];
+    visible_mesh[i] = mesh[index];
+    visible_texture_data[i] = texture_data[index];
+  }
+
+  return count;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file debug_draw.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/debug_draw.h>
+#include <renderer/internal/backend.h>
+#include <renderer/internal/frame_stats.h>
+#include <renderer/internal/renderer_internal.h>
+#include <renderer/internal/state_cache.h>
+
+
+typedef
+struct debug_batch_t {
+  GLenum mode;                // GL_LINES or GL_POINTS.
+  float width;                // line width or point size.
+  debug_vertex_t* vertices;
+  uint32_t vertices_count;
+  uint32_t vertices_capacity;
+  uint32_t* indices;          // GL_LINES only, segments index the vertices.
+  uint32_t indices_count;
+  uint32_t indices_capacity;
+} debug_batch_t;
+
+static debug_batch_t* batches = NULL;
+static uint32_t batches_count = 0;
+static uint32_t batches_capacity = 0;
+
+static
+void*
+grow_array(void* data, uint32_t* capacity, uint32_t required, size_t size)
+{
+  void* result = data;
+  uint32_t new_capacity = *capacity ? *capacity : 1024;
+
+  if (required <= *capacity)
+    return data;
+
+  while (new_capacity < required)
+    new_capacity *= 2;
+
+  result = realloc(data, size * new_capacity);
+  assert(result);
+  *capacity = new_capacity;
+  return result;
+}
+
+/// @brief one batch per primitive type and width class, there are only ever a
+/// handful of those in a frame.
+static
+debug_batch_t*
+get_batch(GLenum mode, float width)
+{
+  for (uint32_t i = 0; i < batches_count; ++i) {
+    if (batches[i].mode == mode && batches[i].width == width)
+      return batches + i;
+  }
+
+  batches = grow_array(
+    batches, &batches_capacity, batches_count + 1, sizeof(debug_batch_t));
+  memset(batches + batches_count, 0, sizeof(debug_batch_t));
+  batches[batches_count].mode = mode;
+  batches[batches_count].width = width;
+  return batches + batches_count++;
+}
+
+static
+uint8_t
+to_byte(float value)
+{
+  value = value < 0.f ? 0.f : (value > 1.f ? 1.f : value);
+  return (uint8_t)(value * 255.f + 0.5f);
+}
+
+/// @brief appends the vertices transformed by the modelview top of @a pipeline,
+/// returns the index of the first one.
+static
+uint32_t
+append_vertices(
+  debug_batch_t* batch,
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  pipeline_t* pipeline)
+{
+  uint32_t first = batch->vertices_count;
+  uint8_t rgba[4] = {
+    to_byte(color.data[0]), to_byte(color.data[1]),
+    to_byte(color.data[2]), to_byte(color.data[3]) };
+  debug_vertex_t* target = NULL;
+
+  batch->vertices = grow_array(
+    batch->vertices,
+    &batch->vertices_capacity,
+    first + vertices_count,
+    sizeof(debug_vertex_t));
+  target = batch->vertices + first;
+
+  if (pipeline) {
+    set_matrix_mode(pipeline, MODELVIEW);
+    transform_points(
+      pipeline,
+      vertices,
+      0,
+      vertices_count,
+      target->position,
+      sizeof(debug_vertex_t) / sizeof(float));
+  } else {
+    for (uint32_t i = 0; i < vertices_count; ++i)
+      memcpy(target[i].position, vertices + i * 3, sizeof(float) * 3);
+  }
+
+  for (uint32_t i = 0; i < vertices_count; ++i)
+    memcpy(target[i].color, rgba, sizeof(rgba));
+
+  batch->vertices_count += vertices_count;
+  return first;
+}
+
+void
+debug_draw_lines(
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float width,
+  pipeline_t* pipeline)
+{
+  debug_batch_t* batch = NULL;
+  uint32_t first = 0;
+  uint32_t* indices = NULL;
+
+  if (vertices_count < 2)
+    return;
+
+  batch = get_batch(GL_LINES, width);
+  first = append_vertices(batch, vertices, vertices_count, color, pipeline);
+
+  // strips from different calls cannot be joined, the segments index the
+  // shared vertices instead of duplicating them.
+  batch->indices = grow_array(
+    batch->indices,
+    &batch->indices_capacity,
+    batch->indices_count + (vertices_count - 1) * 2,
+    sizeof(uint32_t));
+  indices = batch->indices + batch->indices_count;
+  for (uint32_t i = 0; i < vertices_count - 1; ++i) {
+    *indices++ = first + i;
+    *indices++ = first + i + 1;
+  }
+  batch->indices_count += (vertices_count - 1) * 2;
+}
+
+void
+debug_draw_points(
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float size,
+  pipeline_t* pipeline)
+{
+  if (!vertices_count)
+    return;
+
+  append_vertices(
+    get_batch(GL_POINTS, size), vertices, vertices_count, color, pipeline);
+}
+
+/// @brief one call per batch, the backends draw each in a single pass.
+static
+void
+flush_to_backend(void)
+{
+  for (uint32_t i = 0; i < batches_count; ++i) {
+    debug_batch_t* batch = batches + i;
+    if (batch->vertices_count) {
+      renderer_backend->draw_debug_batch(
+        batch->mode,
+        batch->vertices,
+        batch->vertices_count,
+        batch->indices,
+        batch->indices_count,
+        batch->width);
+    }
+
+    batch->vertices_count = 0;
+    batch->indices_count = 0;
+  }
+}
+
+void
+debug_draw_flush()
+{
+  GLsizei stride = (GLsizei)sizeof(debug_vertex_t);
+
+  if (renderer_backend) {
+    flush_to_backend();
+    return;
+  }
+
+  renderer_internal_set_unlit_state();
+  renderer_internal_unbind_buffers();
+  state_set_client(GL_COLOR_ARRAY, 1);
+
+  // the vertices are already in view space.
+  state_load_modelview(NULL);
+
+  for (uint32_t i = 0; i < batches_count; ++i) {
+    debug_batch_t* batch = batches + i;
+    if (!batch->vertices_count)
+      continue;
+
+    glVertexPointer(3, GL_FLOAT, stride, batch->vertices->position);
+    glColorPointer(4, GL_UNSIGNED_BYTE, stride, batch->vertices->color);
+
+    if (batch->mode == GL_LINES) {
+      state_line_width(batch->width);
+      glDrawElements(
+        GL_LINES,
+        (GLsizei)batch->indices_count,
+        GL_UNSIGNED_INT,
+        batch->indices);
+      stats_count_draw(batch->indices_count, 0);
+    } else {
+      state_point_size(batch->width);
+      glDrawArrays(GL_POINTS, 0, (GLsizei)batch->vertices_count);
+      stats_count_draw(batch->vertices_count, 0);
+    }
+
+    batch->vertices_count = 0;
+    batch->indices_count = 0;
+  }
+
+  state_set_client(GL_COLOR_ARRAY, 0);
+}
+
+void
+debug_draw_cleanup()
+{
+  for (uint32_t i = 0; i < batches_count; ++i) {
+    free(batches[i].vertices);
+    free(batches[i].indices);
+  }
+
+  free(batches);
+  batches = NULL;
+  batches_count = batches_capacity = 0;
+}
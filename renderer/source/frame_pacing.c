@@ -0,0 +1,103 @@
+/**
+ * @file frame_pacing.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <string.h>
+#include <renderer/internal/frame_pacing.h>
+#include <renderer/internal/opengl_extensions.h>
+
+
+// the wait is retried, a slow frame is not a reason to stop pacing.
+#define WAIT_TIMEOUT_NS           100000000ull
+#define FENCES_CAPACITY           (RENDERER_MAX_FRAMES_IN_FLIGHT + 1)
+
+typedef
+struct frame_pacing_state_t {
+  renderer_frame_pacing_t pacing;
+  uint32_t frames_in_flight;
+  renderer_glsync_t fences[FENCES_CAPACITY];
+  uint32_t first;           // the oldest pending fence.
+  uint32_t count;
+} frame_pacing_state_t;
+
+static frame_pacing_state_t pacing_state = {
+  .pacing = RENDERER_FRAME_PACING_FENCES,
+  .frames_in_flight = 2 };
+
+void
+frame_pacing_set(renderer_frame_pacing_t pacing, uint32_t frames_in_flight)
+{
+  assert(pacing < RENDERER_FRAME_PACING_COUNT);
+  frames_in_flight = frames_in_flight ? frames_in_flight : 1;
+  frames_in_flight =
+    frames_in_flight > RENDERER_MAX_FRAMES_IN_FLIGHT ?
+    RENDERER_MAX_FRAMES_IN_FLIGHT : frames_in_flight;
+
+  pacing_state.pacing = pacing;
+  pacing_state.frames_in_flight = frames_in_flight;
+}
+
+static
+void
+wait_oldest(void)
+{
+  renderer_glsync_t fence = pacing_state.fences[pacing_state.first];
+  GLenum result;
+
+  // a failed wait leaves nothing to wait on, the fence is dropped either way.
+  do {
+    result = glClientWaitSync(
+      fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT_NS);
+  } while (result == GL_TIMEOUT_EXPIRED);
+
+  glDeleteSync(fence);
+  pacing_state.fences[pacing_state.first] = NULL;
+  pacing_state.first = (pacing_state.first + 1) % FENCES_CAPACITY;
+  --pacing_state.count;
+}
+
+void
+frame_pacing_end_frame(void)
+{
+  renderer_glsync_t fence = NULL;
+
+  if (
+    pacing_state.pacing == RENDERER_FRAME_PACING_FENCES &&
+    opengl_features.sync_objects)
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  if (!fence) {
+    glFinish();
+    // switched from fences, whatever is left is signaled by now.
+    frame_pacing_cleanup();
+    return;
+  }
+
+  pacing_state.fences[
+    (pacing_state.first + pacing_state.count) % FENCES_CAPACITY] = fence;
+  ++pacing_state.count;
+
+  // the gpu starts on the frame while the cpu builds the next one.
+  glFlush();
+  while (pacing_state.count > pacing_state.frames_in_flight)
+    wait_oldest();
+}
+
+void
+frame_pacing_cleanup(void)
+{
+  for (uint32_t i = 0; i < FENCES_CAPACITY; ++i) {
+    if (pacing_state.fences[i])
+      glDeleteSync(pacing_state.fences[i]);
+  }
+
+  memset(pacing_state.fences, 0, sizeof(pacing_state.fences));
+  pacing_state.first = pacing_state.count = 0;
+}
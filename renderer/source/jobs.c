@@ -0,0 +1,153 @@
+/**
+ * @file jobs.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/internal/jobs.h>
+#include <renderer/internal/threads.h>
+
+
+typedef
+struct jobs_pool_t {
+  thread_t** workers;
+  uint32_t workers_count;
+  mutex_t* mutex;
+  condition_t* start;       // signaled when a loop starts or on quit.
+  condition_t* done;        // signaled by the last worker out of a loop.
+  uint64_t generation;      // bumped per loop, wakes the workers.
+  int32_t quit;
+  uint32_t active;          // workers that did not leave the current loop.
+
+  job_function_t function;
+  void* data;
+  uint32_t count;
+  volatile int32_t next;    // handed out indices.
+} jobs_pool_t;
+
+static jobs_pool_t pool;
+
+static
+void
+run_indices(job_function_t function, void* data, uint32_t count)
+{
+  int32_t index;
+  while ((index = thread_atomic_increment(&pool.next) - 1) < (int32_t)count)
+    function(data, (uint32_t)index);
+}
+
+static
+void
+worker_entry(void* parameter)
+{
+  uint64_t seen = 0;
+  (void)parameter;
+
+  mutex_lock(pool.mutex);
+  for (;;) {
+    job_function_t function;
+    void* data;
+    uint32_t count;
+
+    while (!pool.quit && pool.generation == seen)
+      condition_wait(pool.start, pool.mutex);
+    if (pool.quit)
+      break;
+
+    seen = pool.generation;
+    function = pool.function;
+    data = pool.data;
+    count = pool.count;
+    mutex_unlock(pool.mutex);
+
+    run_indices(function, data, count);
+
+    mutex_lock(pool.mutex);
+    if (--pool.active == 0)
+      condition_signal(pool.done);
+  }
+  mutex_unlock(pool.mutex);
+}
+
+void
+jobs_initialize(uint32_t thread_count)
+{
+  assert(!pool.mutex && "jobs_initialize called twice");
+
+  if (!thread_count)
+    thread_count = thread_hardware_concurrency();
+
+  pool.mutex = mutex_create();
+  pool.start = condition_create();
+  pool.done = condition_create();
+  pool.workers = calloc(thread_count, sizeof(thread_t*));
+  assert(pool.workers);
+
+  for (uint32_t i = 0; i + 1 < thread_count; ++i) {
+    pool.workers[pool.workers_count] = thread_create(worker_entry, NULL);
+    if (pool.workers[pool.workers_count])
+      ++pool.workers_count;
+  }
+}
+
+void
+jobs_cleanup(void)
+{
+  if (!pool.mutex)
+    return;
+
+  mutex_lock(pool.mutex);
+  pool.quit = 1;
+  condition_broadcast(pool.start);
+  mutex_unlock(pool.mutex);
+
+  for (uint32_t i = 0; i < pool.workers_count; ++i)
+    thread_join(pool.workers[i]);
+
+  free(pool.workers);
+  condition_destroy(pool.done);
+  condition_destroy(pool.start);
+  mutex_destroy(pool.mutex);
+  memset(&pool, 0, sizeof(jobs_pool_t));
+}
+
+uint32_t
+jobs_thread_count(void)
+{
+  return pool.workers_count + 1;
+}
+
+void
+jobs_parallel_for(uint32_t count, job_function_t function, void* data)
+{
+  if (!pool.workers_count || count <= 1) {
+    for (uint32_t i = 0; i < count; ++i)
+      function(data, i);
+    return;
+  }
+
+  mutex_lock(pool.mutex);
+  pool.function = function;
+  pool.data = data;
+  pool.count = count;
+  pool.next = 0;
+  pool.active = pool.workers_count;
+  ++pool.generation;
+  condition_broadcast(pool.start);
+  mutex_unlock(pool.mutex);
+
+  run_indices(function, data, count);
+
+  // the workers may still be reading the loop parameters.
+  mutex_lock(pool.mutex);
+  while (pool.active)
+    condition_wait(pool.done, pool.mutex);
+  mutex_unlock(pool.mutex);
+}
@@ -0,0 +1,485 @@
+/**
+ * @file light_clusters.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/internal/jobs.h>
+#include <renderer/internal/light_clusters.h>
+
+
+// a light reaches as far as its attenuated intensity stays above 1/256.
+#define LIGHT_CUTOFF              256.f
+#define LIGHT_INDEX_MAX           0xffffu
+
+/// @brief the froxel boundaries shared by the slice jobs.
+typedef
+struct bin_job_t {
+  float tiles_x[LIGHT_CLUSTERS_X + 1];    // ndc.
+  float tiles_y[LIGHT_CLUSTERS_Y + 1];
+  float depths[LIGHT_CLUSTERS_Z + 1];     // positive, along -z.
+  uint16_t* scratch;        // LIGHT_CLUSTERS_CAPACITY entries per cluster.
+} bin_job_t;
+
+light_clusters_t light_clusters;
+static uint16_t* scratch = NULL;
+static uint32_t indices_capacity = 0;
+
+static
+void
+normalize(float* v)
+{
+  float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+  if (length > 0.f) {
+    v[0] /= length;
+    v[1] /= length;
+    v[2] /= length;
+  }
+}
+
+/// @brief solves c + l * d + q * d^2 = threshold for the distance d.
+static
+float
+get_light_range(const eye_light_t* light)
+{
+  const float* attenuation = light->attenuation;
+  float intensity = 0.f, threshold;
+
+  if (light->position[3] == 0.f)
+    return FLT_MAX;
+
+  for (uint32_t c = 0; c < 3; ++c)
+    intensity = fmaxf(
+      intensity,
+      light->ambient[c] + light->diffuse[c] + light->specular[c]);
+
+  threshold = intensity * LIGHT_CUTOFF;
+  if (attenuation[0] >= threshold)
+    return 0.f;
+  if (attenuation[2] > 0.f)
+    return (
+      -attenuation[1] +
+      sqrtf(
+        attenuation[1] * attenuation[1] +
+        4.f * attenuation[2] * (threshold - attenuation[0]))) /
+      (2.f * attenuation[2]);
+  if (attenuation[1] > 0.f)
+    return (threshold - attenuation[0]) / attenuation[1];
+  return FLT_MAX;
+}
+
+void
+eye_light_set(
+  eye_light_t* target,
+  const renderer_light_t* light,
+  const float* modelview)
+{
+  const float* m = modelview;
+  float position[4];
+
+  memset(target, 0, sizeof(eye_light_t));
+  memcpy(target->diffuse, light->diffuse.data, sizeof(target->diffuse));
+  memcpy(target->ambient, light->ambient.data, sizeof(target->ambient));
+  memcpy(target->specular, light->specular.data, sizeof(target->specular));
+
+  for (uint32_t row = 0; row < 3; ++row)
+    target->direction[row] =
+      m[row * 4 + 0] * light->direction.data[0] +
+      m[row * 4 + 1] * light->direction.data[1] +
+      m[row * 4 + 2] * light->direction.data[2];
+  normalize(target->direction);
+
+  target->direction[3] = -1.f;
+  if (
+    light->type == RENDERER_LIGHT_TYPE_SPOT &&
+    TO_DEGREES(light->outer_cone) != 180.f)
+    target->direction[3] = cosf(light->outer_cone);
+
+  target->attenuation[0] = 1.f;
+  if (light->type != RENDERER_LIGHT_TYPE_DIRECTIONAL) {
+    target->attenuation[0] = light->attenuation_constant;
+    target->attenuation[1] = light->attenuation_linear;
+    target->attenuation[2] = light->attenuation_quadratic;
+    if (
+      IS_ZERO_MP(
+        target->attenuation[0] * target->attenuation[0] +
+        target->attenuation[1] * target->attenuation[1] +
+        target->attenuation[2] * target->attenuation[2])) {
+      target->attenuation[0] = 1.0f;
+      target->attenuation[1] = 0.0003f;
+      target->attenuation[2] = 0.0f;
+    }
+  }
+
+  position[0] = light->position.data[0];
+  position[1] = light->position.data[1];
+  position[2] = light->position.data[2];
+  position[3] = light->type == RENDERER_LIGHT_TYPE_DIRECTIONAL ? 0.f : 1.f;
+  for (uint32_t row = 0; row < 4; ++row)
+    target->position[row] =
+      m[row * 4 + 0] * position[0] +
+      m[row * 4 + 1] * position[1] +
+      m[row * 4 + 2] * position[2] +
+      m[row * 4 + 3] * position[3];
+
+  target->attenuation[3] = get_light_range(target);
+}
+
+void
+eye_light_set_default(eye_light_t* target, uint32_t index)
+{
+  float value = index == 0 ? 1.f : 0.f;
+  memset(target, 0, sizeof(eye_light_t));
+  target->position[2] = 1.f;
+  target->direction[2] = -1.f;
+  target->direction[3] = -1.f;
+  target->attenuation[0] = 1.f;
+  target->attenuation[3] = FLT_MAX;
+  target->ambient[3] = 1.f;
+  target->diffuse[0] = target->diffuse[1] = target->diffuse[2] = value;
+  target->diffuse[3] = 1.f;
+  target->specular[0] = target->specular[1] = target->specular[2] = value;
+  target->specular[3] = 1.f;
+}
+
+/// @brief the eye space coordinate of the ndc value @a ndc at @a depth.
+static
+float
+get_eye_coordinate(float ndc, float depth, float scale, float offset)
+{
+  float value = (ndc - offset) / scale;
+  return light_clusters.perspective ? value * depth : value;
+}
+
+/// @brief distance from @a value to the range [min, max], 0 inside.
+static
+float
+get_gap(float value, float min, float max)
+{
+  return value < min ? min - value : (value > max ? value - max : 0.f);
+}
+
+/// @brief the eye space extent of the tiles between the near and far depth of
+/// the slice, @a tiles holds the ndc boundaries.
+static
+void
+get_tile_extents(
+  const float* tiles,
+  uint32_t count,
+  float near_depth,
+  float far_depth,
+  float scale,
+  float offset,
+  float* min,
+  float* max)
+{
+  for (uint32_t i = 0; i < count; ++i) {
+    float a = get_eye_coordinate(tiles[i], near_depth, scale, offset);
+    float b = get_eye_coordinate(tiles[i], far_depth, scale, offset);
+    float c = get_eye_coordinate(tiles[i + 1], near_depth, scale, offset);
+    float d = get_eye_coordinate(tiles[i + 1], far_depth, scale, offset);
+    min[i] = fminf(fminf(a, b), fminf(c, d));
+    max[i] = fmaxf(fmaxf(a, b), fmaxf(c, d));
+  }
+}
+
+static
+void
+add_light(const bin_job_t* job, uint32_t cluster, uint32_t light)
+{
+  uint32_t* count = light_clusters.records[cluster] + 1;
+  if (*count < LIGHT_CLUSTERS_CAPACITY)
+    job->scratch[cluster * LIGHT_CLUSTERS_CAPACITY + (*count)++] =
+      (uint16_t)light;
+}
+
+/// @brief tests every light sphere against the boxes bounding the froxels of
+/// the slice, the rows and columns out of reach are skipped first.
+static
+void
+bin_slice(void* data, uint32_t slice)
+{
+  const bin_job_t* job = (const bin_job_t*)data;
+  const float* projection = light_clusters.projection;
+  uint32_t first = slice * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y;
+  float near_depth = job->depths[slice], far_depth = job->depths[slice + 1];
+  float x_min[LIGHT_CLUSTERS_X], x_max[LIGHT_CLUSTERS_X];
+  float y_min[LIGHT_CLUSTERS_Y], y_max[LIGHT_CLUSTERS_Y];
+
+  get_tile_extents(
+    job->tiles_x, LIGHT_CLUSTERS_X, near_depth, far_depth,
+    projection[0], projection[1], x_min, x_max);
+  get_tile_extents(
+    job->tiles_y, LIGHT_CLUSTERS_Y, near_depth, far_depth,
+    projection[2], projection[3], y_min, y_max);
+
+  for (uint32_t i = 0; i < LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y; ++i)
+    light_clusters.records[first + i][1] = 0;
+
+  for (uint32_t i = 0; i < light_clusters.light_count; ++i) {
+    const eye_light_t* light = light_clusters.lights + i;
+    const float* p = light->position;
+    float range = light->attenuation[3];
+    float depth = -p[2], gap, reach;
+
+    if (range <= 0.f)
+      continue;
+
+    if (range == FLT_MAX) {
+      for (uint32_t c = 0; c < LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y; ++c)
+        add_light(job, first + c, i);
+      continue;
+    }
+
+    gap = get_gap(depth, near_depth, far_depth);
+    reach = range * range - gap * gap;
+    if (reach < 0.f)
+      continue;
+
+    for (uint32_t y = 0; y < LIGHT_CLUSTERS_Y; ++y) {
+      float gap_y = get_gap(p[1], y_min[y], y_max[y]);
+      float reach_y = reach - gap_y * gap_y;
+      if (reach_y < 0.f)
+        continue;
+
+      for (uint32_t x = 0; x < LIGHT_CLUSTERS_X; ++x) {
+        float gap_x = get_gap(p[0], x_min[x], x_max[x]);
+        if (gap_x * gap_x <= reach_y)
+          add_light(job, first + y * LIGHT_CLUSTERS_X + x, i);
+      }
+    }
+  }
+}
+
+/// @brief packs the per cluster runs of the scratch back to back.
+static
+int32_t
+compact_indices(void)
+{
+  uint32_t total = 0;
+
+  for (uint32_t i = 0; i < LIGHT_CLUSTERS_COUNT; ++i)
+    total += light_clusters.records[i][1];
+
+  if (total > indices_capacity) {
+    uint16_t* indices =
+      realloc(light_clusters.indices, sizeof(uint16_t) * total);
+    if (!indices)
+      return 0;
+    light_clusters.indices = indices;
+    indices_capacity = total;
+  }
+
+  total = 0;
+  for (uint32_t i = 0; i < LIGHT_CLUSTERS_COUNT; ++i) {
+    uint32_t count = light_clusters.records[i][1];
+    memcpy(
+      light_clusters.indices + total,
+      scratch + i * LIGHT_CLUSTERS_CAPACITY,
+      sizeof(uint16_t) * count);
+    light_clusters.records[i][0] = total;
+    total += count;
+  }
+
+  light_clusters.index_count = total;
+  return 1;
+}
+
+/// @brief the slice boundaries and the eye to ndc mapping of the frustum.
+static
+void
+set_grid(const pipeline_t* pipeline, bin_job_t* job)
+{
+  float l, r, b, t, n, f;
+  float* projection = light_clusters.projection;
+  get_frustum(pipeline, &l, &r, &b, &t, &n, &f);
+
+  light_clusters.perspective = get_projection_type(pipeline) == PERSPECTIVE;
+  light_clusters.near_plane = n;
+  if (light_clusters.perspective) {
+    projection[0] = 2.f * n / (r - l);
+    projection[1] = -(r + l) / (r - l);
+    projection[2] = 2.f * n / (t - b);
+    projection[3] = -(t + b) / (t - b);
+    light_clusters.depth_scale = LIGHT_CLUSTERS_Z / logf(f / n);
+  } else {
+    projection[0] = 2.f / (r - l);
+    projection[1] = -(r + l) / (r - l);
+    projection[2] = 2.f / (t - b);
+    projection[3] = -(t + b) / (t - b);
+    light_clusters.depth_scale = LIGHT_CLUSTERS_Z / (f - n);
+  }
+
+  for (uint32_t i = 0; i <= LIGHT_CLUSTERS_X; ++i)
+    job->tiles_x[i] = -1.f + 2.f * i / LIGHT_CLUSTERS_X;
+  for (uint32_t i = 0; i <= LIGHT_CLUSTERS_Y; ++i)
+    job->tiles_y[i] = -1.f + 2.f * i / LIGHT_CLUSTERS_Y;
+  for (uint32_t i = 0; i <= LIGHT_CLUSTERS_Z; ++i)
+    job->depths[i] = light_clusters.perspective ?
+      n * powf(f / n, (float)i / LIGHT_CLUSTERS_Z) :
+      n + (f - n) * i / LIGHT_CLUSTERS_Z;
+}
+
+void
+light_clusters_set(
+  const renderer_light_t* lights,
+  uint32_t light_count,
+  const pipeline_t* pipeline)
+{
+  bin_job_t job;
+  const float* modelview =
+    pipeline->modelview_stack[pipeline->modelview_index].data;
+
+  ++light_clusters.version;
+  light_clusters.light_count = 0;
+  light_clusters.index_count = 0;
+  assert(light_count <= LIGHT_INDEX_MAX);
+  if (!light_count)
+    return;
+
+  if (light_count > light_clusters.lights_capacity) {
+    eye_light_t* buffer = realloc(
+      light_clusters.lights, sizeof(eye_light_t) * light_count);
+    if (!buffer)
+      return;
+    light_clusters.lights = buffer;
+    light_clusters.lights_capacity = light_count;
+  }
+
+  if (!scratch) {
+    scratch = malloc(
+      sizeof(uint16_t) * LIGHT_CLUSTERS_COUNT * LIGHT_CLUSTERS_CAPACITY);
+    if (!scratch)
+      return;
+  }
+
+  for (uint32_t i = 0; i < light_count; ++i)
+    eye_light_set(light_clusters.lights + i, lights + i, modelview);
+
+  light_clusters.light_count = light_count;
+  set_grid(pipeline, &job);
+  job.scratch = scratch;
+  jobs_parallel_for(LIGHT_CLUSTERS_Z, bin_slice, &job);
+  if (!compact_indices())
+    light_clusters.light_count = 0;
+}
+
+void
+light_clusters_cleanup(void)
+{
+  free(light_clusters.lights);
+  free(light_clusters.indices);
+  free(scratch);
+  scratch = NULL;
+  indices_capacity = 0;
+  memset(&light_clusters, 0, sizeof(light_clusters_t));
+}
+
+static
+uint32_t
+get_tile(float value, float scale, float offset, uint32_t count)
+{
+  float ndc = value * scale + offset;
+  int32_t tile = (int32_t)floorf((ndc * 0.5f + 0.5f) * count);
+  return tile < 0 ? 0 : (tile >= (int32_t)count ? count - 1 : (uint32_t)tile);
+}
+
+uint32_t
+light_clusters_find(const float* eye)
+{
+  const float* projection = light_clusters.projection;
+  float n = light_clusters.near_plane;
+  float depth = fmaxf(-eye[2], n), slice;
+  float x = eye[0], y = eye[1];
+  uint32_t tile_x, tile_y, tile_z;
+
+  if (light_clusters.perspective) {
+    x /= depth;
+    y /= depth;
+    slice = logf(depth / n) * light_clusters.depth_scale;
+  } else {
+    slice = (depth - n) * light_clusters.depth_scale;
+  }
+
+  tile_x = get_tile(x, projection[0], projection[1], LIGHT_CLUSTERS_X);
+  tile_y = get_tile(y, projection[2], projection[3], LIGHT_CLUSTERS_Y);
+  tile_z = slice < LIGHT_CLUSTERS_Z ? (uint32_t)slice : LIGHT_CLUSTERS_Z - 1;
+  return (tile_z * LIGHT_CLUSTERS_Y + tile_y) * LIGHT_CLUSTERS_X + tile_x;
+}
+
+/// @brief the attenuated intensity of @a light at @a eye, 0 out of its range
+/// or cone.
+static
+float
+get_strength(const eye_light_t* light, const float* eye)
+{
+  float direction[3], distance, intensity = 0.f;
+
+  for (uint32_t c = 0; c < 3; ++c)
+    intensity = fmaxf(
+      intensity,
+      light->ambient[c] + light->diffuse[c] + light->specular[c]);
+
+  if (light->position[3] == 0.f)
+    return intensity;
+
+  direction[0] = light->position[0] - eye[0];
+  direction[1] = light->position[1] - eye[1];
+  direction[2] = light->position[2] - eye[2];
+  distance = sqrtf(
+    direction[0] * direction[0] +
+    direction[1] * direction[1] +
+    direction[2] * direction[2]);
+  if (distance > light->attenuation[3])
+    return 0.f;
+
+  normalize(direction);
+  if (
+    -(direction[0] * light->direction[0] +
+      direction[1] * light->direction[1] +
+      direction[2] * light->direction[2]) < light->direction[3])
+    return 0.f;
+
+  return intensity / (
+    light->attenuation[0] +
+    light->attenuation[1] * distance +
+    light->attenuation[2] * distance * distance);
+}
+
+uint32_t
+light_clusters_strongest(const float* eye, uint32_t max, uint32_t* selected)
+{
+  float strengths[8];
+  uint32_t count = 0;
+  assert(max <= sizeof(strengths) / sizeof(strengths[0]));
+
+  // insertion into the short sorted list.
+  for (uint32_t i = 0; i < light_clusters.light_count; ++i) {
+    float strength = get_strength(light_clusters.lights + i, eye);
+    uint32_t slot = count;
+    if (strength <= 0.f || (count == max && strength <= strengths[max - 1]))
+      continue;
+
+    count = count < max ? count + 1 : max;
+    for (; slot > 0 && strengths[slot - 1] < strength; --slot) {
+      if (slot < max) {
+        strengths[slot] = strengths[slot - 1];
+        selected[slot] = selected[slot - 1];
+      }
+    }
+
+    strengths[slot] = strength;
+    selected[slot] = i;
+  }
+
+  return count;
+}
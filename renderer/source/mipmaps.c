@@ -0,0 +1,376 @@
+/**
+ * @file mipmaps.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <renderer/internal/jobs.h>
+#include <renderer/internal/mipmaps.h>
+
+#if \
+  defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIPMAPS_SSE2
+#include <emmintrin.h>
+#endif
+
+
+#define LINEAR_STEPS              4096
+#define BAND_ROWS                 32
+#define PARALLEL_BYTES            (64 * 1024)
+
+// srgb to linear per byte, and linear (quantized) back to srgb.
+static float to_linear[256];
+static uint8_t to_srgb[LINEAR_STEPS];
+
+void
+mipmaps_initialize(void)
+{
+  for (uint32_t i = 0; i < 256; ++i) {
+    float c = i / 255.f;
+    to_linear[i] =
+      c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+  }
+
+  for (uint32_t i = 0; i < LINEAR_STEPS; ++i) {
+    float l = (float)i / (LINEAR_STEPS - 1);
+    float c =
+      l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.f / 2.4f) - 0.055f;
+    to_srgb[i] = (uint8_t)(c * 255.f + 0.5f);
+  }
+}
+
+uint32_t
+mipmaps_power_of_2(uint32_t size, uint32_t max_size)
+{
+  uint32_t power = 1;
+  while (power <= size / 2 && power * 2 <= max_size)
+    power *= 2;
+  return power;
+}
+
+void
+mipmaps_layout(
+  mipmaps_chain_t* chain,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components)
+{
+  uint32_t level = 0;
+  size_t offset = 0;
+
+  assert(width && height);
+
+  for (;;) {
+    assert(level < MIPMAPS_MAX_LEVELS);
+    chain->width[level] = width;
+    chain->height[level] = height;
+    chain->offset[level] = offset;
+    offset += (size_t)width * height * components;
+    ++level;
+
+    if (width == 1 && height == 1)
+      break;
+    width = width > 1 ? width / 2 : 1;
+    height = height > 1 ? height / 2 : 1;
+  }
+
+  chain->level_count = level;
+  chain->size = offset;
+}
+
+void
+mipmaps_resize(
+  const uint8_t* source,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components,
+  uint8_t* target,
+  uint32_t target_width,
+  uint32_t target_height)
+{
+  float scale_x = (float)width / target_width;
+  float scale_y = (float)height / target_height;
+
+  for (uint32_t y = 0; y < target_height; ++y) {
+    float v = (y + 0.5f) * scale_y - 0.5f;
+    uint32_t y0 = v > 0.f ? (uint32_t)v : 0;
+    uint32_t y1 = y0 + 1 < height ? y0 + 1 : height - 1;
+    float fy = v > 0.f ? v - (float)y0 : 0.f;
+
+    for (uint32_t x = 0; x < target_width; ++x) {
+      float u = (x + 0.5f) * scale_x - 0.5f;
+      uint32_t x0 = u > 0.f ? (uint32_t)u : 0;
+      uint32_t x1 = x0 + 1 < width ? x0 + 1 : width - 1;
+      float fx = u > 0.f ? u - (float)x0 : 0.f;
+      const uint8_t* p00 = source + ((size_t)y0 * width + x0) * components;
+      const uint8_t* p01 = source + ((size_t)y0 * width + x1) * components;
+      const uint8_t* p10 = source + ((size_t)y1 * width + x0) * components;
+      const uint8_t* p11 = source + ((size_t)y1 * width + x1) * components;
+
+      for (uint32_t c = 0; c < components; ++c) {
+        float top = p00[c] + (p01[c] - p00[c]) * fx;
+        float bottom = p10[c] + (p11[c] - p10[c]) * fx;
+        *target++ = (uint8_t)(top + (bottom - top) * fy + 0.5f);
+      }
+    }
+  }
+}
+
+void
+mipmaps_swizzle(uint8_t* pixels, size_t pixel_count, uint32_t components)
+{
+  size_t i = 0;
+  assert(components == 3 || components == 4);
+
+#if defined(MIPMAPS_SSE2)
+  if (components == 4) {
+    __m128i kept = _mm_set1_epi32((int32_t)0xff00ff00);
+    __m128i low = _mm_set1_epi32(0xff);
+    for (; i + 4 <= pixel_count; i += 4) {
+      __m128i* p = (__m128i*)(pixels + i * 4);
+      __m128i x = _mm_loadu_si128(p);
+      __m128i r = _mm_and_si128(_mm_srli_epi32(x, 16), low);
+      __m128i b = _mm_slli_epi32(_mm_and_si128(x, low), 16);
+      _mm_storeu_si128(
+        p, _mm_or_si128(_mm_and_si128(x, kept), _mm_or_si128(r, b)));
+    }
+  }
+#endif
+
+  for (; i < pixel_count; ++i) {
+    uint8_t* p = pixels + i * components;
+    uint8_t t = p[0];
+    p[0] = p[2];
+    p[2] = t;
+  }
+}
+
+/// @brief exact (a + b + c + d + 2) >> 2 per byte, @a step_x is 0 when the
+/// level is 1 texel wide.
+static
+void
+downsample_row_box(
+  const uint8_t* row0,
+  const uint8_t* row1,
+  uint32_t target_width,
+  uint32_t components,
+  size_t step_x,
+  uint8_t* target)
+{
+  size_t count = (size_t)target_width * components;
+  size_t o = 0;
+
+#if defined(MIPMAPS_SSE2)
+  // 16 source bytes of each row give 8 target bytes, the horizontal pairs are
+  // 1, 2 or 4 bytes apart. 3 components go through the scalar loop.
+  if (step_x && components != 3) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i ones = _mm_set1_epi16(1);
+    __m128i two = _mm_set1_epi16(2);
+    for (; o + 8 <= count; o += 8) {
+      __m128i a = _mm_loadu_si128((const __m128i*)(row0 + o * 2));
+      __m128i b = _mm_loadu_si128((const __m128i*)(row1 + o * 2));
+      __m128i lo = _mm_add_epi16(
+        _mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+      __m128i hi = _mm_add_epi16(
+        _mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+      __m128i sum;
+
+      if (components == 1) {
+        sum = _mm_packs_epi32(
+          _mm_madd_epi16(lo, ones), _mm_madd_epi16(hi, ones));
+      } else if (components == 2) {
+        lo = _mm_add_epi16(
+          _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 0, 2, 0)),
+          _mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 3, 1)));
+        hi = _mm_add_epi16(
+          _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 0, 2, 0)),
+          _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 3, 1)));
+        sum = _mm_unpacklo_epi64(lo, hi);
+      } else {
+        sum = _mm_add_epi16(
+          _mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+      }
+
+      sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+      _mm_storel_epi64((__m128i*)(target + o), _mm_packus_epi16(sum, sum));
+    }
+  }
+#endif
+
+  for (; o < count; ++o) {
+    size_t x = o / components, c = o % components;
+    const uint8_t* p0 = row0 + x * 2 * step_x + c;
+    const uint8_t* p1 = row1 + x * 2 * step_x + c;
+    target[o] = (uint8_t)((p0[0] + p0[step_x] + p1[0] + p1[step_x] + 2) >> 2);
+  }
+}
+
+/// @brief averages in linear space, the alpha (if any) stays a plain average.
+static
+void
+downsample_row_srgb(
+  const uint8_t* row0,
+  const uint8_t* row1,
+  uint32_t target_width,
+  uint32_t components,
+  size_t step_x,
+  int32_t has_alpha,
+  uint8_t* target)
+{
+  uint32_t color = has_alpha ? components - 1 : components;
+
+  for (uint32_t x = 0; x < target_width; ++x) {
+    const uint8_t* p0 = row0 + (size_t)x * 2 * step_x;
+    const uint8_t* p1 = row1 + (size_t)x * 2 * step_x;
+
+    for (uint32_t c = 0; c < color; ++c) {
+      float sum =
+        to_linear[p0[c]] + to_linear[p0[c + step_x]] +
+        to_linear[p1[c]] + to_linear[p1[c + step_x]];
+      *target++ = to_srgb[(uint32_t)(sum * 0.25f * (LINEAR_STEPS - 1) + 0.5f)];
+    }
+
+    if (has_alpha) {
+      uint32_t c = components - 1;
+      *target++ =
+        (uint8_t)((p0[c] + p0[c + step_x] + p1[c] + p1[c + step_x] + 2) >> 2);
+    }
+  }
+}
+
+void
+mipmaps_downsample(
+  const uint8_t* source,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components,
+  mipmaps_filter_t filter,
+  uint8_t* target,
+  uint32_t first_row,
+  uint32_t row_count)
+{
+  uint32_t target_width = width > 1 ? width / 2 : 1;
+  size_t pitch = (size_t)width * components;
+  // a dimension of 1 averages the texel with itself.
+  size_t step_x = width > 1 ? components : 0;
+  size_t step_y = height > 1 ? pitch : 0;
+
+  target += (size_t)first_row * target_width * components;
+  for (uint32_t y = first_row; y < first_row + row_count; ++y) {
+    const uint8_t* row0 = source + (size_t)y * 2 * step_y;
+    const uint8_t* row1 = row0 + step_y;
+
+    if (filter == MIPMAPS_FILTER_BOX)
+      downsample_row_box(row0, row1, target_width, components, step_x, target);
+    else
+      downsample_row_srgb(
+        row0,
+        row1,
+        target_width,
+        components,
+        step_x,
+        filter == MIPMAPS_FILTER_SRGB_ALPHA,
+        target);
+
+    target += (size_t)target_width * components;
+  }
+}
+
+typedef
+struct downsample_job_t {
+  const uint8_t* source;
+  uint32_t width;
+  uint32_t height;
+  uint32_t components;
+  mipmaps_filter_t filter;
+  uint8_t* target;
+  uint32_t target_height;
+} downsample_job_t;
+
+static
+void
+downsample_band(void* data, uint32_t index)
+{
+  downsample_job_t* job = data;
+  uint32_t first = index * BAND_ROWS;
+  uint32_t count = job->target_height - first;
+
+  mipmaps_downsample(
+    job->source,
+    job->width,
+    job->height,
+    job->components,
+    job->filter,
+    job->target,
+    first,
+    count < BAND_ROWS ? count : BAND_ROWS);
+}
+
+void
+mipmaps_generate(
+  const mipmaps_chain_t* chain,
+  const uint8_t* pixels,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components,
+  int32_t swizzle,
+  mipmaps_filter_t filter,
+  int32_t parallel,
+  uint8_t* levels)
+{
+  size_t level_0_size = (size_t)width * height * components;
+
+  if (chain->width[0] != width || chain->height[0] != height) {
+    assert(pixels != levels);
+    mipmaps_resize(
+      pixels,
+      width,
+      height,
+      components,
+      levels,
+      chain->width[0],
+      chain->height[0]);
+  } else if (pixels != levels) {
+    memcpy(levels, pixels, level_0_size);
+  }
+
+  if (swizzle)
+    mipmaps_swizzle(
+      levels, (size_t)chain->width[0] * chain->height[0], components);
+
+  for (uint32_t level = 1; level < chain->level_count; ++level) {
+    downsample_job_t job;
+    size_t size = (size_t)chain->width[level] * chain->height[level];
+    job.source = levels + chain->offset[level - 1];
+    job.width = chain->width[level - 1];
+    job.height = chain->height[level - 1];
+    job.components = components;
+    job.filter = filter;
+    job.target = levels + chain->offset[level];
+    job.target_height = chain->height[level];
+
+    // the levels depend on each other, the rows of a level do not.
+    if (parallel && size * components >= PARALLEL_BYTES)
+      jobs_parallel_for(
+        (job.target_height + BAND_ROWS - 1) / BAND_ROWS, downsample_band, &job);
+    else
+      mipmaps_downsample(
+        job.source,
+        job.width,
+        job.height,
+        components,
+        filter,
+        job.target,
+        0,
+        job.target_height);
+  }
+}
@@ -0,0 +1,325 @@
+/**
+ * @file opengl_extensions.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <renderer/internal/opengl_extensions.h>
+
+
+gl_gen_buffers_t renderer_glGenBuffers;
+gl_delete_buffers_t renderer_glDeleteBuffers;
+gl_bind_buffer_t renderer_glBindBuffer;
+gl_buffer_data_t renderer_glBufferData;
+gl_buffer_sub_data_t renderer_glBufferSubData;
+gl_map_buffer_t renderer_glMapBuffer;
+gl_unmap_buffer_t renderer_glUnmapBuffer;
+gl_compressed_tex_image_2d_t renderer_glCompressedTexImage2D;
+gl_gen_queries_t renderer_glGenQueries;
+gl_delete_queries_t renderer_glDeleteQueries;
+gl_begin_query_t renderer_glBeginQuery;
+gl_end_query_t renderer_glEndQuery;
+gl_get_query_objectiv_t renderer_glGetQueryObjectiv;
+gl_get_query_objectui64v_t renderer_glGetQueryObjectui64v;
+gl_fence_sync_t renderer_glFenceSync;
+gl_client_wait_sync_t renderer_glClientWaitSync;
+gl_delete_sync_t renderer_glDeleteSync;
+gl_get_stringi_t renderer_glGetStringi;
+gl_create_shader_t renderer_glCreateShader;
+gl_shader_source_t renderer_glShaderSource;
+gl_compile_shader_t renderer_glCompileShader;
+gl_get_shaderiv_t renderer_glGetShaderiv;
+gl_delete_shader_t renderer_glDeleteShader;
+gl_create_program_t renderer_glCreateProgram;
+gl_attach_shader_t renderer_glAttachShader;
+gl_bind_attrib_location_t renderer_glBindAttribLocation;
+gl_link_program_t renderer_glLinkProgram;
+gl_get_programiv_t renderer_glGetProgramiv;
+gl_use_program_t renderer_glUseProgram;
+gl_delete_program_t renderer_glDeleteProgram;
+gl_get_uniform_location_t renderer_glGetUniformLocation;
+gl_uniform_1i_t renderer_glUniform1i;
+gl_get_uniform_block_index_t renderer_glGetUniformBlockIndex;
+gl_uniform_block_binding_t renderer_glUniformBlockBinding;
+gl_bind_buffer_range_t renderer_glBindBufferRange;
+gl_map_buffer_range_t renderer_glMapBufferRange;
+gl_gen_vertex_arrays_t renderer_glGenVertexArrays;
+gl_bind_vertex_array_t renderer_glBindVertexArray;
+gl_delete_vertex_arrays_t renderer_glDeleteVertexArrays;
+gl_vertex_attrib_pointer_t renderer_glVertexAttribPointer;
+gl_enable_vertex_attrib_array_t renderer_glEnableVertexAttribArray;
+gl_disable_vertex_attrib_array_t renderer_glDisableVertexAttribArray;
+gl_vertex_attrib_4fv_t renderer_glVertexAttrib4fv;
+gl_vertex_attrib_divisor_t renderer_glVertexAttribDivisor;
+gl_draw_elements_instanced_t renderer_glDrawElementsInstanced;
+gl_active_texture_t renderer_glActiveTexture;
+gl_tex_buffer_t renderer_glTexBuffer;
+
+opengl_features_t opengl_features;
+
+/// @brief tries the core name first, then the one with the given suffix.
+static
+void*
+load_entry_point(const char* name, const char* suffix)
+{
+  char suffixed[128];
+  void* address = opengl_get_proc_address(name);
+
+  if (!address && suffix) {
+    snprintf(suffixed, sizeof(suffixed), "%s%s", name, suffix);
+    address = opengl_get_proc_address(suffixed);
+  }
+
+  return address;
+}
+
+static
+int32_t
+is_version_at_least(int32_t major, int32_t minor)
+{
+  return
+    opengl_features.major > major ||
+    (opengl_features.major == major && opengl_features.minor >= minor);
+}
+
+int32_t
+opengl_has_extension(const char* name)
+{
+  const char* extensions = NULL;
+  size_t length = strlen(name);
+
+  // core contexts have no extension string, only the indexed list.
+  if (glGetStringi) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+      const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+      if (extension && !strcmp(extension, name))
+        return 1;
+    }
+    return 0;
+  }
+
+  extensions = (const char*)glGetString(GL_EXTENSIONS);
+  while (extensions && (extensions = strstr(extensions, name))) {
+    if (extensions[length] == ' ' || extensions[length] == '\0')
+      return 1;
+    extensions += length;
+  }
+
+  return 0;
+}
+
+static
+void
+load_buffer_objects(void)
+{
+  const char* suffix = is_version_at_least(1, 5) ? NULL : "ARB";
+  if (suffix && !opengl_has_extension("GL_ARB_vertex_buffer_object"))
+    return;
+
+  glGenBuffers = (gl_gen_buffers_t)load_entry_point("glGenBuffers", suffix);
+  glDeleteBuffers =
+    (gl_delete_buffers_t)load_entry_point("glDeleteBuffers", suffix);
+  glBindBuffer = (gl_bind_buffer_t)load_entry_point("glBindBuffer", suffix);
+  glBufferData = (gl_buffer_data_t)load_entry_point("glBufferData", suffix);
+  glBufferSubData =
+    (gl_buffer_sub_data_t)load_entry_point("glBufferSubData", suffix);
+
+  glMapBuffer = (gl_map_buffer_t)load_entry_point("glMapBuffer", suffix);
+  glUnmapBuffer =
+    (gl_unmap_buffer_t)load_entry_point("glUnmapBuffer", suffix);
+
+  opengl_features.buffer_objects =
+    glGenBuffers && glDeleteBuffers && glBindBuffer &&
+    glBufferData && glBufferSubData;
+}
+
+static
+void
+load_texture_features(void)
+{
+  GLint size = 0;
+
+  opengl_features.pixel_buffer_objects =
+    opengl_features.buffer_objects && glMapBuffer && glUnmapBuffer &&
+    (is_version_at_least(2, 1) ||
+     opengl_has_extension("GL_ARB_pixel_buffer_object"));
+
+  opengl_features.npot_textures =
+    is_version_at_least(2, 0) ||
+    opengl_has_extension("GL_ARB_texture_non_power_of_two");
+
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &size);
+  opengl_features.max_texture_size = size > 0 ? size : 64;
+
+  if (
+    is_version_at_least(1, 3) ||
+    opengl_has_extension("GL_ARB_texture_compression"))
+    glCompressedTexImage2D =
+      (gl_compressed_tex_image_2d_t)load_entry_point(
+        "glCompressedTexImage2D",
+        is_version_at_least(1, 3) ? NULL : "ARB");
+
+  opengl_features.s3tc_textures =
+    glCompressedTexImage2D &&
+    opengl_has_extension("GL_EXT_texture_compression_s3tc");
+  opengl_features.rgtc_textures =
+    glCompressedTexImage2D &&
+    (is_version_at_least(3, 0) ||
+     opengl_has_extension("GL_ARB_texture_compression_rgtc") ||
+     opengl_has_extension("GL_EXT_texture_compression_rgtc"));
+}
+
+/// @brief the query objects come with occlusion queries, the 64 bit result
+/// with the timer queries.
+static
+void
+load_timer_queries(void)
+{
+  const char* suffix = is_version_at_least(1, 5) ? NULL : "ARB";
+  if (
+    !is_version_at_least(3, 3) &&
+    !opengl_has_extension("GL_ARB_timer_query") &&
+    !opengl_has_extension("GL_EXT_timer_query"))
+    return;
+
+  glGenQueries = (gl_gen_queries_t)load_entry_point("glGenQueries", suffix);
+  glDeleteQueries =
+    (gl_delete_queries_t)load_entry_point("glDeleteQueries", suffix);
+  glBeginQuery = (gl_begin_query_t)load_entry_point("glBeginQuery", suffix);
+  glEndQuery = (gl_end_query_t)load_entry_point("glEndQuery", suffix);
+  glGetQueryObjectiv =
+    (gl_get_query_objectiv_t)load_entry_point("glGetQueryObjectiv", suffix);
+  glGetQueryObjectui64v =
+    (gl_get_query_objectui64v_t)load_entry_point(
+      "glGetQueryObjectui64v", "EXT");
+
+  opengl_features.timer_queries =
+    glGenQueries && glDeleteQueries && glBeginQuery && glEndQuery &&
+    glGetQueryObjectiv && glGetQueryObjectui64v;
+}
+
+/// @brief ARB_sync exposes the core names, there is no suffix to try.
+static
+void
+load_sync_objects(void)
+{
+  if (
+    !is_version_at_least(3, 2) &&
+    !opengl_has_extension("GL_ARB_sync"))
+    return;
+
+  glFenceSync = (gl_fence_sync_t)load_entry_point("glFenceSync", NULL);
+  glClientWaitSync =
+    (gl_client_wait_sync_t)load_entry_point("glClientWaitSync", NULL);
+  glDeleteSync = (gl_delete_sync_t)load_entry_point("glDeleteSync", NULL);
+
+  opengl_features.sync_objects =
+    glFenceSync && glClientWaitSync && glDeleteSync;
+}
+
+/// @brief what renderer_core.c needs beyond the buffer objects, all of it
+/// core in 3.3 (mapped ranges and uniform buffers since 3.0/3.1).
+static
+void
+load_core_profile(void)
+{
+  if (!is_version_at_least(3, 3) || !opengl_features.buffer_objects)
+    return;
+
+  glCreateShader = (gl_create_shader_t)load_entry_point("glCreateShader", NULL);
+  glShaderSource = (gl_shader_source_t)load_entry_point("glShaderSource", NULL);
+  glCompileShader =
+    (gl_compile_shader_t)load_entry_point("glCompileShader", NULL);
+  glGetShaderiv = (gl_get_shaderiv_t)load_entry_point("glGetShaderiv", NULL);
+  glDeleteShader = (gl_delete_shader_t)load_entry_point("glDeleteShader", NULL);
+  glCreateProgram =
+    (gl_create_program_t)load_entry_point("glCreateProgram", NULL);
+  glAttachShader = (gl_attach_shader_t)load_entry_point("glAttachShader", NULL);
+  glBindAttribLocation =
+    (gl_bind_attrib_location_t)load_entry_point("glBindAttribLocation", NULL);
+  glLinkProgram = (gl_link_program_t)load_entry_point("glLinkProgram", NULL);
+  glGetProgramiv = (gl_get_programiv_t)load_entry_point("glGetProgramiv", NULL);
+  glUseProgram = (gl_use_program_t)load_entry_point("glUseProgram", NULL);
+  glDeleteProgram =
+    (gl_delete_program_t)load_entry_point("glDeleteProgram", NULL);
+  glGetUniformLocation =
+    (gl_get_uniform_location_t)load_entry_point("glGetUniformLocation", NULL);
+  glUniform1i = (gl_uniform_1i_t)load_entry_point("glUniform1i", NULL);
+  glGetUniformBlockIndex =
+    (gl_get_uniform_block_index_t)load_entry_point(
+      "glGetUniformBlockIndex", NULL);
+  glUniformBlockBinding =
+    (gl_uniform_block_binding_t)load_entry_point(
+      "glUniformBlockBinding", NULL);
+  glBindBufferRange =
+    (gl_bind_buffer_range_t)load_entry_point("glBindBufferRange", NULL);
+  glMapBufferRange =
+    (gl_map_buffer_range_t)load_entry_point("glMapBufferRange", NULL);
+  glGenVertexArrays =
+    (gl_gen_vertex_arrays_t)load_entry_point("glGenVertexArrays", NULL);
+  glBindVertexArray =
+    (gl_bind_vertex_array_t)load_entry_point("glBindVertexArray", NULL);
+  glDeleteVertexArrays =
+    (gl_delete_vertex_arrays_t)load_entry_point("glDeleteVertexArrays", NULL);
+  glVertexAttribPointer =
+    (gl_vertex_attrib_pointer_t)load_entry_point(
+      "glVertexAttribPointer", NULL);
+  glEnableVertexAttribArray =
+    (gl_enable_vertex_attrib_array_t)load_entry_point(
+      "glEnableVertexAttribArray", NULL);
+  glDisableVertexAttribArray =
+    (gl_disable_vertex_attrib_array_t)load_entry_point(
+      "glDisableVertexAttribArray", NULL);
+  glVertexAttrib4fv =
+    (gl_vertex_attrib_4fv_t)load_entry_point("glVertexAttrib4fv", NULL);
+  glVertexAttribDivisor =
+    (gl_vertex_attrib_divisor_t)load_entry_point(
+      "glVertexAttribDivisor", NULL);
+  glDrawElementsInstanced =
+    (gl_draw_elements_instanced_t)load_entry_point(
+      "glDrawElementsInstanced", NULL);
+  glActiveTexture =
+    (gl_active_texture_t)load_entry_point("glActiveTexture", NULL);
+  glTexBuffer = (gl_tex_buffer_t)load_entry_point("glTexBuffer", NULL);
+
+  opengl_features.core_profile =
+    glCreateShader && glShaderSource && glCompileShader && glGetShaderiv &&
+    glDeleteShader && glCreateProgram && glAttachShader &&
+    glBindAttribLocation && glLinkProgram && glGetProgramiv &&
+    glUseProgram && glDeleteProgram && glGetUniformLocation &&
+    glUniform1i && glGetUniformBlockIndex && glUniformBlockBinding &&
+    glBindBufferRange && glMapBufferRange && glUnmapBuffer &&
+    glGenVertexArrays && glBindVertexArray && glDeleteVertexArrays &&
+    glVertexAttribPointer && glEnableVertexAttribArray &&
+    glDisableVertexAttribArray && glVertexAttrib4fv &&
+    glVertexAttribDivisor && glDrawElementsInstanced &&
+    glActiveTexture && glTexBuffer;
+}
+
+void
+opengl_extensions_load(void)
+{
+  const char* version = (const char*)glGetString(GL_VERSION);
+
+  memset(&opengl_features, 0, sizeof(opengl_features_t));
+  if (version)
+    sscanf(version, "%d.%d", &opengl_features.major, &opengl_features.minor);
+
+  // needed by opengl_has_extension on core contexts, so it goes first.
+  glGetStringi = is_version_at_least(3, 0) ?
+    (gl_get_stringi_t)load_entry_point("glGetStringi", NULL) : NULL;
+
+  load_buffer_objects();
+  load_texture_features();
+  load_timer_queries();
+  load_sync_objects();
+  load_core_profile();
+}
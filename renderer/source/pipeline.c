@@ -0,0 +1,22 @@
+/**
+ * @file pipeline.c
+ * @author khalilhenoud@gmail.com
+ * @brief the process wide state behind the inline pipeline.h.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <renderer/pipeline.h>
+#include <renderer/internal/threads.h>
+
+
+static volatile int32_t generation = 0;
+
+uint32_t
+pipeline_next_generation(void)
+{
+  // 0 is never handed out, the state cache uses it for the identity.
+  return (uint32_t)thread_atomic_increment(&generation);
+}
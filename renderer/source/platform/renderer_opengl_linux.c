@@ -0,0 +1,166 @@
+/**
+ * @file renderer_opengl_linux.c
+ * @author khalilhenoud@gmail.com
+ * @brief the linux specific part of the opengl renderer. this is a headless
+ * backend, it creates an EGL pbuffer surface on the surfaceless mesa platform
+ * (works on llvmpipe without a gpu) and renders into it offscreen.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <renderer/platform/opengl_platform.h>
+
+
+static
+EGLDisplay display = EGL_NO_DISPLAY;
+
+static
+EGLSurface surface = EGL_NO_SURFACE;
+
+static
+EGLContext rendering_context = EGL_NO_CONTEXT;
+
+static
+EGLDisplay
+get_display(void)
+{
+  EGLDisplay result = EGL_NO_DISPLAY;
+  PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+    (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress(
+      "eglGetPlatformDisplayEXT");
+
+  // prefer the surfaceless platform, it does not need a display server.
+  if (get_platform_display)
+    result = get_platform_display(
+      EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+
+  if (result == EGL_NO_DISPLAY)
+    result = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+  return result;
+}
+
+/// @brief releases the display and the surface if any, returns 0.
+static
+int32_t
+release_display(void)
+{
+  if (surface != EGL_NO_SURFACE)
+    eglDestroySurface(display, surface);
+  if (display != EGL_NO_DISPLAY)
+    eglTerminate(display);
+
+  display = EGL_NO_DISPLAY;
+  surface = EGL_NO_SURFACE;
+  return 0;
+}
+
+/// @brief creates the pbuffer and a context with @a context_attributes, 0 if
+/// any step fails (nothing is left behind then).
+static
+int32_t
+create_context(
+  const opengl_parameters_t *params,
+  const EGLint* context_attributes)
+{
+  EGLint major = 0, minor = 0, config_count = 0;
+  EGLConfig config;
+  const EGLint config_attributes[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_RED_SIZE, 8,
+    EGL_GREEN_SIZE, 8,
+    EGL_BLUE_SIZE, 8,
+    EGL_ALPHA_SIZE, 8,
+    EGL_DEPTH_SIZE, 24,
+    EGL_NONE };
+  const EGLint surface_attributes[] = {
+    EGL_WIDTH, (EGLint)params->width,
+    EGL_HEIGHT, (EGLint)params->height,
+    EGL_NONE };
+
+  // no driver, or no display to open.
+  display = get_display();
+  if (display == EGL_NO_DISPLAY)
+    return 0;
+
+  if (!eglInitialize(display, &major, &minor)) {
+    display = EGL_NO_DISPLAY;
+    return 0;
+  }
+
+  if (
+    !eglChooseConfig(display, config_attributes, &config, 1, &config_count) ||
+    config_count < 1)
+    return release_display();
+
+  // the offscreen framebuffer, its size is fixed at creation time.
+  surface = eglCreatePbufferSurface(display, config, surface_attributes);
+  if (surface == EGL_NO_SURFACE || !eglBindAPI(EGL_OPENGL_API))
+    return release_display();
+
+  rendering_context = eglCreateContext(
+    display, config, EGL_NO_CONTEXT, context_attributes);
+  if (rendering_context == EGL_NO_CONTEXT)
+    return release_display();
+
+  if (!eglMakeCurrent(display, surface, surface, rendering_context)) {
+    eglDestroyContext(display, rendering_context);
+    rendering_context = EGL_NO_CONTEXT;
+    return release_display();
+  }
+
+  return 1;
+}
+
+int32_t
+opengl_initialize(const opengl_parameters_t *params)
+{
+  return create_context(params, NULL);
+}
+
+int32_t
+opengl_initialize_core(const opengl_parameters_t *params)
+{
+  // EGL 1.5 or EGL_KHR_create_context, the names share their values.
+  const EGLint context_attributes[] = {
+    EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+    EGL_CONTEXT_MINOR_VERSION_KHR, 3,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR,
+    EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+    EGL_NONE };
+  return create_context(params, context_attributes);
+}
+
+void
+opengl_swapbuffer()
+{
+  // a no-op for pbuffers as far as presentation goes, but it keeps the frame
+  // boundary semantics identical to the windowed platforms.
+  eglSwapBuffers(display, surface);
+}
+
+void
+opengl_cleanup()
+{
+  eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglDestroyContext(display, rendering_context);
+  eglDestroySurface(display, surface);
+  eglTerminate(display);
+
+  display = EGL_NO_DISPLAY;
+  surface = EGL_NO_SURFACE;
+  rendering_context = EGL_NO_CONTEXT;
+}
+
+void*
+opengl_get_proc_address(const char* name)
+{
+  return (void*)eglGetProcAddress(name);
+}
@@ -19,14 +19,21 @@ HDC device_context;      // GDI specific, HANDLE, PVOID
 static
 HGLRC rendering_context;        // WIN32 OpenGL specific (not a handle)
 
+// WGL_ARB_create_context and WGL_ARB_create_context_profile.
+#define WGL_CONTEXT_MAJOR_VERSION_ARB       0x2091
+#define WGL_CONTEXT_MINOR_VERSION_ARB       0x2092
+#define WGL_CONTEXT_PROFILE_MASK_ARB        0x9126
+#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB    0x00000001
+
+typedef HGLRC (WINAPI *wgl_create_context_attribs_t)(HDC, HGLRC, const int*);
+
+static
 void
-opengl_initialize(const opengl_parameters_t *params)
+set_pixel_format(void)
 {
   int32_t iPixelFormat = 0;
   PIXELFORMATDESCRIPTOR kPFD = { 0 };
 
-  device_context = *(HDC*)params;
-
   // Binding OpenGL to the current window.
   kPFD.nSize = sizeof(PIXELFORMATDESCRIPTOR);
   kPFD.nVersion = 1;
@@ -40,9 +47,47 @@ opengl_initialize(const opengl_parameters_t *params)
 
   iPixelFormat = ChoosePixelFormat(device_context, &kPFD);
   SetPixelFormat(device_context, iPixelFormat, &kPFD);
+}
+
+int32_t
+opengl_initialize(const opengl_parameters_t *params)
+{
+  device_context = *(HDC*)params;
+  set_pixel_format();
 
   rendering_context = wglCreateContext(device_context);
+  if (!rendering_context)
+    return 0;
+
   wglMakeCurrent(device_context, rendering_context);
+  return 1;
+}
+
+int32_t
+opengl_initialize_core(const opengl_parameters_t *params)
+{
+  const int attributes[] = {
+    WGL_CONTEXT_MAJOR_VERSION_ARB, 3,
+    WGL_CONTEXT_MINOR_VERSION_ARB, 3,
+    WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
+    0 };
+  wgl_create_context_attribs_t create_context_attribs = NULL;
+  HGLRC legacy_context = NULL;
+
+  device_context = *(HDC*)params;
+  set_pixel_format();
+
+  // the entry point is only reachable through a current legacy context.
+  legacy_context = wglCreateContext(device_context);
+  wglMakeCurrent(device_context, legacy_context);
+  create_context_attribs = (wgl_create_context_attribs_t)wglGetProcAddress(
+    "wglCreateContextAttribsARB");
+  rendering_context = create_context_attribs ?
+    create_context_attribs(device_context, NULL, attributes) : NULL;
+
+  wglMakeCurrent(device_context, rendering_context);
+  wglDeleteContext(legacy_context);
+  return rendering_context != NULL;
 }
 
 void
@@ -55,4 +100,21 @@ void
 opengl_cleanup()
 {
   wglDeleteContext(rendering_context);
+}
+
+void*
+opengl_get_proc_address(const char* name)
+{
+  // wglGetProcAddress only knows about post 1.1 functions, some drivers return
+  // small sentinel values instead of NULL on failure.
+  void* address = (void*)wglGetProcAddress(name);
+  if (
+    address == NULL ||
+    address == (void*)0x1 ||
+    address == (void*)0x2 ||
+    address == (void*)0x3 ||
+    address == (void*)-1)
+    address = (void*)GetProcAddress(GetModuleHandleA("opengl32.dll"), name);
+
+  return address;
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+/**
+ * @file threads_posix.c
+ * @author khalilhenoud@gmail.com
+ * @brief pthread implementation of threads.h.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <renderer/internal/threads.h>
+
+
+struct thread_t {
+  pthread_t handle;
+  thread_function_t function;
+  void* data;
+};
+
+struct mutex_t {
+  pthread_mutex_t handle;
+};
+
+struct condition_t {
+  pthread_cond_t handle;
+};
+
+static
+void*
+thread_entry(void* parameter)
+{
+  thread_t* thread = (thread_t*)parameter;
+  thread->function(thread->data);
+  return NULL;
+}
+
+thread_t*
+thread_create(thread_function_t function, void* data)
+{
+  thread_t* thread = malloc(sizeof(thread_t));
+  if (!thread)
+    return NULL;
+
+  thread->function = function;
+  thread->data = data;
+  if (pthread_create(&thread->handle, NULL, thread_entry, thread)) {
+    free(thread);
+    return NULL;
+  }
+
+  return thread;
+}
+
+void
+thread_join(thread_t* thread)
+{
+  pthread_join(thread->handle, NULL);
+  free(thread);
+}
+
+uint32_t
+thread_hardware_concurrency(void)
+{
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? (uint32_t)count : 1;
+}
+
+int32_t
+thread_atomic_increment(volatile int32_t* value)
+{
+  return __atomic_add_fetch(value, 1, __ATOMIC_ACQ_REL);
+}
+
+mutex_t*
+mutex_create(void)
+{
+  mutex_t* mutex = malloc(sizeof(mutex_t));
+  assert(mutex);
+  pthread_mutex_init(&mutex->handle, NULL);
+  return mutex;
+}
+
+void
+mutex_destroy(mutex_t* mutex)
+{
+  pthread_mutex_destroy(&mutex->handle);
+  free(mutex);
+}
+
+void
+mutex_lock(mutex_t* mutex)
+{
+  pthread_mutex_lock(&mutex->handle);
+}
+
+void
+mutex_unlock(mutex_t* mutex)
+{
+  pthread_mutex_unlock(&mutex->handle);
+}
+
+condition_t*
+condition_create(void)
+{
+  condition_t* condition = malloc(sizeof(condition_t));
+  assert(condition);
+  pthread_cond_init(&condition->handle, NULL);
+  return condition;
+}
+
+void
+condition_destroy(condition_t* condition)
+{
+  pthread_cond_destroy(&condition->handle);
+  free(condition);
+}
+
+void
+condition_wait(condition_t* condition, mutex_t* mutex)
+{
+  pthread_cond_wait(&condition->handle, &mutex->handle);
+}
+
+void
+condition_signal(condition_t* condition)
+{
+  pthread_cond_signal(&condition->handle);
+}
+
+void
+condition_broadcast(condition_t* condition)
+{
+  pthread_cond_broadcast(&condition->handle);
+}
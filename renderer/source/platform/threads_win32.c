@@ -0,0 +1,139 @@
+/**
+ * @file threads_win32.c
+ * @author khalilhenoud@gmail.com
+ * @brief win32 implementation of threads.h (slim reader/writer locks and
+ * condition variables, vista and up).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <windows.h>
+#include <renderer/internal/threads.h>
+
+
+struct thread_t {
+  HANDLE handle;
+  thread_function_t function;
+  void* data;
+};
+
+struct mutex_t {
+  SRWLOCK handle;
+};
+
+struct condition_t {
+  CONDITION_VARIABLE handle;
+};
+
+static
+DWORD WINAPI
+thread_entry(LPVOID parameter)
+{
+  thread_t* thread = (thread_t*)parameter;
+  thread->function(thread->data);
+  return 0;
+}
+
+thread_t*
+thread_create(thread_function_t function, void* data)
+{
+  thread_t* thread = malloc(sizeof(thread_t));
+  if (!thread)
+    return NULL;
+
+  thread->function = function;
+  thread->data = data;
+  thread->handle = CreateThread(NULL, 0, thread_entry, thread, 0, NULL);
+  if (!thread->handle) {
+    free(thread);
+    return NULL;
+  }
+
+  return thread;
+}
+
+void
+thread_join(thread_t* thread)
+{
+  WaitForSingleObject(thread->handle, INFINITE);
+  CloseHandle(thread->handle);
+  free(thread);
+}
+
+uint32_t
+thread_hardware_concurrency(void)
+{
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors ? (uint32_t)info.dwNumberOfProcessors : 1;
+}
+
+int32_t
+thread_atomic_increment(volatile int32_t* value)
+{
+  return (int32_t)InterlockedIncrement((volatile LONG*)value);
+}
+
+mutex_t*
+mutex_create(void)
+{
+  mutex_t* mutex = malloc(sizeof(mutex_t));
+  assert(mutex);
+  InitializeSRWLock(&mutex->handle);
+  return mutex;
+}
+
+void
+mutex_destroy(mutex_t* mutex)
+{
+  free(mutex);
+}
+
+void
+mutex_lock(mutex_t* mutex)
+{
+  AcquireSRWLockExclusive(&mutex->handle);
+}
+
+void
+mutex_unlock(mutex_t* mutex)
+{
+  ReleaseSRWLockExclusive(&mutex->handle);
+}
+
+condition_t*
+condition_create(void)
+{
+  condition_t* condition = malloc(sizeof(condition_t));
+  assert(condition);
+  InitializeConditionVariable(&condition->handle);
+  return condition;
+}
+
+void
+condition_destroy(condition_t* condition)
+{
+  free(condition);
+}
+
+void
+condition_wait(condition_t* condition, mutex_t* mutex)
+{
+  SleepConditionVariableSRW(&condition->handle, &mutex->handle, INFINITE, 0);
+}
+
+void
+condition_signal(condition_t* condition)
+{
+  WakeConditionVariable(&condition->handle);
+}
+
+void
+condition_broadcast(condition_t* condition)
+{
+  WakeAllConditionVariable(&condition->handle);
+}
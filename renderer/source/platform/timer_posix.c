@@ -0,0 +1,24 @@
+/**
+ * @file timer_posix.c
+ * @author khalilhenoud@gmail.com
+ * @brief clock_gettime implementation of timer.h.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+#include <time.h>
+#include <renderer/internal/timer.h>
+
+
+uint64_t
+timer_nanoseconds(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
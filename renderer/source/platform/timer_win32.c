@@ -0,0 +1,32 @@
+/**
+ * @file timer_win32.c
+ * @author khalilhenoud@gmail.com
+ * @brief QueryPerformanceCounter implementation of timer.h.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <windows.h>
+#include <renderer/internal/timer.h>
+
+
+uint64_t
+timer_nanoseconds(void)
+{
+  static LARGE_INTEGER frequency;
+  LARGE_INTEGER now;
+  uint64_t seconds, remainder;
+
+  if (!frequency.QuadPart)
+    QueryPerformanceFrequency(&frequency);
+
+  // split to keep the multiplication from overflowing.
+  QueryPerformanceCounter(&now);
+  seconds = (uint64_t)(now.QuadPart / frequency.QuadPart);
+  remainder = (uint64_t)(now.QuadPart % frequency.QuadPart);
+  return
+    seconds * 1000000000ull +
+    remainder * 1000000000ull / (uint64_t)frequency.QuadPart;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file render_queue.c
+ * @author khalilhenoud@gmail.com
+ * @brief key generation and sorting, submission lives with the rest of the
+ * opengl code in renderer_opengl.c.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/render_queue.h>
+
+
+#define RADIX_BITS    8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES  (64 / RADIX_BITS)
+
+static
+int32_t
+is_transparent(const mesh_render_data_t* mesh)
+{
+  return
+    mesh->ambient.data[3] < 1.f ||
+    mesh->diffuse.data[3] < 1.f ||
+    mesh->specular.data[3] < 1.f;
+}
+
+/// @brief FNV-1a over the material colors folded to 16 bits, collisions only
+/// cost a state change, submission compares the actual values.
+static
+uint64_t
+get_material_hash(const mesh_render_data_t* mesh)
+{
+  uint32_t hash = 2166136261u;
+  const color_t* colors[3] = {
+    &mesh->ambient, &mesh->diffuse, &mesh->specular };
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    const uint8_t* bytes = (const uint8_t*)colors[i]->data;
+    for (uint32_t j = 0; j < sizeof(colors[i]->data); ++j) {
+      hash ^= bytes[j];
+      hash *= 16777619u;
+    }
+  }
+
+  return (hash ^ (hash >> 16)) & 0xffff;
+}
+
+/// @brief positive floats sort the same as their bit patterns, negative depths
+/// (behind the camera) are clamped to 0.
+static
+uint64_t
+get_depth_bits(float depth)
+{
+  uint32_t bits = 0;
+  if (depth > 0.f)
+    memcpy(&bits, &depth, sizeof(bits));
+  return bits & 0x7fffffff;
+}
+
+static
+uint64_t
+build_key(const mesh_render_data_t* mesh, uint32_t texture_id, float depth)
+{
+  uint64_t texture = texture_id & 0xffff;
+  uint64_t material = get_material_hash(mesh);
+  uint64_t depth_bits = get_depth_bits(depth);
+
+  if (is_transparent(mesh))
+    return
+      (1ull << 63) |
+      ((~depth_bits & 0x7fffffff) << 32) |
+      (texture << 16) |
+      material;
+  else
+    return
+      (texture << 47) |
+      (material << 31) |
+      depth_bits;
+}
+
+static
+void
+reserve(render_queue_t* queue, uint32_t capacity)
+{
+  render_queue_item_t* items = NULL;
+  render_queue_item_t* scratch = NULL;
+
+  if (capacity <= queue->capacity)
+    return;
+
+  items = realloc(queue->items, sizeof(render_queue_item_t) * capacity);
+  assert(items);
+  queue->items = items;
+  scratch = realloc(queue->scratch, sizeof(render_queue_item_t) * capacity);
+  assert(scratch);
+  queue->scratch = scratch;
+  queue->capacity = capacity;
+}
+
+void
+render_queue_initialize(render_queue_t* queue, uint32_t capacity)
+{
+  memset(queue, 0, sizeof(render_queue_t));
+  reserve(queue, capacity);
+}
+
+void
+render_queue_cleanup(render_queue_t* queue)
+{
+  free(queue->items);
+  free(queue->scratch);
+  memset(queue, 0, sizeof(render_queue_t));
+}
+
+void
+render_queue_clear(render_queue_t* queue)
+{
+  queue->count = 0;
+}
+
+void
+render_queue_push(
+  render_queue_t* queue,
+  const mesh_render_data_t* mesh,
+  const uint32_t* texture_data,
+  const float* depths,
+  uint32_t mesh_count)
+{
+  uint32_t required = queue->count + mesh_count;
+  uint32_t doubled = queue->capacity * 2;
+  if (required > queue->capacity)
+    reserve(queue, required > doubled ? required : doubled);
+
+  for (uint32_t i = 0; i < mesh_count; ++i) {
+    render_queue_item_t* item = queue->items + queue->count++;
+    float depth = depths ? depths[i] : 0.f;
+    item->mesh = mesh + i;
+    item->texture_id = texture_data[i];
+    item->key = build_key(mesh + i, texture_data[i], depth);
+  }
+}
+
+void
+render_queue_sort(render_queue_t* queue)
+{
+  uint32_t histograms[RADIX_PASSES][RADIX_BUCKETS];
+  render_queue_item_t* source = queue->items;
+  render_queue_item_t* target = queue->scratch;
+
+  if (queue->count < 2)
+    return;
+
+  // one read pass builds the histograms of every digit.
+  memset(histograms, 0, sizeof(histograms));
+  for (uint32_t i = 0; i < queue->count; ++i) {
+    uint64_t key = source[i].key;
+    for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass)
+      ++histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)];
+  }
+
+  for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass) {
+    uint32_t* histogram = histograms[pass];
+    uint32_t offset = 0, shift = pass * RADIX_BITS;
+    uint32_t first = (source[0].key >> shift) & (RADIX_BUCKETS - 1);
+    render_queue_item_t* swap = NULL;
+
+    // every key shares this digit, the pass would not move anything.
+    if (histogram[first] == queue->count)
+      continue;
+
+    for (uint32_t i = 0; i < RADIX_BUCKETS; ++i) {
+      uint32_t count = histogram[i];
+      histogram[i] = offset;
+      offset += count;
+    }
+
+    for (uint32_t i = 0; i < queue->count; ++i)
+      target[histogram[(source[i].key >> shift) & (RADIX_BUCKETS - 1)]++] =
+        source[i];
+
+    swap = source;
+    source = target;
+    target = swap;
+  }
+
+  // keep the sorted result in items.
+  queue->items = source;
+  queue->scratch = target;
+}
@@ -0,0 +1,1663 @@
+/**
+ * @file renderer_core.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/renderer_core.h>
+#include <renderer/texture_cache.h>
+#include <renderer/texture_compression.h>
+#include <renderer/internal/backend.h>
+#include <renderer/internal/frame_pacing.h>
+#include <renderer/internal/frame_stats.h>
+#include <renderer/internal/jobs.h>
+#include <renderer/internal/light_clusters.h>
+#include <renderer/internal/mipmaps.h>
+#include <renderer/internal/opengl_extensions.h>
+#include <renderer/internal/renderer_internal.h>
+#include <renderer/internal/state_cache.h>
+#include <renderer/internal/texture_streaming.h>
+#include <renderer/internal/unit_quads.h>
+
+
+#define CORE_VERTEX_STREAM_SIZE   (4u << 20)
+#define CORE_INDEX_STREAM_SIZE    (1u << 20)
+#define CORE_UNIFORM_STREAM_SIZE  (256u << 10)
+
+// attribute locations, the instance matrix takes 4 of them (one per row).
+#define ATTRIBUTE_POSITION        0
+#define ATTRIBUTE_NORMAL          1
+#define ATTRIBUTE_UV              2
+#define ATTRIBUTE_INSTANCE        3
+#define ATTRIBUTE_TINT            7
+#define ATTRIBUTE_COLOR           8
+#define ATTRIBUTE_COUNT           9
+
+#define ARRAY_BIT(attribute)      (1u << (attribute))
+#define INSTANCE_ARRAYS           \
+  ((0xFu << ATTRIBUTE_INSTANCE) | ARRAY_BIT(ATTRIBUTE_TINT))
+#define MATRIX_ARRAYS             (0xFu << ATTRIBUTE_INSTANCE)
+// the shaders read the current value of these while they are disabled.
+#define DEFAULTED_ARRAYS          \
+  (INSTANCE_ARRAYS | ARRAY_BIT(ATTRIBUTE_COLOR))
+#define MESH_ARRAYS               \
+  (ARRAY_BIT(ATTRIBUTE_POSITION) | \
+   ARRAY_BIT(ATTRIBUTE_NORMAL) |   \
+   ARRAY_BIT(ATTRIBUTE_UV))
+
+// uniform buffer binding points.
+#define BINDING_DRAW              0
+#define BINDING_LIGHTS            1
+
+// texture units of the clustered lights, the diffuse texture is on unit 0.
+#define UNIT_CLUSTER_LIGHTS       1
+#define UNIT_CLUSTER_RECORDS      2
+#define UNIT_CLUSTER_INDICES      3
+#define CLUSTER_BUFFER_COUNT      3
+
+#define CORE_STRING(x)            #x
+#define CORE_VALUE(x)             CORE_STRING(x)
+
+/// @brief the std140 layout of draw_block, matrices are row major.
+typedef
+struct core_draw_block_t {
+  float projection[16];
+  float modelview[16];
+  float ambient[4];
+  float diffuse[4];
+  float specular[4];
+  float color[4];           // unlit color or tint.
+  int32_t textured[4];
+} core_draw_block_t;
+
+/// @brief the std140 layout of light_block, the lights are eye_light_t.
+typedef
+struct core_lights_block_t {
+  int32_t count[4];         // enabled lights, clustered lights on.
+  float clusters[4];        // near plane, depth scale, perspective.
+  float cluster_projection[4];
+  eye_light_t lights[RENDERER_CORE_LIGHT_COUNT];
+} core_lights_block_t;
+
+/// @brief buffer written front to back, orphaned when it wraps so the writes
+/// never wait on the draws still reading it.
+typedef
+struct core_stream_t {
+  GLuint buffer;
+  uint32_t size;
+  uint32_t offset;
+} core_stream_t;
+
+typedef
+struct core_mesh_t {
+  GLuint vertex_array;      // 0 if the slot is free.
+  GLuint vertex_buffer;
+  GLuint index_buffer;
+  uint32_t vertex_count;
+  uint32_t indices_count;
+  color_t ambient;
+  color_t diffuse;
+  color_t specular;
+  uint32_t next_free;       // index + 1 of the next free slot, 0 ends the list.
+} core_mesh_t;
+
+typedef
+struct core_state_t {
+  GLuint lit_program;
+  GLuint unlit_program;
+  GLuint program;           // the one in use.
+  GLuint stream_vertex_array;
+  GLuint vertex_array;      // the one bound.
+  uint32_t stream_arrays;   // enabled arrays of the stream vertex array.
+  core_stream_t vertices;
+  core_stream_t indices;
+  core_stream_t uniforms;
+  uint32_t uniform_alignment;
+  GLuint lights_buffer;
+  int32_t lights_dirty;
+  int32_t light_enabled[RENDERER_CORE_LIGHT_COUNT];
+  eye_light_t lights[RENDERER_CORE_LIGHT_COUNT];
+  // the lights, records and indices of light_clusters, as texture buffers.
+  GLuint cluster_buffers[CLUSTER_BUFFER_COUNT];
+  GLuint cluster_textures[CLUSTER_BUFFER_COUNT];
+  uint32_t cluster_version;
+  float projection[16];
+  int32_t depth_test;
+  core_mesh_t* meshes;
+  uint32_t meshes_capacity;
+  uint32_t meshes_free;
+  // draw_grid geometry, rebuilt only when the parameters change.
+  GLuint grid_buffer;
+  float grid_width;
+  int32_t grid_lines_per_axis;
+  // the index pattern of draw_unit_quads, only ever grown.
+  GLuint quad_buffer;
+  uint32_t quad_capacity;
+} core_state_t;
+
+static core_state_t core;
+static core_lights_block_t lights_block;
+
+static const char* shader_header =
+  "#version 330 core\n"
+  "#define LIGHT_COUNT " CORE_VALUE(RENDERER_CORE_LIGHT_COUNT) "\n"
+  "#define CLUSTERS_X " CORE_VALUE(LIGHT_CLUSTERS_X) "\n"
+  "#define CLUSTERS_Y " CORE_VALUE(LIGHT_CLUSTERS_Y) "\n"
+  "#define CLUSTERS_Z " CORE_VALUE(LIGHT_CLUSTERS_Z) "\n"
+  "layout(std140, row_major) uniform draw_block {\n"
+  "  mat4 projection;\n"
+  "  mat4 modelview;\n"
+  "  vec4 ambient;\n"
+  "  vec4 diffuse;\n"
+  "  vec4 specular;\n"
+  "  vec4 color;\n"
+  "  ivec4 textured;\n"
+  "};\n"
+  "uniform sampler2D diffuse_texture;\n";
+
+// the instance rows default to the identity and the tint to white.
+static const char* lit_vertex_shader =
+  "in vec3 position;\n"
+  "in vec3 normal;\n"
+  "in vec2 uv;\n"
+  "in mat4 instance_rows;\n"
+  "in vec4 tint;\n"
+  "out vec3 eye_position;\n"
+  "out vec3 eye_normal;\n"
+  "out vec2 texture_uv;\n"
+  "flat out vec4 instance_tint;\n"
+  "void main() {\n"
+  "  mat4 m = modelview * transpose(instance_rows);\n"
+  "  mat3 l = mat3(m);\n"
+  // the cofactors are the inverse transpose scaled by the determinant.
+  "  mat3 n = mat3(cross(l[1], l[2]), cross(l[2], l[0]), cross(l[0], l[1]));\n"
+  "  vec4 eye = m * vec4(position, 1.0);\n"
+  "  eye_position = eye.xyz;\n"
+  "  eye_normal = n * normal * sign(dot(l[0], n[0]));\n"
+  "  texture_uv = uv;\n"
+  "  instance_tint = tint;\n"
+  "  gl_Position = projection * eye;\n"
+  "}\n";
+
+// same terms as the fixed function pipeline: no emission, black global
+// ambient and a shininess of 0 (constant specular on the lit side). with
+// clustered lights on, only the ones binned in the cluster of the fragment are
+// shaded, a light is 6 texels of cluster_lights.
+static const char* lit_fragment_shader =
+  "struct light_t {\n"
+  "  vec4 position;\n"
+  "  vec4 direction;\n"
+  "  vec4 ambient;\n"
+  "  vec4 diffuse;\n"
+  "  vec4 specular;\n"
+  "  vec4 attenuation;\n"
+  "};\n"
+  "layout(std140) uniform light_block {\n"
+  "  ivec4 light_count;\n"
+  "  vec4 clusters;\n"
+  "  vec4 cluster_projection;\n"
+  "  light_t lights[LIGHT_COUNT];\n"
+  "};\n"
+  "uniform samplerBuffer cluster_lights;\n"
+  "uniform usamplerBuffer cluster_records;\n"
+  "uniform usamplerBuffer cluster_indices;\n"
+  "in vec3 eye_position;\n"
+  "in vec3 eye_normal;\n"
+  "in vec2 texture_uv;\n"
+  "flat in vec4 instance_tint;\n"
+  "out vec4 fragment;\n"
+  "vec3 shade(light_t light, vec3 normal, vec3 a, vec3 d, vec3 s) {\n"
+  "  vec3 direction = normalize(light.position.xyz);\n"
+  "  float factor = 1.0;\n"
+  "  if (light.position.w != 0.0) {\n"
+  "    vec3 to_light = light.position.xyz - eye_position;\n"
+  "    float distance = length(to_light);\n"
+  "    direction = distance > 0.0 ? to_light / distance : to_light;\n"
+  "    factor = 1.0 / dot(\n"
+  "      light.attenuation.xyz, vec3(1.0, distance, distance * distance));\n"
+  "    if (dot(-direction, light.direction.xyz) < light.direction.w)\n"
+  "      return vec3(0.0);\n"
+  "  }\n"
+  "  float n_dot_l = dot(normal, direction);\n"
+  "  vec3 term = light.ambient.rgb * a;\n"
+  "  if (n_dot_l > 0.0)\n"
+  "    term += n_dot_l * light.diffuse.rgb * d + light.specular.rgb * s;\n"
+  "  return factor * term;\n"
+  "}\n"
+  "light_t fetch_light(int index) {\n"
+  "  int texel = index * 6;\n"
+  "  return light_t(\n"
+  "    texelFetch(cluster_lights, texel),\n"
+  "    texelFetch(cluster_lights, texel + 1),\n"
+  "    texelFetch(cluster_lights, texel + 2),\n"
+  "    texelFetch(cluster_lights, texel + 3),\n"
+  "    texelFetch(cluster_lights, texel + 4),\n"
+  "    texelFetch(cluster_lights, texel + 5));\n"
+  "}\n"
+  // same mapping as light_clusters_find.
+  "int find_cluster(vec3 eye) {\n"
+  "  float depth = max(-eye.z, clusters.x);\n"
+  "  vec2 xy = eye.xy;\n"
+  "  float slice = (depth - clusters.x) * clusters.y;\n"
+  "  if (clusters.z != 0.0) {\n"
+  "    xy /= depth;\n"
+  "    slice = log(depth / clusters.x) * clusters.y;\n"
+  "  }\n"
+  "  vec2 ndc = xy * cluster_projection.xz + cluster_projection.yw;\n"
+  "  ivec2 tile = clamp(\n"
+  "    ivec2(floor((ndc * 0.5 + 0.5) * vec2(CLUSTERS_X, CLUSTERS_Y))),\n"
+  "    ivec2(0),\n"
+  "    ivec2(CLUSTERS_X - 1, CLUSTERS_Y - 1));\n"
+  "  int z = min(int(slice), CLUSTERS_Z - 1);\n"
+  "  return (z * CLUSTERS_Y + tile.y) * CLUSTERS_X + tile.x;\n"
+  "}\n"
+  "void main() {\n"
+  "  vec3 normal = normalize(eye_normal);\n"
+  "  vec3 a = ambient.rgb * instance_tint.rgb;\n"
+  "  vec3 d = diffuse.rgb * instance_tint.rgb;\n"
+  "  vec3 s = specular.rgb * instance_tint.rgb;\n"
+  "  vec3 color = vec3(0.0);\n"
+  "  if (light_count.y != 0) {\n"
+  "    uvec2 record =\n"
+  "      texelFetch(cluster_records, find_cluster(eye_position)).xy;\n"
+  "    for (uint i = record.x; i < record.x + record.y; ++i) {\n"
+  "      int index = int(texelFetch(cluster_indices, int(i)).x);\n"
+  "      color += shade(fetch_light(index), normal, a, d, s);\n"
+  "    }\n"
+  "  } else {\n"
+  "    for (int i = 0; i < light_count.x; ++i)\n"
+  "      color += shade(lights[i], normal, a, d, s);\n"
+  "  }\n"
+  "  fragment = clamp(\n"
+  "    vec4(color, diffuse.a * instance_tint.a), vec4(0.0), vec4(1.0));\n"
+  "  if (textured.x != 0)\n"
+  "    fragment *= texture(diffuse_texture, texture_uv);\n"
+  "}\n";
+
+// the vertex color defaults to white, only the debug draw batches set it.
+static const char* unlit_vertex_shader =
+  "in vec3 position;\n"
+  "in vec2 uv;\n"
+  "in vec4 vertex_color;\n"
+  "out vec2 texture_uv;\n"
+  "out vec4 color_factor;\n"
+  "void main() {\n"
+  "  texture_uv = uv;\n"
+  "  color_factor = vertex_color;\n"
+  "  gl_Position = projection * (modelview * vec4(position, 1.0));\n"
+  "}\n";
+
+static const char* unlit_fragment_shader =
+  "in vec2 texture_uv;\n"
+  "in vec4 color_factor;\n"
+  "out vec4 fragment;\n"
+  "void main() {\n"
+  "  fragment = color * color_factor;\n"
+  "  if (textured.x != 0)\n"
+  "    fragment *= texture(diffuse_texture, texture_uv);\n"
+  "}\n";
+
+static
+void
+set_identity(float* m)
+{
+  memset(m, 0, sizeof(float) * 16);
+  m[0] = m[5] = m[10] = m[15] = 1.f;
+}
+
+static
+void
+get_modelview(pipeline_t* pipeline, float* modelview)
+{
+  matrix4f top;
+
+  if (!pipeline) {
+    set_identity(modelview);
+    return;
+  }
+
+  set_matrix_mode(pipeline, MODELVIEW);
+  top = get_matrix(pipeline);
+  memcpy(modelview, top.data, sizeof(float) * 16);
+}
+
+static
+GLuint
+compile_shader(GLenum type, const char* source)
+{
+  const char* sources[2] = { shader_header, source };
+  GLint compiled = 0;
+  GLuint shader = glCreateShader(type);
+
+  glShaderSource(shader, 2, sources, NULL);
+  glCompileShader(shader);
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if (!compiled) {
+    glDeleteShader(shader);
+    return 0;
+  }
+
+  return shader;
+}
+
+/// @brief links the program with the shared attribute locations and block
+/// bindings, 0 on failure.
+static
+GLuint
+build_program(const char* vertex_source, const char* fragment_source)
+{
+  GLint linked = 0;
+  GLuint block;
+  GLuint program = 0;
+  GLuint vertex = compile_shader(GL_VERTEX_SHADER, vertex_source);
+  GLuint fragment = compile_shader(GL_FRAGMENT_SHADER, fragment_source);
+
+  if (vertex && fragment) {
+    program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glBindAttribLocation(program, ATTRIBUTE_POSITION, "position");
+    glBindAttribLocation(program, ATTRIBUTE_NORMAL, "normal");
+    glBindAttribLocation(program, ATTRIBUTE_UV, "uv");
+    glBindAttribLocation(program, ATTRIBUTE_INSTANCE, "instance_rows");
+    glBindAttribLocation(program, ATTRIBUTE_TINT, "tint");
+    glBindAttribLocation(program, ATTRIBUTE_COLOR, "vertex_color");
+    glLinkProgram(program);
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  }
+
+  // the program keeps them alive until it is deleted.
+  if (vertex)
+    glDeleteShader(vertex);
+  if (fragment)
+    glDeleteShader(fragment);
+
+  if (!linked) {
+    if (program)
+      glDeleteProgram(program);
+    return 0;
+  }
+
+  glUseProgram(program);
+  glUniform1i(glGetUniformLocation(program, "diffuse_texture"), 0);
+  glUniform1i(
+    glGetUniformLocation(program, "cluster_lights"), UNIT_CLUSTER_LIGHTS);
+  glUniform1i(
+    glGetUniformLocation(program, "cluster_records"), UNIT_CLUSTER_RECORDS);
+  glUniform1i(
+    glGetUniformLocation(program, "cluster_indices"), UNIT_CLUSTER_INDICES);
+  block = glGetUniformBlockIndex(program, "draw_block");
+  if (block != GL_INVALID_INDEX)
+    glUniformBlockBinding(program, block, BINDING_DRAW);
+  block = glGetUniformBlockIndex(program, "light_block");
+  if (block != GL_INVALID_INDEX)
+    glUniformBlockBinding(program, block, BINDING_LIGHTS);
+  return program;
+}
+
+static
+void
+create_stream(core_stream_t* stream, GLenum target, uint32_t size)
+{
+  glGenBuffers(1, &stream->buffer);
+  glBindBuffer(target, stream->buffer);
+  glBufferData(target, (renderer_glsizeiptr_t)size, NULL, GL_STREAM_DRAW);
+  stream->size = size;
+  stream->offset = 0;
+}
+
+/// @brief maps @a size bytes of the stream at an @a alignment multiple and
+/// stores their offset in @a offset. the buffer is unsynchronized, a range is
+/// never written twice before the buffer is orphaned.
+static
+void*
+map_stream(
+  core_stream_t* stream,
+  uint32_t size,
+  uint32_t alignment,
+  uint32_t* offset)
+{
+  uint32_t start = (stream->offset + alignment - 1) / alignment * alignment;
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, stream->buffer);
+  if (start + size > stream->size) {
+    while (stream->size < size)
+      stream->size *= 2;
+    glBufferData(
+      GL_COPY_WRITE_BUFFER,
+      (renderer_glsizeiptr_t)stream->size,
+      NULL,
+      GL_STREAM_DRAW);
+    start = 0;
+  }
+
+  *offset = start;
+  stream->offset = start + size;
+  stats_count_upload(size);
+  return glMapBufferRange(
+    GL_COPY_WRITE_BUFFER,
+    (renderer_glintptr_t)start,
+    (renderer_glsizeiptr_t)size,
+    GL_MAP_WRITE_BIT |
+    GL_MAP_INVALIDATE_RANGE_BIT |
+    GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+static
+void
+unmap_stream(void)
+{
+  glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+}
+
+static
+uint32_t
+write_stream(
+  core_stream_t* stream,
+  const void* data,
+  uint32_t size,
+  uint32_t alignment)
+{
+  uint32_t offset;
+  void* target = map_stream(stream, size, alignment, &offset);
+  if (target) {
+    memcpy(target, data, size);
+    unmap_stream();
+  }
+  return offset;
+}
+
+static
+void
+use_program(GLuint program)
+{
+  if (core.program != program) {
+    core.program = program;
+    glUseProgram(program);
+  }
+}
+
+static
+void
+bind_vertex_array(GLuint vertex_array)
+{
+  if (core.vertex_array != vertex_array) {
+    core.vertex_array = vertex_array;
+    glBindVertexArray(vertex_array);
+  }
+}
+
+/// @brief values read by the disabled instance and color arrays, the current
+/// values are undefined after a draw that sourced them from an array.
+static
+void
+set_array_defaults(void)
+{
+  float identity[16], white[4] = { 1.f, 1.f, 1.f, 1.f };
+  set_identity(identity);
+  for (uint32_t row = 0; row < 4; ++row)
+    glVertexAttrib4fv(ATTRIBUTE_INSTANCE + row, identity + row * 4);
+  glVertexAttrib4fv(ATTRIBUTE_TINT, white);
+  glVertexAttrib4fv(ATTRIBUTE_COLOR, white);
+}
+
+/// @brief enables the arrays in @a mask on the stream vertex array, the
+/// disabled ones read their current value.
+static
+void
+set_stream_arrays(uint32_t mask)
+{
+  uint32_t changed = core.stream_arrays ^ mask;
+  bind_vertex_array(core.stream_vertex_array);
+
+  for (uint32_t i = 0; i < ATTRIBUTE_COUNT; ++i) {
+    if (!(changed & ARRAY_BIT(i)))
+      continue;
+    if (mask & ARRAY_BIT(i))
+      glEnableVertexAttribArray(i);
+    else
+      glDisableVertexAttribArray(i);
+  }
+
+  if (changed & core.stream_arrays & DEFAULTED_ARRAYS)
+    set_array_defaults();
+  core.stream_arrays = mask;
+}
+
+/// @brief offset in the vertex stream, the stream is bound to
+/// GL_ARRAY_BUFFER.
+static
+void
+set_stream_pointer(
+  GLuint attribute,
+  GLint size,
+  uint32_t stride,
+  uint32_t offset)
+{
+  state_bind_buffer(GL_ARRAY_BUFFER, core.vertices.buffer);
+  glVertexAttribPointer(
+    attribute,
+    size,
+    GL_FLOAT,
+    GL_FALSE,
+    (GLsizei)stride,
+    (const void*)(uintptr_t)offset);
+}
+
+/// @brief the color array, 4 normalized bytes per vertex.
+static
+void
+set_stream_color_pointer(uint32_t stride, uint32_t offset)
+{
+  state_bind_buffer(GL_ARRAY_BUFFER, core.vertices.buffer);
+  glVertexAttribPointer(
+    ATTRIBUTE_COLOR,
+    4,
+    GL_UNSIGNED_BYTE,
+    GL_TRUE,
+    (GLsizei)stride,
+    (const void*)(uintptr_t)offset);
+}
+
+static
+void
+init_draw_block(core_draw_block_t* block, pipeline_t* pipeline)
+{
+  memset(block, 0, sizeof(core_draw_block_t));
+  memcpy(block->projection, core.projection, sizeof(core.projection));
+  get_modelview(pipeline, block->modelview);
+}
+
+static
+void
+bind_draw_block(const core_draw_block_t* block)
+{
+  uint32_t offset = write_stream(
+    &core.uniforms, block, sizeof(core_draw_block_t), core.uniform_alignment);
+  glBindBufferRange(
+    GL_UNIFORM_BUFFER,
+    BINDING_DRAW,
+    core.uniforms.buffer,
+    (renderer_glintptr_t)offset,
+    (renderer_glsizeiptr_t)sizeof(core_draw_block_t));
+}
+
+static
+void
+upload_cluster_buffer(uint32_t index, const void* data, uint32_t size)
+{
+  glBindBuffer(GL_COPY_WRITE_BUFFER, core.cluster_buffers[index]);
+  glBufferData(
+    GL_COPY_WRITE_BUFFER, (renderer_glsizeiptr_t)size, data, GL_STREAM_DRAW);
+  stats_count_upload(size);
+}
+
+/// @brief uploads the clustered lights once per light_clusters_set.
+static
+void
+update_clusters(void)
+{
+  if (core.cluster_version == light_clusters.version)
+    return;
+
+  core.cluster_version = light_clusters.version;
+  core.lights_dirty = 1;
+  lights_block.count[1] = light_clusters.light_count != 0;
+  if (!light_clusters.light_count)
+    return;
+
+  lights_block.clusters[0] = light_clusters.near_plane;
+  lights_block.clusters[1] = light_clusters.depth_scale;
+  lights_block.clusters[2] = (float)light_clusters.perspective;
+  memcpy(
+    lights_block.cluster_projection,
+    light_clusters.projection,
+    sizeof(lights_block.cluster_projection));
+  upload_cluster_buffer(
+    0,
+    light_clusters.lights,
+    (uint32_t)sizeof(eye_light_t) * light_clusters.light_count);
+  upload_cluster_buffer(
+    1, light_clusters.records, (uint32_t)sizeof(light_clusters.records));
+  upload_cluster_buffer(
+    2,
+    light_clusters.indices,
+    (uint32_t)sizeof(uint16_t) * light_clusters.index_count);
+}
+
+/// @brief the enabled lights are packed at the front of the block.
+static
+void
+update_lights(void)
+{
+  uint32_t count = 0;
+  update_clusters();
+  if (!core.lights_dirty)
+    return;
+
+  for (uint32_t i = 0; i < RENDERER_CORE_LIGHT_COUNT; ++i) {
+    if (core.light_enabled[i])
+      lights_block.lights[count++] = core.lights[i];
+  }
+
+  lights_block.count[0] = (int32_t)count;
+  glBindBuffer(GL_UNIFORM_BUFFER, core.lights_buffer);
+  glBufferSubData(
+    GL_UNIFORM_BUFFER,
+    0,
+    (renderer_glsizeiptr_t)(
+      offsetof(core_lights_block_t, lights) + sizeof(eye_light_t) * count),
+    &lights_block);
+  core.lights_dirty = 0;
+}
+
+static
+void
+set_unlit_program(void)
+{
+  use_program(core.unlit_program);
+  state_disable(GL_BLEND);
+  state_set(GL_DEPTH_TEST, core.depth_test);
+  state_enable(GL_CULL_FACE);
+}
+
+static
+void
+set_lit_program(void)
+{
+  use_program(core.lit_program);
+  update_lights();
+  state_set(GL_DEPTH_TEST, core.depth_test);
+  state_enable(GL_CULL_FACE);
+}
+
+static
+void
+set_texture(core_draw_block_t* block, uint32_t texture_id)
+{
+  block->textured[0] = texture_id != 0;
+  if (texture_id) {
+    state_bind_texture(texture_id);
+    texture_cache_touch(texture_id);
+  }
+}
+
+/// @brief blends if any of the colors is translucent, @a tints can be NULL.
+static
+void
+set_material(
+  core_draw_block_t* block,
+  const color_t* ambient,
+  const color_t* diffuse,
+  const color_t* specular,
+  const color_t* tints,
+  uint32_t tint_count)
+{
+  int32_t blend =
+    ambient->data[3] < 1.f ||
+    diffuse->data[3] < 1.f ||
+    specular->data[3] < 1.f;
+
+  for (uint32_t i = 0; tints && !blend && i < tint_count; ++i)
+    blend = tints[i].data[3] < 1.f;
+
+  state_set(GL_BLEND, blend);
+  if (blend)
+    state_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  memcpy(block->ambient, ambient->data, sizeof(block->ambient));
+  memcpy(block->diffuse, diffuse->data, sizeof(block->diffuse));
+  memcpy(block->specular, specular->data, sizeof(block->specular));
+}
+
+/// @brief streams the positions (3 floats every @a stride floats) and points
+/// the position array at them.
+static
+void
+stream_positions(const float* positions, uint32_t stride, uint32_t count)
+{
+  uint32_t offset = write_stream(
+    &core.vertices,
+    positions,
+    (uint32_t)(sizeof(float) * ((count - 1) * stride + 3)),
+    sizeof(float));
+  set_stream_pointer(
+    ATTRIBUTE_POSITION, 3, (uint32_t)sizeof(float) * stride, offset);
+}
+
+/// @brief copies @a size bytes to @a target and returns the end of the copy.
+static
+uint8_t*
+copy_bytes(uint8_t* target, const void* source, uint32_t size)
+{
+  memcpy(target, source, size);
+  return target + size;
+}
+
+/// @brief streams the vertex arrays of @a mesh, followed by the per instance
+/// matrices and @a tints when given, and points the stream vertex array at
+/// them. everything goes through a single map, the stream can only be
+/// orphaned before the first array is written. returns the offset of the
+/// streamed indices.
+static
+uint32_t
+stream_mesh(
+  const mesh_render_data_t* mesh,
+  const matrix4f* instances,
+  const color_t* tints,
+  uint32_t instance_count)
+{
+  uint32_t offset;
+  uint32_t count = mesh->vertex_count;
+  uint32_t array_size = (uint32_t)sizeof(float) * 3 * count;
+  uint32_t vertices_size = mesh->interleaved ?
+    (uint32_t)sizeof(renderer_vertex_t) * count : array_size * 3;
+  uint32_t instances_size =
+    instances ? (uint32_t)sizeof(matrix4f) * instance_count : 0;
+  uint32_t tints_size = tints ? (uint32_t)sizeof(color_t) * instance_count : 0;
+  uint8_t* target = map_stream(
+    &core.vertices,
+    vertices_size + instances_size + tints_size,
+    sizeof(float),
+    &offset);
+
+  if (target) {
+    if (mesh->interleaved) {
+      target = copy_bytes(target, mesh->interleaved, vertices_size);
+    } else {
+      target = copy_bytes(target, mesh->vertices, array_size);
+      target = copy_bytes(target, mesh->normals, array_size);
+      target = copy_bytes(target, mesh->uv_coords, array_size);
+    }
+    if (instances)
+      target = copy_bytes(target, instances, instances_size);
+    if (tints)
+      copy_bytes(target, tints, tints_size);
+    unmap_stream();
+  }
+
+  if (mesh->interleaved) {
+    uint32_t stride = sizeof(renderer_vertex_t);
+    set_stream_pointer(ATTRIBUTE_POSITION, 3, stride, offset);
+    set_stream_pointer(
+      ATTRIBUTE_NORMAL,
+      3,
+      stride,
+      offset + (uint32_t)offsetof(renderer_vertex_t, normal));
+    set_stream_pointer(
+      ATTRIBUTE_UV,
+      2,
+      stride,
+      offset + (uint32_t)offsetof(renderer_vertex_t, uv));
+  } else {
+    set_stream_pointer(ATTRIBUTE_POSITION, 3, 0, offset);
+    set_stream_pointer(ATTRIBUTE_NORMAL, 3, 0, offset + array_size);
+    set_stream_pointer(
+      ATTRIBUTE_UV, 2, sizeof(float) * 3, offset + array_size * 2);
+  }
+  offset += vertices_size;
+
+  // the rows of the row major matrices.
+  for (uint32_t row = 0; instances && row < 4; ++row)
+    set_stream_pointer(
+      ATTRIBUTE_INSTANCE + row,
+      4,
+      sizeof(matrix4f),
+      offset + (uint32_t)sizeof(float) * 4 * row);
+  offset += instances_size;
+
+  if (tints)
+    set_stream_pointer(ATTRIBUTE_TINT, 4, sizeof(color_t), offset);
+
+  return write_stream(
+    &core.indices,
+    mesh->indices,
+    (uint32_t)sizeof(uint32_t) * mesh->indices_count,
+    sizeof(uint32_t));
+}
+
+static
+int32_t
+is_drawable(const mesh_render_data_t* mesh)
+{
+  return mesh->vertex_count && mesh->indices_count;
+}
+
+static
+void
+core_cleanup(void)
+{
+  for (uint32_t i = 0; i < core.meshes_capacity; ++i) {
+    if (core.meshes[i].vertex_array)
+      evict_mesh(i + 1);
+  }
+
+  glBindVertexArray(0);
+  glUseProgram(0);
+  state_bind_texture(0);
+  state_forget_buffer(core.vertices.buffer);
+  if (core.grid_buffer) {
+    state_forget_buffer(core.grid_buffer);
+    glDeleteBuffers(1, &core.grid_buffer);
+  }
+  if (core.quad_buffer)
+    glDeleteBuffers(1, &core.quad_buffer);
+  glDeleteVertexArrays(1, &core.stream_vertex_array);
+  glDeleteBuffers(1, &core.vertices.buffer);
+  glDeleteBuffers(1, &core.indices.buffer);
+  glDeleteBuffers(1, &core.uniforms.buffer);
+  glDeleteBuffers(1, &core.lights_buffer);
+  glDeleteTextures(CLUSTER_BUFFER_COUNT, core.cluster_textures);
+  glDeleteBuffers(CLUSTER_BUFFER_COUNT, core.cluster_buffers);
+  glDeleteProgram(core.lit_program);
+  glDeleteProgram(core.unlit_program);
+  free(core.meshes);
+
+  frame_pacing_cleanup();
+  texture_streaming_cleanup();
+  jobs_cleanup();
+  memset(&core, 0, sizeof(core_state_t));
+}
+
+static
+void
+core_set_depth_test(int32_t enable)
+{
+  core.depth_test = enable;
+}
+
+static
+void
+core_clear_color_and_depth_buffers(void)
+{
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+static
+void
+core_flush_operations(void)
+{
+  frame_pacing_end_frame();
+}
+
+static
+void
+core_update_viewport(const pipeline_t* pipeline)
+{
+  float x, y, width, height;
+  get_viewport_info(pipeline, &x, &y, &width, &height);
+  state_viewport((GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height);
+}
+
+static
+void
+core_update_projection(const pipeline_t* pipeline)
+{
+  renderer_internal_get_projection_matrix(pipeline, core.projection);
+}
+
+static
+void
+core_set_light(uint32_t index, int32_t enable)
+{
+  assert(index < RENDERER_CORE_LIGHT_COUNT);
+  core.light_enabled[index] = enable;
+  core.lights_dirty = 1;
+}
+
+static
+void
+core_set_light_properties(
+  uint32_t index,
+  renderer_light_t* light,
+  pipeline_t* pipeline)
+{
+  float m[16];
+  assert(index < RENDERER_CORE_LIGHT_COUNT);
+
+  get_modelview(pipeline, m);
+  eye_light_set(core.lights + index, light, m);
+  core.lights_dirty = 1;
+}
+
+static
+void
+draw_unlit_positions(
+  GLenum mode,
+  const float* positions,
+  uint32_t stride,
+  uint32_t count,
+  color_t color,
+  pipeline_t* pipeline)
+{
+  core_draw_block_t block;
+
+  init_draw_block(&block, pipeline);
+  memcpy(block.color, color.data, sizeof(block.color));
+  set_unlit_program();
+  bind_draw_block(&block);
+  set_stream_arrays(ARRAY_BIT(ATTRIBUTE_POSITION));
+  stream_positions(positions, stride, count);
+  glDrawArrays(mode, 0, (GLsizei)count);
+  stats_count_draw(count, 0);
+}
+
+/// @brief (re)builds the grid buffer, only when the parameters change.
+static
+int32_t
+update_grid_buffer(float width, int32_t lines_per_axis)
+{
+  float half = width / 2;
+  float step = width / lines_per_axis;
+  uint32_t count = (uint32_t)(lines_per_axis + 1) * 4;
+  float* vertices = NULL;
+
+  if (
+    core.grid_buffer &&
+    core.grid_width == width &&
+    core.grid_lines_per_axis == lines_per_axis)
+    return 1;
+
+  vertices = malloc(sizeof(float) * 3 * count);
+  if (!vertices)
+    return 0;
+
+  for (int32_t i = 0; i <= lines_per_axis; ++i) {
+    float offset = -half + step * i;
+    float line[12] = {
+      -half, 0, offset,
+      half, 0, offset,
+      offset, 0, -half,
+      offset, 0, half };
+    memcpy(vertices + i * 12, line, sizeof(line));
+  }
+
+  if (!core.grid_buffer)
+    glGenBuffers(1, &core.grid_buffer);
+  state_bind_buffer(GL_ARRAY_BUFFER, core.grid_buffer);
+  glBufferData(
+    GL_ARRAY_BUFFER,
+    (renderer_glsizeiptr_t)(sizeof(float) * 3 * count),
+    vertices,
+    GL_STATIC_DRAW);
+  stats_count_upload(sizeof(float) * 3 * count);
+  free(vertices);
+
+  core.grid_width = width;
+  core.grid_lines_per_axis = lines_per_axis;
+  return 1;
+}
+
+static
+void
+core_draw_grid(
+  pipeline_t* pipeline,
+  float width,
+  int32_t lines_per_axis)
+{
+  color_t black = { { 0.f, 0.f, 0.f, 1.f } };
+  uint32_t count = (uint32_t)(lines_per_axis + 1) * 4;
+  core_draw_block_t block;
+
+  if (lines_per_axis <= 0 || !update_grid_buffer(width, lines_per_axis))
+    return;
+
+  init_draw_block(&block, pipeline);
+  memcpy(block.color, black.data, sizeof(block.color));
+  set_unlit_program();
+  bind_draw_block(&block);
+  set_stream_arrays(ARRAY_BIT(ATTRIBUTE_POSITION));
+
+  // the stream vertex array sources the positions from the grid buffer.
+  state_bind_buffer(GL_ARRAY_BUFFER, core.grid_buffer);
+  glVertexAttribPointer(
+    ATTRIBUTE_POSITION, 3, GL_FLOAT, GL_FALSE, 0, (const void*)0);
+  glDrawArrays(GL_LINES, 0, (GLsizei)count);
+  stats_count_draw(count, 0);
+}
+
+static
+void
+core_draw_points(
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float size,
+  pipeline_t* pipeline)
+{
+  if (!vertices_count)
+    return;
+
+  state_point_size(size);
+  draw_unlit_positions(
+    GL_POINTS, vertices, 3, vertices_count, color, pipeline);
+}
+
+static
+void
+core_draw_lines(
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float width,
+  pipeline_t* pipeline)
+{
+  if (vertices_count < 2)
+    return;
+
+  state_line_width(width);
+  draw_unlit_positions(
+    GL_LINE_STRIP, vertices, 3, vertices_count, color, pipeline);
+}
+
+/// @brief the vertices are in view space. the segments are expanded into the
+/// stream, each batch is a single draw whatever its size.
+static
+void
+core_draw_debug_batch(
+  GLenum mode,
+  const debug_vertex_t* vertices,
+  uint32_t vertices_count,
+  const uint32_t* indices,
+  uint32_t indices_count,
+  float width)
+{
+  color_t white = { { 1.f, 1.f, 1.f, 1.f } };
+  uint32_t stride = (uint32_t)sizeof(debug_vertex_t);
+  uint32_t count = mode == GL_LINES ? indices_count : vertices_count;
+  uint32_t vertex_offset;
+  debug_vertex_t* target = NULL;
+  core_draw_block_t block;
+
+  if (!count)
+    return;
+
+  init_draw_block(&block, NULL);
+  memcpy(block.color, white.data, sizeof(block.color));
+  set_unlit_program();
+  bind_draw_block(&block);
+  set_stream_arrays(
+    ARRAY_BIT(ATTRIBUTE_POSITION) | ARRAY_BIT(ATTRIBUTE_COLOR));
+
+  target = map_stream(&core.vertices, stride * count, stride, &vertex_offset);
+  if (!target)
+    return;
+  if (mode == GL_LINES) {
+    for (uint32_t i = 0; i < count; ++i)
+      target[i] = vertices[indices[i]];
+  } else {
+    memcpy(target, vertices, stride * count);
+  }
+  unmap_stream();
+
+  if (mode == GL_LINES)
+    state_line_width(width);
+  else
+    state_point_size(width);
+  set_stream_pointer(ATTRIBUTE_POSITION, 3, stride, vertex_offset);
+  set_stream_color_pointer(
+    stride, vertex_offset + (uint32_t)offsetof(debug_vertex_t, color));
+  glDrawArrays(mode, 0, (GLsizei)count);
+  stats_count_draw(count, 0);
+}
+
+/// @brief grows the quad index buffer to at least @a count quads.
+static
+int32_t
+reserve_quad_indices(uint32_t count)
+{
+  uint32_t capacity = core.quad_capacity ? core.quad_capacity : 256;
+  uint32_t* indices = NULL;
+
+  if (count <= core.quad_capacity)
+    return 1;
+
+  while (capacity < count)
+    capacity *= 2;
+
+  indices = malloc(sizeof(uint32_t) * UNIT_QUAD_INDICES * capacity);
+  if (!indices)
+    return 0;
+  build_unit_quad_indices(indices, 0, capacity);
+
+  if (!core.quad_buffer)
+    glGenBuffers(1, &core.quad_buffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, core.quad_buffer);
+  glBufferData(
+    GL_COPY_WRITE_BUFFER,
+    (renderer_glsizeiptr_t)(sizeof(uint32_t) * UNIT_QUAD_INDICES * capacity),
+    indices,
+    GL_STATIC_DRAW);
+  stats_count_upload(sizeof(uint32_t) * UNIT_QUAD_INDICES * capacity);
+  free(indices);
+
+  core.quad_capacity = capacity;
+  return 1;
+}
+
+/// @brief the quads are expanded straight into the vertex stream, the indices
+/// come from the shared pattern.
+static
+void
+core_draw_unit_quads(
+  const unit_quad_t* uvs,
+  uint32_t uvs_count,
+  int32_t texture_id,
+  color_t tint,
+  pipeline_t* pipeline)
+{
+  uint32_t vertex_count = uvs_count * UNIT_QUAD_VERTICES;
+  uint32_t index_count = uvs_count * UNIT_QUAD_INDICES;
+  uint32_t vertex_offset;
+  float* vertices = NULL;
+  core_draw_block_t block;
+
+  if (!uvs_count || !reserve_quad_indices(uvs_count))
+    return;
+
+  init_draw_block(&block, pipeline);
+  memcpy(block.color, tint.data, sizeof(block.color));
+  set_texture(&block, (uint32_t)texture_id);
+  use_program(core.unlit_program);
+  state_disable(GL_CULL_FACE);
+  state_disable(GL_DEPTH_TEST);
+  state_enable(GL_BLEND);
+  state_blend_func(GL_SRC_COLOR, GL_ONE_MINUS_SRC_COLOR);
+  bind_draw_block(&block);
+  set_stream_arrays(ARRAY_BIT(ATTRIBUTE_POSITION) | ARRAY_BIT(ATTRIBUTE_UV));
+
+  vertices = map_stream(
+    &core.vertices, sizeof(float) * 5 * vertex_count, sizeof(float),
+    &vertex_offset);
+  if (!vertices)
+    return;
+  expand_unit_quads(uvs, uvs_count, vertices, vertices + vertex_count * 3);
+  unmap_stream();
+
+  set_stream_pointer(ATTRIBUTE_POSITION, 3, 0, vertex_offset);
+  set_stream_pointer(
+    ATTRIBUTE_UV,
+    2,
+    0,
+    vertex_offset + (uint32_t)sizeof(float) * 3 * vertex_count);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, core.quad_buffer);
+  glDrawElements(
+    GL_TRIANGLES, (GLsizei)index_count, GL_UNSIGNED_INT, (const void*)0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, core.indices.buffer);
+  stats_count_draw(index_count, index_count / 3);
+}
+
+/// @brief the triangles are rasterized as lines, every edge is drawn as in
+/// the opengl path (shared ones twice).
+static
+void
+core_draw_meshes_wireframe(
+  const mesh_render_data_t* mesh,
+  uint32_t mesh_count,
+  color_t color,
+  float width,
+  pipeline_t* pipeline)
+{
+  core_draw_block_t block;
+
+  init_draw_block(&block, pipeline);
+  memcpy(block.color, color.data, sizeof(block.color));
+  set_unlit_program();
+  state_disable(GL_CULL_FACE);
+  state_line_width(width);
+  bind_draw_block(&block);
+  set_stream_arrays(ARRAY_BIT(ATTRIBUTE_POSITION));
+  glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+  for (uint32_t i = 0; i < mesh_count; ++i) {
+    uint32_t offset;
+    if (!is_drawable(mesh + i))
+      continue;
+
+    if (mesh[i].interleaved)
+      stream_positions(
+        mesh[i].interleaved->position,
+        sizeof(renderer_vertex_t) / sizeof(float),
+        mesh[i].vertex_count);
+    else
+      stream_positions(mesh[i].vertices, 3, mesh[i].vertex_count);
+
+    offset = write_stream(
+      &core.indices,
+      mesh[i].indices,
+      (uint32_t)sizeof(uint32_t) * mesh[i].indices_count,
+      sizeof(uint32_t));
+    glDrawElements(
+      GL_TRIANGLES,
+      (GLsizei)mesh[i].indices_count,
+      GL_UNSIGNED_INT,
+      (const void*)(uintptr_t)offset);
+    stats_count_draw(mesh[i].indices_count, 0);
+  }
+
+  glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+}
+
+static
+void
+core_draw_meshes(
+  const mesh_render_data_t* mesh,
+  const uint32_t* texture_data,
+  uint32_t mesh_count,
+  pipeline_t* pipeline)
+{
+  core_draw_block_t block;
+
+  init_draw_block(&block, pipeline);
+  set_lit_program();
+  set_stream_arrays(MESH_ARRAYS);
+
+  for (uint32_t i = 0; i < mesh_count; ++i) {
+    uint32_t offset;
+    if (!is_drawable(mesh + i))
+      continue;
+
+    set_material(
+      &block, &mesh[i].ambient, &mesh[i].diffuse, &mesh[i].specular,
+      NULL, 0);
+    set_texture(&block, texture_data[i]);
+    bind_draw_block(&block);
+    offset = stream_mesh(mesh + i, NULL, NULL, 0);
+    glDrawElements(
+      GL_TRIANGLES,
+      (GLsizei)mesh[i].indices_count,
+      GL_UNSIGNED_INT,
+      (const void*)(uintptr_t)offset);
+    stats_count_draw(mesh[i].indices_count, mesh[i].indices_count / 3);
+  }
+}
+
+/// @brief one draw, the matrices and tints are per instance arrays.
+static
+void
+core_draw_meshes_instanced(
+  const mesh_render_data_t* mesh,
+  uint32_t texture_id,
+  const matrix4f* instances,
+  const color_t* tints,
+  uint32_t instance_count,
+  pipeline_t* pipeline)
+{
+  uint32_t index_offset;
+  uint32_t arrays = MESH_ARRAYS | MATRIX_ARRAYS;
+  core_draw_block_t block;
+
+  if (!instance_count || !is_drawable(mesh))
+    return;
+
+  init_draw_block(&block, pipeline);
+  set_lit_program();
+  set_material(
+    &block, &mesh->ambient, &mesh->diffuse, &mesh->specular,
+    tints, instance_count);
+  set_texture(&block, texture_id);
+  bind_draw_block(&block);
+
+  if (tints)
+    arrays |= ARRAY_BIT(ATTRIBUTE_TINT);
+  set_stream_arrays(arrays);
+  index_offset = stream_mesh(mesh, instances, tints, instance_count);
+
+  glDrawElementsInstanced(
+    GL_TRIANGLES,
+    (GLsizei)mesh->indices_count,
+    GL_UNSIGNED_INT,
+    (const void*)(uintptr_t)index_offset,
+    (GLsizei)instance_count);
+  stats_count_draw(
+    (uint64_t)mesh->indices_count * instance_count,
+    (uint64_t)mesh->indices_count / 3 * instance_count);
+}
+
+static
+uint32_t
+allocate_mesh(void)
+{
+  uint32_t index;
+
+  if (!core.meshes_free) {
+    uint32_t capacity = core.meshes_capacity ? core.meshes_capacity * 2 : 64;
+    core_mesh_t* meshes = realloc(core.meshes, sizeof(core_mesh_t) * capacity);
+    if (!meshes)
+      return 0;
+
+    // chain the new slots into the free list.
+    memset(
+      meshes + core.meshes_capacity,
+      0,
+      sizeof(core_mesh_t) * (capacity - core.meshes_capacity));
+    for (uint32_t i = core.meshes_capacity; i < capacity - 1; ++i)
+      meshes[i].next_free = i + 2;
+
+    core.meshes_free = core.meshes_capacity + 1;
+    core.meshes = meshes;
+    core.meshes_capacity = capacity;
+  }
+
+  index = core.meshes_free - 1;
+  core.meshes_free = core.meshes[index].next_free;
+  core.meshes[index].next_free = 0;
+  return index + 1;
+}
+
+/// @brief the vertex array of a resident mesh keeps its buffers and arrays,
+/// drawing it is a single bind.
+static
+uint32_t
+core_upload_mesh(const mesh_render_data_t* mesh)
+{
+  uint32_t handle = 0;
+  uint32_t stride = sizeof(renderer_vertex_t);
+  core_mesh_t* target = NULL;
+  renderer_vertex_t* vertices = mesh->interleaved;
+
+  if (!is_drawable(mesh))
+    return 0;
+
+  if (!vertices) {
+    vertices = malloc(sizeof(renderer_vertex_t) * mesh->vertex_count);
+    if (!vertices)
+      return 0;
+    interleave_mesh_vertices(mesh, vertices);
+  }
+
+  handle = allocate_mesh();
+  if (handle) {
+    target = core.meshes + handle - 1;
+    target->vertex_count = mesh->vertex_count;
+    target->indices_count = mesh->indices_count;
+    target->ambient = mesh->ambient;
+    target->diffuse = mesh->diffuse;
+    target->specular = mesh->specular;
+
+    glGenVertexArrays(1, &target->vertex_array);
+    bind_vertex_array(target->vertex_array);
+    glGenBuffers(1, &target->vertex_buffer);
+    state_bind_buffer(GL_ARRAY_BUFFER, target->vertex_buffer);
+    glBufferData(
+      GL_ARRAY_BUFFER,
+      (renderer_glsizeiptr_t)(stride * mesh->vertex_count),
+      vertices,
+      GL_STATIC_DRAW);
+
+    // the element array binding is part of the vertex array.
+    glGenBuffers(1, &target->index_buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, target->index_buffer);
+    glBufferData(
+      GL_ELEMENT_ARRAY_BUFFER,
+      (renderer_glsizeiptr_t)(sizeof(uint32_t) * mesh->indices_count),
+      mesh->indices,
+      GL_STATIC_DRAW);
+
+    glVertexAttribPointer(
+      ATTRIBUTE_POSITION, 3, GL_FLOAT, GL_FALSE, (GLsizei)stride,
+      (const void*)offsetof(renderer_vertex_t, position));
+    glVertexAttribPointer(
+      ATTRIBUTE_NORMAL, 3, GL_FLOAT, GL_FALSE, (GLsizei)stride,
+      (const void*)offsetof(renderer_vertex_t, normal));
+    glVertexAttribPointer(
+      ATTRIBUTE_UV, 2, GL_FLOAT, GL_FALSE, (GLsizei)stride,
+      (const void*)offsetof(renderer_vertex_t, uv));
+    glEnableVertexAttribArray(ATTRIBUTE_POSITION);
+    glEnableVertexAttribArray(ATTRIBUTE_NORMAL);
+    glEnableVertexAttribArray(ATTRIBUTE_UV);
+    stats_count_upload(
+      stride * mesh->vertex_count + sizeof(uint32_t) * mesh->indices_count);
+  }
+
+  if (vertices != mesh->interleaved)
+    free(vertices);
+
+  return handle;
+}
+
+static
+uint32_t
+core_evict_mesh(uint32_t mesh_handle)
+{
+  core_mesh_t* mesh = NULL;
+  assert(mesh_handle && mesh_handle <= core.meshes_capacity);
+
+  mesh = core.meshes + mesh_handle - 1;
+  assert(mesh->vertex_array);
+  if (core.vertex_array == mesh->vertex_array)
+    bind_vertex_array(core.stream_vertex_array);
+  state_forget_buffer(mesh->vertex_buffer);
+  glDeleteVertexArrays(1, &mesh->vertex_array);
+  glDeleteBuffers(1, &mesh->vertex_buffer);
+  glDeleteBuffers(1, &mesh->index_buffer);
+  memset(mesh, 0, sizeof(core_mesh_t));
+
+  mesh->next_free = core.meshes_free;
+  core.meshes_free = mesh_handle;
+  return mesh_handle;
+}
+
+static
+void
+core_draw_mesh_handles(
+  const uint32_t* mesh_handles,
+  const uint32_t* texture_data,
+  uint32_t mesh_count,
+  pipeline_t* pipeline)
+{
+  core_draw_block_t block;
+
+  init_draw_block(&block, pipeline);
+  set_lit_program();
+
+  for (uint32_t i = 0; i < mesh_count; ++i) {
+    const core_mesh_t* mesh = core.meshes + mesh_handles[i] - 1;
+    assert(mesh_handles[i] && mesh_handles[i] <= core.meshes_capacity);
+
+    set_material(
+      &block, &mesh->ambient, &mesh->diffuse, &mesh->specular, NULL, 0);
+    set_texture(&block, texture_data[i]);
+    bind_draw_block(&block);
+    bind_vertex_array(mesh->vertex_array);
+    glDrawElements(
+      GL_TRIANGLES,
+      (GLsizei)mesh->indices_count,
+      GL_UNSIGNED_INT,
+      (const void*)0);
+    stats_count_draw(mesh->indices_count, mesh->indices_count / 3);
+  }
+}
+
+/// @brief core contexts have no luminance or alpha formats, those are
+/// expanded to RGBA first.
+static
+uint32_t
+core_upload_to_gpu(
+  const char* path,
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  uint32_t n = 0;
+  uint8_t* texels = NULL;
+  (void)path;
+
+  if (
+    texture_compression_is_compressed(format) ||
+    format == RENDERER_OPENGL_RGBA ||
+    format == RENDERER_OPENGL_BGRA ||
+    format == RENDERER_OPENGL_RGB ||
+    format == RENDERER_OPENGL_BGR)
+    return renderer_internal_upload_texture(buffer, width, height, format);
+
+  texels = malloc((size_t)width * height * 4);
+  if (!texels)
+    return 0;
+
+  renderer_internal_convert_texels(buffer, width * height, format, texels);
+  n = renderer_internal_upload_texture(
+    texels, width, height, RENDERER_OPENGL_RGBA);
+  free(texels);
+  return n;
+}
+
+static
+uint32_t
+core_evict_from_gpu(uint32_t texture_id)
+{
+  texture_streaming_cancel(texture_id);
+  state_forget_texture(texture_id);
+  glDeleteTextures(1, &texture_id);
+  return texture_id;
+}
+
+static
+void
+core_read_pixels(
+  int32_t x,
+  int32_t y,
+  uint32_t width,
+  uint32_t height,
+  uint8_t* buffer)
+{
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(
+    x, y, (GLsizei)width, (GLsizei)height,
+    GL_RGBA, GL_UNSIGNED_BYTE, buffer);
+}
+
+static const renderer_backend_t core_backend = {
+  core_cleanup,
+  core_set_depth_test,
+  core_clear_color_and_depth_buffers,
+  core_flush_operations,
+  core_update_viewport,
+  core_update_projection,
+  core_set_light,
+  core_set_light_properties,
+  core_draw_grid,
+  core_draw_points,
+  core_draw_lines,
+  core_draw_debug_batch,
+  core_draw_unit_quads,
+  core_draw_meshes_wireframe,
+  core_draw_meshes,
+  core_draw_meshes_instanced,
+  core_upload_mesh,
+  core_evict_mesh,
+  core_draw_mesh_handles,
+  core_upload_to_gpu,
+  core_evict_from_gpu,
+  core_read_pixels,
+  1
+};
+
+/// @brief opengl defaults, every light is off and only the first is white.
+static
+void
+set_default_lights(void)
+{
+  for (uint32_t i = 0; i < RENDERER_CORE_LIGHT_COUNT; ++i)
+    eye_light_set_default(core.lights + i, i);
+  core.lights_dirty = 1;
+}
+
+/// @brief the texture buffers stay bound to their units, the texture cache
+/// only ever binds unit 0.
+static
+void
+create_cluster_buffers(void)
+{
+  const GLenum formats[CLUSTER_BUFFER_COUNT] = {
+    GL_RGBA32F, GL_RG32UI, GL_R16UI };
+
+  glGenBuffers(CLUSTER_BUFFER_COUNT, core.cluster_buffers);
+  glGenTextures(CLUSTER_BUFFER_COUNT, core.cluster_textures);
+  for (uint32_t i = 0; i < CLUSTER_BUFFER_COUNT; ++i) {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, core.cluster_buffers[i]);
+    glBufferData(GL_COPY_WRITE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+    glActiveTexture(GL_TEXTURE0 + UNIT_CLUSTER_LIGHTS + i);
+    glBindTexture(GL_TEXTURE_BUFFER, core.cluster_textures[i]);
+    glTexBuffer(GL_TEXTURE_BUFFER, formats[i], core.cluster_buffers[i]);
+  }
+  glActiveTexture(GL_TEXTURE0);
+}
+
+int32_t
+renderer_initialize_core()
+{
+  GLint alignment = 0;
+
+  renderer_backend = NULL;
+  opengl_extensions_load();
+  if (!opengl_features.core_profile)
+    return 0;
+
+  memset(&core, 0, sizeof(core_state_t));
+  core.lit_program = build_program(lit_vertex_shader, lit_fragment_shader);
+  core.unlit_program =
+    build_program(unlit_vertex_shader, unlit_fragment_shader);
+  if (!core.lit_program || !core.unlit_program) {
+    if (core.lit_program)
+      glDeleteProgram(core.lit_program);
+    if (core.unlit_program)
+      glDeleteProgram(core.unlit_program);
+    memset(&core, 0, sizeof(core_state_t));
+    return 0;
+  }
+
+  state_cache_reset();
+  mipmaps_initialize();
+  jobs_initialize(0);
+
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  core.uniform_alignment = alignment > 0 ? (uint32_t)alignment : 256;
+  core.depth_test = 1;
+  set_default_lights();
+
+  // the element array binding of the stream vertex array is the index stream,
+  // draw_unit_quads only swaps it for its draw.
+  glGenVertexArrays(1, &core.stream_vertex_array);
+  bind_vertex_array(core.stream_vertex_array);
+  create_stream(&core.vertices, GL_ARRAY_BUFFER, CORE_VERTEX_STREAM_SIZE);
+  create_stream(&core.indices, GL_ELEMENT_ARRAY_BUFFER, CORE_INDEX_STREAM_SIZE);
+  create_stream(&core.uniforms, GL_UNIFORM_BUFFER, CORE_UNIFORM_STREAM_SIZE);
+  for (uint32_t i = ATTRIBUTE_INSTANCE; i <= ATTRIBUTE_TINT; ++i)
+    glVertexAttribDivisor(i, 1);
+  set_array_defaults();
+
+  glGenBuffers(1, &core.lights_buffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, core.lights_buffer);
+  glBufferData(
+    GL_UNIFORM_BUFFER,
+    (renderer_glsizeiptr_t)sizeof(core_lights_block_t),
+    NULL,
+    GL_DYNAMIC_DRAW);
+  glBindBufferRange(
+    GL_UNIFORM_BUFFER,
+    BINDING_LIGHTS,
+    core.lights_buffer,
+    0,
+    (renderer_glsizeiptr_t)sizeof(core_lights_block_t));
+  memset(&lights_block, 0, sizeof(core_lights_block_t));
+  create_cluster_buffers();
+
+  set_identity(core.projection);
+  state_enable(GL_DEPTH_TEST);
+  state_enable(GL_CULL_FACE);
+  glCullFace(GL_BACK);
+  glClearColor(0.3f, 0.3f, 0.3f, 1);
+
+  renderer_backend = &core_backend;
+  return 1;
+}
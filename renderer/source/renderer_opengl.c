@@ -9,7 +9,74 @@
  *
  */
 #include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
 #include <renderer/renderer_opengl.h>
+#include <renderer/debug_draw.h>
+#include <renderer/render_queue.h>
+#include <renderer/texture_cache.h>
+#include <renderer/texture_compression.h>
+#include <renderer/internal/backend.h>
+#include <renderer/internal/frame_pacing.h>
+#include <renderer/internal/frame_stats.h>
+#include <renderer/internal/image_format.h>
+#include <renderer/internal/jobs.h>
+#include <renderer/internal/light_clusters.h>
+#include <renderer/internal/mipmaps.h>
+#include <renderer/internal/opengl_extensions.h>
+#include <renderer/internal/renderer_internal.h>
+#include <renderer/internal/state_cache.h>
+#include <renderer/internal/texture_streaming.h>
+#include <renderer/internal/unit_quads.h>
+
+
+// the light slots every fixed function implementation has.
+#define CLUSTERED_LIGHT_SLOTS     8
+
+typedef
+struct gpu_mesh_t {
+  GLuint vertex_buffer;     // 0 if the slot is free.
+  GLuint index_buffer;
+  uint32_t vertex_count;
+  uint32_t indices_count;
+  color_t ambient;
+  color_t diffuse;
+  color_t specular;
+  uint32_t next_free;       // index + 1 of the next free slot, 0 ends the list.
+} gpu_mesh_t;
+
+static gpu_mesh_t* gpu_meshes = NULL;
+static uint32_t gpu_meshes_capacity = 0;
+static uint32_t gpu_meshes_free = 0;
+
+// the entry points set the state they need on entry and leave it as is on exit,
+// the state cache drops the transitions that are not needed. the depth test is
+// the only one the user controls.
+static int32_t depth_test_enabled = 1;
+
+// mip levels of color textures are averaged in linear space when set.
+static int32_t gamma_correct_mipmaps = 0;
+
+// draw_grid geometry, rebuilt only when the parameters change.
+typedef
+struct grid_cache_t {
+  float width;
+  int32_t lines_per_axis;
+  float* vertices;
+  uint32_t vertex_count;
+  GLuint buffer;        // 0 if buffer objects are not supported.
+} grid_cache_t;
+
+static grid_cache_t grid_cache;
+
+// glyph scratch arrays used by draw_unit_quads, sized in quads.
+static float* quad_vertices = NULL;
+static float* quad_tex_coords = NULL;
+static uint32_t* quad_indices = NULL;
+static uint32_t quad_capacity = 0;
+
+const renderer_backend_t* renderer_backend = NULL;
 
 
 void
@@ -23,78 +90,224 @@ renderer_initialize()
   float dir2[4] = { -1.f, 1.f, -1.f, 0.f };
   float amb[4] = { 0.3f, 0.3f, 0.3f, 1.f };
 
+  renderer_backend = NULL;
+  opengl_extensions_load();
+  state_cache_reset();
+  mipmaps_initialize();
+  jobs_initialize(0);
+  depth_test_enabled = 1;
+
   glShadeModel(GL_SMOOTH);
-  glEnable(GL_DEPTH_TEST);
-  glEnable(GL_CULL_FACE);
+  state_enable(GL_DEPTH_TEST);
+  state_enable(GL_CULL_FACE);
   glCullFace(GL_BACK);
   glClearColor(0.3f, 0.3f, 0.3f, 1);
 
   // enable material colors (should be set per mesh).
-  glEnable(GL_COLOR_MATERIAL);
+  state_enable(GL_COLOR_MATERIAL);
 
   // enabling lighting, setting ambient color, etc...
-  glEnable(GL_LIGHTING);
-  glEnable(GL_NORMALIZE);
+  state_enable(GL_LIGHTING);
+  state_enable(GL_NORMALIZE);
   glLightModelfv(GL_LIGHT_MODEL_AMBIENT, vec);
 
   // setting the texture blending mode.
   glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
 
   // enabling vertex, normal and UV arrays.
-  glEnableClientState(GL_VERTEX_ARRAY);
-  glEnableClientState(GL_NORMAL_ARRAY);
-  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  state_set_client(GL_VERTEX_ARRAY, 1);
+  state_set_client(GL_NORMAL_ARRAY, 1);
+  state_set_client(GL_TEXTURE_COORD_ARRAY, 1);
+  state_set_client(GL_COLOR_ARRAY, 0);
+}
+
+void
+renderer_internal_set_unlit_state(void)
+{
+  state_disable(GL_LIGHTING);
+  state_disable(GL_TEXTURE_2D);
+  state_disable(GL_BLEND);
+  state_set(GL_DEPTH_TEST, depth_test_enabled);
+  state_enable(GL_CULL_FACE);
+  state_set_client(GL_NORMAL_ARRAY, 0);
+  state_set_client(GL_TEXTURE_COORD_ARRAY, 0);
+  state_set_client(GL_COLOR_ARRAY, 0);
+}
+
+/// @brief loads the modelview top of @a pipeline, NULL loads the identity.
+/// like the rest of the state it is left loaded on exit, the state cache skips
+/// the upload while the pipeline slot version does not change.
+static inline
+void
+set_pipeline_transform(const pipeline_t* pipeline)
+{
+  state_load_modelview(pipeline);
 }
 
-inline
+/// @brief the fixed function approximation of the clustered lights, there is
+/// no per cluster lookup: the ones strongest at the origin of the modelview
+/// take the 8 light slots for the whole draw. their eye
+/// space values go up under the identity, the modelview is loaded back after.
+static
 void
-set_pipeline_transform(pipeline_t* pipeline)
+set_clustered_light_slots(const pipeline_t* pipeline)
 {
-  matrix4f result;
-  matrix4f result_column;
+  uint32_t selected[CLUSTERED_LIGHT_SLOTS], count;
+  float origin[3] = { 0.f, 0.f, 0.f };
+
+  if (!light_clusters.light_count)
+    return;
 
   if (pipeline) {
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
+    const float* m =
+      pipeline->modelview_stack[pipeline->modelview_index].data;
+    origin[0] = m[3];
+    origin[1] = m[7];
+    origin[2] = m[11];
+  }
 
-    set_matrix_mode(pipeline, MODELVIEW);
-    result = get_matrix(pipeline);
-    matrix4f_set_column_major(&result_column, &result);
-    glMultMatrixf(result_column.data);
+  count = light_clusters_strongest(origin, CLUSTERED_LIGHT_SLOTS, selected);
+  state_load_modelview(NULL);
+  for (uint32_t i = 0; i < CLUSTERED_LIGHT_SLOTS; ++i) {
+    GLenum slot = GL_LIGHT0 + i;
+    const eye_light_t* light = light_clusters.lights + selected[i];
+    float cutoff;
+
+    state_set(slot, i < count);
+    if (i >= count)
+      continue;
+
+    cutoff = light->direction[3] == -1.f ?
+      180.f : TO_DEGREES(acosf(light->direction[3]));
+    state_light(slot, GL_DIFFUSE, light->diffuse);
+    state_light(slot, GL_AMBIENT, light->ambient);
+    state_light(slot, GL_SPECULAR, light->specular);
+    state_light(slot, GL_SPOT_DIRECTION, light->direction);
+    state_light(slot, GL_SPOT_CUTOFF, &cutoff);
+    state_light(slot, GL_CONSTANT_ATTENUATION, light->attenuation + 0);
+    state_light(slot, GL_LINEAR_ATTENUATION, light->attenuation + 1);
+    state_light(slot, GL_QUADRATIC_ATTENUATION, light->attenuation + 2);
+    state_light(slot, GL_POSITION, light->position);
   }
+
+  set_pipeline_transform(pipeline);
 }
 
-inline
+/// @brief state for the lit meshes, blending and texturing are set per mesh.
+static
 void
-clear_pipeline_transform(pipeline_t* pipeline)
+set_lit_state(const pipeline_t* pipeline)
 {
-  if (pipeline)
-    glPopMatrix();
+  set_clustered_light_slots(pipeline);
+  state_enable(GL_LIGHTING);
+  state_set(GL_DEPTH_TEST, depth_test_enabled);
+  state_enable(GL_CULL_FACE);
+  state_set_client(GL_NORMAL_ARRAY, 1);
+  state_set_client(GL_TEXTURE_COORD_ARRAY, 1);
+  state_set_client(GL_COLOR_ARRAY, 0);
+}
+
+void
+renderer_internal_unbind_buffers(void)
+{
+  state_bind_buffer(GL_ARRAY_BUFFER, 0);
+  state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+color_t
+renderer_internal_modulate_color(const color_t* color, const color_t* tint)
+{
+  color_t result;
+  for (uint32_t i = 0; i < 4; ++i)
+    result.data[i] = color->data[i] * tint->data[i];
+  return result;
+}
+
+void
+renderer_internal_get_projection_matrix(
+  const pipeline_t* pipeline,
+  float* matrix)
+{
+  float l, r, b, t, n, f;
+  float* m = matrix;
+  get_frustum(pipeline, &l, &r, &b, &t, &n, &f);
+
+  memset(m, 0, sizeof(float) * 16);
+  if (get_projection_type(pipeline) == PERSPECTIVE) {
+    m[0] = 2.f * n / (r - l);
+    m[2] = (r + l) / (r - l);
+    m[5] = 2.f * n / (t - b);
+    m[6] = (t + b) / (t - b);
+    m[10] = -(f + n) / (f - n);
+    m[11] = -2.f * f * n / (f - n);
+    m[14] = -1.f;
+  } else {
+    m[0] = 2.f / (r - l);
+    m[3] = -(r + l) / (r - l);
+    m[5] = 2.f / (t - b);
+    m[7] = -(t + b) / (t - b);
+    m[10] = -2.f / (f - n);
+    m[11] = -(f + n) / (f - n);
+    m[15] = 1.f;
+  }
 }
 
 void
 disable_depth_test()
 {
-  glDisable(GL_DEPTH_TEST);
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->set_depth_test(0);
+    stats_timer_end(RENDERER_TIMER_STATE, start);
+    return;
+  }
+
+  depth_test_enabled = 0;
+  state_disable(GL_DEPTH_TEST);
+  stats_timer_end(RENDERER_TIMER_STATE, start);
 }
 
 void
 enable_depth_test()
 {
-  glEnable(GL_DEPTH_TEST);
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->set_depth_test(1);
+    stats_timer_end(RENDERER_TIMER_STATE, start);
+    return;
+  }
+
+  depth_test_enabled = 1;
+  state_enable(GL_DEPTH_TEST);
+  stats_timer_end(RENDERER_TIMER_STATE, start);
 }
 
 void
 disable_light(uint32_t index)
 {
-  glDisable(GL_LIGHT0 + index);
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->set_light(index, 0);
+    stats_timer_end(RENDERER_TIMER_STATE, start);
+    return;
+  }
+
+  state_disable(GL_LIGHT0 + index);
+  stats_timer_end(RENDERER_TIMER_STATE, start);
 }
 
 void
 enable_light(uint32_t index)
 {
-  glEnable(GL_LIGHT0 + index);
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->set_light(index, 1);
+    stats_timer_end(RENDERER_TIMER_STATE, start);
+    return;
+  }
+
+  state_enable(GL_LIGHT0 + index);
+  stats_timer_end(RENDERER_TIMER_STATE, start);
 }
 
 void
@@ -103,18 +316,25 @@ set_light_properties(
   renderer_light_t* light,
   pipeline_t* pipeline)
 {
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->set_light_properties(index, light, pipeline);
+    stats_timer_end(RENDERER_TIMER_STATE, start);
+    return;
+  }
+
   set_pipeline_transform(pipeline);
 
   // Fix the ambient which is undefined, also support default attenuation.
-  glLightfv(GL_LIGHT0 + index, GL_DIFFUSE, light->diffuse.data);
-  glLightfv(GL_LIGHT0 + index, GL_AMBIENT, light->ambient.data);
-  glLightfv(GL_LIGHT0 + index, GL_SPECULAR, light->specular.data);
-  glLightfv(GL_LIGHT0 + index, GL_SPOT_DIRECTION, light->direction.data);
+  state_light(GL_LIGHT0 + index, GL_DIFFUSE, light->diffuse.data);
+  state_light(GL_LIGHT0 + index, GL_AMBIENT, light->ambient.data);
+  state_light(GL_LIGHT0 + index, GL_SPECULAR, light->specular.data);
+  state_light(GL_LIGHT0 + index, GL_SPOT_DIRECTION, light->direction.data);
 
   // GL_SPOT_EXPONENT has no real equivalent in our data set.
   if (light->type == RENDERER_LIGHT_TYPE_SPOT) {
     float degrees_outer = TO_DEGREES(light->outer_cone);
-    glLightfv(GL_LIGHT0 + index, GL_SPOT_CUTOFF, &degrees_outer);
+    state_light(GL_LIGHT0 + index, GL_SPOT_CUTOFF, &degrees_outer);
   }
 
   if (light->type != RENDERER_LIGHT_TYPE_DIRECTIONAL) {
@@ -129,9 +349,9 @@ set_light_properties(
     if (IS_ZERO_MP(length_squared_v3f(&atten)))
       memcpy(atten.data, default_atten.data, sizeof(atten.data));
 
-    glLightfv(GL_LIGHT0 + index, GL_CONSTANT_ATTENUATION, atten.data + 0);
-    glLightfv(GL_LIGHT0 + index, GL_LINEAR_ATTENUATION, atten.data + 1);
-    glLightfv(GL_LIGHT0 + index, GL_QUADRATIC_ATTENUATION, atten.data + 2);
+    state_light(GL_LIGHT0 + index, GL_CONSTANT_ATTENUATION, atten.data + 0);
+    state_light(GL_LIGHT0 + index, GL_LINEAR_ATTENUATION, atten.data + 1);
+    state_light(GL_LIGHT0 + index, GL_QUADRATIC_ATTENUATION, atten.data + 2);
   }
 
   {
@@ -140,51 +360,185 @@ set_light_properties(
     pos[1] = light->position.data[1];
     pos[2] = light->position.data[2];
     pos[3] = light->type == RENDERER_LIGHT_TYPE_DIRECTIONAL ? 0.f : 1.f;
-    glLightfv(GL_LIGHT0 + index, GL_POSITION, pos);
+    state_light(GL_LIGHT0 + index, GL_POSITION, pos);
   }
 
-  clear_pipeline_transform(pipeline);
+  stats_timer_end(RENDERER_TIMER_STATE, start);
+}
+
+/// @brief every path reads the clusters when it draws, there is nothing to
+/// hand to the backend.
+void
+set_clustered_lights(
+  const renderer_light_t* lights,
+  uint32_t light_count,
+  const pipeline_t* pipeline)
+{
+  uint64_t start = stats_timer_begin();
+  light_clusters_set(lights, light_count, pipeline);
+  stats_timer_end(RENDERER_TIMER_LIGHT_CLUSTERS, start);
 }
 
 void
 renderer_cleanup()
 {
-  glBindTexture(GL_TEXTURE_2D, 0);
+  // the cached textures go through evict_from_gpu, while it still works.
+  texture_cache_cleanup();
+  stats_cleanup();
+  light_clusters_cleanup();
+
+  if (renderer_backend) {
+    renderer_backend->cleanup();
+    renderer_backend = NULL;
+    debug_draw_cleanup();
+    return;
+  }
+
+  state_bind_texture(0);
+  frame_pacing_cleanup();
+  texture_streaming_cleanup();
+  jobs_cleanup();
+
+  for (uint32_t i = 0; i < gpu_meshes_capacity; ++i) {
+    if (gpu_meshes[i].vertex_buffer)
+      evict_mesh(i + 1);
+  }
+
+  free(gpu_meshes);
+  gpu_meshes = NULL;
+  gpu_meshes_capacity = gpu_meshes_free = 0;
+
+  free(quad_vertices);
+  free(quad_tex_coords);
+  free(quad_indices);
+  quad_vertices = quad_tex_coords = NULL;
+  quad_indices = NULL;
+  quad_capacity = 0;
+
+  if (grid_cache.buffer) {
+    state_forget_buffer(grid_cache.buffer);
+    glDeleteBuffers(1, &grid_cache.buffer);
+  }
+  free(grid_cache.vertices);
+  memset(&grid_cache, 0, sizeof(grid_cache_t));
+
+  debug_draw_cleanup();
 }
 
 void
 clear_color_and_depth_buffers()
 {
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->clear_color_and_depth_buffers();
+    stats_timer_end(RENDERER_TIMER_CLEAR, start);
+    return;
+  }
+
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  stats_timer_end(RENDERER_TIMER_CLEAR, start);
 }
 
 void
 flush_operations()
 {
-  glFinish();
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend)
+    renderer_backend->flush_operations();
+  else
+    frame_pacing_end_frame();
+
+  texture_cache_collect();
+  stats_timer_end(RENDERER_TIMER_FLUSH, start);
+  stats_end_frame(!renderer_backend || renderer_backend->opengl);
+}
+
+void
+set_frame_pacing(renderer_frame_pacing_t pacing, uint32_t frames_in_flight)
+{
+  frame_pacing_set(pacing, frames_in_flight);
 }
 
 void
 update_viewport(const pipeline_t* pipeline)
 {
   float x, y, width, height;
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->update_viewport(pipeline);
+    stats_timer_end(RENDERER_TIMER_VIEW, start);
+    return;
+  }
+
   get_viewport_info(pipeline, &x, &y, &width, &height);
 
-  glViewport((GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height);
+  state_viewport((GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height);
+  stats_timer_end(RENDERER_TIMER_VIEW, start);
 }
 
 void
 update_projection(const pipeline_t* pipeline)
 {
-  float left, right, bottom, top, near_z, far_z;
-  get_frustum(pipeline, &left, &right, &bottom, &top, &near_z, &far_z);
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->update_projection(pipeline);
+    stats_timer_end(RENDERER_TIMER_VIEW, start);
+    return;
+  }
 
-  glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-  if (get_projection_type(pipeline) == PERSPECTIVE)
-    glFrustum(left, right, bottom, top, near_z, far_z);
-  else
-    glOrtho(left, right, bottom, top, near_z, far_z);
+  state_load_projection(pipeline);
+  stats_timer_end(RENDERER_TIMER_VIEW, start);
+}
+
+/// @brief (re)builds the grid geometry, only when the parameters change.
+static
+int32_t
+update_grid_cache(float width, int32_t lines_per_axis)
+{
+  float* vertices = NULL;
+  float half = width / 2;
+  float step = width / lines_per_axis;
+  uint32_t vertex_count = (uint32_t)(lines_per_axis + 1) * 4;
+
+  if (
+    grid_cache.vertices &&
+    grid_cache.width == width &&
+    grid_cache.lines_per_axis == lines_per_axis)
+    return 1;
+
+  vertices = realloc(grid_cache.vertices, sizeof(float) * 3 * vertex_count);
+  if (!vertices)
+    return 0;
+
+  grid_cache.vertices = vertices;
+  grid_cache.vertex_count = vertex_count;
+  grid_cache.width = width;
+  grid_cache.lines_per_axis = lines_per_axis;
+
+  for (int32_t i = 0; i <= lines_per_axis; ++i) {
+    float offset = -half + step * i;
+    float line[12] = {
+      -half, 0, offset,
+      half, 0, offset,
+      offset, 0, -half,
+      offset, 0, half };
+    memcpy(vertices, line, sizeof(line));
+    vertices += 12;
+  }
+
+  if (opengl_features.buffer_objects) {
+    if (!grid_cache.buffer)
+      glGenBuffers(1, &grid_cache.buffer);
+    state_bind_buffer(GL_ARRAY_BUFFER, grid_cache.buffer);
+    glBufferData(
+      GL_ARRAY_BUFFER,
+      (renderer_glsizeiptr_t)(sizeof(float) * 3 * vertex_count),
+      grid_cache.vertices,
+      GL_STATIC_DRAW);
+    stats_count_upload(sizeof(float) * 3 * vertex_count);
+  }
+
+  return 1;
 }
 
 void
@@ -193,24 +547,31 @@ draw_grid(
   float width,
   int32_t lines_per_axis)
 {
-  set_pipeline_transform(pipeline);
-
-  glDisable(GL_LIGHTING);
-  glColor4f(0, 0, 0, 1);
-  glBegin(GL_LINES);
-
-  for (int32_t i = 0; i <= lines_per_axis; ++i) {
-    glVertex3f(-width / 2, 0, -width / 2 + width / lines_per_axis * i);
-    glVertex3f(width / 2, 0, -width / 2 + width / lines_per_axis * i);
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->draw_grid(pipeline, width, lines_per_axis);
+    stats_timer_end(RENDERER_TIMER_GRID, start);
+    return;
+  }
 
-    glVertex3f(-width / 2 + width / lines_per_axis * i, 0, -width / 2);
-    glVertex3f(-width / 2 + width / lines_per_axis * i, 0, width / 2);
+  if (lines_per_axis <= 0 || !update_grid_cache(width, lines_per_axis)) {
+    stats_timer_end(RENDERER_TIMER_GRID, start);
+    return;
   }
 
-  glEnd();
-  glEnable(GL_LIGHTING);
+  set_pipeline_transform(pipeline);
+  renderer_internal_set_unlit_state();
 
-  clear_pipeline_transform(pipeline);
+  glColor4f(0, 0, 0, 1);
+  if (grid_cache.buffer) {
+    state_bind_buffer(GL_ARRAY_BUFFER, grid_cache.buffer);
+    glVertexPointer(3, GL_FLOAT, 0, (const void*)0);
+  } else {
+    glVertexPointer(3, GL_FLOAT, 0, grid_cache.vertices);
+  }
+  glDrawArrays(GL_LINES, 0, (GLsizei)grid_cache.vertex_count);
+  stats_count_draw(grid_cache.vertex_count, 0);
+  stats_timer_end(RENDERER_TIMER_GRID, start);
 }
 
 void
@@ -221,23 +582,28 @@ draw_points(
   float size,
   pipeline_t* pipeline)
 {
-  set_pipeline_transform(pipeline);
-
-  glDisable(GL_LIGHTING);
-  glColor4f(color.data[0], color.data[1], color.data[2], color.data[3]);
-  glPointSize(size);
-  glBegin(GL_POINTS);
-
-  {
-    for (uint32_t i = 0ull; i < vertices_count; ++i)
-      glVertex3f(vertices[i * 3 + 0], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+  uint64_t start;
+  if (!vertices_count)
+    return;
+
+  start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->draw_points(
+      vertices, vertices_count, color, size, pipeline);
+    stats_timer_end(RENDERER_TIMER_POINTS, start);
+    return;
   }
 
-  glEnd();
-  glPointSize(1.f);
-  glEnable(GL_LIGHTING);
+  set_pipeline_transform(pipeline);
+  renderer_internal_set_unlit_state();
+  renderer_internal_unbind_buffers();
 
-  clear_pipeline_transform(pipeline);
+  glColor4f(color.data[0], color.data[1], color.data[2], color.data[3]);
+  state_point_size(size);
+  glVertexPointer(3, GL_FLOAT, 0, vertices);
+  glDrawArrays(GL_POINTS, 0, (GLsizei)vertices_count);
+  stats_count_draw(vertices_count, 0);
+  stats_timer_end(RENDERER_TIMER_POINTS, start);
 }
 
 void
@@ -248,34 +614,72 @@ draw_lines(
   float width,
   pipeline_t* pipeline)
 {
+  uint64_t start;
+  if (vertices_count < 2)
+    return;
+
+  start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->draw_lines(
+      vertices, vertices_count, color, width, pipeline);
+    stats_timer_end(RENDERER_TIMER_LINES, start);
+    return;
+  }
+
   set_pipeline_transform(pipeline);
+  renderer_internal_set_unlit_state();
+  renderer_internal_unbind_buffers();
 
-  glDisable(GL_LIGHTING);
+  // the vertices form a strip, each interior vertex is only sent once.
   glColor4f(color.data[0], color.data[1], color.data[2], color.data[3]);
-  glLineWidth(width);
-  glBegin(GL_LINES);
-
-  {
-    const float* v1 = NULL;
-    const float* v2 = NULL;
-    const float* v3 = NULL;
-    for (uint32_t i = 0ull; i < vertices_count - 1; i++) {
-      v1 = vertices + i * 3;
-      v2 = vertices + (i + 1) * 3;
+  state_line_width(width);
+  glVertexPointer(3, GL_FLOAT, 0, vertices);
+  glDrawArrays(GL_LINE_STRIP, 0, (GLsizei)vertices_count);
+  stats_count_draw(vertices_count, 0);
+  stats_timer_end(RENDERER_TIMER_LINES, start);
+}
 
-      glVertex3f(v1[0], v1[1], v1[2]);
-      glVertex3f(v2[0], v2[1], v2[2]);
-    }
-  }
+/// @brief grows the glyph scratch arrays, the index pattern is shared by every
+/// call and only extended.
+static
+int32_t
+reserve_unit_quads(uint32_t count)
+{
+  float* vertices = NULL;
+  float* tex_coords = NULL;
+  uint32_t* indices = NULL;
+  uint32_t capacity = quad_capacity ? quad_capacity : 256;
 
-  glEnd();
-  glLineWidth(1.f);
-  glEnable(GL_LIGHTING);
+  if (count <= quad_capacity)
+    return 1;
 
-  clear_pipeline_transform(pipeline);
+  while (capacity < count)
+    capacity *= 2;
+
+  vertices = realloc(
+    quad_vertices, sizeof(float) * 3 * UNIT_QUAD_VERTICES * capacity);
+  if (vertices)
+    quad_vertices = vertices;
+  tex_coords = realloc(
+    quad_tex_coords, sizeof(float) * 2 * UNIT_QUAD_VERTICES * capacity);
+  if (tex_coords)
+    quad_tex_coords = tex_coords;
+  indices = realloc(
+    quad_indices, sizeof(uint32_t) * UNIT_QUAD_INDICES * capacity);
+  if (indices)
+    quad_indices = indices;
+
+  if (!vertices || !tex_coords || !indices)
+    return 0;
+
+  build_unit_quad_indices(
+    quad_indices, quad_capacity, capacity - quad_capacity);
+  quad_capacity = capacity;
+  return 1;
 }
 
-/// @brief highly specific way to render font.
+/// @brief highly specific way to render font, the whole run is expanded into
+/// one vertex/uv array and submitted with a single draw.
 void
 draw_unit_quads(
   const unit_quad_t* uvs,
@@ -284,71 +688,47 @@ draw_unit_quads(
   color_t tint,
   pipeline_t* pipeline)
 {
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->draw_unit_quads(
+      uvs, uvs_count, texture_id, tint, pipeline);
+    stats_timer_end(RENDERER_TIMER_UNIT_QUADS, start);
+    return;
+  }
+
   set_pipeline_transform(pipeline);
+  renderer_internal_unbind_buffers();
 
+  state_set(GL_TEXTURE_2D, texture_id != 0);
   if (texture_id) {
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, texture_id);
+    state_bind_texture(texture_id);
+    texture_cache_touch((uint32_t)texture_id);
   }
 
-  glDisableClientState(GL_NORMAL_ARRAY);
-  glDisable(GL_LIGHTING);
+  state_set_client(GL_NORMAL_ARRAY, 0);
+  state_set_client(GL_TEXTURE_COORD_ARRAY, 1);
+  state_set_client(GL_COLOR_ARRAY, 0);
+  state_disable(GL_LIGHTING);
   glColor4f(tint.data[0], tint.data[1], tint.data[2], tint.data[3]);
-  glDisable(GL_CULL_FACE);
-  glDisable(GL_DEPTH_TEST);
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_COLOR, GL_ONE_MINUS_SRC_COLOR);
-
-  {
-    float left = 0.f;
-    float vertices[12] = { 1.f };
-    float ogl_uvs[8] = { 0.f };
-    uint32_t ogl_idx[6] = { 0, 1, 2, 0, 2, 3 };
-
-    for (uint32_t i = 0; i < uvs_count; ++i) {
-      vertices[0] = 0.f + left;
-      vertices[1] = uvs[i].data[5];
-      vertices[2] = 0.f;
-
-      vertices[3] = 0.f + left;
-      vertices[4] = 0.f;
-      vertices[5] = 0.f;
-
-      vertices[6] = uvs[i].data[4] + left;
-      vertices[7] = 0.f;
-      vertices[8] = 0.f;
-
-      vertices[9] = uvs[i].data[4] + left;
-      vertices[10] = uvs[i].data[5];
-      vertices[11] = 0.f;
-      left += uvs[i].data[4];
-
-      ogl_uvs[0] = uvs[i].data[0];
-      ogl_uvs[1] = uvs[i].data[1];
-
-      ogl_uvs[2] = uvs[i].data[0];
-      ogl_uvs[3] = uvs[i].data[3];
-
-      ogl_uvs[4] = uvs[i].data[2];
-      ogl_uvs[5] = uvs[i].data[3];
-
-      ogl_uvs[6] = uvs[i].data[2];
-      ogl_uvs[7] = uvs[i].data[1];
-
-      glVertexPointer(3, GL_FLOAT, 0, &vertices[0]);
-      glTexCoordPointer(2, GL_FLOAT, 0, &ogl_uvs[0]);
-      glDrawElements(GL_TRIANGLES, (GLsizei)6, GL_UNSIGNED_INT, &ogl_idx[0]);
-    }
+  state_disable(GL_CULL_FACE);
+  state_disable(GL_DEPTH_TEST);
+  state_enable(GL_BLEND);
+  state_blend_func(GL_SRC_COLOR, GL_ONE_MINUS_SRC_COLOR);
+
+  if (uvs_count && reserve_unit_quads(uvs_count)) {
+    expand_unit_quads(uvs, uvs_count, quad_vertices, quad_tex_coords);
+    glVertexPointer(3, GL_FLOAT, 0, quad_vertices);
+    glTexCoordPointer(2, GL_FLOAT, 0, quad_tex_coords);
+    glDrawElements(
+      GL_TRIANGLES,
+      (GLsizei)(uvs_count * UNIT_QUAD_INDICES),
+      GL_UNSIGNED_INT,
+      quad_indices);
+    stats_count_draw(
+      uvs_count * UNIT_QUAD_INDICES, uvs_count * UNIT_QUAD_INDICES / 3);
   }
 
-  glDisable(GL_BLEND);
-  glEnable(GL_DEPTH_TEST);
-  glEnable(GL_CULL_FACE);
-  glEnable(GL_LIGHTING);
-  glEnableClientState(GL_NORMAL_ARRAY);
-  glDisable(GL_TEXTURE_2D);
-
-  clear_pipeline_transform(pipeline);
+  stats_timer_end(RENDERER_TIMER_UNIT_QUADS, start);
 }
 
 void
@@ -359,21 +739,34 @@ draw_meshes_wireframe(
   float width,
   pipeline_t* pipeline)
 {
+  uint64_t start, vertices = 0;
+  start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->draw_meshes_wireframe(
+      mesh, mesh_count, color, width, pipeline);
+    stats_timer_end(RENDERER_TIMER_WIREFRAME, start);
+    return;
+  }
+
   set_pipeline_transform(pipeline);
+  renderer_internal_set_unlit_state();
 
-  glDisable(GL_LIGHTING);
   glColor4f(color.data[0], color.data[1], color.data[2], color.data[3]);
-  glLineWidth(width);
+  state_line_width(width);
   glBegin(GL_LINES);
 
   for (uint32_t mesh_index = 0; mesh_index < mesh_count; ++mesh_index) {
     const float* v1 = NULL;
     const float* v2 = NULL;
     const float* v3 = NULL;
+    const float* positions = mesh[mesh_index].interleaved ?
+      mesh[mesh_index].interleaved->position : mesh[mesh_index].vertices;
+    uint32_t stride = mesh[mesh_index].interleaved ?
+      sizeof(renderer_vertex_t) / sizeof(float) : 3;
     for (uint32_t i = 0ull; i < mesh[mesh_index].indices_count; i += 3) {
-      v1 = mesh[mesh_index].vertices + mesh[mesh_index].indices[i + 0] * 3;
-      v2 = mesh[mesh_index].vertices + mesh[mesh_index].indices[i + 1] * 3;
-      v3 = mesh[mesh_index].vertices + mesh[mesh_index].indices[i + 2] * 3;
+      v1 = positions + mesh[mesh_index].indices[i + 0] * stride;
+      v2 = positions + mesh[mesh_index].indices[i + 1] * stride;
+      v3 = positions + mesh[mesh_index].indices[i + 2] * stride;
 
       glVertex3f(v1[0], v1[1], v1[2]);
       glVertex3f(v2[0], v2[1], v2[2]);
@@ -382,13 +775,129 @@ draw_meshes_wireframe(
       glVertex3f(v2[0], v2[1], v2[2]);
       glVertex3f(v3[0], v3[1], v3[2]);
     }
+    vertices += mesh[mesh_index].indices_count / 3 * 6;
   }
 
   glEnd();
-  glLineWidth(1.f);
-  glEnable(GL_LIGHTING);
+  stats_count_draw(vertices, 0);
+  stats_timer_end(RENDERER_TIMER_WIREFRAME, start);
+}
+
+/// @brief sets the vertex/normal/uv pointers for the interleaved layout, @a
+/// base is the address (or buffer offset) of the first vertex.
+static
+void
+set_interleaved_arrays(const void* base)
+{
+  uintptr_t address = (uintptr_t)base;
+  GLsizei stride = (GLsizei)sizeof(renderer_vertex_t);
+
+  glVertexPointer(
+    3, GL_FLOAT, stride,
+    (const void*)(address + offsetof(renderer_vertex_t, position)));
+  glNormalPointer(
+    GL_FLOAT, stride,
+    (const void*)(address + offsetof(renderer_vertex_t, normal)));
+  glTexCoordPointer(
+    2, GL_FLOAT, stride,
+    (const void*)(address + offsetof(renderer_vertex_t, uv)));
+}
+
+/// @brief material colors of the last drawn mesh, only valid within a single
+/// draw call since the other entry points touch the current color (which feeds
+/// the color material).
+typedef
+struct mesh_state_t {
+  int32_t valid;
+  color_t ambient;
+  color_t diffuse;
+  color_t specular;
+} mesh_state_t;
+
+static
+int32_t
+is_same_color(const color_t* a, const color_t* b)
+{
+  return memcmp(a->data, b->data, sizeof(a->data)) == 0;
+}
+
+static
+void
+set_material_color(GLenum mode, const color_t* color)
+{
+  glColorMaterial(GL_FRONT, mode);
+  glColor4f(color->data[0], color->data[1], color->data[2], color->data[3]);
+}
+
+/// @brief applies the mesh material/texture, skipping what is already set.
+static
+void
+set_mesh_state(
+  mesh_state_t* state,
+  const color_t* ambient,
+  const color_t* diffuse,
+  const color_t* specular,
+  uint32_t texture_id)
+{
+  int32_t blend =
+    ambient->data[3] < 1.f ||
+    diffuse->data[3] < 1.f ||
+    specular->data[3] < 1.f;
+
+  state_set(GL_BLEND, blend);
+  if (blend)
+    state_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  if (!state->valid || !is_same_color(ambient, &state->ambient))
+    set_material_color(GL_AMBIENT, ambient);
+  if (!state->valid || !is_same_color(diffuse, &state->diffuse))
+    set_material_color(GL_DIFFUSE, diffuse);
+  if (!state->valid || !is_same_color(specular, &state->specular))
+    set_material_color(GL_SPECULAR, specular);
+
+  state_set(GL_TEXTURE_2D, texture_id != 0);
+  if (texture_id != 0) {
+    state_bind_texture(texture_id);
+    texture_cache_touch(texture_id);
+  }
+
+  state->valid = 1;
+  state->ambient = *ambient;
+  state->diffuse = *diffuse;
+  state->specular = *specular;
+}
+
+static
+void
+set_mesh_arrays(const mesh_render_data_t* mesh)
+{
+  if (mesh->interleaved) {
+    set_interleaved_arrays(mesh->interleaved);
+  } else {
+    glVertexPointer(3, GL_FLOAT, 0, &mesh->vertices[0]);
+    glTexCoordPointer(3, GL_FLOAT, 0, &mesh->uv_coords[0]);
+    glNormalPointer(GL_FLOAT, 0, &mesh->normals[0]);
+  }
+}
 
-  clear_pipeline_transform(pipeline);
+static
+void
+draw_mesh_elements(const mesh_render_data_t* mesh)
+{
+  glDrawElements(
+    GL_TRIANGLES,
+    (GLsizei)mesh->indices_count,
+    GL_UNSIGNED_INT,
+    &mesh->indices[0]);
+  stats_count_draw(mesh->indices_count, mesh->indices_count / 3);
+}
+
+static
+void
+draw_mesh_arrays(const mesh_render_data_t* mesh)
+{
+  set_mesh_arrays(mesh);
+  draw_mesh_elements(mesh);
 }
 
 void
@@ -398,94 +907,306 @@ draw_meshes(
   uint32_t mesh_count,
   pipeline_t* pipeline)
 {
+  mesh_state_t state = { 0 };
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->draw_meshes(mesh, texture_data, mesh_count, pipeline);
+    stats_timer_end(RENDERER_TIMER_MESHES, start);
+    return;
+  }
+
   set_pipeline_transform(pipeline);
+  set_lit_state(pipeline);
+  renderer_internal_unbind_buffers();
+
+  for (uint32_t i = 0; i < mesh_count; ++i) {
+    set_mesh_state(
+      &state,
+      &mesh[i].ambient,
+      &mesh[i].diffuse,
+      &mesh[i].specular,
+      texture_data[i]);
+    draw_mesh_arrays(mesh + i);
+  }
 
-  {
-    for (uint32_t i = 0; i < mesh_count; ++i) {
-      if (
-        mesh[i].ambient.data[3] < 1.f ||
-        mesh[i].diffuse.data[3] < 1.f ||
-        mesh[i].specular.data[3] < 1.f) {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-      } else {
-        glDisable(GL_BLEND);
-      }
-
-      glColorMaterial(GL_FRONT, GL_AMBIENT);
-      glColor4f(
-        mesh[i].ambient.data[0],
-        mesh[i].ambient.data[1],
-        mesh[i].ambient.data[2],
-        mesh[i].ambient.data[3]);
-      glColorMaterial(GL_FRONT, GL_DIFFUSE);
-      glColor4f(
-        mesh[i].diffuse.data[0],
-        mesh[i].diffuse.data[1],
-        mesh[i].diffuse.data[2],
-        mesh[i].diffuse.data[3]);
-      glColorMaterial(GL_FRONT, GL_SPECULAR);
-      glColor4f(
-        mesh[i].specular.data[0],
-        mesh[i].specular.data[1],
-        mesh[i].specular.data[2],
-        mesh[i].specular.data[3]);
-
-      if (texture_data[i] != 0) {
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, texture_data[i]);
-      }
-
-      glVertexPointer(3, GL_FLOAT, 0, &mesh[i].vertices[0]);
-      glTexCoordPointer(3, GL_FLOAT, 0, &mesh[i].uv_coords[0]);
-      glNormalPointer(GL_FLOAT, 0, &mesh[i].normals[0]);
-      glDrawElements(
-        GL_TRIANGLES,
-        (GLsizei)mesh[i].indices_count,
-        GL_UNSIGNED_INT,
-        &mesh[i].indices[0]);
-
-      glDisable(GL_TEXTURE_2D);
-      glDisable(GL_BLEND);
+  stats_timer_end(RENDERER_TIMER_MESHES, start);
+}
+
+/// @brief the fixed function pipeline has no instancing, the arrays stay put
+/// and only the modelview changes between the draws.
+void
+draw_meshes_instanced(
+  const mesh_render_data_t* mesh,
+  uint32_t texture_id,
+  const matrix4f* instances,
+  const color_t* tints,
+  uint32_t instance_count,
+  pipeline_t* pipeline)
+{
+  mesh_state_t state = { 0 };
+  matrix4f view, modelview;
+  uint64_t start;
+  if (!instance_count)
+    return;
+
+  start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->draw_meshes_instanced(
+      mesh, texture_id, instances, tints, instance_count, pipeline);
+    stats_timer_end(RENDERER_TIMER_INSTANCES, start);
+    return;
+  }
+
+  if (pipeline)
+    view = pipeline->modelview_stack[pipeline->modelview_index];
+  else
+    matrix4f_set_identity(&view);
+
+  set_lit_state(pipeline);
+  renderer_internal_unbind_buffers();
+  set_mesh_arrays(mesh);
+  if (!tints)
+    set_mesh_state(
+      &state, &mesh->ambient, &mesh->diffuse, &mesh->specular, texture_id);
+
+  for (uint32_t i = 0; i < instance_count; ++i) {
+    if (tints) {
+      color_t ambient =
+        renderer_internal_modulate_color(&mesh->ambient, tints + i);
+      color_t diffuse =
+        renderer_internal_modulate_color(&mesh->diffuse, tints + i);
+      color_t specular =
+        renderer_internal_modulate_color(&mesh->specular, tints + i);
+      set_mesh_state(&state, &ambient, &diffuse, &specular, texture_id);
     }
+
+    pipeline_multiply(view.data, instances[i].data, modelview.data);
+    state_load_modelview_matrix(&modelview);
+    draw_mesh_elements(mesh);
   }
 
-  clear_pipeline_transform(pipeline);
+  stats_timer_end(RENDERER_TIMER_INSTANCES, start);
+}
+
+void
+render_queue_submit(const render_queue_t* queue, pipeline_t* pipeline)
+{
+  mesh_state_t state = { 0 };
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    for (uint32_t i = 0; i < queue->count; ++i)
+      renderer_backend->draw_meshes(
+        queue->items[i].mesh, &queue->items[i].texture_id, 1, pipeline);
+    stats_timer_end(RENDERER_TIMER_RENDER_QUEUE, start);
+    return;
+  }
+
+  set_pipeline_transform(pipeline);
+  set_lit_state(pipeline);
+  renderer_internal_unbind_buffers();
+
+  for (uint32_t i = 0; i < queue->count; ++i) {
+    const render_queue_item_t* item = queue->items + i;
+    set_mesh_state(
+      &state,
+      &item->mesh->ambient,
+      &item->mesh->diffuse,
+      &item->mesh->specular,
+      item->texture_id);
+    draw_mesh_arrays(item->mesh);
+  }
+
+  stats_timer_end(RENDERER_TIMER_RENDER_QUEUE, start);
+}
+
+void
+interleave_mesh_vertices(
+  const mesh_render_data_t* mesh,
+  renderer_vertex_t* vertices)
+{
+  const float* position = mesh->vertices;
+  const float* normal = mesh->normals;
+  const float* uv = mesh->uv_coords;
+
+  for (uint32_t i = 0; i < mesh->vertex_count; ++i) {
+    vertices[i].position[0] = position[0];
+    vertices[i].position[1] = position[1];
+    vertices[i].position[2] = position[2];
+    vertices[i].normal[0] = normal[0];
+    vertices[i].normal[1] = normal[1];
+    vertices[i].normal[2] = normal[2];
+    vertices[i].uv[0] = uv[0];
+    vertices[i].uv[1] = uv[1];
+    position += 3;
+    normal += 3;
+    uv += 3;
+  }
 }
 
 static
 uint32_t
-get_component_number(renderer_image_format_t format)
+allocate_gpu_mesh(void)
 {
-  switch (format)
-  {
-  case RENDERER_OPENGL_RGBA:
-  case RENDERER_OPENGL_BGRA:
-    return 4;
-    break;
-  case RENDERER_OPENGL_RGB:
-  case RENDERER_OPENGL_BGR:
-    return 3;
-    break;
-  case RENDERER_OPENGL_LA:
-    return 2;
-    break;
-  case RENDERER_OPENGL_L:
-  case RENDERER_OPENGL_A:
-    return 1;
-    break;
+  uint32_t index;
+
+  if (!gpu_meshes_free) {
+    uint32_t capacity = gpu_meshes_capacity ? gpu_meshes_capacity * 2 : 64;
+    gpu_mesh_t* meshes = realloc(gpu_meshes, sizeof(gpu_mesh_t) * capacity);
+    if (!meshes)
+      return 0;
+
+    // chain the new slots into the free list.
+    memset(
+      meshes + gpu_meshes_capacity,
+      0,
+      sizeof(gpu_mesh_t) * (capacity - gpu_meshes_capacity));
+    for (uint32_t i = gpu_meshes_capacity; i < capacity - 1; ++i)
+      meshes[i].next_free = i + 2;
+
+    gpu_meshes_free = gpu_meshes_capacity + 1;
+    gpu_meshes = meshes;
+    gpu_meshes_capacity = capacity;
   }
 
-  assert(0);
-  return 0;
+  index = gpu_meshes_free - 1;
+  gpu_meshes_free = gpu_meshes[index].next_free;
+  gpu_meshes[index].next_free = 0;
+  return index + 1;
 }
 
-static
-int32_t
-is_component_power_2(renderer_image_format_t format)
+uint32_t
+upload_mesh(const mesh_render_data_t* mesh)
 {
-  uint32_t components = get_component_number(format);
-  return (components & (components - 1)) == 0;
+  uint32_t handle = 0;
+  gpu_mesh_t* gpu_mesh = NULL;
+  renderer_vertex_t* vertices = mesh->interleaved;
+  uint64_t start = stats_timer_begin();
+
+  if (renderer_backend || !opengl_features.buffer_objects) {
+    if (renderer_backend && renderer_backend->upload_mesh)
+      handle = renderer_backend->upload_mesh(mesh);
+    stats_timer_end(RENDERER_TIMER_MESH_UPLOADS, start);
+    return handle;
+  }
+
+  // resident geometry is always stored interleaved.
+  if (!vertices) {
+    vertices = malloc(sizeof(renderer_vertex_t) * mesh->vertex_count);
+    if (!vertices) {
+      stats_timer_end(RENDERER_TIMER_MESH_UPLOADS, start);
+      return 0;
+    }
+    interleave_mesh_vertices(mesh, vertices);
+  }
+
+  handle = allocate_gpu_mesh();
+  if (handle) {
+    gpu_mesh = gpu_meshes + handle - 1;
+    gpu_mesh->vertex_count = mesh->vertex_count;
+    gpu_mesh->indices_count = mesh->indices_count;
+    gpu_mesh->ambient = mesh->ambient;
+    gpu_mesh->diffuse = mesh->diffuse;
+    gpu_mesh->specular = mesh->specular;
+
+    glGenBuffers(1, &gpu_mesh->vertex_buffer);
+    state_bind_buffer(GL_ARRAY_BUFFER, gpu_mesh->vertex_buffer);
+    glBufferData(
+      GL_ARRAY_BUFFER,
+      (renderer_glsizeiptr_t)(sizeof(renderer_vertex_t) * mesh->vertex_count),
+      vertices,
+      GL_STATIC_DRAW);
+
+    glGenBuffers(1, &gpu_mesh->index_buffer);
+    state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, gpu_mesh->index_buffer);
+    glBufferData(
+      GL_ELEMENT_ARRAY_BUFFER,
+      (renderer_glsizeiptr_t)(sizeof(uint32_t) * mesh->indices_count),
+      mesh->indices,
+      GL_STATIC_DRAW);
+    stats_count_upload(
+      sizeof(renderer_vertex_t) * mesh->vertex_count +
+      sizeof(uint32_t) * mesh->indices_count);
+  }
+
+  if (vertices != mesh->interleaved)
+    free(vertices);
+
+  stats_timer_end(RENDERER_TIMER_MESH_UPLOADS, start);
+  return handle;
+}
+
+uint32_t
+evict_mesh(uint32_t mesh_handle)
+{
+  gpu_mesh_t* gpu_mesh = NULL;
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    if (renderer_backend->evict_mesh)
+      mesh_handle = renderer_backend->evict_mesh(mesh_handle);
+    stats_timer_end(RENDERER_TIMER_MESH_UPLOADS, start);
+    return mesh_handle;
+  }
+
+  assert(mesh_handle && mesh_handle <= gpu_meshes_capacity);
+
+  gpu_mesh = gpu_meshes + mesh_handle - 1;
+  assert(gpu_mesh->vertex_buffer);
+  state_forget_buffer(gpu_mesh->vertex_buffer);
+  state_forget_buffer(gpu_mesh->index_buffer);
+  glDeleteBuffers(1, &gpu_mesh->vertex_buffer);
+  glDeleteBuffers(1, &gpu_mesh->index_buffer);
+  memset(gpu_mesh, 0, sizeof(gpu_mesh_t));
+
+  gpu_mesh->next_free = gpu_meshes_free;
+  gpu_meshes_free = mesh_handle;
+  stats_timer_end(RENDERER_TIMER_MESH_UPLOADS, start);
+  return mesh_handle;
+}
+
+void
+draw_mesh_handles(
+  const uint32_t* mesh_handles,
+  const uint32_t* texture_data,
+  uint32_t mesh_count,
+  pipeline_t* pipeline)
+{
+  mesh_state_t state = { 0 };
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    if (renderer_backend->draw_mesh_handles)
+      renderer_backend->draw_mesh_handles(
+        mesh_handles, texture_data, mesh_count, pipeline);
+    stats_timer_end(RENDERER_TIMER_MESH_HANDLES, start);
+    return;
+  }
+
+  set_pipeline_transform(pipeline);
+  set_lit_state(pipeline);
+
+  for (uint32_t i = 0; i < mesh_count; ++i) {
+    const gpu_mesh_t* gpu_mesh = gpu_meshes + mesh_handles[i] - 1;
+    assert(mesh_handles[i] && mesh_handles[i] <= gpu_meshes_capacity);
+
+    set_mesh_state(
+      &state,
+      &gpu_mesh->ambient,
+      &gpu_mesh->diffuse,
+      &gpu_mesh->specular,
+      texture_data[i]);
+
+    // pointers are offsets into the bound buffer objects.
+    state_bind_buffer(GL_ARRAY_BUFFER, gpu_mesh->vertex_buffer);
+    state_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, gpu_mesh->index_buffer);
+    set_interleaved_arrays(NULL);
+    glDrawElements(
+      GL_TRIANGLES,
+      (GLsizei)gpu_mesh->indices_count,
+      GL_UNSIGNED_INT,
+      (const void*)0);
+    stats_count_draw(gpu_mesh->indices_count, gpu_mesh->indices_count / 3);
+  }
+
+  stats_timer_end(RENDERER_TIMER_MESH_HANDLES, start);
 }
 
 static
@@ -523,31 +1244,81 @@ get_ogl_format(renderer_image_format_t format)
   return GL_RGBA;
 }
 
-uint32_t
-upload_to_gpu(
-  const char* path,
-  const uint8_t* buffer,
+/// @brief the pixel format the levels are uploaded with, BGR(A) images are
+/// swizzled on the cpu so the upload does not depend on GL_EXT_bgra.
+static
+GLenum
+get_upload_format(renderer_image_format_t format, int32_t* swizzle)
+{
+  *swizzle =
+    format == RENDERER_OPENGL_BGR || format == RENDERER_OPENGL_BGRA;
+  if (format == RENDERER_OPENGL_BGR)
+    return GL_RGB;
+  if (format == RENDERER_OPENGL_BGRA)
+    return GL_RGBA;
+  return get_ogl_format(format);
+}
+
+/// @brief core contexts reject the legacy component counts, the luminance
+/// and alpha formats never reach one (the core backend converts them).
+static
+GLint
+get_internal_format(renderer_image_format_t format)
+{
+  switch (format)
+  {
+  case RENDERER_OPENGL_RGBA:
+  case RENDERER_OPENGL_BGRA:
+    return GL_RGBA;
+  case RENDERER_OPENGL_RGB:
+  case RENDERER_OPENGL_BGR:
+    return GL_RGB;
+  default:
+    return (GLint)image_format_components(format);
+  }
+}
+
+static
+mipmaps_filter_t
+get_mipmaps_filter(renderer_image_format_t format)
+{
+  if (!gamma_correct_mipmaps || format == RENDERER_OPENGL_A)
+    return MIPMAPS_FILTER_BOX;
+
+  switch (format)
+  {
+  case RENDERER_OPENGL_RGBA:
+  case RENDERER_OPENGL_BGRA:
+  case RENDERER_OPENGL_LA:
+    return MIPMAPS_FILTER_SRGB_ALPHA;
+  default:
+    return MIPMAPS_FILTER_SRGB;
+  }
+}
+
+/// @brief the level 0 size, scaled down to powers of 2 (as gluBuild2DMipmaps
+/// does) when the context cannot mipmap other sizes.
+static
+void
+get_level_0_size(
   uint32_t width,
   uint32_t height,
-  renderer_image_format_t format)
+  uint32_t* level_width,
+  uint32_t* level_height)
 {
-  uint32_t n = 0;
-  GLenum ogl_format = get_ogl_format(format);
+  uint32_t max_size = (uint32_t)opengl_features.max_texture_size;
+  *level_width = width;
+  *level_height = height;
+  if (!opengl_features.npot_textures) {
+    *level_width = mipmaps_power_of_2(width, max_size);
+    *level_height = mipmaps_power_of_2(height, max_size);
+  }
+}
 
-  // upload the texture, generate mipmaps and set wrapping modes.
-  glGenTextures(1, &n);
-  glBindTexture(GL_TEXTURE_2D, n);
-  glPixelStorei(
-    GL_UNPACK_ALIGNMENT,
-    is_component_power_2(format) ? get_component_number(format) : 1);
-  gluBuild2DMipmaps(
-    GL_TEXTURE_2D,
-    get_component_number(format),
-    width,
-    height,
-    ogl_format,
-    GL_UNSIGNED_BYTE,
-    buffer);
+static
+void
+set_texture_sampling(void)
+{
   glTexParameteri(
     GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
   glTexParameteri(
@@ -556,12 +1327,388 @@ upload_to_gpu(
     GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glTexParameteri(
     GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+}
+
+static
+GLenum
+get_compressed_format(renderer_image_format_t format)
+{
+  switch (format)
+  {
+  case RENDERER_OPENGL_BC1:
+    return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+  case RENDERER_OPENGL_BC3:
+    return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+  case RENDERER_OPENGL_BC4:
+    return GL_COMPRESSED_RED_RGTC1;
+  case RENDERER_OPENGL_BC5:
+    return GL_COMPRESSED_RG_RGTC2;
+  default:
+    assert(0);
+    return GL_RGBA;
+  }
+}
+
+/// @brief the blocks cannot be resized, the chain has to be usable as is.
+static
+int32_t
+is_compressed_supported(
+  renderer_image_format_t format,
+  uint32_t width,
+  uint32_t height)
+{
+  uint32_t max_size = (uint32_t)opengl_features.max_texture_size;
+  int32_t power_of_2 =
+    (width & (width - 1)) == 0 && (height & (height - 1)) == 0;
+
+  if (width > max_size || height > max_size)
+    return 0;
+  if (!power_of_2 && !opengl_features.npot_textures)
+    return 0;
+
+  if (format == RENDERER_OPENGL_BC1 || format == RENDERER_OPENGL_BC3)
+    return opengl_features.s3tc_textures;
+  return opengl_features.rgtc_textures;
+}
+
+/// @brief builds the mip chain on the cpu, every level goes up as is.
+static
+uint32_t
+upload_uncompressed(
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  GLuint n = 0;
+  uint32_t components;
+  uint32_t level_width, level_height;
+  int32_t swizzle = 0;
+  GLenum upload_format;
+  mipmaps_chain_t chain;
+  uint8_t* levels = NULL;
+
+  // the compressed formats are uploaded as blocks, never per component.
+  components = image_format_components(format);
+  assert(components);
+  upload_format = get_upload_format(format, &swizzle);
+
+  get_level_0_size(width, height, &level_width, &level_height);
+  mipmaps_layout(&chain, level_width, level_height, components);
+  levels = malloc(chain.size);
+  assert(levels);
+  mipmaps_generate(
+    &chain,
+    buffer,
+    width,
+    height,
+    components,
+    swizzle,
+    get_mipmaps_filter(format),
+    1,
+    levels);
+
+  glGenTextures(1, &n);
+  state_bind_texture(n);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  for (uint32_t level = 0; level < chain.level_count; ++level)
+    glTexImage2D(
+      GL_TEXTURE_2D,
+      (GLint)level,
+      get_internal_format(format),
+      (GLsizei)chain.width[level],
+      (GLsizei)chain.height[level],
+      0,
+      upload_format,
+      GL_UNSIGNED_BYTE,
+      levels + chain.offset[level]);
+  set_texture_sampling();
+  stats_count_upload(chain.size);
+
+  free(levels);
+  return n;
+}
+
+/// @brief uploads the chain of blocks level by level, or decompresses level 0
+/// and takes the uncompressed path when the context cannot use them.
+static
+uint32_t
+upload_compressed(
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  GLuint n = 0;
+  GLenum compressed_format = get_compressed_format(format);
+  uint32_t block_bytes =
+    format == RENDERER_OPENGL_BC1 || format == RENDERER_OPENGL_BC4 ? 8 : 16;
+  mipmaps_chain_t chain;
+
+  if (!is_compressed_supported(format, width, height)) {
+    uint8_t* pixels = malloc((size_t)width * height * 4);
+    assert(pixels);
+    texture_decompress(buffer, width, height, format, pixels);
+    n = upload_uncompressed(pixels, width, height, RENDERER_OPENGL_RGBA);
+    free(pixels);
+    return n;
+  }
+
+  mipmaps_layout(&chain, width, height, 1);
+  glGenTextures(1, &n);
+  state_bind_texture(n);
+  for (uint32_t level = 0; level < chain.level_count; ++level) {
+    uint32_t level_width = chain.width[level];
+    uint32_t level_height = chain.height[level];
+    GLsizei size = (GLsizei)(
+      ((level_width + 3) / 4) * ((level_height + 3) / 4) * block_bytes);
+    glCompressedTexImage2D(
+      GL_TEXTURE_2D,
+      (GLint)level,
+      compressed_format,
+      (GLsizei)level_width,
+      (GLsizei)level_height,
+      0,
+      size,
+      buffer);
+    stats_count_upload((uint64_t)size);
+    buffer += size;
+  }
+  set_texture_sampling();
+
+  return n;
+}
+
+void
+enable_gamma_correct_mipmaps()
+{
+  gamma_correct_mipmaps = 1;
+}
+
+void
+disable_gamma_correct_mipmaps()
+{
+  gamma_correct_mipmaps = 0;
+}
+
+void
+renderer_internal_convert_texels(
+  const uint8_t* source,
+  uint32_t count,
+  renderer_image_format_t format,
+  uint8_t* target)
+{
+  for (uint32_t i = 0; i < count; ++i, target += 4) {
+    switch (format) {
+    case RENDERER_OPENGL_RGBA:
+      memcpy(target, source, 4);
+      source += 4;
+      break;
+    case RENDERER_OPENGL_BGRA:
+      target[0] = source[2];
+      target[1] = source[1];
+      target[2] = source[0];
+      target[3] = source[3];
+      source += 4;
+      break;
+    case RENDERER_OPENGL_RGB:
+      memcpy(target, source, 3);
+      target[3] = 255;
+      source += 3;
+      break;
+    case RENDERER_OPENGL_BGR:
+      target[0] = source[2];
+      target[1] = source[1];
+      target[2] = source[0];
+      target[3] = 255;
+      source += 3;
+      break;
+    case RENDERER_OPENGL_LA:
+      target[0] = target[1] = target[2] = source[0];
+      target[3] = source[1];
+      source += 2;
+      break;
+    case RENDERER_OPENGL_L:
+      target[0] = target[1] = target[2] = source[0];
+      target[3] = 255;
+      source += 1;
+      break;
+    case RENDERER_OPENGL_A:
+    default:
+      target[0] = target[1] = target[2] = 255;
+      target[3] = source[0];
+      source += 1;
+      break;
+    }
+  }
+}
+
+uint32_t
+renderer_internal_upload_texture(
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  if (texture_compression_is_compressed(format))
+    return upload_compressed(buffer, width, height, format);
+  return upload_uncompressed(buffer, width, height, format);
+}
+
+uint32_t
+upload_to_gpu(
+  const char* path,
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  GLuint n = 0;
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend)
+    n = renderer_backend->upload_to_gpu(path, buffer, width, height, format);
+  else
+    n = renderer_internal_upload_texture(buffer, width, height, format);
+  stats_timer_end(RENDERER_TIMER_TEXTURE_UPLOADS, start);
+  return n;
+}
+
+uint32_t
+upload_to_gpu_async(
+  const char* path,
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  GLuint n = 0;
+  int32_t swizzle = 0;
+  GLenum upload_format;
+  uint8_t* texels = NULL;
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend && !renderer_backend->opengl) {
+    n = renderer_backend->upload_to_gpu(path, buffer, width, height, format);
+    stats_timer_end(RENDERER_TIMER_TEXTURE_UPLOADS, start);
+    return n;
+  }
+
+  // nothing to build, the blocks are small enough to go up right away.
+  if (texture_compression_is_compressed(format)) {
+    n = upload_compressed(buffer, width, height, format);
+    stats_timer_end(RENDERER_TIMER_TEXTURE_UPLOADS, start);
+    return n;
+  }
+
+  // core contexts have no luminance or alpha formats, as in core_upload_to_gpu
+  // they go up as RGBA.
+  if (renderer_backend && image_format_components(format) < 3) {
+    texels = malloc((size_t)width * height * 4);
+    if (!texels) {
+      stats_timer_end(RENDERER_TIMER_TEXTURE_UPLOADS, start);
+      return 0;
+    }
+    renderer_internal_convert_texels(buffer, width * height, format, texels);
+    buffer = texels;
+    format = RENDERER_OPENGL_RGBA;
+  }
+
+  // the sampling state is set now, the levels come later.
+  glGenTextures(1, &n);
+  state_bind_texture(n);
+  set_texture_sampling();
+
+  upload_format = get_upload_format(format, &swizzle);
+  texture_streaming_request(
+    n,
+    buffer,
+    width,
+    height,
+    image_format_components(format),
+    upload_format,
+    swizzle,
+    get_mipmaps_filter(format));
+  free(texels);
+  stats_timer_end(RENDERER_TIMER_TEXTURE_UPLOADS, start);
   return n;
 }
 
+int32_t
+is_texture_ready(uint32_t texture_id)
+{
+  if (renderer_backend && !renderer_backend->opengl)
+    return 1;
+
+  return !texture_streaming_is_pending(texture_id);
+}
+
+void
+stream_textures(uint32_t byte_budget)
+{
+  uint64_t start;
+  if (renderer_backend && !renderer_backend->opengl)
+    return;
+
+  start = stats_timer_begin();
+  texture_streaming_pump(byte_budget);
+  stats_timer_end(RENDERER_TIMER_STREAMING, start);
+}
+
 uint32_t
 evict_from_gpu(uint32_t texture_id)
 {
-  glDeleteTextures(1, &texture_id);
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    texture_id = renderer_backend->evict_from_gpu(texture_id);
+  } else {
+    texture_streaming_cancel(texture_id);
+    state_forget_texture(texture_id);
+    glDeleteTextures(1, &texture_id);
+  }
+
+  stats_timer_end(RENDERER_TIMER_TEXTURE_UPLOADS, start);
   return texture_id;
+}
+
+void
+read_pixels(
+  int32_t x,
+  int32_t y,
+  uint32_t width,
+  uint32_t height,
+  uint8_t* buffer)
+{
+  uint64_t start = stats_timer_begin();
+  if (renderer_backend) {
+    renderer_backend->read_pixels(x, y, width, height, buffer);
+    stats_timer_end(RENDERER_TIMER_READ_PIXELS, start);
+    return;
+  }
+
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(
+    x, y, (GLsizei)width, (GLsizei)height,
+    GL_RGBA, GL_UNSIGNED_BYTE, buffer);
+  stats_timer_end(RENDERER_TIMER_READ_PIXELS, start);
+}
+
+void
+get_state_counters(renderer_state_counters_t* counters)
+{
+  state_get_counters(&counters->issued, &counters->skipped);
+  state_get_skipped_updates(
+    &counters->viewport_skipped,
+    &counters->projection_skipped,
+    &counters->light_skipped);
+}
+
+void
+reset_state_counters()
+{
+  state_reset_counters();
+}
+
+void
+invalidate_state_cache()
+{
+  state_cache_reset();
 }
\ No newline at end of file
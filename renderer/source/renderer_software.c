@@ -0,0 +1,1190 @@
+/**
+ * @file renderer_software.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/renderer_software.h>
+#include <renderer/texture_cache.h>
+#include <renderer/texture_compression.h>
+#include <renderer/internal/backend.h>
+#include <renderer/internal/jobs.h>
+#include <renderer/internal/light_clusters.h>
+#include <renderer/internal/renderer_internal.h>
+#include <renderer/internal/software_raster.h>
+#include <renderer/internal/unit_quads.h>
+
+
+#define SOFTWARE_LIGHT_COUNT      8
+#define SOFTWARE_VERTEX_BATCH     4096    // vertices lit per job.
+#define CLIP_PLANE_COUNT          6
+#define CLIP_MAX_VERTICES         (3 + CLIP_PLANE_COUNT)
+
+typedef
+struct clip_vertex_t {
+  float position[4];
+  float color[4];
+  float uv[2];
+} clip_vertex_t;
+
+typedef
+struct window_vertex_t {
+  float x;
+  float y;
+  float z;
+  float inv_w;
+  float color[4];           // divided by w.
+  float uv[2];              // divided by w.
+} window_vertex_t;
+
+typedef
+struct primitive_state_t {
+  const raster_texture_t* texture;
+  uint8_t blend;
+  uint8_t depth_test;
+  int32_t cull;
+} primitive_state_t;
+
+typedef
+struct software_state_t {
+  renderer_software_target_t target;
+  float viewport[4];
+  float projection[16];     // row major, same layout as matrix4f.
+  int32_t depth_test;
+  eye_light_t lights[SOFTWARE_LIGHT_COUNT];
+  int32_t light_enabled[SOFTWARE_LIGHT_COUNT];
+  raster_texture_t** textures;    // indexed by id - 1, NULL if free.
+  uint32_t textures_capacity;
+  clip_vertex_t* vertices;        // per draw scratch.
+  uint32_t vertices_capacity;
+  float* scratch;                 // unit quads expansion, in floats.
+  uint32_t scratch_capacity;
+} software_state_t;
+
+static software_state_t software;
+
+static
+void
+set_identity(float* m)
+{
+  memset(m, 0, sizeof(float) * 16);
+  m[0] = m[5] = m[10] = m[15] = 1.f;
+}
+
+static
+void
+get_modelview(pipeline_t* pipeline, float* modelview)
+{
+  matrix4f top;
+
+  if (!pipeline) {
+    set_identity(modelview);
+    return;
+  }
+
+  set_matrix_mode(pipeline, MODELVIEW);
+  top = get_matrix(pipeline);
+  memcpy(modelview, top.data, sizeof(float) * 16);
+}
+
+/// @brief inverse transpose of the upper 3x3 of @a m, normals are normalized
+/// after the transform (GL_NORMALIZE) so only the direction matters.
+static
+void
+get_normal_matrix(const float* m, float* normal)
+{
+  float determinant;
+
+  normal[0] = m[5] * m[10] - m[6] * m[9];
+  normal[1] = m[6] * m[8] - m[4] * m[10];
+  normal[2] = m[4] * m[9] - m[5] * m[8];
+  normal[3] = m[2] * m[9] - m[1] * m[10];
+  normal[4] = m[0] * m[10] - m[2] * m[8];
+  normal[5] = m[1] * m[8] - m[0] * m[9];
+  normal[6] = m[1] * m[6] - m[2] * m[5];
+  normal[7] = m[2] * m[4] - m[0] * m[6];
+  normal[8] = m[0] * m[5] - m[1] * m[4];
+
+  determinant = m[0] * normal[0] + m[1] * normal[1] + m[2] * normal[2];
+  if (determinant < 0.f) {
+    for (uint32_t i = 0; i < 9; ++i)
+      normal[i] = -normal[i];
+  }
+}
+
+static
+void
+normalize(float* v)
+{
+  float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+  if (length > 0.f) {
+    v[0] /= length;
+    v[1] /= length;
+    v[2] /= length;
+  }
+}
+
+static
+int32_t
+reserve_vertices(uint32_t count)
+{
+  clip_vertex_t* vertices = NULL;
+  uint32_t capacity = software.vertices_capacity ?
+    software.vertices_capacity : 1024;
+
+  if (count <= software.vertices_capacity)
+    return 1;
+
+  while (capacity < count)
+    capacity *= 2;
+
+  vertices = realloc(software.vertices, sizeof(clip_vertex_t) * capacity);
+  if (!vertices)
+    return 0;
+
+  software.vertices = vertices;
+  software.vertices_capacity = capacity;
+  return 1;
+}
+
+static
+int32_t
+reserve_scratch(uint32_t count)
+{
+  float* scratch = NULL;
+  uint32_t capacity = software.scratch_capacity ?
+    software.scratch_capacity : 1024;
+
+  if (count <= software.scratch_capacity)
+    return 1;
+
+  while (capacity < count)
+    capacity *= 2;
+
+  scratch = realloc(software.scratch, sizeof(float) * capacity);
+  if (!scratch)
+    return 0;
+
+  software.scratch = scratch;
+  software.scratch_capacity = capacity;
+  return 1;
+}
+
+static
+raster_texture_t*
+get_texture(uint32_t texture_id)
+{
+  if (!texture_id || texture_id > software.textures_capacity)
+    return NULL;
+  return software.textures[texture_id - 1];
+}
+
+static
+void
+transform_vertex(
+  const float* mvp,
+  const float* position,
+  const float* color,
+  clip_vertex_t* vertex)
+{
+  for (uint32_t row = 0; row < 4; ++row) {
+    const float* r = mvp + row * 4;
+    vertex->position[row] =
+      r[0] * position[0] + r[1] * position[1] + r[2] * position[2] + r[3];
+  }
+
+  memcpy(vertex->color, color, sizeof(vertex->color));
+  vertex->uv[0] = vertex->uv[1] = 0.f;
+}
+
+/// @brief adds the contribution of @a light to @a color.
+static
+void
+add_light(
+  const eye_light_t* light,
+  const float* eye,
+  const float* normal,
+  const mesh_render_data_t* mesh,
+  float* color)
+{
+  const float* ambient = mesh->ambient.data;
+  const float* diffuse = mesh->diffuse.data;
+  const float* specular = mesh->specular.data;
+  float direction[3], factor = 1.f, n_dot_l;
+
+  if (light->position[3] != 0.f) {
+    float distance;
+    direction[0] = light->position[0] - eye[0];
+    direction[1] = light->position[1] - eye[1];
+    direction[2] = light->position[2] - eye[2];
+    distance = sqrtf(
+      direction[0] * direction[0] +
+      direction[1] * direction[1] +
+      direction[2] * direction[2]);
+    normalize(direction);
+    factor = 1.f / (
+      light->attenuation[0] +
+      light->attenuation[1] * distance +
+      light->attenuation[2] * distance * distance);
+
+    // GL_SPOT_EXPONENT is 0, full intensity inside the cone.
+    if (
+      -(direction[0] * light->direction[0] +
+        direction[1] * light->direction[1] +
+        direction[2] * light->direction[2]) < light->direction[3])
+      return;
+  } else {
+    memcpy(direction, light->position, sizeof(direction));
+    normalize(direction);
+  }
+
+  n_dot_l =
+    normal[0] * direction[0] +
+    normal[1] * direction[1] +
+    normal[2] * direction[2];
+
+  for (uint32_t c = 0; c < 3; ++c) {
+    float term = light->ambient[c] * ambient[c];
+    if (n_dot_l > 0.f)
+      term +=
+        n_dot_l * light->diffuse[c] * diffuse[c] +
+        light->specular[c] * specular[c];
+    color[c] += factor * term;
+  }
+}
+
+/// @brief fixed function lighting, local viewer off, no emission and a black
+/// global ambient (see renderer_initialize). the shininess is left at 0 so the
+/// specular term is constant on the lit side, same as the opengl path. the
+/// clustered lights replace the fixed ones, the vertex is lit by its cluster.
+static
+void
+light_vertex(
+  const float* eye,
+  const float* normal,
+  const mesh_render_data_t* mesh,
+  float* color)
+{
+  color[0] = color[1] = color[2] = 0.f;
+  color[3] = mesh->diffuse.data[3];
+
+  if (light_clusters.light_count) {
+    const uint32_t* record = light_clusters.records[light_clusters_find(eye)];
+    const uint16_t* indices = light_clusters.indices + record[0];
+    for (uint32_t i = 0; i < record[1]; ++i)
+      add_light(light_clusters.lights + indices[i], eye, normal, mesh, color);
+  } else {
+    for (uint32_t i = 0; i < SOFTWARE_LIGHT_COUNT; ++i) {
+      if (software.light_enabled[i])
+        add_light(software.lights + i, eye, normal, mesh, color);
+    }
+  }
+
+  for (uint32_t c = 0; c < 4; ++c)
+    color[c] = color[c] < 0.f ? 0.f : (color[c] > 1.f ? 1.f : color[c]);
+}
+
+typedef
+struct vertex_job_t {
+  const mesh_render_data_t* mesh;
+  const float* modelview;
+  const float* mvp;
+  const float* normal_matrix;
+  clip_vertex_t* vertices;
+} vertex_job_t;
+
+/// @brief transforms and lights a batch of SOFTWARE_VERTEX_BATCH vertices.
+static
+void
+vertex_job(void* data, uint32_t batch)
+{
+  const vertex_job_t* job = (const vertex_job_t*)data;
+  const mesh_render_data_t* mesh = job->mesh;
+  uint32_t first = batch * SOFTWARE_VERTEX_BATCH;
+  uint32_t last = first + SOFTWARE_VERTEX_BATCH < mesh->vertex_count ?
+    first + SOFTWARE_VERTEX_BATCH : mesh->vertex_count;
+
+  for (uint32_t i = first; i < last; ++i) {
+    const float* position;
+    const float* normal;
+    const float* uv;
+    const float* m = job->modelview;
+    const float* n = job->normal_matrix;
+    float eye[3], eye_normal[3];
+    clip_vertex_t* vertex = job->vertices + i;
+
+    if (mesh->interleaved) {
+      position = mesh->interleaved[i].position;
+      normal = mesh->interleaved[i].normal;
+      uv = mesh->interleaved[i].uv;
+    } else {
+      position = mesh->vertices + i * 3;
+      normal = mesh->normals + i * 3;
+      uv = mesh->uv_coords + i * 3;
+    }
+
+    for (uint32_t row = 0; row < 3; ++row) {
+      eye[row] =
+        m[row * 4 + 0] * position[0] +
+        m[row * 4 + 1] * position[1] +
+        m[row * 4 + 2] * position[2] +
+        m[row * 4 + 3];
+      eye_normal[row] =
+        n[row * 3 + 0] * normal[0] +
+        n[row * 3 + 1] * normal[1] +
+        n[row * 3 + 2] * normal[2];
+    }
+    normalize(eye_normal);
+
+    transform_vertex(job->mvp, position, mesh->diffuse.data, vertex);
+    light_vertex(eye, eye_normal, mesh, vertex->color);
+    vertex->uv[0] = uv[0];
+    vertex->uv[1] = uv[1];
+  }
+}
+
+static
+float
+get_plane_distance(const clip_vertex_t* vertex, uint32_t plane)
+{
+  const float* p = vertex->position;
+  float value = p[plane >> 1];
+  return p[3] + ((plane & 1) ? -value : value);
+}
+
+static
+uint32_t
+get_outcode(const clip_vertex_t* vertex)
+{
+  uint32_t code = 0;
+  for (uint32_t plane = 0; plane < CLIP_PLANE_COUNT; ++plane) {
+    if (get_plane_distance(vertex, plane) < 0.f)
+      code |= 1u << plane;
+  }
+  return code;
+}
+
+static
+void
+lerp_vertex(
+  const clip_vertex_t* a,
+  const clip_vertex_t* b,
+  float t,
+  clip_vertex_t* result)
+{
+  for (uint32_t i = 0; i < 4; ++i) {
+    result->position[i] =
+      a->position[i] + (b->position[i] - a->position[i]) * t;
+    result->color[i] = a->color[i] + (b->color[i] - a->color[i]) * t;
+  }
+  result->uv[0] = a->uv[0] + (b->uv[0] - a->uv[0]) * t;
+  result->uv[1] = a->uv[1] + (b->uv[1] - a->uv[1]) * t;
+}
+
+/// @brief sutherland-hodgman against a single plane, returns the new count.
+static
+uint32_t
+clip_polygon(
+  const clip_vertex_t* input,
+  uint32_t count,
+  uint32_t plane,
+  clip_vertex_t* output)
+{
+  uint32_t result = 0;
+
+  for (uint32_t i = 0; i < count; ++i) {
+    const clip_vertex_t* current = input + i;
+    const clip_vertex_t* next = input + (i + 1) % count;
+    float d0 = get_plane_distance(current, plane);
+    float d1 = get_plane_distance(next, plane);
+
+    if (d0 >= 0.f)
+      output[result++] = *current;
+    if ((d0 >= 0.f) != (d1 >= 0.f))
+      lerp_vertex(current, next, d0 / (d0 - d1), output + result++);
+  }
+
+  return result;
+}
+
+static
+void
+to_window(const clip_vertex_t* vertex, window_vertex_t* result)
+{
+  const float* p = vertex->position;
+  float inv_w = 1.f / p[3];
+
+  result->x =
+    software.viewport[0] + (p[0] * inv_w + 1.f) * 0.5f * software.viewport[2];
+  result->y =
+    software.viewport[1] + (p[1] * inv_w + 1.f) * 0.5f * software.viewport[3];
+  result->z = (p[2] * inv_w + 1.f) * 0.5f;
+  result->inv_w = inv_w;
+  for (uint32_t i = 0; i < 4; ++i)
+    result->color[i] = vertex->color[i] * inv_w;
+  result->uv[0] = vertex->uv[0] * inv_w;
+  result->uv[1] = vertex->uv[1] * inv_w;
+}
+
+static
+void
+push_triangle(
+  const window_vertex_t* a,
+  const window_vertex_t* b,
+  const window_vertex_t* c,
+  const primitive_state_t* state)
+{
+  const window_vertex_t* vertices[3] = { a, b, c };
+  raster_triangle_t* triangle = raster_append(1);
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    triangle->x[i] = vertices[i]->x;
+    triangle->y[i] = vertices[i]->y;
+    triangle->z[i] = vertices[i]->z;
+    triangle->inv_w[i] = vertices[i]->inv_w;
+    memcpy(triangle->color[i], vertices[i]->color, sizeof(float) * 4);
+    memcpy(triangle->uv[i], vertices[i]->uv, sizeof(float) * 2);
+  }
+
+  triangle->texture = state->texture;
+  triangle->blend = state->blend;
+  triangle->depth_test = state->depth_test;
+}
+
+/// @brief projects a convex polygon that is inside the clip volume, culls it
+/// (counter clockwise front faces) and queues it as a fan.
+static
+void
+emit_polygon(
+  const clip_vertex_t* polygon,
+  uint32_t count,
+  const primitive_state_t* state)
+{
+  window_vertex_t vertices[CLIP_MAX_VERTICES];
+
+  for (uint32_t i = 0; i < count; ++i)
+    to_window(polygon + i, vertices + i);
+
+  if (state->cull) {
+    float area = 0.f;
+    for (uint32_t i = 0; i < count; ++i) {
+      const window_vertex_t* a = vertices + i;
+      const window_vertex_t* b = vertices + (i + 1) % count;
+      area += a->x * b->y - b->x * a->y;
+    }
+
+    if (area <= 0.f)
+      return;
+  }
+
+  for (uint32_t i = 1; i + 1 < count; ++i)
+    push_triangle(vertices, vertices + i, vertices + i + 1, state);
+}
+
+static
+void
+emit_triangle(
+  const clip_vertex_t* a,
+  const clip_vertex_t* b,
+  const clip_vertex_t* c,
+  const primitive_state_t* state)
+{
+  clip_vertex_t polygons[2][CLIP_MAX_VERTICES];
+  uint32_t codes[3] = { get_outcode(a), get_outcode(b), get_outcode(c) };
+  uint32_t planes = codes[0] | codes[1] | codes[2];
+  uint32_t count = 3, current = 0;
+
+  if (codes[0] & codes[1] & codes[2])
+    return;
+
+  polygons[0][0] = *a;
+  polygons[0][1] = *b;
+  polygons[0][2] = *c;
+
+  for (uint32_t plane = 0; plane < CLIP_PLANE_COUNT && count >= 3; ++plane) {
+    if (!(planes & (1u << plane)))
+      continue;
+
+    count = clip_polygon(
+      polygons[current], count, plane, polygons[current ^ 1]);
+    current ^= 1;
+  }
+
+  if (count >= 3)
+    emit_polygon(polygons[current], count, state);
+}
+
+/// @brief queues a screen aligned quad, lines and points are drawn as quads.
+static
+void
+emit_quad(
+  const window_vertex_t* quad,
+  const primitive_state_t* state)
+{
+  push_triangle(quad + 0, quad + 1, quad + 2, state);
+  push_triangle(quad + 0, quad + 2, quad + 3, state);
+}
+
+static
+void
+emit_line(
+  const clip_vertex_t* a,
+  const clip_vertex_t* b,
+  float width,
+  const primitive_state_t* state)
+{
+  float t0 = 0.f, t1 = 1.f, dx, dy, length, nx, ny;
+  clip_vertex_t clipped[2];
+  window_vertex_t ends[2], quad[4];
+
+  for (uint32_t plane = 0; plane < CLIP_PLANE_COUNT; ++plane) {
+    float d0 = get_plane_distance(a, plane);
+    float d1 = get_plane_distance(b, plane);
+    if (d0 < 0.f && d1 < 0.f)
+      return;
+    if (d0 < 0.f)
+      t0 = fmaxf(t0, d0 / (d0 - d1));
+    else if (d1 < 0.f)
+      t1 = fminf(t1, d0 / (d0 - d1));
+  }
+
+  if (t0 > t1)
+    return;
+
+  lerp_vertex(a, b, t0, clipped + 0);
+  lerp_vertex(a, b, t1, clipped + 1);
+  to_window(clipped + 0, ends + 0);
+  to_window(clipped + 1, ends + 1);
+
+  dx = ends[1].x - ends[0].x;
+  dy = ends[1].y - ends[0].y;
+  length = sqrtf(dx * dx + dy * dy);
+  if (length < 1e-6f)
+    return;
+
+  nx = -dy / length * width * 0.5f;
+  ny = dx / length * width * 0.5f;
+  quad[0] = quad[1] = ends[0];
+  quad[2] = quad[3] = ends[1];
+  quad[0].x += nx;
+  quad[0].y += ny;
+  quad[1].x -= nx;
+  quad[1].y -= ny;
+  quad[2].x -= nx;
+  quad[2].y -= ny;
+  quad[3].x += nx;
+  quad[3].y += ny;
+  emit_quad(quad, state);
+}
+
+static
+void
+emit_point(
+  const clip_vertex_t* vertex,
+  float size,
+  const primitive_state_t* state)
+{
+  window_vertex_t center, quad[4];
+  float half = size * 0.5f;
+
+  // like opengl, points are dropped if their center is clipped.
+  if (get_outcode(vertex))
+    return;
+
+  to_window(vertex, &center);
+  quad[0] = quad[1] = quad[2] = quad[3] = center;
+  quad[0].x -= half;
+  quad[0].y -= half;
+  quad[1].x += half;
+  quad[1].y -= half;
+  quad[2].x += half;
+  quad[2].y += half;
+  quad[3].x -= half;
+  quad[3].y += half;
+  emit_quad(quad, state);
+}
+
+static
+void
+get_unlit_state(primitive_state_t* state)
+{
+  state->texture = NULL;
+  state->blend = RASTER_BLEND_NONE;
+  state->depth_test = (uint8_t)software.depth_test;
+  state->cull = 0;
+}
+
+/// @brief transforms @a count positions spaced by @a stride floats into the
+/// scratch vertices, returns 0 on allocation failure.
+static
+int32_t
+transform_positions(
+  const float* positions,
+  uint32_t stride,
+  uint32_t count,
+  color_t color,
+  pipeline_t* pipeline)
+{
+  float modelview[16], mvp[16];
+
+  if (!reserve_vertices(count))
+    return 0;
+
+  get_modelview(pipeline, modelview);
+  pipeline_multiply(software.projection, modelview, mvp);
+  for (uint32_t i = 0; i < count; ++i, positions += stride)
+    transform_vertex(mvp, positions, color.data, software.vertices + i);
+
+  return 1;
+}
+
+static
+void
+software_cleanup(void)
+{
+  raster_cleanup();
+  jobs_cleanup();
+
+  for (uint32_t i = 0; i < software.textures_capacity; ++i) {
+    if (software.textures[i]) {
+      free(software.textures[i]->texels);
+      free(software.textures[i]);
+    }
+  }
+
+  free(software.textures);
+  free(software.vertices);
+  free(software.scratch);
+  memset(&software, 0, sizeof(software_state_t));
+}
+
+static
+void
+software_set_depth_test(int32_t enable)
+{
+  software.depth_test = enable;
+}
+
+static
+void
+software_clear_color_and_depth_buffers(void)
+{
+  // same as the clear color set by renderer_initialize.
+  float color[4] = { 0.3f, 0.3f, 0.3f, 1.f };
+  raster_clear(color);
+}
+
+static
+void
+software_flush_operations(void)
+{
+  raster_flush();
+}
+
+static
+void
+software_update_viewport(const pipeline_t* pipeline)
+{
+  get_viewport_info(
+    pipeline,
+    software.viewport + 0,
+    software.viewport + 1,
+    software.viewport + 2,
+    software.viewport + 3);
+}
+
+static
+void
+software_update_projection(const pipeline_t* pipeline)
+{
+  renderer_internal_get_projection_matrix(pipeline, software.projection);
+}
+
+static
+void
+software_set_light(uint32_t index, int32_t enable)
+{
+  assert(index < SOFTWARE_LIGHT_COUNT);
+  software.light_enabled[index] = enable;
+}
+
+/// @brief mirrors the glLightfv calls of the opengl path, the position and
+/// direction are stored in eye space.
+static
+void
+software_set_light_properties(
+  uint32_t index,
+  renderer_light_t* light,
+  pipeline_t* pipeline)
+{
+  float m[16];
+  assert(index < SOFTWARE_LIGHT_COUNT);
+
+  get_modelview(pipeline, m);
+  eye_light_set(software.lights + index, light, m);
+}
+
+static
+void
+software_draw_grid(
+  pipeline_t* pipeline,
+  float width,
+  int32_t lines_per_axis)
+{
+  float half = width / 2;
+  float step = width / lines_per_axis;
+  float black[4] = { 0.f, 0.f, 0.f, 1.f };
+  float modelview[16], mvp[16];
+  primitive_state_t state;
+
+  if (lines_per_axis <= 0 || !reserve_vertices(4))
+    return;
+
+  get_unlit_state(&state);
+  get_modelview(pipeline, modelview);
+  pipeline_multiply(software.projection, modelview, mvp);
+
+  for (int32_t i = 0; i <= lines_per_axis; ++i) {
+    float offset = -half + step * i;
+    float line[12] = {
+      -half, 0, offset,
+      half, 0, offset,
+      offset, 0, -half,
+      offset, 0, half };
+    clip_vertex_t* vertices = software.vertices;
+    for (uint32_t j = 0; j < 4; ++j)
+      transform_vertex(mvp, line + j * 3, black, vertices + j);
+
+    emit_line(vertices + 0, vertices + 1, 1.f, &state);
+    emit_line(vertices + 2, vertices + 3, 1.f, &state);
+  }
+}
+
+static
+void
+software_draw_points(
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float size,
+  pipeline_t* pipeline)
+{
+  primitive_state_t state;
+  get_unlit_state(&state);
+
+  if (!transform_positions(vertices, 3, vertices_count, color, pipeline))
+    return;
+
+  for (uint32_t i = 0; i < vertices_count; ++i)
+    emit_point(software.vertices + i, size, &state);
+}
+
+static
+void
+software_draw_lines(
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float width,
+  pipeline_t* pipeline)
+{
+  primitive_state_t state;
+  get_unlit_state(&state);
+
+  if (
+    vertices_count < 2 ||
+    !transform_positions(vertices, 3, vertices_count, color, pipeline))
+    return;
+
+  for (uint32_t i = 0; i + 1 < vertices_count; ++i)
+    emit_line(software.vertices + i, software.vertices + i + 1, width, &state);
+}
+
+/// @brief the vertices are in view space, only the projection applies.
+static
+void
+software_draw_debug_batch(
+  GLenum mode,
+  const debug_vertex_t* vertices,
+  uint32_t vertices_count,
+  const uint32_t* indices,
+  uint32_t indices_count,
+  float width)
+{
+  primitive_state_t state;
+  get_unlit_state(&state);
+
+  if (!reserve_vertices(vertices_count))
+    return;
+
+  for (uint32_t i = 0; i < vertices_count; ++i) {
+    float color[4];
+    for (uint32_t j = 0; j < 4; ++j)
+      color[j] = vertices[i].color[j] / 255.f;
+    transform_vertex(
+      software.projection, vertices[i].position, color, software.vertices + i);
+  }
+
+  if (mode == GL_LINES) {
+    for (uint32_t i = 0; i + 1 < indices_count; i += 2)
+      emit_line(
+        software.vertices + indices[i],
+        software.vertices + indices[i + 1],
+        width,
+        &state);
+  } else {
+    for (uint32_t i = 0; i < vertices_count; ++i)
+      emit_point(software.vertices + i, width, &state);
+  }
+}
+
+static
+void
+software_draw_unit_quads(
+  const unit_quad_t* uvs,
+  uint32_t uvs_count,
+  int32_t texture_id,
+  color_t tint,
+  pipeline_t* pipeline)
+{
+  uint32_t positions_count = uvs_count * UNIT_QUAD_VERTICES * 3;
+  float* tex_coords = NULL;
+  primitive_state_t state;
+
+  state.texture = get_texture((uint32_t)texture_id);
+  texture_cache_touch((uint32_t)texture_id);
+  state.blend = RASTER_BLEND_COLOR;
+  state.depth_test = 0;
+  state.cull = 0;
+
+  if (
+    !uvs_count ||
+    !reserve_scratch(uvs_count * UNIT_QUAD_VERTICES * 5))
+    return;
+
+  tex_coords = software.scratch + positions_count;
+  expand_unit_quads(uvs, uvs_count, software.scratch, tex_coords);
+  if (
+    !transform_positions(
+      software.scratch,
+      3,
+      uvs_count * UNIT_QUAD_VERTICES,
+      tint,
+      pipeline))
+    return;
+
+  for (uint32_t i = 0; i < uvs_count; ++i) {
+    clip_vertex_t* quad = software.vertices + i * UNIT_QUAD_VERTICES;
+    for (uint32_t j = 0; j < UNIT_QUAD_VERTICES; ++j) {
+      quad[j].uv[0] = tex_coords[(i * UNIT_QUAD_VERTICES + j) * 2 + 0];
+      quad[j].uv[1] = tex_coords[(i * UNIT_QUAD_VERTICES + j) * 2 + 1];
+    }
+
+    emit_triangle(quad + 0, quad + 1, quad + 2, &state);
+    emit_triangle(quad + 0, quad + 2, quad + 3, &state);
+  }
+}
+
+static
+void
+software_draw_meshes_wireframe(
+  const mesh_render_data_t* mesh,
+  uint32_t mesh_count,
+  color_t color,
+  float width,
+  pipeline_t* pipeline)
+{
+  primitive_state_t state;
+  get_unlit_state(&state);
+
+  for (uint32_t i = 0; i < mesh_count; ++i) {
+    const float* positions = mesh[i].interleaved ?
+      mesh[i].interleaved->position : mesh[i].vertices;
+    uint32_t stride = mesh[i].interleaved ?
+      sizeof(renderer_vertex_t) / sizeof(float) : 3;
+    const uint32_t* indices = mesh[i].indices;
+
+    if (
+      !transform_positions(
+        positions, stride, mesh[i].vertex_count, color, pipeline))
+      return;
+
+    for (uint32_t j = 0; j + 2 < mesh[i].indices_count; j += 3) {
+      const clip_vertex_t* v1 = software.vertices + indices[j + 0];
+      const clip_vertex_t* v2 = software.vertices + indices[j + 1];
+      const clip_vertex_t* v3 = software.vertices + indices[j + 2];
+      emit_line(v1, v2, width, &state);
+      emit_line(v1, v3, width, &state);
+      emit_line(v2, v3, width, &state);
+    }
+  }
+}
+
+/// @brief transforms and emits @a mesh with the matrices in @a job, 0 if the
+/// vertices could not be reserved.
+static
+int32_t
+emit_mesh(
+  const mesh_render_data_t* mesh,
+  uint32_t texture_id,
+  vertex_job_t* job)
+{
+  primitive_state_t state;
+  const uint32_t* indices = mesh->indices;
+  if (!reserve_vertices(mesh->vertex_count))
+    return 0;
+
+  job->mesh = mesh;
+  job->vertices = software.vertices;
+  jobs_parallel_for(
+    (mesh->vertex_count + SOFTWARE_VERTEX_BATCH - 1) / SOFTWARE_VERTEX_BATCH,
+    vertex_job,
+    job);
+
+  state.texture = get_texture(texture_id);
+  texture_cache_touch(texture_id);
+  state.blend =
+    mesh->ambient.data[3] < 1.f ||
+    mesh->diffuse.data[3] < 1.f ||
+    mesh->specular.data[3] < 1.f ? RASTER_BLEND_ALPHA : RASTER_BLEND_NONE;
+  state.depth_test = (uint8_t)software.depth_test;
+  state.cull = 1;
+
+  for (uint32_t j = 0; j + 2 < mesh->indices_count; j += 3)
+    emit_triangle(
+      software.vertices + indices[j + 0],
+      software.vertices + indices[j + 1],
+      software.vertices + indices[j + 2],
+      &state);
+  return 1;
+}
+
+static
+void
+software_draw_meshes(
+  const mesh_render_data_t* mesh,
+  const uint32_t* texture_data,
+  uint32_t mesh_count,
+  pipeline_t* pipeline)
+{
+  float modelview[16], mvp[16], normal_matrix[9];
+  vertex_job_t job;
+
+  get_modelview(pipeline, modelview);
+  pipeline_multiply(software.projection, modelview, mvp);
+  get_normal_matrix(modelview, normal_matrix);
+  job.modelview = modelview;
+  job.mvp = mvp;
+  job.normal_matrix = normal_matrix;
+
+  for (uint32_t i = 0; i < mesh_count; ++i) {
+    if (!emit_mesh(mesh + i, texture_data[i], &job))
+      return;
+  }
+}
+
+static
+void
+software_draw_meshes_instanced(
+  const mesh_render_data_t* mesh,
+  uint32_t texture_id,
+  const matrix4f* instances,
+  const color_t* tints,
+  uint32_t instance_count,
+  pipeline_t* pipeline)
+{
+  float view[16], modelview[16], mvp[16], normal_matrix[9];
+  mesh_render_data_t tinted = *mesh;
+  vertex_job_t job;
+
+  get_modelview(pipeline, view);
+  job.modelview = modelview;
+  job.mvp = mvp;
+  job.normal_matrix = normal_matrix;
+
+  for (uint32_t i = 0; i < instance_count; ++i) {
+    pipeline_multiply(view, instances[i].data, modelview);
+    pipeline_multiply(software.projection, modelview, mvp);
+    get_normal_matrix(modelview, normal_matrix);
+
+    if (tints) {
+      tinted.ambient =
+        renderer_internal_modulate_color(&mesh->ambient, tints + i);
+      tinted.diffuse =
+        renderer_internal_modulate_color(&mesh->diffuse, tints + i);
+      tinted.specular =
+        renderer_internal_modulate_color(&mesh->specular, tints + i);
+    }
+
+    if (!emit_mesh(&tinted, texture_id, &job))
+      return;
+  }
+}
+
+static
+uint32_t
+software_upload_to_gpu(
+  const char* path,
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  uint32_t index = 0;
+  raster_texture_t* texture = NULL;
+  (void)path;
+
+  while (index < software.textures_capacity && software.textures[index])
+    ++index;
+
+  if (index == software.textures_capacity) {
+    uint32_t capacity = software.textures_capacity ?
+      software.textures_capacity * 2 : 64;
+    raster_texture_t** textures = realloc(
+      software.textures, sizeof(raster_texture_t*) * capacity);
+    if (!textures)
+      return 0;
+
+    memset(
+      textures + software.textures_capacity,
+      0,
+      sizeof(raster_texture_t*) * (capacity - software.textures_capacity));
+    software.textures = textures;
+    software.textures_capacity = capacity;
+  }
+
+  texture = malloc(sizeof(raster_texture_t));
+  if (!texture)
+    return 0;
+
+  texture->width = width;
+  texture->height = height;
+  texture->texels = malloc((size_t)width * height * 4);
+  if (!texture->texels) {
+    free(texture);
+    return 0;
+  }
+
+  if (texture_compression_is_compressed(format))
+    texture_decompress(buffer, width, height, format, texture->texels);
+  else
+    renderer_internal_convert_texels(
+      buffer, width * height, format, texture->texels);
+  software.textures[index] = texture;
+  return index + 1;
+}
+
+static
+uint32_t
+software_evict_from_gpu(uint32_t texture_id)
+{
+  raster_texture_t* texture = get_texture(texture_id);
+  if (!texture)
+    return texture_id;
+
+  // queued triangles may still sample it.
+  if (raster_pending())
+    raster_flush();
+
+  free(texture->texels);
+  free(texture);
+  software.textures[texture_id - 1] = NULL;
+  return texture_id;
+}
+
+static
+void
+software_read_pixels(
+  int32_t x,
+  int32_t y,
+  uint32_t width,
+  uint32_t height,
+  uint8_t* buffer)
+{
+  raster_flush();
+
+  for (uint32_t row = 0; row < height; ++row) {
+    int32_t source_y = y + (int32_t)row;
+    int32_t source_x = x;
+    uint32_t count = width;
+    uint8_t* target = buffer + (size_t)row * width * 4;
+
+    if (source_y < 0 || source_y >= (int32_t)software.target.height)
+      continue;
+
+    if (source_x < 0) {
+      if ((uint32_t)-source_x >= count)
+        continue;
+      target += (size_t)-source_x * 4;
+      count -= (uint32_t)-source_x;
+      source_x = 0;
+    }
+
+    if (source_x >= (int32_t)software.target.width)
+      continue;
+    if (source_x + count > software.target.width)
+      count = software.target.width - (uint32_t)source_x;
+
+    memcpy(
+      target,
+      software.target.color +
+        ((size_t)source_y * software.target.width + source_x) * 4,
+      (size_t)count * 4);
+  }
+}
+
+static const renderer_backend_t software_backend = {
+  software_cleanup,
+  software_set_depth_test,
+  software_clear_color_and_depth_buffers,
+  software_flush_operations,
+  software_update_viewport,
+  software_update_projection,
+  software_set_light,
+  software_set_light_properties,
+  software_draw_grid,
+  software_draw_points,
+  software_draw_lines,
+  software_draw_debug_batch,
+  software_draw_unit_quads,
+  software_draw_meshes_wireframe,
+  software_draw_meshes,
+  software_draw_meshes_instanced,
+  NULL,
+  NULL,
+  NULL,
+  software_upload_to_gpu,
+  software_evict_from_gpu,
+  software_read_pixels,
+  0
+};
+
+void
+renderer_initialize_software(
+  const renderer_software_target_t* target,
+  uint32_t thread_count)
+{
+  assert(target && target->color && target->depth);
+
+  memset(&software, 0, sizeof(software_state_t));
+  software.target = *target;
+  software.viewport[2] = (float)target->width;
+  software.viewport[3] = (float)target->height;
+  set_identity(software.projection);
+  software.depth_test = 1;
+
+  for (uint32_t i = 0; i < SOFTWARE_LIGHT_COUNT; ++i)
+    eye_light_set_default(software.lights + i, i);
+
+  jobs_initialize(thread_count);
+  raster_initialize(target);
+  renderer_backend = &software_backend;
+}
@@ -0,0 +1,360 @@
+/**
+ * @file renderer_stats.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/renderer_stats.h>
+#include <renderer/internal/frame_stats.h>
+#include <renderer/internal/opengl_extensions.h>
+#include <renderer/internal/state_cache.h>
+#include <renderer/internal/timer.h>
+
+
+// the results are read back a few frames late so the cpu never waits on them.
+#define STATS_QUERIES             4
+
+typedef
+struct stats_query_t {
+  GLuint query;
+  uint64_t frame;
+  int32_t pending;          // ended, the result is not read yet.
+} stats_query_t;
+
+typedef
+struct renderer_stats_t {
+  int32_t enabled;
+  uint64_t frame;           // the one being recorded.
+  uint64_t frame_start;
+  uint64_t state_issued;    // state cache count at the frame start.
+  uint64_t timer_ns[RENDERER_TIMER_COUNT];
+  uint32_t timer_calls[RENDERER_TIMER_COUNT];
+  renderer_frame_stats_t frames[RENDERER_STATS_FRAMES];
+  uint32_t frames_count;
+  stats_query_t queries[STATS_QUERIES];
+  int32_t query_active;
+} renderer_stats_t;
+
+frame_counters_t frame_counters;
+static renderer_stats_t stats;
+
+static const char* timer_names[RENDERER_TIMER_COUNT] = {
+  "clear",
+  "flush",
+  "view",
+  "state",
+  "light_clusters",
+  "grid",
+  "points",
+  "lines",
+  "unit_quads",
+  "wireframe",
+  "meshes",
+  "instances",
+  "render_queue",
+  "mesh_handles",
+  "mesh_uploads",
+  "texture_uploads",
+  "streaming",
+  "read_pixels" };
+
+static
+void
+start_frame(uint64_t now)
+{
+  uint64_t skipped;
+  stats.frame_start = now;
+  state_get_counters(&stats.state_issued, &skipped);
+  memset(stats.timer_ns, 0, sizeof(stats.timer_ns));
+  memset(stats.timer_calls, 0, sizeof(stats.timer_calls));
+  memset(&frame_counters, 0, sizeof(frame_counters_t));
+}
+
+/// @brief drops the pending results, the queries can be reused right away.
+static
+void
+discard_queries(void)
+{
+  if (stats.query_active) {
+    glEndQuery(GL_TIME_ELAPSED);
+    stats.query_active = 0;
+  }
+
+  for (uint32_t i = 0; i < STATS_QUERIES; ++i)
+    stats.queries[i].pending = 0;
+}
+
+void
+enable_renderer_stats()
+{
+  if (stats.enabled)
+    return;
+
+  stats.enabled = 1;
+  start_frame(timer_nanoseconds());
+}
+
+void
+disable_renderer_stats()
+{
+  discard_queries();
+  stats.enabled = 0;
+}
+
+void
+reset_renderer_stats()
+{
+  discard_queries();
+  memset(stats.frames, 0, sizeof(stats.frames));
+  stats.frames_count = 0;
+  if (stats.enabled)
+    start_frame(timer_nanoseconds());
+}
+
+uint64_t
+stats_timer_begin(void)
+{
+  return stats.enabled ? timer_nanoseconds() : 0;
+}
+
+void
+stats_timer_end(renderer_timer_t timer, uint64_t start)
+{
+  if (!start)
+    return;
+
+  stats.timer_ns[timer] += timer_nanoseconds() - start;
+  ++stats.timer_calls[timer];
+}
+
+/// @brief the ring slot of @a frame, NULL if it was overwritten or dropped.
+static
+renderer_frame_stats_t*
+get_frame_record(uint64_t frame)
+{
+  renderer_frame_stats_t* record =
+    stats.frames + frame % RENDERER_STATS_FRAMES;
+  if (frame >= stats.frame || stats.frame - frame > stats.frames_count)
+    return NULL;
+  return record->frame == frame ? record : NULL;
+}
+
+static
+void
+resolve_queries(void)
+{
+  for (uint32_t i = 0; i < STATS_QUERIES; ++i) {
+    stats_query_t* query = stats.queries + i;
+    renderer_frame_stats_t* record = NULL;
+    GLint available = 0;
+    uint64_t elapsed = 0;
+    if (!query->pending)
+      continue;
+
+    glGetQueryObjectiv(query->query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      continue;
+
+    glGetQueryObjectui64v(query->query, GL_QUERY_RESULT, &elapsed);
+    record = get_frame_record(query->frame);
+    if (record)
+      record->gpu_ns = elapsed;
+    query->pending = 0;
+  }
+}
+
+/// @brief times the frame about to start, unless every query is still
+/// waiting on the gpu.
+static
+void
+begin_query(void)
+{
+  if (!stats.queries[0].query) {
+    GLuint queries[STATS_QUERIES];
+    glGenQueries(STATS_QUERIES, queries);
+    for (uint32_t i = 0; i < STATS_QUERIES; ++i)
+      stats.queries[i].query = queries[i];
+  }
+
+  for (uint32_t i = 0; i < STATS_QUERIES; ++i) {
+    stats_query_t* query = stats.queries + i;
+    if (query->pending)
+      continue;
+
+    glBeginQuery(GL_TIME_ELAPSED, query->query);
+    query->frame = stats.frame;
+    query->pending = 1;
+    stats.query_active = 1;
+    return;
+  }
+}
+
+void
+stats_end_frame(int32_t opengl)
+{
+  renderer_frame_stats_t* record = NULL;
+  uint64_t now, issued, skipped;
+  int32_t timed = opengl && opengl_features.timer_queries;
+
+  if (!stats.enabled) {
+    memset(&frame_counters, 0, sizeof(frame_counters_t));
+    return;
+  }
+
+  now = timer_nanoseconds();
+  if (timed && stats.query_active) {
+    glEndQuery(GL_TIME_ELAPSED);
+    stats.query_active = 0;
+  }
+
+  record = stats.frames + stats.frame % RENDERER_STATS_FRAMES;
+  memset(record, 0, sizeof(renderer_frame_stats_t));
+  state_get_counters(&issued, &skipped);
+  record->frame = stats.frame;
+  record->draw_calls = frame_counters.draw_calls;
+  record->triangles = frame_counters.triangles;
+  record->vertices = frame_counters.vertices;
+  // reset_state_counters may have run mid frame.
+  record->state_changes =
+    issued >= stats.state_issued ? issued - stats.state_issued : issued;
+  record->texture_binds = frame_counters.texture_binds;
+  record->uploaded_bytes = frame_counters.uploaded_bytes;
+  record->cpu_ns = now - stats.frame_start;
+  memcpy(record->timer_ns, stats.timer_ns, sizeof(stats.timer_ns));
+  memcpy(record->timer_calls, stats.timer_calls, sizeof(stats.timer_calls));
+
+  if (stats.frames_count < RENDERER_STATS_FRAMES)
+    ++stats.frames_count;
+  ++stats.frame;
+  start_frame(now);
+
+  if (timed) {
+    resolve_queries();
+    begin_query();
+  }
+}
+
+void
+stats_cleanup(void)
+{
+  if (stats.query_active)
+    glEndQuery(GL_TIME_ELAPSED);
+
+  if (stats.queries[0].query) {
+    GLuint queries[STATS_QUERIES];
+    for (uint32_t i = 0; i < STATS_QUERIES; ++i)
+      queries[i] = stats.queries[i].query;
+    glDeleteQueries(STATS_QUERIES, queries);
+  }
+
+  memset(&stats, 0, sizeof(renderer_stats_t));
+  memset(&frame_counters, 0, sizeof(frame_counters_t));
+}
+
+/// @brief @a age 0 is the last recorded frame.
+static
+const renderer_frame_stats_t*
+get_recorded_frame(uint32_t age)
+{
+  return stats.frames + (stats.frame - 1 - age) % RENDERER_STATS_FRAMES;
+}
+
+uint32_t
+get_frame_stats(renderer_frame_stats_t* frames, uint32_t count)
+{
+  count = count < stats.frames_count ? count : stats.frames_count;
+  for (uint32_t i = 0; i < count; ++i)
+    frames[i] = *get_recorded_frame(i);
+  return count;
+}
+
+static
+uint64_t
+get_stat(const renderer_frame_stats_t* frame, renderer_stat_t stat)
+{
+  switch (stat)
+  {
+  case RENDERER_STAT_DRAW_CALLS:
+    return frame->draw_calls;
+  case RENDERER_STAT_TRIANGLES:
+    return frame->triangles;
+  case RENDERER_STAT_VERTICES:
+    return frame->vertices;
+  case RENDERER_STAT_STATE_CHANGES:
+    return frame->state_changes;
+  case RENDERER_STAT_TEXTURE_BINDS:
+    return frame->texture_binds;
+  case RENDERER_STAT_UPLOADED_BYTES:
+    return frame->uploaded_bytes;
+  case RENDERER_STAT_CPU_TIME:
+    return frame->cpu_ns;
+  case RENDERER_STAT_GPU_TIME:
+    return frame->gpu_ns;
+  default:
+    return 0;
+  }
+}
+
+static
+int
+compare_values(const void* a, const void* b)
+{
+  uint64_t left = *(const uint64_t*)a, right = *(const uint64_t*)b;
+  return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+/// @brief nearest rank, sorts @a values.
+static
+uint64_t
+get_percentile(uint64_t* values, uint32_t count, float percentile)
+{
+  uint32_t rank;
+  if (!count)
+    return 0;
+
+  percentile = percentile < 0.f ? 0.f : percentile;
+  percentile = percentile > 100.f ? 100.f : percentile;
+  qsort(values, count, sizeof(uint64_t), compare_values);
+  rank = (uint32_t)ceilf(percentile / 100.f * (float)count);
+  return values[rank ? rank - 1 : 0];
+}
+
+uint64_t
+get_stats_percentile(renderer_stat_t stat, float percentile)
+{
+  uint64_t values[RENDERER_STATS_FRAMES];
+  uint32_t count = 0;
+
+  for (uint32_t i = 0; i < stats.frames_count; ++i) {
+    const renderer_frame_stats_t* frame = get_recorded_frame(i);
+    if (stat == RENDERER_STAT_GPU_TIME && !frame->gpu_ns)
+      continue;
+    values[count++] = get_stat(frame, stat);
+  }
+
+  return get_percentile(values, count, percentile);
+}
+
+uint64_t
+get_timer_percentile(renderer_timer_t timer, float percentile)
+{
+  uint64_t values[RENDERER_STATS_FRAMES];
+
+  for (uint32_t i = 0; i < stats.frames_count; ++i)
+    values[i] = get_recorded_frame(i)->timer_ns[timer];
+
+  return get_percentile(values, stats.frames_count, percentile);
+}
+
+const char*
+get_timer_name(renderer_timer_t timer)
+{
+  return timer < RENDERER_TIMER_COUNT ? timer_names[timer] : "unknown";
+}
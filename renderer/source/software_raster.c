@@ -0,0 +1,520 @@
+/**
+ * @file software_raster.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/internal/jobs.h>
+#include <renderer/internal/software_raster.h>
+
+#if \
+  defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RASTER_SSE2
+#include <emmintrin.h>
+#endif
+
+
+// vertices are snapped to 1/16th of a pixel, edge values at pixel centers are
+// then multiples of 1/256. the bias implements the top-left fill rule with a
+// single 'greater than zero' test.
+#define RASTER_SUBPIXEL           16.f
+#define RASTER_EDGE_BIAS          (1.f / 1024.f)
+
+typedef
+struct raster_bin_t {
+  uint32_t* items;
+  uint32_t count;
+  uint32_t capacity;
+} raster_bin_t;
+
+typedef
+struct raster_state_t {
+  renderer_software_target_t target;
+  raster_triangle_t* triangles;
+  uint32_t count;
+  uint32_t capacity;
+  uint32_t tiles_x;
+  uint32_t tiles_y;
+  uint32_t chunks;          // binning jobs, each has its own set of bins.
+  raster_bin_t* bins;       // chunks * tiles, chunk major.
+  int32_t clear_pending;
+  uint8_t clear_color[4];
+} raster_state_t;
+
+static raster_state_t raster;
+
+static
+float
+saturate(float value)
+{
+  return value < 0.f ? 0.f : (value > 1.f ? 1.f : value);
+}
+
+static
+uint8_t
+to_byte(float value)
+{
+  return (uint8_t)(saturate(value) * 255.f + 0.5f);
+}
+
+void
+raster_initialize(const renderer_software_target_t* target)
+{
+  memset(&raster, 0, sizeof(raster_state_t));
+  raster.target = *target;
+  raster.tiles_x = (target->width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+  raster.tiles_y = (target->height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+  raster.chunks = jobs_thread_count();
+  raster.bins = calloc(
+    (size_t)raster.chunks * raster.tiles_x * raster.tiles_y,
+    sizeof(raster_bin_t));
+  assert(raster.bins);
+}
+
+void
+raster_cleanup(void)
+{
+  uint32_t bins_count = raster.chunks * raster.tiles_x * raster.tiles_y;
+  for (uint32_t i = 0; i < bins_count; ++i)
+    free(raster.bins[i].items);
+
+  free(raster.bins);
+  free(raster.triangles);
+  memset(&raster, 0, sizeof(raster_state_t));
+}
+
+raster_triangle_t*
+raster_append(uint32_t count)
+{
+  if (raster.count + count > raster.capacity) {
+    uint32_t capacity = raster.capacity ? raster.capacity : 1024;
+    raster_triangle_t* triangles = NULL;
+    while (capacity < raster.count + count)
+      capacity *= 2;
+
+    triangles = realloc(
+      raster.triangles, sizeof(raster_triangle_t) * capacity);
+    assert(triangles);
+    raster.triangles = triangles;
+    raster.capacity = capacity;
+  }
+
+  raster.count += count;
+  return raster.triangles + raster.count - count;
+}
+
+uint32_t
+raster_pending(void)
+{
+  return raster.count;
+}
+
+void
+raster_clear(const float color[4])
+{
+  raster.count = 0;
+  raster.clear_pending = 1;
+  for (uint32_t i = 0; i < 4; ++i)
+    raster.clear_color[i] = to_byte(color[i]);
+}
+
+/// @brief snaps the vertices, computes the pixel bounds and edge equations.
+/// returns 0 if the triangle covers no pixel center.
+static
+int32_t
+setup_triangle(raster_triangle_t* triangle)
+{
+  float* x = triangle->x;
+  float* y = triangle->y;
+  float area, sign, min_x, min_y, max_x, max_y, origin_x, origin_y;
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    x[i] = floorf(x[i] * RASTER_SUBPIXEL + 0.5f) / RASTER_SUBPIXEL;
+    y[i] = floorf(y[i] * RASTER_SUBPIXEL + 0.5f) / RASTER_SUBPIXEL;
+  }
+
+  area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+  if (!(area > 0.f || area < 0.f))
+    return 0;
+
+  // pixel centers are at .5, the bounds are inclusive.
+  min_x = fminf(x[0], fminf(x[1], x[2]));
+  min_y = fminf(y[0], fminf(y[1], y[2]));
+  max_x = fmaxf(x[0], fmaxf(x[1], x[2]));
+  max_y = fmaxf(y[0], fmaxf(y[1], y[2]));
+  triangle->min_x = (int32_t)fmaxf(ceilf(min_x - 0.5f), 0.f);
+  triangle->min_y = (int32_t)fmaxf(ceilf(min_y - 0.5f), 0.f);
+  triangle->max_x = (int32_t)fminf(
+    floorf(max_x - 0.5f), (float)raster.target.width - 1.f);
+  triangle->max_y = (int32_t)fminf(
+    floorf(max_y - 0.5f), (float)raster.target.height - 1.f);
+  if (
+    triangle->min_x > triangle->max_x ||
+    triangle->min_y > triangle->max_y)
+    return 0;
+
+  // both windings are accepted (culling happens upstream), the edges are
+  // flipped so the inside is always positive.
+  sign = area > 0.f ? 1.f : -1.f;
+  origin_x = (float)triangle->min_x + 0.5f;
+  origin_y = (float)triangle->min_y + 0.5f;
+  for (uint32_t i = 0; i < 3; ++i) {
+    uint32_t j = (i + 1) % 3, k = (i + 2) % 3;
+    float a = -(y[k] - y[j]) * sign;
+    float b = (x[k] - x[j]) * sign;
+    int32_t top_left = a > 0.f || (a == 0.f && b < 0.f);
+    triangle->edge_dx[i] = a;
+    triangle->edge_dy[i] = b;
+    triangle->edge_origin[i] =
+      a * (origin_x - x[j]) + b * (origin_y - y[j]) +
+      (top_left ? RASTER_EDGE_BIAS : -RASTER_EDGE_BIAS);
+  }
+
+  triangle->inv_area = 1.f / fabsf(area);
+  return 1;
+}
+
+static
+void
+push_bin(raster_bin_t* bin, uint32_t item)
+{
+  if (bin->count == bin->capacity) {
+    uint32_t capacity = bin->capacity ? bin->capacity * 2 : 256;
+    uint32_t* items = realloc(bin->items, sizeof(uint32_t) * capacity);
+    assert(items);
+    bin->items = items;
+    bin->capacity = capacity;
+  }
+
+  bin->items[bin->count++] = item;
+}
+
+/// @brief sets up a contiguous run of the queue and bins it, chunk order plus
+/// the order within a bin is the submission order.
+static
+void
+bin_job(void* data, uint32_t chunk)
+{
+  uint32_t tiles = raster.tiles_x * raster.tiles_y;
+  raster_bin_t* bins = raster.bins + (size_t)chunk * tiles;
+  uint32_t first = (uint32_t)((uint64_t)raster.count * chunk / raster.chunks);
+  uint32_t last =
+    (uint32_t)((uint64_t)raster.count * (chunk + 1) / raster.chunks);
+  (void)data;
+
+  for (uint32_t i = 0; i < tiles; ++i)
+    bins[i].count = 0;
+
+  for (uint32_t i = first; i < last; ++i) {
+    raster_triangle_t* triangle = raster.triangles + i;
+    if (!setup_triangle(triangle))
+      continue;
+
+    for (
+      int32_t ty = triangle->min_y / RASTER_TILE_SIZE;
+      ty <= triangle->max_y / RASTER_TILE_SIZE;
+      ++ty) {
+      for (
+        int32_t tx = triangle->min_x / RASTER_TILE_SIZE;
+        tx <= triangle->max_x / RASTER_TILE_SIZE;
+        ++tx)
+        push_bin(bins + ty * raster.tiles_x + tx, i);
+    }
+  }
+}
+
+static
+void
+fetch_texel(const raster_texture_t* texture, int32_t x, int32_t y, float* out)
+{
+  const uint8_t* texel =
+    texture->texels + ((size_t)y * texture->width + x) * 4;
+  out[0] = texel[0];
+  out[1] = texel[1];
+  out[2] = texel[2];
+  out[3] = texel[3];
+}
+
+/// @brief bilinear filtering with repeat wrapping, returns [0, 1] values.
+static
+void
+sample_texture(
+  const raster_texture_t* texture,
+  float u,
+  float v,
+  float* out)
+{
+  float x, y, fx, fy;
+  int32_t x0, y0, x1, y1;
+  float t00[4], t10[4], t01[4], t11[4];
+
+  u -= floorf(u);
+  v -= floorf(v);
+  x = u * texture->width - 0.5f;
+  y = v * texture->height - 0.5f;
+  fx = x - floorf(x);
+  fy = y - floorf(y);
+  x0 = (int32_t)floorf(x);
+  y0 = (int32_t)floorf(y);
+  x1 = x0 + 1;
+  y1 = y0 + 1;
+  x0 = x0 < 0 ? (int32_t)texture->width - 1 : x0;
+  y0 = y0 < 0 ? (int32_t)texture->height - 1 : y0;
+  x1 = x1 >= (int32_t)texture->width ? 0 : x1;
+  y1 = y1 >= (int32_t)texture->height ? 0 : y1;
+
+  fetch_texel(texture, x0, y0, t00);
+  fetch_texel(texture, x1, y0, t10);
+  fetch_texel(texture, x0, y1, t01);
+  fetch_texel(texture, x1, y1, t11);
+
+  for (uint32_t i = 0; i < 4; ++i) {
+    float top = t00[i] + (t10[i] - t00[i]) * fx;
+    float bottom = t01[i] + (t11[i] - t01[i]) * fx;
+    out[i] = (top + (bottom - top) * fy) * (1.f / 255.f);
+  }
+}
+
+/// @brief interpolates, textures and blends the covered pixels of a block of
+/// 4, @a edges and @a z are per lane.
+static
+void
+shade_block(
+  const raster_triangle_t* triangle,
+  int32_t x,
+  int32_t y,
+  uint32_t mask,
+  const float edges[3][4],
+  const float* z)
+{
+  size_t row = (size_t)y * raster.target.width;
+
+  for (uint32_t lane = 0; lane < 4; ++lane) {
+    float b0, b1, b2, w, color[4];
+    uint8_t* target;
+
+    if (!(mask & (1u << lane)))
+      continue;
+
+    b0 = edges[0][lane] * triangle->inv_area;
+    b1 = edges[1][lane] * triangle->inv_area;
+    b2 = edges[2][lane] * triangle->inv_area;
+    w = 1.f / (
+      b0 * triangle->inv_w[0] +
+      b1 * triangle->inv_w[1] +
+      b2 * triangle->inv_w[2]);
+
+    for (uint32_t i = 0; i < 4; ++i)
+      color[i] = (
+        b0 * triangle->color[0][i] +
+        b1 * triangle->color[1][i] +
+        b2 * triangle->color[2][i]) * w;
+
+    // GL_MODULATE.
+    if (triangle->texture) {
+      float texel[4];
+      float u = (
+        b0 * triangle->uv[0][0] +
+        b1 * triangle->uv[1][0] +
+        b2 * triangle->uv[2][0]) * w;
+      float v = (
+        b0 * triangle->uv[0][1] +
+        b1 * triangle->uv[1][1] +
+        b2 * triangle->uv[2][1]) * w;
+      sample_texture(triangle->texture, u, v, texel);
+      for (uint32_t i = 0; i < 4; ++i)
+        color[i] *= texel[i];
+    }
+
+    target = raster.target.color + (row + x + lane) * 4;
+    if (triangle->blend == RASTER_BLEND_ALPHA) {
+      float alpha = saturate(color[3]);
+      for (uint32_t i = 0; i < 4; ++i)
+        color[i] = color[i] * alpha + target[i] / 255.f * (1.f - alpha);
+    } else if (triangle->blend == RASTER_BLEND_COLOR) {
+      for (uint32_t i = 0; i < 4; ++i) {
+        float source = saturate(color[i]);
+        color[i] = source * source + target[i] / 255.f * (1.f - source);
+      }
+    }
+
+    for (uint32_t i = 0; i < 4; ++i)
+      target[i] = to_byte(color[i]);
+
+    if (triangle->depth_test)
+      raster.target.depth[row + x + lane] = z[lane];
+  }
+}
+
+/// @brief rasterizes the part of @a triangle inside the tile, 4 pixels of a
+/// row at a time.
+static
+void
+raster_triangle(
+  const raster_triangle_t* triangle,
+  int32_t tile_min_x,
+  int32_t tile_min_y,
+  int32_t tile_max_x,
+  int32_t tile_max_y)
+{
+  int32_t min_x = triangle->min_x > tile_min_x ? triangle->min_x : tile_min_x;
+  int32_t min_y = triangle->min_y > tile_min_y ? triangle->min_y : tile_min_y;
+  int32_t max_x = triangle->max_x < tile_max_x ? triangle->max_x : tile_max_x;
+  int32_t max_y = triangle->max_y < tile_max_y ? triangle->max_y : tile_max_y;
+  float edges[3][4];
+  float z[4];
+
+#if defined(RASTER_SSE2)
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 lanes = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+  const __m128 inv_area = _mm_set1_ps(triangle->inv_area);
+  __m128 dx[3], z_vertex[3];
+  for (uint32_t i = 0; i < 3; ++i) {
+    dx[i] = _mm_set1_ps(triangle->edge_dx[i]);
+    z_vertex[i] = _mm_set1_ps(triangle->z[i]);
+  }
+#endif
+
+  for (int32_t y = min_y; y <= max_y; ++y) {
+    float fy = (float)(y - triangle->min_y);
+    float row[3];
+    size_t depth_row = (size_t)y * raster.target.width;
+    for (uint32_t i = 0; i < 3; ++i)
+      row[i] = triangle->edge_origin[i] + triangle->edge_dy[i] * fy;
+
+    for (int32_t x = min_x; x <= max_x; x += 4) {
+      float fx = (float)(x - triangle->min_x);
+      int32_t count = max_x - x + 1 < 4 ? max_x - x + 1 : 4;
+      uint32_t mask = (1u << count) - 1;
+
+#if defined(RASTER_SSE2)
+      __m128 px = _mm_add_ps(_mm_set1_ps(fx), lanes);
+      __m128 e0 = _mm_add_ps(_mm_set1_ps(row[0]), _mm_mul_ps(dx[0], px));
+      __m128 e1 = _mm_add_ps(_mm_set1_ps(row[1]), _mm_mul_ps(dx[1], px));
+      __m128 e2 = _mm_add_ps(_mm_set1_ps(row[2]), _mm_mul_ps(dx[2], px));
+      __m128 inside = _mm_and_ps(
+        _mm_and_ps(_mm_cmpgt_ps(e0, zero), _mm_cmpgt_ps(e1, zero)),
+        _mm_cmpgt_ps(e2, zero));
+      __m128 depth;
+
+      mask &= (uint32_t)_mm_movemask_ps(inside);
+      if (!mask)
+        continue;
+
+      depth = _mm_mul_ps(
+        _mm_add_ps(
+          _mm_add_ps(
+            _mm_mul_ps(z_vertex[0], e0), _mm_mul_ps(z_vertex[1], e1)),
+          _mm_mul_ps(z_vertex[2], e2)),
+        inv_area);
+
+      if (triangle->depth_test) {
+        float* stored = raster.target.depth + depth_row + x;
+        __m128 current;
+        if (count == 4) {
+          current = _mm_loadu_ps(stored);
+        } else {
+          float padded[4] = { 0.f, 0.f, 0.f, 0.f };
+          memcpy(padded, stored, sizeof(float) * count);
+          current = _mm_loadu_ps(padded);
+        }
+        mask &= (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(depth, current));
+        if (!mask)
+          continue;
+      }
+
+      _mm_storeu_ps(edges[0], e0);
+      _mm_storeu_ps(edges[1], e1);
+      _mm_storeu_ps(edges[2], e2);
+      _mm_storeu_ps(z, depth);
+#else
+      for (int32_t lane = 0; lane < 4; ++lane) {
+        float px = fx + (float)lane;
+        edges[0][lane] = row[0] + triangle->edge_dx[0] * px;
+        edges[1][lane] = row[1] + triangle->edge_dx[1] * px;
+        edges[2][lane] = row[2] + triangle->edge_dx[2] * px;
+        if (
+          edges[0][lane] <= 0.f ||
+          edges[1][lane] <= 0.f ||
+          edges[2][lane] <= 0.f)
+          mask &= ~(1u << lane);
+      }
+
+      if (!mask)
+        continue;
+
+      for (int32_t lane = 0; lane < count; ++lane) {
+        z[lane] = (
+          triangle->z[0] * edges[0][lane] +
+          triangle->z[1] * edges[1][lane] +
+          triangle->z[2] * edges[2][lane]) * triangle->inv_area;
+        if (
+          triangle->depth_test &&
+          !(z[lane] < raster.target.depth[depth_row + x + lane]))
+          mask &= ~(1u << lane);
+      }
+
+      if (!mask)
+        continue;
+#endif
+
+      shade_block(triangle, x, y, mask, edges, z);
+    }
+  }
+}
+
+static
+void
+tile_job(void* data, uint32_t tile)
+{
+  int32_t min_x = (int32_t)(tile % raster.tiles_x) * RASTER_TILE_SIZE;
+  int32_t min_y = (int32_t)(tile / raster.tiles_x) * RASTER_TILE_SIZE;
+  int32_t max_x = min_x + RASTER_TILE_SIZE - 1;
+  int32_t max_y = min_y + RASTER_TILE_SIZE - 1;
+  uint32_t tiles = raster.tiles_x * raster.tiles_y;
+  (void)data;
+
+  max_x = max_x < (int32_t)raster.target.width ?
+    max_x : (int32_t)raster.target.width - 1;
+  max_y = max_y < (int32_t)raster.target.height ?
+    max_y : (int32_t)raster.target.height - 1;
+
+  if (raster.clear_pending) {
+    for (int32_t y = min_y; y <= max_y; ++y) {
+      size_t row = (size_t)y * raster.target.width;
+      for (int32_t x = min_x; x <= max_x; ++x) {
+        memcpy(raster.target.color + (row + x) * 4, raster.clear_color, 4);
+        raster.target.depth[row + x] = 1.f;
+      }
+    }
+  }
+
+  for (uint32_t chunk = 0; chunk < raster.chunks; ++chunk) {
+    const raster_bin_t* bin = raster.bins + (size_t)chunk * tiles + tile;
+    for (uint32_t i = 0; i < bin->count; ++i)
+      raster_triangle(
+        raster.triangles + bin->items[i], min_x, min_y, max_x, max_y);
+  }
+}
+
+void
+raster_flush(void)
+{
+  if (!raster.count && !raster.clear_pending)
+    return;
+
+  jobs_parallel_for(raster.chunks, bin_job, NULL);
+  jobs_parallel_for(raster.tiles_x * raster.tiles_y, tile_job, NULL);
+
+  raster.count = 0;
+  raster.clear_pending = 0;
+}
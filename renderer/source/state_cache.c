@@ -0,0 +1,521 @@
+/**
+ * @file state_cache.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <string.h>
+#include <renderer/internal/frame_stats.h>
+#include <renderer/internal/opengl_extensions.h>
+#include <renderer/internal/state_cache.h>
+
+
+#define STATE_UNKNOWN     -1
+#define LIGHT_COUNT       8
+
+typedef
+enum {
+  CAP_LIGHTING,
+  CAP_DEPTH_TEST,
+  CAP_CULL_FACE,
+  CAP_BLEND,
+  CAP_TEXTURE_2D,
+  CAP_COLOR_MATERIAL,
+  CAP_NORMALIZE,
+  CAP_LIGHT0,
+  CAP_COUNT = CAP_LIGHT0 + LIGHT_COUNT
+} cap_slot_t;
+
+typedef
+enum {
+  CLIENT_VERTEX_ARRAY,
+  CLIENT_NORMAL_ARRAY,
+  CLIENT_TEXTURE_COORD_ARRAY,
+  CLIENT_COLOR_ARRAY,
+  CLIENT_COUNT
+} client_slot_t;
+
+typedef
+enum {
+  LIGHT_AMBIENT,
+  LIGHT_DIFFUSE,
+  LIGHT_SPECULAR,
+  LIGHT_POSITION,
+  LIGHT_SPOT_DIRECTION,
+  LIGHT_SPOT_CUTOFF,
+  LIGHT_CONSTANT_ATTENUATION,
+  LIGHT_LINEAR_ATTENUATION,
+  LIGHT_QUADRATIC_ATTENUATION,
+  LIGHT_PARAMETER_COUNT
+} light_parameter_slot_t;
+
+/// @brief last values sent with glLightfv, position and spot direction are
+/// transformed by the modelview at the time of the call, the modelview is
+/// part of their value.
+typedef
+struct light_parameter_t {
+  int32_t known;
+  float value[4];
+  float modelview[16];
+} light_parameter_t;
+
+typedef
+struct state_cache_t {
+  int32_t caps[CAP_COUNT];
+  int32_t clients[CLIENT_COUNT];
+  int32_t has_blend_func;
+  GLenum blend_source;
+  GLenum blend_destination;
+  float line_width;       // <= 0 is unknown.
+  float point_size;
+  int32_t texture;        // STATE_UNKNOWN or the bound name.
+  int32_t array_buffer;
+  int32_t element_buffer;
+  int32_t matrix_mode;    // STATE_UNKNOWN or the GLenum.
+  int32_t has_modelview;
+  const pipeline_t* modelview_pipeline;   // NULL for the identity.
+  uint32_t modelview_generation;
+  int32_t modelview_index;
+  uint32_t modelview_version;
+  matrix4f modelview;     // row major copy of the loaded matrix.
+  int32_t has_viewport;
+  GLint viewport[4];
+  int32_t has_projection;
+  projection_mode_t projection_mode;
+  float frustum[FRUSTUM_COUNT];
+  light_parameter_t lights[LIGHT_COUNT][LIGHT_PARAMETER_COUNT];
+  uint64_t issued;
+  uint64_t skipped;
+  uint64_t viewport_skipped;
+  uint64_t projection_skipped;
+  uint64_t light_skipped;
+} state_cache_t;
+
+static state_cache_t cache;
+
+static
+int32_t
+get_cap_slot(GLenum cap)
+{
+  switch (cap) {
+  case GL_LIGHTING:
+    return CAP_LIGHTING;
+  case GL_DEPTH_TEST:
+    return CAP_DEPTH_TEST;
+  case GL_CULL_FACE:
+    return CAP_CULL_FACE;
+  case GL_BLEND:
+    return CAP_BLEND;
+  case GL_TEXTURE_2D:
+    return CAP_TEXTURE_2D;
+  case GL_COLOR_MATERIAL:
+    return CAP_COLOR_MATERIAL;
+  case GL_NORMALIZE:
+    return CAP_NORMALIZE;
+  default:
+    if (cap >= GL_LIGHT0 && cap < GL_LIGHT0 + LIGHT_COUNT)
+      return CAP_LIGHT0 + (int32_t)(cap - GL_LIGHT0);
+    return -1;
+  }
+}
+
+/// @brief the slot and the number of floats of a glLightfv parameter.
+static
+int32_t
+get_light_parameter_slot(GLenum pname, uint32_t* size)
+{
+  *size = 1;
+  switch (pname) {
+  case GL_AMBIENT:
+    *size = 4;
+    return LIGHT_AMBIENT;
+  case GL_DIFFUSE:
+    *size = 4;
+    return LIGHT_DIFFUSE;
+  case GL_SPECULAR:
+    *size = 4;
+    return LIGHT_SPECULAR;
+  case GL_POSITION:
+    *size = 4;
+    return LIGHT_POSITION;
+  case GL_SPOT_DIRECTION:
+    *size = 3;
+    return LIGHT_SPOT_DIRECTION;
+  case GL_SPOT_CUTOFF:
+    return LIGHT_SPOT_CUTOFF;
+  case GL_CONSTANT_ATTENUATION:
+    return LIGHT_CONSTANT_ATTENUATION;
+  case GL_LINEAR_ATTENUATION:
+    return LIGHT_LINEAR_ATTENUATION;
+  case GL_QUADRATIC_ATTENUATION:
+    return LIGHT_QUADRATIC_ATTENUATION;
+  default:
+    return -1;
+  }
+}
+
+static
+int32_t
+get_client_slot(GLenum array)
+{
+  switch (array) {
+  case GL_VERTEX_ARRAY:
+    return CLIENT_VERTEX_ARRAY;
+  case GL_NORMAL_ARRAY:
+    return CLIENT_NORMAL_ARRAY;
+  case GL_TEXTURE_COORD_ARRAY:
+    return CLIENT_TEXTURE_COORD_ARRAY;
+  case GL_COLOR_ARRAY:
+    return CLIENT_COLOR_ARRAY;
+  default:
+    return -1;
+  }
+}
+
+/// @brief returns non-zero if the call has to reach opengl, counts it either
+/// way.
+static
+int32_t
+needs_update(int32_t* tracked, int32_t value)
+{
+  if (tracked && *tracked == value) {
+    ++cache.skipped;
+    return 0;
+  }
+
+  if (tracked)
+    *tracked = value;
+  ++cache.issued;
+  return 1;
+}
+
+void
+state_cache_reset(void)
+{
+  uint64_t issued = cache.issued, skipped = cache.skipped;
+  uint64_t viewport_skipped = cache.viewport_skipped;
+  uint64_t projection_skipped = cache.projection_skipped;
+  uint64_t light_skipped = cache.light_skipped;
+
+  memset(&cache, 0, sizeof(state_cache_t));
+  for (uint32_t i = 0; i < CAP_COUNT; ++i)
+    cache.caps[i] = STATE_UNKNOWN;
+  for (uint32_t i = 0; i < CLIENT_COUNT; ++i)
+    cache.clients[i] = STATE_UNKNOWN;
+  cache.texture = STATE_UNKNOWN;
+  cache.array_buffer = STATE_UNKNOWN;
+  cache.element_buffer = STATE_UNKNOWN;
+  cache.matrix_mode = STATE_UNKNOWN;
+
+  // the counters survive invalidation.
+  cache.issued = issued;
+  cache.skipped = skipped;
+  cache.viewport_skipped = viewport_skipped;
+  cache.projection_skipped = projection_skipped;
+  cache.light_skipped = light_skipped;
+}
+
+void
+state_set(GLenum cap, int32_t enable)
+{
+  int32_t slot = get_cap_slot(cap);
+  enable = enable ? 1 : 0;
+
+  if (!needs_update(slot >= 0 ? cache.caps + slot : NULL, enable))
+    return;
+
+  if (enable)
+    glEnable(cap);
+  else
+    glDisable(cap);
+}
+
+void
+state_enable(GLenum cap)
+{
+  state_set(cap, 1);
+}
+
+void
+state_disable(GLenum cap)
+{
+  state_set(cap, 0);
+}
+
+void
+state_set_client(GLenum array, int32_t enable)
+{
+  int32_t slot = get_client_slot(array);
+  enable = enable ? 1 : 0;
+
+  if (!needs_update(slot >= 0 ? cache.clients + slot : NULL, enable))
+    return;
+
+  if (enable)
+    glEnableClientState(array);
+  else
+    glDisableClientState(array);
+}
+
+void
+state_blend_func(GLenum source, GLenum destination)
+{
+  if (
+    cache.has_blend_func &&
+    cache.blend_source == source &&
+    cache.blend_destination == destination) {
+    ++cache.skipped;
+    return;
+  }
+
+  cache.has_blend_func = 1;
+  cache.blend_source = source;
+  cache.blend_destination = destination;
+  ++cache.issued;
+  glBlendFunc(source, destination);
+}
+
+void
+state_line_width(float width)
+{
+  if (cache.line_width == width) {
+    ++cache.skipped;
+    return;
+  }
+
+  cache.line_width = width;
+  ++cache.issued;
+  glLineWidth(width);
+}
+
+void
+state_point_size(float size)
+{
+  if (cache.point_size == size) {
+    ++cache.skipped;
+    return;
+  }
+
+  cache.point_size = size;
+  ++cache.issued;
+  glPointSize(size);
+}
+
+void
+state_bind_texture(GLuint texture)
+{
+  if (needs_update(&cache.texture, (int32_t)texture)) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    ++frame_counters.texture_binds;
+  }
+}
+
+void
+state_forget_texture(GLuint texture)
+{
+  if (cache.texture == (int32_t)texture)
+    cache.texture = 0;
+}
+
+void
+state_bind_buffer(GLenum target, GLuint buffer)
+{
+  int32_t* tracked = NULL;
+  if (!opengl_features.buffer_objects)
+    return;
+
+  if (target == GL_ARRAY_BUFFER)
+    tracked = &cache.array_buffer;
+  else if (target == GL_ELEMENT_ARRAY_BUFFER)
+    tracked = &cache.element_buffer;
+
+  if (needs_update(tracked, (int32_t)buffer))
+    glBindBuffer(target, buffer);
+}
+
+void
+state_forget_buffer(GLuint buffer)
+{
+  if (cache.array_buffer == (int32_t)buffer)
+    cache.array_buffer = 0;
+  if (cache.element_buffer == (int32_t)buffer)
+    cache.element_buffer = 0;
+}
+
+void
+state_matrix_mode(GLenum mode)
+{
+  if (needs_update(&cache.matrix_mode, (int32_t)mode))
+    glMatrixMode(mode);
+}
+
+void
+state_load_modelview(const pipeline_t* pipeline)
+{
+  const matrix4f* top = NULL;
+  matrix4f column_major;
+  int32_t index = pipeline ? pipeline->modelview_index : 0;
+  uint32_t version = pipeline ? pipeline->modelview_version[index] : 0;
+  uint32_t generation = pipeline ? pipeline->generation : 0;
+
+  if (
+    cache.has_modelview &&
+    cache.modelview_pipeline == pipeline &&
+    cache.modelview_generation == generation &&
+    cache.modelview_index == index &&
+    cache.modelview_version == version) {
+    ++cache.skipped;
+    return;
+  }
+
+  cache.has_modelview = 1;
+  cache.modelview_pipeline = pipeline;
+  cache.modelview_generation = generation;
+  cache.modelview_index = index;
+  cache.modelview_version = version;
+  ++cache.issued;
+
+  state_matrix_mode(GL_MODELVIEW);
+  if (pipeline) {
+    top = pipeline->modelview_stack + index;
+    cache.modelview = *top;
+    matrix4f_set_column_major(&column_major, top);
+    glLoadMatrixf(column_major.data);
+  } else {
+    matrix4f_set_identity(&cache.modelview);
+    glLoadIdentity();
+  }
+}
+
+void
+state_load_modelview_matrix(const matrix4f* matrix)
+{
+  matrix4f column_major;
+
+  // the lights still compare against the loaded matrix.
+  cache.has_modelview = 0;
+  cache.modelview = *matrix;
+  ++cache.issued;
+
+  state_matrix_mode(GL_MODELVIEW);
+  matrix4f_set_column_major(&column_major, matrix);
+  glLoadMatrixf(column_major.data);
+}
+
+void
+state_viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+  GLint viewport[4] = { x, y, (GLint)width, (GLint)height };
+
+  if (
+    cache.has_viewport &&
+    !memcmp(cache.viewport, viewport, sizeof(viewport))) {
+    ++cache.skipped;
+    ++cache.viewport_skipped;
+    return;
+  }
+
+  cache.has_viewport = 1;
+  memcpy(cache.viewport, viewport, sizeof(viewport));
+  ++cache.issued;
+  glViewport(x, y, width, height);
+}
+
+void
+state_load_projection(const pipeline_t* pipeline)
+{
+  if (
+    cache.has_projection &&
+    cache.projection_mode == pipeline->projection_mode &&
+    !memcmp(cache.frustum, pipeline->frustum, sizeof(cache.frustum))) {
+    ++cache.skipped;
+    ++cache.projection_skipped;
+    return;
+  }
+
+  cache.has_projection = 1;
+  cache.projection_mode = pipeline->projection_mode;
+  memcpy(cache.frustum, pipeline->frustum, sizeof(cache.frustum));
+  ++cache.issued;
+
+  state_matrix_mode(GL_PROJECTION);
+  glLoadIdentity();
+  if (pipeline->projection_mode == PERSPECTIVE)
+    glFrustum(
+      pipeline->frustum[LEFT], pipeline->frustum[RIGHT],
+      pipeline->frustum[BOTTOM], pipeline->frustum[TOP],
+      pipeline->frustum[ZNEAR], pipeline->frustum[ZFAR]);
+  else
+    glOrtho(
+      pipeline->frustum[LEFT], pipeline->frustum[RIGHT],
+      pipeline->frustum[BOTTOM], pipeline->frustum[TOP],
+      pipeline->frustum[ZNEAR], pipeline->frustum[ZFAR]);
+}
+
+void
+state_light(GLenum light, GLenum pname, const float* params)
+{
+  uint32_t size = 0;
+  int32_t slot = get_light_parameter_slot(pname, &size);
+  int32_t transformed = pname == GL_POSITION || pname == GL_SPOT_DIRECTION;
+  light_parameter_t* tracked = NULL;
+
+  if (slot >= 0 && light >= GL_LIGHT0 && light < GL_LIGHT0 + LIGHT_COUNT)
+    tracked = cache.lights[light - GL_LIGHT0] + slot;
+
+  // the modelview is only known after a state_load_modelview.
+  if (tracked && transformed && !cache.has_modelview)
+    tracked = NULL;
+
+  if (
+    tracked &&
+    tracked->known &&
+    !memcmp(tracked->value, params, sizeof(float) * size) &&
+    (!transformed || !memcmp(
+      tracked->modelview, cache.modelview.data, sizeof(tracked->modelview)))) {
+    ++cache.skipped;
+    ++cache.light_skipped;
+    return;
+  }
+
+  if (tracked) {
+    tracked->known = 1;
+    memcpy(tracked->value, params, sizeof(float) * size);
+    if (transformed)
+      memcpy(tracked->modelview, cache.modelview.data, sizeof(float) * 16);
+  }
+
+  ++cache.issued;
+  glLightfv(light, pname, params);
+}
+
+void
+state_get_counters(uint64_t* issued, uint64_t* skipped)
+{
+  *issued = cache.issued;
+  *skipped = cache.skipped;
+}
+
+void
+state_get_skipped_updates(
+  uint64_t* viewports,
+  uint64_t* projections,
+  uint64_t* lights)
+{
+  *viewports = cache.viewport_skipped;
+  *projections = cache.projection_skipped;
+  *lights = cache.light_skipped;
+}
+
+void
+state_reset_counters(void)
+{
+  cache.issued = cache.skipped = 0;
+  cache.viewport_skipped = 0;
+  cache.projection_skipped = 0;
+  cache.light_skipped = 0;
+}
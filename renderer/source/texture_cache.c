@@ -0,0 +1,307 @@
+/**
+ * @file texture_cache.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/texture_cache.h>
+#include <renderer/texture_compression.h>
+#include <renderer/internal/image_format.h>
+
+
+typedef
+struct texture_entry_t {
+  uint32_t texture;         // 0 if the slot is free.
+  uint64_t key;             // hash of the path, or of the content.
+  char* path;               // NULL if keyed by content.
+  uint32_t width;
+  uint32_t height;
+  renderer_image_format_t format;
+  uint32_t references;
+  uint64_t bytes;
+  uint64_t last_drawn;      // frame of the last draw or acquisition.
+} texture_entry_t;
+
+typedef
+struct texture_cache_t {
+  texture_entry_t* entries;
+  uint32_t entries_capacity;
+  uint32_t* lookup;         // texture id -> entry index + 1, 0 if not ours.
+  uint32_t lookup_capacity;
+  uint64_t frame;
+  uint64_t resident_bytes;
+  uint64_t budget;
+  int32_t has_budget;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+} texture_cache_t;
+
+static texture_cache_t cache;
+
+/// @brief the whole mip chain, drivers usually pad 3 components to 4.
+static
+uint64_t
+estimate_bytes(
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  uint32_t components = image_format_components(format);
+  uint64_t texel = components == 3 ? 4 : components;
+  uint64_t bytes = 0;
+  if (!components)
+    return texture_compression_size(width, height, format);
+
+  for (;;) {
+    bytes += (uint64_t)width * height * texel;
+    if (width == 1 && height == 1)
+      break;
+    width = width > 1 ? width / 2 : 1;
+    height = height > 1 ? height / 2 : 1;
+  }
+
+  return bytes;
+}
+
+static
+texture_entry_t*
+find_entry(
+  const char* path,
+  uint64_t key,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  for (uint32_t i = 0; i < cache.entries_capacity; ++i) {
+    texture_entry_t* entry = cache.entries + i;
+    if (!entry->texture || entry->key != key)
+      continue;
+
+    if (path && entry->path && !strcmp(path, entry->path))
+      return entry;
+
+    if (
+      !path && !entry->path &&
+      entry->width == width &&
+      entry->height == height &&
+      entry->format == format)
+      return entry;
+  }
+
+  return NULL;
+}
+
+static
+texture_entry_t*
+allocate_entry(void)
+{
+  uint32_t previous = cache.entries_capacity;
+  uint32_t capacity = previous ? previous * 2 : 64;
+  texture_entry_t* entries = NULL;
+
+  for (uint32_t i = 0; i < previous; ++i) {
+    if (!cache.entries[i].texture)
+      return cache.entries + i;
+  }
+
+  entries = realloc(cache.entries, sizeof(texture_entry_t) * capacity);
+  assert(entries);
+  memset(
+    entries + previous, 0, sizeof(texture_entry_t) * (capacity - previous));
+  cache.entries = entries;
+  cache.entries_capacity = capacity;
+  return cache.entries + previous;
+}
+
+static
+void
+set_lookup(uint32_t texture, uint32_t value)
+{
+  if (texture >= cache.lookup_capacity) {
+    uint32_t capacity = cache.lookup_capacity ? cache.lookup_capacity : 256;
+    uint32_t* lookup = NULL;
+    while (capacity <= texture)
+      capacity *= 2;
+
+    lookup = realloc(cache.lookup, sizeof(uint32_t) * capacity);
+    assert(lookup);
+    memset(
+      lookup + cache.lookup_capacity,
+      0,
+      sizeof(uint32_t) * (capacity - cache.lookup_capacity));
+    cache.lookup = lookup;
+    cache.lookup_capacity = capacity;
+  }
+
+  cache.lookup[texture] = value;
+}
+
+static
+texture_entry_t*
+get_entry(uint32_t texture)
+{
+  if (texture >= cache.lookup_capacity || !cache.lookup[texture])
+    return NULL;
+  return cache.entries + cache.lookup[texture] - 1;
+}
+
+uint32_t
+texture_cache_acquire(
+  const char* path,
+  const uint8_t* buffer,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format,
+  int32_t async)
+{
+  texture_entry_t* entry = NULL;
+  uint64_t key = IMAGE_HASH_SEED;
+
+  if (path) {
+    key = image_hash_bytes(key, (const uint8_t*)path, strlen(path));
+  } else {
+    // content keyed, a 64 bit hash collision is accepted as a hit.
+    if (!buffer)
+      return 0;
+    key = image_hash_bytes(
+      key,
+      buffer,
+      texture_compression_is_compressed(format) ?
+        texture_compression_size(width, height, format) :
+        (size_t)width * height * image_format_components(format));
+  }
+
+  entry = find_entry(path, key, width, height, format);
+  if (entry) {
+    ++cache.hits;
+    ++entry->references;
+    entry->last_drawn = cache.frame;
+    return entry->texture;
+  }
+
+  if (!buffer)
+    return 0;
+
+  ++cache.misses;
+  entry = allocate_entry();
+  entry->texture = async ?
+    upload_to_gpu_async(path, buffer, width, height, format) :
+    upload_to_gpu(path, buffer, width, height, format);
+  if (!entry->texture)
+    return 0;
+
+  entry->key = key;
+  entry->path = NULL;
+  if (path) {
+    entry->path = malloc(strlen(path) + 1);
+    assert(entry->path);
+    strcpy(entry->path, path);
+  }
+  entry->width = width;
+  entry->height = height;
+  entry->format = format;
+  entry->references = 1;
+  entry->bytes = estimate_bytes(width, height, format);
+  entry->last_drawn = cache.frame;
+  cache.resident_bytes += entry->bytes;
+  set_lookup(entry->texture, (uint32_t)(entry - cache.entries) + 1);
+  return entry->texture;
+}
+
+void
+texture_cache_release(uint32_t texture_id)
+{
+  texture_entry_t* entry = get_entry(texture_id);
+  assert(entry && entry->references && "released more than acquired");
+  if (entry && entry->references)
+    --entry->references;
+}
+
+void
+texture_cache_touch(uint32_t texture_id)
+{
+  texture_entry_t* entry = get_entry(texture_id);
+  if (entry)
+    entry->last_drawn = cache.frame;
+}
+
+void
+texture_cache_set_budget(uint64_t bytes)
+{
+  cache.budget = bytes;
+  cache.has_budget = 1;
+}
+
+static
+void
+evict_entry(texture_entry_t* entry)
+{
+  evict_from_gpu(entry->texture);
+  set_lookup(entry->texture, 0);
+  cache.resident_bytes -= entry->bytes;
+  free(entry->path);
+  memset(entry, 0, sizeof(texture_entry_t));
+}
+
+void
+texture_cache_collect()
+{
+  while (cache.has_budget && cache.resident_bytes > cache.budget) {
+    texture_entry_t* oldest = NULL;
+    for (uint32_t i = 0; i < cache.entries_capacity; ++i) {
+      texture_entry_t* entry = cache.entries + i;
+      if (
+        entry->texture && !entry->references &&
+        (!oldest || entry->last_drawn < oldest->last_drawn))
+        oldest = entry;
+    }
+
+    // what is left is referenced.
+    if (!oldest)
+      break;
+
+    evict_entry(oldest);
+    ++cache.evictions;
+  }
+
+  ++cache.frame;
+}
+
+void
+texture_cache_get_stats(texture_cache_stats_t* stats)
+{
+  memset(stats, 0, sizeof(texture_cache_stats_t));
+  for (uint32_t i = 0; i < cache.entries_capacity; ++i) {
+    if (cache.entries[i].texture) {
+      ++stats->textures;
+      stats->referenced += cache.entries[i].references ? 1 : 0;
+    }
+  }
+
+  stats->resident_bytes = cache.resident_bytes;
+  stats->budget = cache.has_budget ? cache.budget : UINT64_MAX;
+  stats->hits = cache.hits;
+  stats->misses = cache.misses;
+  stats->evictions = cache.evictions;
+}
+
+void
+texture_cache_cleanup()
+{
+  for (uint32_t i = 0; i < cache.entries_capacity; ++i) {
+    if (cache.entries[i].texture)
+      evict_entry(cache.entries + i);
+  }
+
+  free(cache.entries);
+  free(cache.lookup);
+  memset(&cache, 0, sizeof(texture_cache_t));
+}
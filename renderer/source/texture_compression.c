@@ -0,0 +1,705 @@
+/**
+ * @file texture_compression.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/texture_compression.h>
+#include <renderer/internal/image_format.h>
+#include <renderer/internal/jobs.h>
+#include <renderer/internal/mipmaps.h>
+
+
+// bump whenever the encoder output changes, older cached files are ignored.
+#define ENCODER_VERSION           1
+#define CACHE_MAGIC               0x58544342u
+#define BAND_BLOCK_ROWS           4
+
+typedef
+struct encode_job_t {
+  const uint8_t* pixels;    // RGBA8 level.
+  uint32_t width;
+  uint32_t height;
+  renderer_image_format_t format;
+  uint8_t* blocks;
+} encode_job_t;
+
+int32_t
+texture_compression_is_compressed(renderer_image_format_t format)
+{
+  return
+    format == RENDERER_OPENGL_BC1 ||
+    format == RENDERER_OPENGL_BC3 ||
+    format == RENDERER_OPENGL_BC4 ||
+    format == RENDERER_OPENGL_BC5;
+}
+
+static
+uint32_t
+get_block_bytes(renderer_image_format_t format)
+{
+  return
+    format == RENDERER_OPENGL_BC1 || format == RENDERER_OPENGL_BC4 ? 8 : 16;
+}
+
+static
+size_t
+get_level_size(
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  return
+    (size_t)((width + 3) / 4) * ((height + 3) / 4) * get_block_bytes(format);
+}
+
+size_t
+texture_compression_size(
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format)
+{
+  mipmaps_chain_t chain;
+  size_t size = 0;
+  assert(texture_compression_is_compressed(format));
+
+  mipmaps_layout(&chain, width, height, 1);
+  for (uint32_t level = 0; level < chain.level_count; ++level)
+    size += get_level_size(chain.width[level], chain.height[level], format);
+
+  return size;
+}
+
+/// @brief any uncompressed format to RGBA8, luminance replicates and alpha
+/// only images are white.
+static
+void
+expand_texels(
+  const uint8_t* source,
+  size_t count,
+  renderer_image_format_t format,
+  uint8_t* target)
+{
+  uint32_t components = image_format_components(format);
+  int32_t swap =
+    format == RENDERER_OPENGL_BGRA || format == RENDERER_OPENGL_BGR;
+
+  for (size_t i = 0; i < count; ++i, source += components, target += 4) {
+    if (components >= 3) {
+      target[0] = source[swap ? 2 : 0];
+      target[1] = source[1];
+      target[2] = source[swap ? 0 : 2];
+      target[3] = components == 4 ? source[3] : 255;
+    } else if (format == RENDERER_OPENGL_A) {
+      target[0] = target[1] = target[2] = 255;
+      target[3] = source[0];
+    } else {
+      target[0] = target[1] = target[2] = source[0];
+      target[3] = components == 2 ? source[1] : 255;
+    }
+  }
+}
+
+static
+uint16_t
+pack_565(const float color[3])
+{
+  static const int32_t limits[3] = { 31, 63, 31 };
+  int32_t packed[3];
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    packed[i] = (int32_t)(color[i] * limits[i] / 255.f + 0.5f);
+    packed[i] = packed[i] < 0 ? 0 : packed[i];
+    packed[i] = packed[i] > limits[i] ? limits[i] : packed[i];
+  }
+
+  return (uint16_t)((packed[0] << 11) | (packed[1] << 5) | packed[2]);
+}
+
+static
+void
+unpack_565(uint16_t packed, int32_t color[4])
+{
+  int32_t r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+  color[0] = (r << 3) | (r >> 2);
+  color[1] = (g << 2) | (g >> 4);
+  color[2] = (b << 3) | (b >> 2);
+  color[3] = 255;
+}
+
+/// @brief @a four_colors unless BC1 with c0 <= c1, in which case the third
+/// color is the average and the fourth transparent black.
+static
+void
+get_color_palette(
+  uint16_t c0,
+  uint16_t c1,
+  int32_t four_colors,
+  int32_t palette[4][4])
+{
+  unpack_565(c0, palette[0]);
+  unpack_565(c1, palette[1]);
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    if (four_colors) {
+      palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+      palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+    } else {
+      palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+      palette[3][i] = 0;
+    }
+  }
+
+  palette[2][3] = 255;
+  palette[3][3] = four_colors ? 255 : 0;
+}
+
+/// @brief nearest palette entry of each opaque texel, the transparent ones get
+/// index 3. returns the squared error.
+static
+uint32_t
+select_color_indices(
+  const uint8_t* block,
+  uint32_t transparent,
+  int32_t palette[4][4],
+  uint32_t candidates,
+  uint32_t* indices)
+{
+  uint32_t error = 0;
+  *indices = 0;
+
+  for (uint32_t i = 0; i < 16; ++i) {
+    uint32_t best = 3, best_error = UINT32_MAX;
+    if (!(transparent & (1u << i))) {
+      for (uint32_t j = 0; j < candidates; ++j) {
+        int32_t r = block[i * 4 + 0] - palette[j][0];
+        int32_t g = block[i * 4 + 1] - palette[j][1];
+        int32_t b = block[i * 4 + 2] - palette[j][2];
+        uint32_t distance = (uint32_t)(r * r + g * g + b * b);
+        if (distance < best_error) {
+          best_error = distance;
+          best = j;
+        }
+      }
+      error += best_error;
+    }
+    *indices |= best << (i * 2);
+  }
+
+  return error;
+}
+
+/// @brief orders the endpoints for the mode (c0 > c1 for 4 colors) and picks
+/// the indices. returns the squared error.
+static
+uint32_t
+fit_color_block(
+  const uint8_t* block,
+  uint32_t transparent,
+  int32_t bc1,
+  uint16_t* c0,
+  uint16_t* c1,
+  uint32_t* indices)
+{
+  int32_t palette[4][4];
+  int32_t four_colors = !transparent;
+
+  if (four_colors ? *c0 < *c1 : *c0 > *c1) {
+    uint16_t swap = *c0;
+    *c0 = *c1;
+    *c1 = swap;
+  }
+
+  // BC1 decodes equal endpoints in 3 color mode, index 0 is right anyway.
+  four_colors = !bc1 || *c0 > *c1;
+  get_color_palette(*c0, *c1, four_colors, palette);
+  return select_color_indices(
+    block, transparent, palette, four_colors ? 4 : 3, indices);
+}
+
+/// @brief least squares endpoints for the current 4 color indices.
+static
+int32_t
+refine_endpoints(
+  const uint8_t* block,
+  uint32_t indices,
+  float endpoints[2][3])
+{
+  static const float weights[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+  float aa = 0.f, bb = 0.f, ab = 0.f, ax[3] = { 0 }, bx[3] = { 0 };
+  float determinant;
+
+  for (uint32_t i = 0; i < 16; ++i) {
+    float a = weights[(indices >> (i * 2)) & 3], b = 1.f - a;
+    aa += a * a;
+    bb += b * b;
+    ab += a * b;
+    for (uint32_t j = 0; j < 3; ++j) {
+      ax[j] += a * block[i * 4 + j];
+      bx[j] += b * block[i * 4 + j];
+    }
+  }
+
+  determinant = aa * bb - ab * ab;
+  if (determinant < FLT_EPSILON)
+    return 0;
+
+  for (uint32_t j = 0; j < 3; ++j) {
+    endpoints[0][j] = (ax[j] * bb - bx[j] * ab) / determinant;
+    endpoints[1][j] = (bx[j] * aa - ax[j] * ab) / determinant;
+  }
+
+  return 1;
+}
+
+/// @brief endpoints along the principal axis of the opaque texels, then one
+/// least squares pass. texels with alpha below 128 are transparent if @a bc1.
+static
+void
+encode_color_block(const uint8_t* block, int32_t bc1, uint8_t* out)
+{
+  uint32_t transparent = 0, count = 0, indices = 0, error;
+  float mean[3] = { 0 }, axis[3] = { 1.f, 1.f, 1.f }, covariance[6] = { 0 };
+  float low = FLT_MAX, high = -FLT_MAX, endpoints[2][3];
+  uint16_t c0 = 0, c1 = 0;
+
+  for (uint32_t i = 0; i < 16; ++i) {
+    if (bc1 && block[i * 4 + 3] < 128) {
+      transparent |= 1u << i;
+      continue;
+    }
+    for (uint32_t j = 0; j < 3; ++j)
+      mean[j] += block[i * 4 + j];
+    ++count;
+  }
+
+  if (count) {
+    for (uint32_t j = 0; j < 3; ++j)
+      mean[j] /= (float)count;
+
+    for (uint32_t i = 0; i < 16; ++i) {
+      float r, g, b;
+      if (transparent & (1u << i))
+        continue;
+      r = block[i * 4 + 0] - mean[0];
+      g = block[i * 4 + 1] - mean[1];
+      b = block[i * 4 + 2] - mean[2];
+      covariance[0] += r * r;
+      covariance[1] += r * g;
+      covariance[2] += r * b;
+      covariance[3] += g * g;
+      covariance[4] += g * b;
+      covariance[5] += b * b;
+    }
+
+    for (uint32_t iteration = 0; iteration < 4; ++iteration) {
+      float x =
+        covariance[0] * axis[0] + covariance[1] * axis[1] +
+        covariance[2] * axis[2];
+      float y =
+        covariance[1] * axis[0] + covariance[3] * axis[1] +
+        covariance[4] * axis[2];
+      float z =
+        covariance[2] * axis[0] + covariance[4] * axis[1] +
+        covariance[5] * axis[2];
+      float largest = x * x > y * y ? x : y;
+      largest = largest * largest > z * z ? largest : z;
+      if (largest == 0.f)
+        break;
+      axis[0] = x / largest;
+      axis[1] = y / largest;
+      axis[2] = z / largest;
+    }
+
+    for (uint32_t i = 0; i < 16; ++i) {
+      float t;
+      if (transparent & (1u << i))
+        continue;
+      t =
+        (block[i * 4 + 0] - mean[0]) * axis[0] +
+        (block[i * 4 + 1] - mean[1]) * axis[1] +
+        (block[i * 4 + 2] - mean[2]) * axis[2];
+      low = t < low ? t : low;
+      high = t > high ? t : high;
+    }
+
+    for (uint32_t j = 0; j < 3; ++j) {
+      endpoints[0][j] = mean[j] + axis[j] * high;
+      endpoints[1][j] = mean[j] + axis[j] * low;
+    }
+
+    c0 = pack_565(endpoints[0]);
+    c1 = pack_565(endpoints[1]);
+    error = fit_color_block(block, transparent, bc1, &c0, &c1, &indices);
+
+    if (!transparent && error && refine_endpoints(block, indices, endpoints)) {
+      uint16_t r0 = pack_565(endpoints[0]), r1 = pack_565(endpoints[1]);
+      uint32_t refined = 0;
+      if (fit_color_block(block, 0, bc1, &r0, &r1, &refined) < error) {
+        c0 = r0;
+        c1 = r1;
+        indices = refined;
+      }
+    }
+  } else {
+    // fully transparent, 3 color mode with every index at 3.
+    indices = UINT32_MAX;
+  }
+
+  out[0] = (uint8_t)c0;
+  out[1] = (uint8_t)(c0 >> 8);
+  out[2] = (uint8_t)c1;
+  out[3] = (uint8_t)(c1 >> 8);
+  for (uint32_t i = 0; i < 4; ++i)
+    out[4 + i] = (uint8_t)(indices >> (i * 8));
+}
+
+/// @brief 8 interpolated values if @a a0 > @a a1, else 6 and then 0 and 255.
+static
+void
+get_channel_palette(int32_t a0, int32_t a1, int32_t palette[8])
+{
+  palette[0] = a0;
+  palette[1] = a1;
+
+  if (a0 > a1) {
+    for (int32_t i = 1; i < 7; ++i)
+      palette[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+  } else {
+    for (int32_t i = 1; i < 5; ++i)
+      palette[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+}
+
+static
+uint32_t
+select_channel_indices(
+  const uint8_t* block,
+  uint32_t channel,
+  int32_t a0,
+  int32_t a1,
+  uint64_t* indices)
+{
+  int32_t palette[8];
+  uint32_t error = 0;
+  get_channel_palette(a0, a1, palette);
+  *indices = 0;
+
+  for (uint32_t i = 0; i < 16; ++i) {
+    uint32_t best = 0, best_error = UINT32_MAX;
+    for (uint32_t j = 0; j < 8; ++j) {
+      int32_t difference = block[i * 4 + channel] - palette[j];
+      uint32_t distance = (uint32_t)(difference * difference);
+      if (distance < best_error) {
+        best_error = distance;
+        best = j;
+      }
+    }
+    error += best_error;
+    *indices |= (uint64_t)best << (i * 3);
+  }
+
+  return error;
+}
+
+/// @brief BC4 block of one component, the better of the 8 value mode over the
+/// whole range and the 6 value mode over the range without 0 and 255.
+static
+void
+encode_channel_block(const uint8_t* block, uint32_t channel, uint8_t* out)
+{
+  int32_t low = 255, high = 0, inner_low = 255, inner_high = 0;
+  int32_t a0, a1;
+  uint64_t indices = 0, inner_indices = 0;
+  uint32_t error, inner_error;
+
+  for (uint32_t i = 0; i < 16; ++i) {
+    int32_t value = block[i * 4 + channel];
+    low = value < low ? value : low;
+    high = value > high ? value : high;
+    if (value != 0 && value != 255) {
+      inner_low = value < inner_low ? value : inner_low;
+      inner_high = value > inner_high ? value : inner_high;
+    }
+  }
+
+  // only extremes, the 6 value mode has them.
+  if (inner_low > inner_high)
+    inner_low = inner_high = 0;
+
+  // the palettes are the ones the decoder picks, equal endpoints included.
+  error = select_channel_indices(block, channel, high, low, &indices);
+  inner_error = select_channel_indices(
+    block, channel, inner_low, inner_high, &inner_indices);
+
+  a0 = high;
+  a1 = low;
+  if (inner_error < error) {
+    a0 = inner_low;
+    a1 = inner_high;
+    indices = inner_indices;
+  }
+
+  out[0] = (uint8_t)a0;
+  out[1] = (uint8_t)a1;
+  for (uint32_t i = 0; i < 6; ++i)
+    out[2 + i] = (uint8_t)(indices >> (i * 8));
+}
+
+/// @brief the 4x4 texels at (@a x, @a y), the last row/column repeats past the
+/// edges.
+static
+void
+fetch_block(
+  const uint8_t* pixels,
+  uint32_t width,
+  uint32_t height,
+  uint32_t x,
+  uint32_t y,
+  uint8_t block[64])
+{
+  for (uint32_t j = 0; j < 4; ++j) {
+    uint32_t row = y + j < height ? y + j : height - 1;
+    for (uint32_t i = 0; i < 4; ++i) {
+      uint32_t column = x + i < width ? x + i : width - 1;
+      memcpy(
+        block + (j * 4 + i) * 4,
+        pixels + ((size_t)row * width + column) * 4,
+        4);
+    }
+  }
+}
+
+static
+void
+encode_band(void* data, uint32_t index)
+{
+  const encode_job_t* job = (const encode_job_t*)data;
+  uint32_t block_bytes = get_block_bytes(job->format);
+  uint32_t blocks_wide = (job->width + 3) / 4;
+  uint32_t blocks_high = (job->height + 3) / 4;
+  uint32_t first = index * BAND_BLOCK_ROWS;
+  uint32_t last = first + BAND_BLOCK_ROWS;
+  uint8_t block[64];
+  last = last < blocks_high ? last : blocks_high;
+
+  for (uint32_t y = first; y < last; ++y) {
+    for (uint32_t x = 0; x < blocks_wide; ++x) {
+      uint8_t* out =
+        job->blocks + ((size_t)y * blocks_wide + x) * block_bytes;
+      fetch_block(job->pixels, job->width, job->height, x * 4, y * 4, block);
+
+      switch (job->format)
+      {
+      case RENDERER_OPENGL_BC1:
+        encode_color_block(block, 1, out);
+        break;
+      case RENDERER_OPENGL_BC3:
+        encode_channel_block(block, 3, out);
+        encode_color_block(block, 0, out + 8);
+        break;
+      case RENDERER_OPENGL_BC4:
+        encode_channel_block(block, 0, out);
+        break;
+      default:
+        encode_channel_block(block, 0, out);
+        encode_channel_block(block, 1, out + 8);
+        break;
+      }
+    }
+  }
+}
+
+void
+texture_compress(
+  const uint8_t* pixels,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format,
+  renderer_image_format_t target,
+  uint8_t* blocks)
+{
+  mipmaps_chain_t chain;
+  uint8_t* levels = NULL;
+  assert(!texture_compression_is_compressed(format));
+  assert(texture_compression_is_compressed(target));
+
+  // the chain is built in RGBA8, level 0 is expanded in place.
+  mipmaps_layout(&chain, width, height, 4);
+  levels = malloc(chain.size);
+  assert(levels);
+  expand_texels(pixels, (size_t)width * height, format, levels);
+  mipmaps_generate(
+    &chain,
+    levels,
+    width,
+    height,
+    4,
+    0,
+    MIPMAPS_FILTER_BOX,
+    1,
+    levels);
+
+  for (uint32_t level = 0; level < chain.level_count; ++level) {
+    encode_job_t job;
+    job.pixels = levels + chain.offset[level];
+    job.width = chain.width[level];
+    job.height = chain.height[level];
+    job.format = target;
+    job.blocks = blocks;
+    jobs_parallel_for(
+      ((job.height + 3) / 4 + BAND_BLOCK_ROWS - 1) / BAND_BLOCK_ROWS,
+      encode_band,
+      &job);
+    blocks += get_level_size(job.width, job.height, target);
+  }
+
+  free(levels);
+}
+
+int32_t
+texture_compress_cached(
+  const char* directory,
+  const uint8_t* pixels,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format,
+  renderer_image_format_t target,
+  uint8_t* blocks)
+{
+  size_t size = texture_compression_size(width, height, target);
+  uint32_t header[7] = {
+    CACHE_MAGIC,
+    ENCODER_VERSION,
+    width,
+    height,
+    (uint32_t)format,
+    (uint32_t)target,
+    (uint32_t)size };
+  uint32_t stored[7];
+  uint64_t key = IMAGE_HASH_SEED;
+  char path[1024];
+  FILE* file = NULL;
+
+  key = image_hash_bytes(
+    key, pixels, (size_t)width * height * image_format_components(format));
+  key = image_hash_bytes(key, (const uint8_t*)header, sizeof(header));
+  snprintf(
+    path,
+    sizeof(path),
+    "%s/%016llx.bc",
+    directory,
+    (unsigned long long)key);
+
+  file = fopen(path, "rb");
+  if (file) {
+    int32_t valid =
+      fread(stored, sizeof(stored), 1, file) == 1 &&
+      !memcmp(stored, header, sizeof(header)) &&
+      fread(blocks, 1, size, file) == size;
+    fclose(file);
+    if (valid)
+      return 1;
+  }
+
+  texture_compress(pixels, width, height, format, target, blocks);
+
+  // a file cut short fails the checks above and is written again.
+  file = fopen(path, "wb");
+  if (file) {
+    fwrite(header, sizeof(header), 1, file);
+    fwrite(blocks, 1, size, file);
+    fclose(file);
+  }
+
+  return 0;
+}
+
+static
+void
+decode_color_block(const uint8_t* in, int32_t bc1, uint8_t* texels)
+{
+  uint16_t c0 = (uint16_t)(in[0] | (in[1] << 8));
+  uint16_t c1 = (uint16_t)(in[2] | (in[3] << 8));
+  uint32_t indices =
+    (uint32_t)in[4] | ((uint32_t)in[5] << 8) |
+    ((uint32_t)in[6] << 16) | ((uint32_t)in[7] << 24);
+  int32_t palette[4][4];
+  get_color_palette(c0, c1, !bc1 || c0 > c1, palette);
+
+  for (uint32_t i = 0; i < 16; ++i) {
+    const int32_t* color = palette[(indices >> (i * 2)) & 3];
+    for (uint32_t j = 0; j < 4; ++j)
+      texels[i * 4 + j] = (uint8_t)color[j];
+  }
+}
+
+static
+void
+decode_channel_block(const uint8_t* in, uint8_t* texels, uint32_t channel)
+{
+  int32_t palette[8];
+  uint64_t indices = 0;
+  get_channel_palette(in[0], in[1], palette);
+  for (uint32_t i = 0; i < 6; ++i)
+    indices |= (uint64_t)in[2 + i] << (i * 8);
+
+  for (uint32_t i = 0; i < 16; ++i)
+    texels[i * 4 + channel] = (uint8_t)palette[(indices >> (i * 3)) & 7];
+}
+
+void
+texture_decompress(
+  const uint8_t* blocks,
+  uint32_t width,
+  uint32_t height,
+  renderer_image_format_t format,
+  uint8_t* pixels)
+{
+  uint32_t block_bytes = get_block_bytes(format);
+  uint8_t texels[64];
+  assert(texture_compression_is_compressed(format));
+
+  for (uint32_t y = 0; y < height; y += 4) {
+    for (uint32_t x = 0; x < width; x += 4, blocks += block_bytes) {
+      switch (format)
+      {
+      case RENDERER_OPENGL_BC1:
+        decode_color_block(blocks, 1, texels);
+        break;
+      case RENDERER_OPENGL_BC3:
+        decode_color_block(blocks + 8, 0, texels);
+        decode_channel_block(blocks, texels, 3);
+        break;
+      default:
+        // red (and green), blue 0 and alpha 1 as opengl samples them.
+        memset(texels, 0, sizeof(texels));
+        for (uint32_t i = 0; i < 16; ++i)
+          texels[i * 4 + 3] = 255;
+        decode_channel_block(blocks, texels, 0);
+        if (format == RENDERER_OPENGL_BC5)
+          decode_channel_block(blocks + 8, texels, 1);
+        break;
+      }
+
+      for (uint32_t j = 0; j < 4 && y + j < height; ++j) {
+        uint32_t columns = width - x < 4 ? width - x : 4;
+        memcpy(
+          pixels + ((size_t)(y + j) * width + x) * 4,
+          texels + j * 16,
+          columns * 4);
+      }
+    }
+  }
+}
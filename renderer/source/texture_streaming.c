@@ -0,0 +1,397 @@
+/**
+ * @file texture_streaming.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <renderer/internal/frame_stats.h>
+#include <renderer/internal/mipmaps.h>
+#include <renderer/internal/opengl_extensions.h>
+#include <renderer/internal/state_cache.h>
+#include <renderer/internal/texture_streaming.h>
+#include <renderer/internal/threads.h>
+
+
+#define STREAM_BUFFER_COUNT       3
+
+typedef
+enum {
+  STREAM_QUEUED,            // waiting for the worker.
+  STREAM_BUILDING,          // owned by the worker.
+  STREAM_PREPARED           // owned by the context thread.
+} stream_state_t;
+
+typedef
+struct texture_stream_t {
+  GLuint texture;
+  GLenum format;
+  uint32_t components;
+  uint32_t width;
+  uint32_t height;
+  int32_t swizzle;
+  mipmaps_filter_t filter;
+  uint8_t* pixels;          // source copy if it needs resizing, else NULL.
+  uint8_t* levels;          // laid out by chain.
+  mipmaps_chain_t chain;
+  uint32_t next_level;      // next one to upload.
+  int32_t cancelled;
+  stream_state_t state;
+  struct texture_stream_t* next;
+} texture_stream_t;
+
+// the list is only linked/unlinked by the context thread, the worker reads it
+// and changes the state of the streams, both under the mutex.
+typedef
+struct texture_streaming_t {
+  texture_stream_t* head;
+  texture_stream_t* tail;
+  thread_t* worker;
+  mutex_t* mutex;
+  condition_t* wake;
+  int32_t quit;
+  GLuint buffers[STREAM_BUFFER_COUNT];
+  uint32_t next_buffer;
+} texture_streaming_t;
+
+static texture_streaming_t streaming;
+
+/// @brief level 0 (resized if needed) and the rest of the chain, @a parallel
+/// only on the thread owning the jobs pool.
+static
+void
+prepare_stream(texture_stream_t* stream, int32_t parallel)
+{
+  mipmaps_generate(
+    &stream->chain,
+    stream->pixels ? stream->pixels : stream->levels,
+    stream->width,
+    stream->height,
+    stream->components,
+    stream->swizzle,
+    stream->filter,
+    parallel,
+    stream->levels);
+
+  free(stream->pixels);
+  stream->pixels = NULL;
+}
+
+static
+void
+worker_entry(void* data)
+{
+  (void)data;
+
+  mutex_lock(streaming.mutex);
+  while (!streaming.quit) {
+    texture_stream_t* stream = streaming.head;
+    int32_t cancelled = 0;
+    while (stream && stream->state != STREAM_QUEUED)
+      stream = stream->next;
+
+    if (!stream) {
+      condition_wait(streaming.wake, streaming.mutex);
+      continue;
+    }
+
+    // a cancelled stream still ends up prepared, the context thread frees it.
+    stream->state = STREAM_BUILDING;
+    cancelled = stream->cancelled;
+    mutex_unlock(streaming.mutex);
+    if (!cancelled)
+      prepare_stream(stream, 0);
+    mutex_lock(streaming.mutex);
+    stream->state = STREAM_PREPARED;
+  }
+  mutex_unlock(streaming.mutex);
+}
+
+static
+void
+free_stream(texture_stream_t* stream)
+{
+  free(stream->pixels);
+  free(stream->levels);
+  free(stream);
+}
+
+/// @brief the worker starts with the first request, if it cannot the streams
+/// are prepared on the calling thread.
+static
+int32_t
+start_worker(void)
+{
+  if (streaming.worker)
+    return 1;
+
+  if (!streaming.mutex) {
+    streaming.mutex = mutex_create();
+    streaming.wake = condition_create();
+  }
+
+  streaming.quit = 0;
+  streaming.worker = thread_create(worker_entry, NULL);
+  return streaming.worker != NULL;
+}
+
+void
+texture_streaming_request(
+  GLuint texture,
+  const uint8_t* pixels,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components,
+  GLenum format,
+  int32_t swizzle,
+  mipmaps_filter_t filter)
+{
+  texture_stream_t* stream = calloc(1, sizeof(texture_stream_t));
+  uint32_t level_width = width, level_height = height;
+  size_t size = (size_t)width * height * components;
+  uint32_t max_size = (uint32_t)opengl_features.max_texture_size;
+  assert(stream);
+
+  // scaled to powers of 2, as gluBuild2DMipmaps does, when npot sizes are
+  // not supported.
+  if (!opengl_features.npot_textures) {
+    level_width = mipmaps_power_of_2(width, max_size);
+    level_height = mipmaps_power_of_2(height, max_size);
+  }
+
+  stream->texture = texture;
+  stream->format = format;
+  stream->components = components;
+  stream->width = width;
+  stream->height = height;
+  stream->swizzle = swizzle;
+  stream->filter = filter;
+  mipmaps_layout(&stream->chain, level_width, level_height, components);
+  stream->levels = malloc(stream->chain.size);
+  assert(stream->levels);
+
+  if (level_width == width && level_height == height) {
+    memcpy(stream->levels, pixels, size);
+  } else {
+    stream->pixels = malloc(size);
+    assert(stream->pixels);
+    memcpy(stream->pixels, pixels, size);
+  }
+
+  if (!start_worker()) {
+    prepare_stream(stream, 1);
+    stream->state = STREAM_PREPARED;
+  }
+
+  mutex_lock(streaming.mutex);
+  if (streaming.tail)
+    streaming.tail->next = stream;
+  else
+    streaming.head = stream;
+  streaming.tail = stream;
+  condition_signal(streaming.wake);
+  mutex_unlock(streaming.mutex);
+}
+
+int32_t
+texture_streaming_is_pending(GLuint texture)
+{
+  texture_stream_t* stream = NULL;
+  if (!streaming.mutex)
+    return 0;
+
+  mutex_lock(streaming.mutex);
+  for (stream = streaming.head; stream; stream = stream->next) {
+    if (stream->texture == texture && !stream->cancelled)
+      break;
+  }
+  mutex_unlock(streaming.mutex);
+
+  return stream != NULL;
+}
+
+/// @brief @a previous is NULL for the head, the mutex must be held.
+static
+void
+unlink_stream(texture_stream_t* previous, texture_stream_t* stream)
+{
+  if (previous)
+    previous->next = stream->next;
+  else
+    streaming.head = stream->next;
+  if (streaming.tail == stream)
+    streaming.tail = previous;
+}
+
+void
+texture_streaming_cancel(GLuint texture)
+{
+  texture_stream_t* previous = NULL;
+  texture_stream_t* stream = NULL;
+  if (!streaming.mutex)
+    return;
+
+  mutex_lock(streaming.mutex);
+  stream = streaming.head;
+  while (stream) {
+    texture_stream_t* next = stream->next;
+    if (stream->texture == texture && stream->state != STREAM_BUILDING) {
+      unlink_stream(previous, stream);
+      free_stream(stream);
+    } else {
+      // the worker has it, it is freed once prepared.
+      if (stream->texture == texture)
+        stream->cancelled = 1;
+      previous = stream;
+    }
+    stream = next;
+  }
+  mutex_unlock(streaming.mutex);
+}
+
+/// @brief goes through the next pixel buffer when supported, the buffer is
+/// orphaned first so the copy never waits on the previous upload from it.
+static
+void
+upload_level(texture_stream_t* stream, uint32_t level)
+{
+  const uint8_t* source = stream->levels + stream->chain.offset[level];
+  uint32_t width = stream->chain.width[level];
+  uint32_t height = stream->chain.height[level];
+  size_t size = (size_t)width * height * stream->components;
+
+  if (opengl_features.pixel_buffer_objects) {
+    GLuint buffer = 0;
+    void* mapped = NULL;
+
+    if (!streaming.buffers[0])
+      glGenBuffers(STREAM_BUFFER_COUNT, streaming.buffers);
+
+    buffer = streaming.buffers[streaming.next_buffer];
+    streaming.next_buffer = (streaming.next_buffer + 1) % STREAM_BUFFER_COUNT;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    glBufferData(
+      GL_PIXEL_UNPACK_BUFFER,
+      (renderer_glsizeiptr_t)size,
+      NULL,
+      GL_STREAM_DRAW);
+    mapped = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+
+    if (mapped) {
+      memcpy(mapped, source, size);
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+      source = NULL;        // offset 0 in the bound buffer.
+    } else {
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+  }
+
+  // core contexts reject the legacy component counts, the luminance and alpha
+  // formats only stream on compatibility contexts.
+  glTexImage2D(
+    GL_TEXTURE_2D,
+    (GLint)level,
+    stream->components >= 3 ?
+      (GLint)stream->format : (GLint)stream->components,
+    (GLsizei)width,
+    (GLsizei)height,
+    0,
+    stream->format,
+    GL_UNSIGNED_BYTE,
+    source);
+  stats_count_upload(size);
+}
+
+void
+texture_streaming_pump(uint32_t byte_budget)
+{
+  texture_stream_t* previous = NULL;
+  texture_stream_t* stream = NULL;
+  uint64_t uploaded = 0;
+  uint32_t levels = 0;
+  if (!streaming.mutex)
+    return;
+
+  mutex_lock(streaming.mutex);
+  stream = streaming.head;
+  while (stream && (!levels || uploaded < byte_budget)) {
+    texture_stream_t* next = stream->next;
+
+    if (stream->state != STREAM_PREPARED) {
+      previous = stream;
+      stream = next;
+      continue;
+    }
+
+    if (stream->cancelled) {
+      unlink_stream(previous, stream);
+      free_stream(stream);
+      stream = next;
+      continue;
+    }
+
+    // the levels are tightly packed.
+    if (!levels)
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    state_bind_texture(stream->texture);
+    while (
+      stream->next_level < stream->chain.level_count &&
+      (!levels || uploaded < byte_budget)) {
+      uint32_t level = stream->next_level++;
+      ++levels;
+      upload_level(stream, level);
+      uploaded +=
+        (uint64_t)stream->chain.width[level] *
+        stream->chain.height[level] * stream->components;
+    }
+
+    // the texture is complete, hence usable, once the last level is in.
+    if (stream->next_level == stream->chain.level_count) {
+      unlink_stream(previous, stream);
+      free_stream(stream);
+    } else {
+      previous = stream;
+    }
+    stream = next;
+  }
+  mutex_unlock(streaming.mutex);
+
+  // sourcing pixels from client memory again.
+  if (levels && opengl_features.pixel_buffer_objects)
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void
+texture_streaming_cleanup(void)
+{
+  if (streaming.worker) {
+    mutex_lock(streaming.mutex);
+    streaming.quit = 1;
+    condition_broadcast(streaming.wake);
+    mutex_unlock(streaming.mutex);
+    thread_join(streaming.worker);
+  }
+
+  while (streaming.head) {
+    texture_stream_t* next = streaming.head->next;
+    free_stream(streaming.head);
+    streaming.head = next;
+  }
+
+  if (streaming.buffers[0])
+    glDeleteBuffers(STREAM_BUFFER_COUNT, streaming.buffers);
+
+  if (streaming.mutex) {
+    condition_destroy(streaming.wake);
+    mutex_destroy(streaming.mutex);
+  }
+
+  memset(&streaming, 0, sizeof(texture_streaming_t));
+}
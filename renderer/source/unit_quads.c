@@ -0,0 +1,76 @@
+/**
+ * @file unit_quads.c
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <renderer/internal/unit_quads.h>
+
+
+void
+expand_unit_quads(
+  const unit_quad_t* uvs,
+  uint32_t uvs_count,
+  float* vertices,
+  float* tex_coords)
+{
+  float left = 0.f;
+
+  for (uint32_t i = 0; i < uvs_count; ++i) {
+    const float* data = uvs[i].data;
+    float right = left + data[4];
+
+    vertices[0] = left;
+    vertices[1] = data[5];
+    vertices[2] = 0.f;
+
+    vertices[3] = left;
+    vertices[4] = 0.f;
+    vertices[5] = 0.f;
+
+    vertices[6] = right;
+    vertices[7] = 0.f;
+    vertices[8] = 0.f;
+
+    vertices[9] = right;
+    vertices[10] = data[5];
+    vertices[11] = 0.f;
+
+    tex_coords[0] = data[0];
+    tex_coords[1] = data[1];
+
+    tex_coords[2] = data[0];
+    tex_coords[3] = data[3];
+
+    tex_coords[4] = data[2];
+    tex_coords[5] = data[3];
+
+    tex_coords[6] = data[2];
+    tex_coords[7] = data[1];
+
+    left = right;
+    vertices += UNIT_QUAD_VERTICES * 3;
+    tex_coords += UNIT_QUAD_VERTICES * 2;
+  }
+}
+
+void
+build_unit_quad_indices(uint32_t* indices, uint32_t first, uint32_t count)
+{
+  indices += first * UNIT_QUAD_INDICES;
+
+  for (uint32_t i = first; i < first + count; ++i) {
+    uint32_t base = i * UNIT_QUAD_VERTICES;
+    indices[0] = base + 0;
+    indices[1] = base + 1;
+    indices[2] = base + 2;
+    indices[3] = base + 0;
+    indices[4] = base + 2;
+    indices[5] = base + 3;
+    indices += UNIT_QUAD_INDICES;
+  }
+}
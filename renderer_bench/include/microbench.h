@@ -0,0 +1,48 @@
+/**
+ * @file microbench.h
+ * @author khalilhenoud@gmail.com
+ * @brief cpu side microbenchmarks of the renderer (pipeline.h math, quad
+ * expansion, texture conversion), no opengl context or library involved.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+struct microbench_t {
+  const char* name;
+  double bytes_per_op;      // read and written by one op, 0 if meaningless.
+  std::function<void(uint64_t iterations)> run;
+};
+
+/// @brief keeps the compiler from discarding the work that produced the
+/// pointed to data, inlined so the cases do not pay for a call.
+inline
+void
+microbench_escape(const void* pointer)
+{
+#if defined(_MSC_VER)
+  static const void* volatile sink;
+  sink = pointer;
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "g"(pointer) : "memory");
+#endif
+}
+
+/// @brief every case, in report order. the fixtures are built here.
+std::vector<microbench_t>
+get_microbenchmarks();
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * @file report.h
+ * @author khalilhenoud@gmail.com
+ * @brief frame time statistics and their json output.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <scene.h>
+
+
+struct report_t {
+  const char* backend = "";
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t warmup = 0;
+  scene_params_t scene;
+  scene_workload_t workload = {};
+  std::vector<double> frame_ms;         // the measured frames, in order.
+  double total_seconds = 0.0;
+
+  // renderer_stats.h averages, opengl only (the software backend leaves its
+  // counters at 0).
+  int32_t has_renderer_stats = 0;
+  double renderer_draw_calls = 0.0;
+  double renderer_state_changes = 0.0;
+  double renderer_texture_binds = 0.0;
+  double gpu_ms[3] = {};                // p50/p95/p99, 0 without queries.
+};
+
+/// @brief nearest rank, @a percentile in [0, 100].
+double
+get_percentile(std::vector<double> values, double percentile);
+
+void
+write_report(const report_t& report, FILE* file);
+
+#endif
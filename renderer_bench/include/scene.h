@@ -0,0 +1,57 @@
+/**
+ * @file scene.h
+ * @author khalilhenoud@gmail.com
+ * @brief parameterized benchmark scene, everything is generated from the
+ * parameters and the seed so two runs submit exactly the same work.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <cstdint>
+
+
+#define SCENE_MAX_LIGHTS          8
+
+struct scene_params_t {
+  uint32_t mesh_count = 64;
+  uint32_t mesh_triangles = 2048;       // per mesh.
+  uint32_t glyph_count = 2000;
+  uint32_t line_count = 1000;
+  uint32_t texture_count = 8;           // 0 draws everything untextured.
+  uint32_t light_count = 4;             // up to SCENE_MAX_LIGHTS.
+  uint32_t instanced = 0;               // one draw per texture, tinted.
+  uint32_t clustered_lights = 0;        // replace the lights above if set.
+  uint32_t seed = 1;
+};
+
+/// @brief what a single frame submits, the same for every frame.
+struct scene_workload_t {
+  uint32_t submitted_draws; // batches handed to the renderer, the draw calls
+                            // it issues are measured (renderer_stats.h).
+  uint64_t triangles;       // meshes and glyph quads.
+  uint64_t lines;
+};
+
+/// @brief generates the geometry and uploads the textures, the renderer has to
+/// be initialized.
+void
+scene_initialize(
+  const scene_params_t& params,
+  uint32_t width,
+  uint32_t height,
+  scene_workload_t& workload);
+
+/// @brief clears, draws the whole scene and calls flush_operations.
+void
+scene_draw(uint32_t frame);
+
+/// @brief evicts the textures, call before renderer_cleanup.
+void
+scene_cleanup();
+
+#endif
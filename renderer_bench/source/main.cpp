@@ -0,0 +1,318 @@
+/**
+ * @file main.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief headless renderer benchmark, draws a generated scene for a fixed
+ * number of frames and writes the frame time percentiles and throughput as
+ * json. the opengl context is offscreen (a pbuffer on linux, a window that is
+ * never shown on win32).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <renderer/renderer_core.h>
+#include <renderer/renderer_opengl.h>
+#include <renderer/renderer_software.h>
+#include <renderer/renderer_stats.h>
+#include <report.h>
+#include <scene.h>
+
+
+struct options_t {
+  int32_t software = 0;
+  int32_t core = 0;                     // 3.3 core profile backend.
+  uint32_t width = 1280;
+  uint32_t height = 720;
+  uint32_t frames = 500;
+  uint32_t warmup = 30;
+  uint32_t threads = 0;
+  renderer_frame_pacing_t pacing = RENDERER_FRAME_PACING_FENCES;
+  uint32_t frames_in_flight = 2;
+  const char* output = nullptr;
+  scene_params_t scene;
+};
+
+static
+void
+print_usage(FILE* file)
+{
+  fprintf(
+    file,
+    "usage: renderer_bench [options]\n"
+    "  --backend gl|core|software (gl)\n"
+    "  --width n --height n     (1280x720)\n"
+    "  --frames n               measured frames (500)\n"
+    "  --warmup n               frames drawn before measuring (30)\n"
+    "  --threads n              software backend threads, 0 for all (0)\n"
+    "  --pacing fences|finish   (fences)\n"
+    "  --frames-in-flight n     (2)\n"
+    "  --meshes n               (64)\n"
+    "  --triangles n            triangles per mesh (2048)\n"
+    "  --glyphs n               (2000)\n"
+    "  --lines n                debug lines (1000)\n"
+    "  --textures n             (8)\n"
+    "  --lights n               up to 8 (4)\n"
+    "  --instanced 0|1          one instanced draw per texture (0)\n"
+    "  --clustered-lights n     binned lights instead of --lights (0)\n"
+    "  --seed n                 (1)\n"
+    "  --output path            json report, stdout by default\n");
+}
+
+static
+int32_t
+parse_options(int argc, char** argv, options_t& options)
+{
+  for (int i = 1; i < argc; ++i) {
+    const char* name = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+    uint32_t* number = nullptr;
+
+    if (!strcmp(name, "--help") || !strcmp(name, "-h")) {
+      print_usage(stdout);
+      exit(0);
+    }
+
+    if (!value) {
+      fprintf(stderr, "missing value for %s\n", name);
+      return 0;
+    }
+
+    ++i;
+    if (!strcmp(name, "--backend")) {
+      if (
+        strcmp(value, "gl") &&
+        strcmp(value, "core") &&
+        strcmp(value, "software")) {
+        fprintf(stderr, "unknown backend %s\n", value);
+        return 0;
+      }
+      options.software = !strcmp(value, "software");
+      options.core = !strcmp(value, "core");
+      continue;
+    } else if (!strcmp(name, "--pacing")) {
+      if (strcmp(value, "fences") && strcmp(value, "finish")) {
+        fprintf(stderr, "unknown pacing %s\n", value);
+        return 0;
+      }
+      options.pacing = !strcmp(value, "finish") ?
+        RENDERER_FRAME_PACING_FINISH : RENDERER_FRAME_PACING_FENCES;
+      continue;
+    } else if (!strcmp(name, "--output")) {
+      options.output = value;
+      continue;
+    }
+
+    if (!strcmp(name, "--width"))
+      number = &options.width;
+    else if (!strcmp(name, "--height"))
+      number = &options.height;
+    else if (!strcmp(name, "--frames"))
+      number = &options.frames;
+    else if (!strcmp(name, "--warmup"))
+      number = &options.warmup;
+    else if (!strcmp(name, "--threads"))
+      number = &options.threads;
+    else if (!strcmp(name, "--frames-in-flight"))
+      number = &options.frames_in_flight;
+    else if (!strcmp(name, "--meshes"))
+      number = &options.scene.mesh_count;
+    else if (!strcmp(name, "--triangles"))
+      number = &options.scene.mesh_triangles;
+    else if (!strcmp(name, "--glyphs"))
+      number = &options.scene.glyph_count;
+    else if (!strcmp(name, "--lines"))
+      number = &options.scene.line_count;
+    else if (!strcmp(name, "--textures"))
+      number = &options.scene.texture_count;
+    else if (!strcmp(name, "--lights"))
+      number = &options.scene.light_count;
+    else if (!strcmp(name, "--instanced"))
+      number = &options.scene.instanced;
+    else if (!strcmp(name, "--clustered-lights"))
+      number = &options.scene.clustered_lights;
+    else if (!strcmp(name, "--seed"))
+      number = &options.scene.seed;
+
+    if (!number) {
+      fprintf(stderr, "unknown option %s\n", name);
+      return 0;
+    }
+    *number = (uint32_t)strtoul(value, nullptr, 10);
+  }
+
+  if (options.scene.light_count > SCENE_MAX_LIGHTS)
+    options.scene.light_count = SCENE_MAX_LIGHTS;
+  return options.width && options.height && options.frames;
+}
+
+#if defined(WIN32) || defined(WIN64)
+static HWND window;
+static HDC window_dc;
+
+static
+int32_t
+create_context(uint32_t width, uint32_t height, int32_t core)
+{
+  WNDCLASSEX wcex = { 0 };
+  RECT r = { 0, 0, (LONG)width, (LONG)height };
+  wcex.cbSize = sizeof(WNDCLASSEX);
+  wcex.style = CS_OWNDC;
+  wcex.lpfnWndProc = DefWindowProc;
+  wcex.hInstance = GetModuleHandle(nullptr);
+  wcex.lpszClassName = "renderer_bench";
+  RegisterClassEx(&wcex);
+
+  // the window is never shown, its default framebuffer is still rendered to.
+  AdjustWindowRect(&r, WS_OVERLAPPEDWINDOW, FALSE);
+  window = CreateWindow(
+    "renderer_bench", "", WS_OVERLAPPEDWINDOW, 0, 0,
+    r.right - r.left, r.bottom - r.top, 0, 0, wcex.hInstance, 0);
+  window_dc = GetDC(window);
+  if (core)
+    return opengl_initialize_core((opengl_parameters_t*)&window_dc);
+  return opengl_initialize((opengl_parameters_t*)&window_dc);
+}
+
+static
+void
+destroy_context()
+{
+  opengl_cleanup();
+  ReleaseDC(window, window_dc);
+  DestroyWindow(window);
+}
+#else
+static
+int32_t
+create_context(uint32_t width, uint32_t height, int32_t core)
+{
+  opengl_parameters_t params;
+  params.width = width;
+  params.height = height;
+  if (core)
+    return opengl_initialize_core(&params);
+  return opengl_initialize(&params);
+}
+
+static
+void
+destroy_context()
+{
+  opengl_cleanup();
+}
+#endif
+
+int
+main(int argc, char** argv)
+{
+  using clock = std::chrono::steady_clock;
+  options_t options;
+  report_t report;
+  renderer_software_target_t target = {};
+  std::vector<uint8_t> color;
+  std::vector<float> depth;
+  FILE* file = stdout;
+  clock::time_point begin;
+
+  if (!parse_options(argc, argv, options)) {
+    print_usage(stderr);
+    return 1;
+  }
+
+  if (options.software) {
+    color.resize((size_t)options.width * options.height * 4);
+    depth.resize((size_t)options.width * options.height);
+    target.color = color.data();
+    target.depth = depth.data();
+    target.width = options.width;
+    target.height = options.height;
+    renderer_initialize_software(&target, options.threads);
+  } else {
+    if (!create_context(options.width, options.height, options.core)) {
+      fprintf(
+        stderr,
+        "cannot create %s context\n",
+        options.core ? "a 3.3 core profile" : "an opengl");
+      return 1;
+    }
+
+    if (!options.core)
+      renderer_initialize();
+    else if (!renderer_initialize_core()) {
+      fprintf(stderr, "the core profile backend failed to initialize\n");
+      destroy_context();
+      return 1;
+    }
+    set_frame_pacing(options.pacing, options.frames_in_flight);
+  }
+
+  report.backend = options.software ? "software" : "gl";
+  report.backend = options.core ? "core" : report.backend;
+  report.width = options.width;
+  report.height = options.height;
+  report.warmup = options.warmup;
+  report.has_renderer_stats = !options.software;
+  scene_initialize(
+    options.scene, options.width, options.height, report.workload);
+  report.scene = options.scene;
+
+  for (uint32_t frame = 0; frame < options.warmup; ++frame) {
+    scene_draw(frame);
+    if (!options.software)
+      opengl_swapbuffer();
+  }
+
+  enable_renderer_stats();
+  report.frame_ms.reserve(options.frames);
+  begin = clock::now();
+  for (uint32_t frame = 0; frame < options.frames; ++frame) {
+    clock::time_point start = clock::now();
+    renderer_frame_stats_t stats;
+
+    scene_draw(options.warmup + frame);
+    if (!options.software)
+      opengl_swapbuffer();
+
+    report.frame_ms.push_back(
+      std::chrono::duration<double, std::milli>(clock::now() - start).count());
+    if (get_frame_stats(&stats, 1)) {
+      report.renderer_draw_calls += (double)stats.draw_calls;
+      report.renderer_state_changes += (double)stats.state_changes;
+      report.renderer_texture_binds += (double)stats.texture_binds;
+    }
+  }
+  report.total_seconds =
+    std::chrono::duration<double>(clock::now() - begin).count();
+
+  report.renderer_draw_calls /= options.frames;
+  report.renderer_state_changes /= options.frames;
+  report.renderer_texture_binds /= options.frames;
+  // the ring only keeps the last RENDERER_STATS_FRAMES frames.
+  report.gpu_ms[0] = get_stats_percentile(RENDERER_STAT_GPU_TIME, 50.f) / 1e6;
+  report.gpu_ms[1] = get_stats_percentile(RENDERER_STAT_GPU_TIME, 95.f) / 1e6;
+  report.gpu_ms[2] = get_stats_percentile(RENDERER_STAT_GPU_TIME, 99.f) / 1e6;
+
+  scene_cleanup();
+  renderer_cleanup();
+  if (!options.software)
+    destroy_context();
+
+  if (options.output) {
+    file = fopen(options.output, "w");
+    if (!file) {
+      fprintf(stderr, "cannot write %s\n", options.output);
+      return 1;
+    }
+  }
+
+  write_report(report, file);
+  if (file != stdout)
+    fclose(file);
+  return 0;
+}
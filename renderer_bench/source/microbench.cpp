@@ -0,0 +1,238 @@
+/**
+ * @file microbench.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief runs the cases of microbench_cases.cpp and reports ns/op and
+ * bytes/op. the results can be saved as a baseline, and later runs compared
+ * against it (the exit code is 1 when a case got slower than the threshold).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <microbench.h>
+
+
+struct options_t {
+  const char* filter = nullptr;
+  const char* save = nullptr;
+  const char* compare = nullptr;
+  double min_time_ms = 50.0;
+  uint32_t repetitions = 5;
+  double threshold = 10.0;              // percent.
+};
+
+struct result_t {
+  const char* name;
+  double ns_per_op;
+  double bytes_per_op;
+};
+
+static
+void
+print_usage(FILE* file)
+{
+  fprintf(
+    file,
+    "usage: renderer_microbench [options]\n"
+    "  --filter text            runs the cases whose name contains text\n"
+    "  --min-time ms            per repetition (50)\n"
+    "  --repetitions n          the median is reported (5)\n"
+    "  --save path              writes the results as a json baseline\n"
+    "  --compare path           compares against a saved baseline\n"
+    "  --threshold percent      slowdown reported as a regression (10)\n");
+}
+
+static
+int32_t
+parse_options(int argc, char** argv, options_t& options)
+{
+  for (int i = 1; i < argc; ++i) {
+    const char* name = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+    if (!strcmp(name, "--help") || !strcmp(name, "-h")) {
+      print_usage(stdout);
+      exit(0);
+    }
+
+    if (!value) {
+      fprintf(stderr, "missing value for %s\n", name);
+      return 0;
+    }
+
+    ++i;
+    if (!strcmp(name, "--filter"))
+      options.filter = value;
+    else if (!strcmp(name, "--min-time"))
+      options.min_time_ms = atof(value);
+    else if (!strcmp(name, "--repetitions"))
+      options.repetitions = (uint32_t)strtoul(value, nullptr, 10);
+    else if (!strcmp(name, "--save"))
+      options.save = value;
+    else if (!strcmp(name, "--compare"))
+      options.compare = value;
+    else if (!strcmp(name, "--threshold"))
+      options.threshold = atof(value);
+    else {
+      fprintf(stderr, "unknown option %s\n", name);
+      return 0;
+    }
+  }
+
+  return options.repetitions && options.min_time_ms > 0.0;
+}
+
+static
+double
+time_ms(const microbench_t& benchmark, uint64_t iterations)
+{
+  using clock = std::chrono::steady_clock;
+  clock::time_point start = clock::now();
+  benchmark.run(iterations);
+  return std::chrono::duration<double, std::milli>(clock::now() - start)
+    .count();
+}
+
+/// @brief grows the iteration count until a run lasts the minimum time, then
+/// keeps the median of the repetitions.
+static
+double
+measure(const microbench_t& benchmark, const options_t& options)
+{
+  std::vector<double> samples;
+  uint64_t iterations = 1;
+  double elapsed = time_ms(benchmark, iterations);
+
+  while (elapsed < options.min_time_ms && iterations < (1ull << 40)) {
+    double scale = elapsed > 0.0 ?
+      options.min_time_ms / elapsed * 1.2 : 100.0;
+    iterations = std::max(
+      iterations * 2, (uint64_t)((double)iterations * scale));
+    elapsed = time_ms(benchmark, iterations);
+  }
+
+  samples.push_back(elapsed * 1e6 / (double)iterations);
+  for (uint32_t i = 1; i < options.repetitions; ++i)
+    samples.push_back(time_ms(benchmark, iterations) * 1e6 / iterations);
+
+  std::sort(samples.begin(), samples.end());
+  return samples[samples.size() / 2];
+}
+
+static
+int32_t
+save_baseline(const char* path, const std::vector<result_t>& results)
+{
+  FILE* file = fopen(path, "w");
+  if (!file)
+    return 0;
+
+  // one case per line, load_baseline relies on it.
+  fprintf(file, "{\n  \"benchmarks\": [\n");
+  for (size_t i = 0; i < results.size(); ++i)
+    fprintf(
+      file,
+      "    {\"name\": \"%s\", \"ns_per_op\": %.4f, \"bytes_per_op\": %.0f}%s\n",
+      results[i].name,
+      results[i].ns_per_op,
+      results[i].bytes_per_op,
+      i + 1 < results.size() ? "," : "");
+  fprintf(file, "  ]\n}\n");
+  fclose(file);
+  return 1;
+}
+
+static
+int32_t
+load_baseline(const char* path, std::map<std::string, double>& baseline)
+{
+  char line[512], name[256];
+  double ns_per_op;
+  FILE* file = fopen(path, "r");
+  if (!file)
+    return 0;
+
+  while (fgets(line, sizeof(line), file)) {
+    if (
+      sscanf(
+        line,
+        " {\"name\": \"%255[^\"]\", \"ns_per_op\": %lf",
+        name,
+        &ns_per_op) == 2)
+      baseline[name] = ns_per_op;
+  }
+
+  fclose(file);
+  return 1;
+}
+
+int
+main(int argc, char** argv)
+{
+  options_t options;
+  std::vector<result_t> results;
+  std::map<std::string, double> baseline;
+  uint32_t regressions = 0;
+
+  if (!parse_options(argc, argv, options)) {
+    print_usage(stderr);
+    return 1;
+  }
+
+  if (options.compare && !load_baseline(options.compare, baseline)) {
+    fprintf(stderr, "cannot read %s\n", options.compare);
+    return 1;
+  }
+
+  printf(
+    "%-36s %12s %12s %10s%s\n", "case", "ns/op", "bytes/op", "GB/s",
+    options.compare ? "   baseline     delta" : "");
+  for (const microbench_t& benchmark : get_microbenchmarks()) {
+    result_t result;
+    if (options.filter && !strstr(benchmark.name, options.filter))
+      continue;
+
+    result.name = benchmark.name;
+    result.ns_per_op = measure(benchmark, options);
+    result.bytes_per_op = benchmark.bytes_per_op;
+    results.push_back(result);
+
+    // bytes per nanosecond and gigabytes per second are the same number.
+    printf(
+      "%-36s %12.2f %12.0f %10.2f", result.name, result.ns_per_op,
+      result.bytes_per_op, result.bytes_per_op / result.ns_per_op);
+
+    if (options.compare) {
+      auto found = baseline.find(result.name);
+      if (found == baseline.end()) {
+        printf("   (new)");
+      } else {
+        double delta = (result.ns_per_op / found->second - 1.0) * 100.0;
+        int32_t regressed = delta > options.threshold;
+        regressions += regressed;
+        printf(
+          " %10.2f %+8.1f%%%s", found->second, delta,
+          regressed ? "  REGRESSION" : "");
+      }
+    }
+    printf("\n");
+  }
+
+  if (options.save && !save_baseline(options.save, results)) {
+    fprintf(stderr, "cannot write %s\n", options.save);
+    return 1;
+  }
+
+  if (options.compare)
+    printf(
+      "%u regression(s) above %.1f%%\n", regressions, options.threshold);
+  return regressions ? 1 : 0;
+}
@@ -0,0 +1,328 @@
+/**
+ * @file microbench_cases.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstring>
+#include <memory>
+#include <renderer/pipeline.h>
+#include <renderer/renderer_opengl.h>
+#include <renderer/texture_compression.h>
+#include <renderer/internal/light_clusters.h>
+#include <renderer/internal/mipmaps.h>
+#include <renderer/internal/unit_quads.h>
+#include <microbench.h>
+
+
+#define MATRIX_BYTES              ((double)sizeof(matrix4f))
+#define GLYPH_RUN                 80
+#define TEXTURE_SIZE              256
+#define NPOT_WIDTH                300
+#define NPOT_HEIGHT               200
+
+// the pipelines are too large for the stack.
+static pipeline_t pipeline;
+static matrix4f operand;
+
+static
+void
+reset_pipeline()
+{
+  pipeline_set_default(&pipeline);
+  set_matrix_mode(&pipeline, MODELVIEW);
+  load_identity(&pipeline);
+  matrix4f_rotation_y(&operand, 0.3f);
+}
+
+static
+std::vector<uint8_t>
+make_pixels(uint32_t width, uint32_t height, uint32_t components)
+{
+  std::vector<uint8_t> pixels((size_t)width * height * components);
+  uint32_t state = 0x9e3779b9u;
+  for (uint8_t& pixel : pixels) {
+    state = state * 1664525u + 1013904223u;
+    pixel = (uint8_t)(state >> 24);
+  }
+  return pixels;
+}
+
+static
+void
+add_pipeline_cases(std::vector<microbench_t>& cases)
+{
+  cases.push_back({ "pipeline/push_pop_matrix", MATRIX_BYTES * 2,
+    [](uint64_t iterations) {
+      reset_pipeline();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        push_matrix(&pipeline);
+        microbench_escape(&pipeline);
+        pop_matrix(&pipeline);
+      }
+    } });
+
+  cases.push_back({ "pipeline/post_multiply", MATRIX_BYTES * 3,
+    [](uint64_t iterations) {
+      reset_pipeline();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        post_multiply(&pipeline, &operand);
+        microbench_escape(&pipeline);
+      }
+    } });
+
+  cases.push_back({ "pipeline/pre_multiply", MATRIX_BYTES * 3,
+    [](uint64_t iterations) {
+      reset_pipeline();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        pre_multiply(&pipeline, &operand);
+        microbench_escape(&pipeline);
+      }
+    } });
+
+  // the rotations touch 2 rows or columns of the top matrix.
+  cases.push_back({ "pipeline/pre_rotate_x", MATRIX_BYTES,
+    [](uint64_t iterations) {
+      reset_pipeline();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        pre_rotate_x(&pipeline, 0.001f);
+        microbench_escape(&pipeline);
+      }
+    } });
+
+  cases.push_back({ "pipeline/pre_rotate_y", MATRIX_BYTES,
+    [](uint64_t iterations) {
+      reset_pipeline();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        pre_rotate_y(&pipeline, 0.001f);
+        microbench_escape(&pipeline);
+      }
+    } });
+
+  cases.push_back({ "pipeline/pre_rotate_z", MATRIX_BYTES,
+    [](uint64_t iterations) {
+      reset_pipeline();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        pre_rotate_z(&pipeline, 0.001f);
+        microbench_escape(&pipeline);
+      }
+    } });
+
+  cases.push_back({ "pipeline/post_rotate_y", MATRIX_BYTES,
+    [](uint64_t iterations) {
+      reset_pipeline();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        post_rotate_y(&pipeline, 0.001f);
+        microbench_escape(&pipeline);
+      }
+    } });
+
+  cases.push_back({ "pipeline/post_translate", MATRIX_BYTES * 2,
+    [](uint64_t iterations) {
+      reset_pipeline();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        post_translate(&pipeline, 0.001f, 0.002f, 0.003f);
+        microbench_escape(&pipeline);
+      }
+    } });
+
+  // what state_load_modelview does on the cpu before glLoadMatrixf.
+  cases.push_back({ "pipeline/set_column_major", MATRIX_BYTES * 2,
+    [](uint64_t iterations) {
+      matrix4f column_major;
+      reset_pipeline();
+      for (uint64_t i = 0; i < iterations; ++i) {
+        matrix4f top = get_matrix(&pipeline);
+        matrix4f_set_column_major(&column_major, &top);
+        microbench_escape(&column_major);
+      }
+    } });
+}
+
+static
+void
+add_unit_quads_cases(std::vector<microbench_t>& cases)
+{
+  static std::vector<unit_quad_t> glyphs(GLYPH_RUN);
+  static std::vector<float> vertices(GLYPH_RUN * UNIT_QUAD_VERTICES * 3);
+  static std::vector<float> tex_coords(GLYPH_RUN * UNIT_QUAD_VERTICES * 2);
+  static std::vector<uint32_t> indices(GLYPH_RUN * UNIT_QUAD_INDICES);
+
+  for (uint32_t i = 0; i < GLYPH_RUN; ++i) {
+    float data[6] = { i / 80.f, 0.f, (i + 1) / 80.f, 1.f, 8.f, 16.f };
+    memcpy(glyphs[i].data, data, sizeof(data));
+  }
+
+  cases.push_back({ "unit_quads/expand_80_glyphs",
+    (double)(
+      glyphs.size() * sizeof(unit_quad_t) +
+      (vertices.size() + tex_coords.size()) * sizeof(float)),
+    [](uint64_t iterations) {
+      for (uint64_t i = 0; i < iterations; ++i) {
+        expand_unit_quads(
+          glyphs.data(), GLYPH_RUN, vertices.data(), tex_coords.data());
+        microbench_escape(vertices.data());
+        microbench_escape(tex_coords.data());
+      }
+    } });
+
+  cases.push_back({ "unit_quads/build_80_indices",
+    (double)(indices.size() * sizeof(uint32_t)),
+    [](uint64_t iterations) {
+      for (uint64_t i = 0; i < iterations; ++i) {
+        build_unit_quad_indices(indices.data(), 0, GLYPH_RUN);
+        microbench_escape(indices.data());
+      }
+    } });
+}
+
+/// @brief the conversion upload_to_gpu does before glTexImage2D, on the
+/// calling thread alone (the jobs pool is never started here).
+static
+void
+add_mipmaps_case(
+  std::vector<microbench_t>& cases,
+  const char* name,
+  uint32_t components,
+  int32_t swizzle,
+  mipmaps_filter_t filter)
+{
+  auto pixels = std::make_shared<std::vector<uint8_t>>(
+    make_pixels(TEXTURE_SIZE, TEXTURE_SIZE, components));
+  auto chain = std::make_shared<mipmaps_chain_t>();
+  std::shared_ptr<std::vector<uint8_t>> levels;
+
+  mipmaps_layout(chain.get(), TEXTURE_SIZE, TEXTURE_SIZE, components);
+  levels = std::make_shared<std::vector<uint8_t>>(chain->size);
+  cases.push_back({ name, (double)(pixels->size() + chain->size),
+    [=](uint64_t iterations) {
+      for (uint64_t i = 0; i < iterations; ++i) {
+        mipmaps_generate(
+          chain.get(), pixels->data(), TEXTURE_SIZE, TEXTURE_SIZE,
+          components, swizzle, filter, 0, levels->data());
+        microbench_escape(levels->data());
+      }
+    } });
+}
+
+static
+void
+add_texture_cases(std::vector<microbench_t>& cases)
+{
+  static std::vector<uint8_t> npot;
+  static std::vector<uint8_t> resized;
+  static std::vector<uint8_t> rgba;
+  static std::vector<uint8_t> blocks;
+  static std::vector<uint8_t> decoded;
+
+  mipmaps_initialize();
+  add_mipmaps_case(
+    cases, "upload/mipmaps_rgba_256", 4, 0, MIPMAPS_FILTER_BOX);
+  add_mipmaps_case(
+    cases, "upload/mipmaps_bgra_swizzle_256", 4, 1, MIPMAPS_FILTER_BOX);
+  add_mipmaps_case(
+    cases, "upload/mipmaps_rgb_256", 3, 0, MIPMAPS_FILTER_BOX);
+  add_mipmaps_case(
+    cases, "upload/mipmaps_rgba_srgb_256", 4, 0, MIPMAPS_FILTER_SRGB_ALPHA);
+
+  // non power of 2 images are resized when the context requires it.
+  npot = make_pixels(NPOT_WIDTH, NPOT_HEIGHT, 3);
+  resized.resize((size_t)TEXTURE_SIZE * (TEXTURE_SIZE / 2) * 3);
+  cases.push_back({ "upload/resize_rgb_300x200",
+    (double)(npot.size() + resized.size()),
+    [](uint64_t iterations) {
+      for (uint64_t i = 0; i < iterations; ++i) {
+        mipmaps_resize(
+          npot.data(), NPOT_WIDTH, NPOT_HEIGHT, 3,
+          resized.data(), TEXTURE_SIZE, TEXTURE_SIZE / 2);
+        microbench_escape(resized.data());
+      }
+    } });
+
+  rgba = make_pixels(TEXTURE_SIZE, TEXTURE_SIZE, 4);
+  blocks.resize(
+    texture_compression_size(
+      TEXTURE_SIZE, TEXTURE_SIZE, RENDERER_OPENGL_BC1));
+  decoded.resize(rgba.size());
+  cases.push_back({ "upload/compress_bc1_256",
+    (double)(rgba.size() + blocks.size()),
+    [](uint64_t iterations) {
+      for (uint64_t i = 0; i < iterations; ++i) {
+        texture_compress(
+          rgba.data(), TEXTURE_SIZE, TEXTURE_SIZE, RENDERER_OPENGL_RGBA,
+          RENDERER_OPENGL_BC1, blocks.data());
+        microbench_escape(blocks.data());
+      }
+    } });
+
+  // level 0 only, what the fallback for contexts without S3TC decodes.
+  cases.push_back({ "upload/decompress_bc1_256",
+    (double)(TEXTURE_SIZE / 4 * TEXTURE_SIZE / 4 * 8 + decoded.size()),
+    [](uint64_t iterations) {
+      for (uint64_t i = 0; i < iterations; ++i) {
+        texture_decompress(
+          blocks.data(), TEXTURE_SIZE, TEXTURE_SIZE, RENDERER_OPENGL_BC1,
+          decoded.data());
+        microbench_escape(decoded.data());
+      }
+    } });
+}
+
+/// @brief what set_clustered_lights does per frame, the lights are scattered
+/// through the first 50 units of a 60 degrees frustum.
+static
+void
+add_light_clusters_case(
+  std::vector<microbench_t>& cases,
+  const char* name,
+  uint32_t count)
+{
+  auto lights = std::make_shared<std::vector<renderer_light_t>>(count);
+  uint32_t state = 0x9e3779b9u;
+
+  for (renderer_light_t& light : *lights) {
+    float values[3];
+    for (float& value : values) {
+      state = state * 1664525u + 1013904223u;
+      value = (float)(state >> 8) / 16777216.f;
+    }
+    light.type = RENDERER_LIGHT_TYPE_POINT;
+    light.position.data[0] = (values[0] - 0.5f) * 40.f;
+    light.position.data[1] = (values[1] - 0.5f) * 24.f;
+    light.position.data[2] = -1.f - values[2] * 50.f;
+    light.diffuse.data[0] = light.diffuse.data[1] = 1.f;
+    light.diffuse.data[2] = light.diffuse.data[3] = 1.f;
+    light.attenuation_constant = 1.f;
+    light.attenuation_quadratic = 40.f;
+  }
+
+  cases.push_back({ name,
+    (double)(
+      count * (sizeof(renderer_light_t) + sizeof(eye_light_t)) +
+      sizeof(light_clusters.records)),
+    [=](uint64_t iterations) {
+      reset_pipeline();
+      set_perspective(&pipeline, -0.1f, 0.1f, -0.0577f, 0.0577f, 0.1f, 100.f);
+      for (uint64_t i = 0; i < iterations; ++i) {
+        light_clusters_set(lights->data(), count, &pipeline);
+        microbench_escape(light_clusters.indices);
+      }
+      light_clusters_cleanup();
+    } });
+}
+
+std::vector<microbench_t>
+get_microbenchmarks()
+{
+  std::vector<microbench_t> cases;
+  add_pipeline_cases(cases);
+  add_unit_quads_cases(cases);
+  add_texture_cases(cases);
+  add_light_clusters_case(cases, "lights/cluster_256", 256);
+  add_light_clusters_case(cases, "lights/cluster_1024", 1024);
+  return cases;
+}
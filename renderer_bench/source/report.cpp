@@ -0,0 +1,113 @@
+/**
+ * @file report.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <report.h>
+
+
+double
+get_percentile(std::vector<double> values, double percentile)
+{
+  size_t rank;
+  if (values.empty())
+    return 0.0;
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  std::sort(values.begin(), values.end());
+  rank = (size_t)std::ceil(percentile / 100.0 * values.size());
+  return values[rank ? rank - 1 : 0];
+}
+
+void
+write_report(const report_t& report, FILE* file)
+{
+  const std::vector<double>& frames = report.frame_ms;
+  double sum = 0.0, mean = 0.0, seconds = report.total_seconds;
+  double frame_count = (double)frames.size();
+
+  for (double frame : frames)
+    sum += frame;
+  mean = frames.empty() ? 0.0 : sum / frame_count;
+  seconds = seconds > 0.0 ? seconds : 1e-9;
+
+  fprintf(file, "{\n");
+  fprintf(file, "  \"backend\": \"%s\",\n", report.backend);
+  fprintf(file, "  \"width\": %u,\n", report.width);
+  fprintf(file, "  \"height\": %u,\n", report.height);
+  fprintf(file, "  \"warmup_frames\": %u,\n", report.warmup);
+  fprintf(file, "  \"frames\": %zu,\n", frames.size());
+  fprintf(file, "  \"scene\": {\n");
+  fprintf(file, "    \"meshes\": %u,\n", report.scene.mesh_count);
+  fprintf(
+    file, "    \"triangles_per_mesh\": %u,\n", report.scene.mesh_triangles);
+  fprintf(file, "    \"glyphs\": %u,\n", report.scene.glyph_count);
+  fprintf(file, "    \"lines\": %u,\n", report.scene.line_count);
+  fprintf(file, "    \"textures\": %u,\n", report.scene.texture_count);
+  fprintf(file, "    \"lights\": %u,\n", report.scene.light_count);
+  fprintf(
+    file, "    \"instanced\": %s,\n",
+    report.scene.instanced ? "true" : "false");
+  fprintf(
+    file, "    \"clustered_lights\": %u,\n", report.scene.clustered_lights);
+  fprintf(file, "    \"seed\": %u\n", report.scene.seed);
+  fprintf(file, "  },\n");
+  fprintf(file, "  \"frame_time_ms\": {\n");
+  fprintf(file, "    \"mean\": %.4f,\n", mean);
+  fprintf(file, "    \"p50\": %.4f,\n", get_percentile(frames, 50.0));
+  fprintf(file, "    \"p95\": %.4f,\n", get_percentile(frames, 95.0));
+  fprintf(file, "    \"p99\": %.4f,\n", get_percentile(frames, 99.0));
+  fprintf(file, "    \"min\": %.4f,\n", get_percentile(frames, 0.0));
+  fprintf(file, "    \"max\": %.4f\n", get_percentile(frames, 100.0));
+  fprintf(file, "  },\n");
+  fprintf(file, "  \"frames_per_second\": %.2f,\n", frame_count / seconds);
+  // the draws are the measured ones, the software backend counts none.
+  if (report.has_renderer_stats) {
+    fprintf(
+      file, "  \"draws_per_frame\": %.2f,\n", report.renderer_draw_calls);
+    fprintf(
+      file, "  \"draws_per_second\": %.0f,\n",
+      report.renderer_draw_calls * frame_count / seconds);
+  } else {
+    fprintf(file, "  \"draws_per_frame\": null,\n");
+    fprintf(file, "  \"draws_per_second\": null,\n");
+  }
+  fprintf(
+    file, "  \"submitted_draws_per_frame\": %u,\n",
+    report.workload.submitted_draws);
+  fprintf(
+    file, "  \"triangles_per_frame\": %llu,\n",
+    (unsigned long long)report.workload.triangles);
+  fprintf(
+    file, "  \"triangles_per_second\": %.0f%s\n",
+    (double)report.workload.triangles * frame_count / seconds,
+    report.has_renderer_stats ? "," : "");
+
+  if (report.has_renderer_stats) {
+    fprintf(file, "  \"renderer\": {\n");
+    fprintf(
+      file, "    \"draw_calls_per_frame\": %.2f,\n",
+      report.renderer_draw_calls);
+    fprintf(
+      file, "    \"state_changes_per_frame\": %.2f,\n",
+      report.renderer_state_changes);
+    fprintf(
+      file, "    \"texture_binds_per_frame\": %.2f,\n",
+      report.renderer_texture_binds);
+    fprintf(file, "    \"gpu_time_ms\": {\n");
+    fprintf(file, "      \"p50\": %.4f,\n", report.gpu_ms[0]);
+    fprintf(file, "      \"p95\": %.4f,\n", report.gpu_ms[1]);
+    fprintf(file, "      \"p99\": %.4f\n", report.gpu_ms[2]);
+    fprintf(file, "    }\n");
+    fprintf(file, "  }\n");
+  }
+
+  fprintf(file, "}\n");
+}
@@ -0,0 +1,411 @@
+/**
+ * @file scene.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <renderer/debug_draw.h>
+#include <renderer/pipeline.h>
+#include <renderer/renderer_opengl.h>
+#include <scene.h>
+
+
+#define TEXTURE_SIZE              256
+#define GLYPHS_PER_RUN            80
+#define GLYPH_WIDTH               8.f
+#define GLYPH_HEIGHT              16.f
+#define MESH_SPACING              2.5f
+
+static const float pi = 3.14159265f;
+
+static scene_params_t params;
+static pipeline_t pipeline;
+static pipeline_t text_pipeline;
+static std::vector<renderer_vertex_t> vertices;
+static std::vector<uint32_t> indices;
+static std::vector<mesh_render_data_t> meshes;
+static std::vector<uint32_t> mesh_textures;
+static std::vector<matrix4f> instances;
+static std::vector<color_t> tints;
+static std::vector<uint32_t> textures;
+static std::vector<unit_quad_t> glyphs;
+static uint32_t glyph_texture;
+static std::vector<float> lines;
+static std::vector<color_t> line_colors;
+static std::vector<renderer_light_t> clustered_lights;
+static uint32_t grid_columns;
+static uint32_t text_rows;
+
+/// @brief xorshift32, the standard distributions differ between libraries.
+static
+float
+random_float(uint32_t& state)
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return (float)(state >> 8) / 16777216.f;
+}
+
+static
+color_t
+make_color(float r, float g, float b, float a)
+{
+  color_t color;
+  color.data[0] = r;
+  color.data[1] = g;
+  color.data[2] = b;
+  color.data[3] = a;
+  return color;
+}
+
+/// @brief a bumpy grid of exactly @a triangles triangles in [-1, 1], the
+/// last cell is cut in half for odd counts.
+static
+void
+build_mesh_geometry(uint32_t triangles)
+{
+  uint32_t cells = (triangles + 1) / 2;
+  uint32_t columns = (uint32_t)std::ceil(std::sqrt((double)cells));
+  uint32_t rows = (cells + columns - 1) / columns;
+
+  vertices.resize((size_t)(columns + 1) * (rows + 1));
+  for (uint32_t y = 0; y <= rows; ++y) {
+    for (uint32_t x = 0; x <= columns; ++x) {
+      renderer_vertex_t& vertex = vertices[(size_t)y * (columns + 1) + x];
+      float u = (float)x / columns, v = (float)y / rows;
+      float px = u * 2.f - 1.f, py = v * 2.f - 1.f;
+      float dx = 0.6f * std::cos(px * 6.f) * std::cos(py * 6.f);
+      float dy = -0.6f * std::sin(px * 6.f) * std::sin(py * 6.f);
+      float length = std::sqrt(dx * dx + dy * dy + 1.f);
+      vertex.position[0] = px;
+      vertex.position[1] = py;
+      vertex.position[2] = 0.1f * std::sin(px * 6.f) * std::cos(py * 6.f);
+      vertex.normal[0] = -dx / length;
+      vertex.normal[1] = -dy / length;
+      vertex.normal[2] = 1.f / length;
+      vertex.uv[0] = u;
+      vertex.uv[1] = v;
+    }
+  }
+
+  indices.clear();
+  indices.reserve((size_t)cells * 6);
+  for (uint32_t cell = 0; cell < cells; ++cell) {
+    uint32_t x = cell % columns, y = cell / columns;
+    uint32_t i0 = y * (columns + 1) + x, i1 = i0 + 1;
+    uint32_t i2 = i0 + columns + 1, i3 = i2 + 1;
+    uint32_t quad[6] = { i0, i1, i3, i0, i3, i2 };
+    indices.insert(indices.end(), quad, quad + 6);
+  }
+  indices.resize((size_t)triangles * 3);
+}
+
+/// @brief checkers of a random hue, or glyph like blobs on a 16x16 atlas.
+static
+uint32_t
+build_texture(uint32_t& state, int32_t atlas)
+{
+  std::vector<uint8_t> pixels((size_t)TEXTURE_SIZE * TEXTURE_SIZE * 4);
+  uint8_t r = (uint8_t)(64 + random_float(state) * 191);
+  uint8_t g = (uint8_t)(64 + random_float(state) * 191);
+  uint8_t b = (uint8_t)(64 + random_float(state) * 191);
+
+  for (uint32_t y = 0; y < TEXTURE_SIZE; ++y) {
+    for (uint32_t x = 0; x < TEXTURE_SIZE; ++x) {
+      uint8_t* pixel = &pixels[((size_t)y * TEXTURE_SIZE + x) * 4];
+      int32_t on = atlas ?
+        (x % 16) > 2 && (x % 16) < 13 && ((x ^ y) & 4) :
+        ((x / 32) + (y / 32)) & 1;
+      pixel[0] = on ? r : r / 4;
+      pixel[1] = on ? g : g / 4;
+      pixel[2] = on ? b : b / 4;
+      pixel[3] = 255;
+    }
+  }
+
+  return upload_to_gpu(
+    NULL, pixels.data(), TEXTURE_SIZE, TEXTURE_SIZE, RENDERER_OPENGL_RGBA);
+}
+
+/// @brief the instanced draws per frame, one per texture.
+static
+uint32_t
+get_instance_groups()
+{
+  uint32_t groups = std::max((uint32_t)textures.size(), 1u);
+  return std::min(groups, params.mesh_count);
+}
+
+void
+scene_initialize(
+  const scene_params_t& scene_params,
+  uint32_t width,
+  uint32_t height,
+  scene_workload_t& workload)
+{
+  uint32_t state = scene_params.seed ? scene_params.seed : 1;
+  float znear = 0.1f, zfar = 1000.f, aspect = (float)width / height;
+  float fh = std::tan(60.f / 2.f / 180.f * pi) * znear;
+  float fw = fh * aspect;
+
+  params = scene_params;
+  params.light_count =
+    std::min(params.light_count, (uint32_t)SCENE_MAX_LIGHTS);
+  params.mesh_triangles = std::max(params.mesh_triangles, 1u);
+
+  pipeline_set_default(&pipeline);
+  set_viewport(&pipeline, 0.f, 0.f, (float)width, (float)height);
+  update_viewport(&pipeline);
+  set_perspective(&pipeline, -fw, fw, -fh, fh, znear, zfar);
+  set_matrix_mode(&pipeline, MODELVIEW);
+  load_identity(&pipeline);
+
+  // text is laid out in pixels, origin at the bottom left.
+  pipeline_set_default(&text_pipeline);
+  set_viewport(&text_pipeline, 0.f, 0.f, (float)width, (float)height);
+  set_orthographic(
+    &text_pipeline, 0.f, (float)width, 0.f, (float)height, -1.f, 1.f);
+  set_matrix_mode(&text_pipeline, MODELVIEW);
+  load_identity(&text_pipeline);
+  text_rows = height > 24 ? (uint32_t)((height - 8) / GLYPH_HEIGHT) : 1;
+
+  for (uint32_t i = 0; i < params.texture_count; ++i)
+    textures.push_back(build_texture(state, 0));
+  if (params.glyph_count)
+    glyph_texture = build_texture(state, 1);
+
+  // one geometry shared by every mesh, the materials differ.
+  build_mesh_geometry(params.mesh_triangles);
+  for (uint32_t i = 0; i < params.mesh_count; ++i) {
+    mesh_render_data_t mesh = {};
+    color_t color = make_color(
+      random_float(state), random_float(state), random_float(state), 1.f);
+    mesh.interleaved = vertices.data();
+    mesh.vertex_count = (uint32_t)vertices.size();
+    mesh.indices = indices.data();
+    mesh.indices_count = (uint32_t)indices.size();
+    mesh.ambient = make_color(0.1f, 0.1f, 0.1f, 1.f);
+    mesh.diffuse = color;
+    mesh.specular = make_color(0.3f, 0.3f, 0.3f, 1.f);
+    meshes.push_back(mesh);
+    mesh_textures.push_back(
+      textures.empty() ? 0 : textures[i % textures.size()]);
+  }
+  grid_columns = (uint32_t)std::ceil(std::sqrt((double)params.mesh_count));
+
+  for (uint32_t i = 0; i < params.glyph_count; ++i) {
+    unit_quad_t glyph;
+    uint32_t cell = (uint32_t)(random_float(state) * 256.f) % 256;
+    glyph.data[0] = (float)(cell % 16) / 16.f;
+    glyph.data[1] = (float)(cell / 16 + 1) / 16.f;
+    glyph.data[2] = (float)(cell % 16 + 1) / 16.f;
+    glyph.data[3] = (float)(cell / 16) / 16.f;
+    glyph.data[4] = GLYPH_WIDTH;
+    glyph.data[5] = GLYPH_HEIGHT;
+    glyphs.push_back(glyph);
+  }
+
+  // segments spread over the volume the meshes occupy.
+  for (uint32_t i = 0; i < params.line_count; ++i) {
+    float extent = grid_columns * MESH_SPACING;
+    for (uint32_t j = 0; j < 6; ++j) {
+      float value = random_float(state);
+      lines.push_back(
+        j % 3 == 2 ? -extent * (0.5f + value) : (value - 0.5f) * extent);
+    }
+    line_colors.push_back(
+      make_color(random_float(state), random_float(state), 1.f, 1.f));
+  }
+
+  // small lights scattered in front of the mesh grid, each reaching about a
+  // mesh away.
+  for (uint32_t i = 0; i < params.clustered_lights; ++i) {
+    renderer_light_t light = {};
+    float extent = grid_columns * MESH_SPACING;
+    light.position.data[0] = (random_float(state) - 0.5f) * extent;
+    light.position.data[1] = (random_float(state) - 0.5f) * extent;
+    light.position.data[2] = -extent - 1.f - random_float(state) * 2.f;
+    light.direction.data[2] = -1.f;
+    light.diffuse = make_color(
+      random_float(state), random_float(state), random_float(state), 1.f);
+    light.specular = make_color(0.3f, 0.3f, 0.3f, 1.f);
+    light.ambient = make_color(0.02f, 0.02f, 0.02f, 1.f);
+    light.attenuation_constant = 1.f;
+    light.attenuation_quadratic = 40.f;
+    light.type = RENDERER_LIGHT_TYPE_POINT;
+    clustered_lights.push_back(light);
+  }
+
+  // the debug lines all share a width, debug_draw_flush submits them as one
+  // batch.
+  workload.submitted_draws =
+    (params.instanced ? get_instance_groups() : params.mesh_count) +
+    (params.glyph_count + GLYPHS_PER_RUN - 1) / GLYPHS_PER_RUN +
+    (params.line_count ? 1 : 0);
+  workload.triangles =
+    (uint64_t)params.mesh_count * params.mesh_triangles +
+    (uint64_t)params.glyph_count * 2;
+  workload.lines = params.line_count;
+}
+
+static
+void
+draw_lights(uint32_t frame)
+{
+  if (!clustered_lights.empty()) {
+    set_clustered_lights(
+      clustered_lights.data(), (uint32_t)clustered_lights.size(), &pipeline);
+    return;
+  }
+
+  for (uint32_t i = 0; i < SCENE_MAX_LIGHTS; ++i) {
+    renderer_light_t light = {};
+    float angle = frame * 0.01f + i * 2.f * pi / SCENE_MAX_LIGHTS;
+    if (i >= params.light_count) {
+      disable_light(i);
+      continue;
+    }
+
+    light.position.data[0] = std::cos(angle) * grid_columns * MESH_SPACING;
+    light.position.data[1] = std::sin(angle) * grid_columns;
+    light.position.data[2] = -grid_columns * MESH_SPACING * 0.5f;
+    light.direction.data[2] = -1.f;
+    light.diffuse = make_color(0.8f, 0.8f, 0.8f, 1.f);
+    light.specular = make_color(0.5f, 0.5f, 0.5f, 1.f);
+    light.ambient = make_color(0.05f, 0.05f, 0.05f, 1.f);
+    light.type = RENDERER_LIGHT_TYPE_POINT;
+    enable_light(i);
+    set_light_properties(i, &light, &pipeline);
+  }
+}
+
+/// @brief places mesh @a i of the grid on top of the modelview.
+static
+void
+transform_grid_mesh(uint32_t frame, uint32_t i)
+{
+  float offset = (grid_columns - 1) * MESH_SPACING * 0.5f;
+  float distance = grid_columns * MESH_SPACING + 2.f;
+  uint32_t x = i % grid_columns, y = i / grid_columns;
+  post_rotate_y(&pipeline, frame * 0.02f + i);
+  post_translate(
+    &pipeline, x * MESH_SPACING - offset, y * MESH_SPACING - offset,
+    -distance);
+}
+
+static
+void
+draw_mesh_grid(uint32_t frame)
+{
+  for (uint32_t i = 0; i < params.mesh_count; ++i) {
+    push_matrix(&pipeline);
+    transform_grid_mesh(frame, i);
+    draw_meshes(&meshes[i], &mesh_textures[i], 1, &pipeline);
+    pop_matrix(&pipeline);
+  }
+}
+
+/// @brief the same grid, the meshes sharing a texture are a single draw and
+/// their diffuse color becomes the instance tint.
+static
+void
+draw_mesh_grid_instanced(uint32_t frame)
+{
+  uint32_t groups = get_instance_groups();
+
+  for (uint32_t group = 0; group < groups; ++group) {
+    mesh_render_data_t mesh = meshes[group];
+    mesh.diffuse = make_color(1.f, 1.f, 1.f, 1.f);
+    instances.clear();
+    tints.clear();
+
+    // the modelview is the identity, the instance is the whole transform.
+    for (uint32_t i = group; i < params.mesh_count; i += groups) {
+      push_matrix(&pipeline);
+      load_identity(&pipeline);
+      transform_grid_mesh(frame, i);
+      instances.push_back(get_matrix(&pipeline));
+      tints.push_back(meshes[i].diffuse);
+      pop_matrix(&pipeline);
+    }
+
+    draw_meshes_instanced(
+      &mesh, mesh_textures[group], instances.data(), tints.data(),
+      (uint32_t)instances.size(), &pipeline);
+  }
+}
+
+static
+void
+draw_text()
+{
+  color_t white = make_color(1.f, 1.f, 1.f, 1.f);
+
+  update_projection(&text_pipeline);
+  for (uint32_t first = 0; first < glyphs.size(); first += GLYPHS_PER_RUN) {
+    uint32_t count =
+      std::min((uint32_t)glyphs.size() - first, (uint32_t)GLYPHS_PER_RUN);
+    push_matrix(&text_pipeline);
+    post_translate(
+      &text_pipeline,
+      4.f,
+      4.f + (first / GLYPHS_PER_RUN % text_rows) * GLYPH_HEIGHT,
+      0.f);
+    draw_unit_quads(
+      &glyphs[first], count, (int32_t)glyph_texture, white, &text_pipeline);
+    pop_matrix(&text_pipeline);
+  }
+}
+
+void
+scene_draw(uint32_t frame)
+{
+  clear_color_and_depth_buffers();
+  update_projection(&pipeline);
+  enable_depth_test();
+
+  draw_lights(frame);
+  if (params.instanced)
+    draw_mesh_grid_instanced(frame);
+  else
+    draw_mesh_grid(frame);
+
+  for (uint32_t i = 0; i < params.line_count; ++i)
+    debug_draw_lines(&lines[i * 6], 2, line_colors[i], 1.f, &pipeline);
+  debug_draw_flush();
+
+  if (!glyphs.empty())
+    draw_text();
+
+  flush_operations();
+}
+
+void
+scene_cleanup()
+{
+  for (uint32_t texture : textures)
+    evict_from_gpu(texture);
+  if (glyph_texture)
+    evict_from_gpu(glyph_texture);
+
+  textures.clear();
+  glyph_texture = 0;
+  vertices.clear();
+  indices.clear();
+  meshes.clear();
+  mesh_textures.clear();
+  instances.clear();
+  tints.clear();
+  glyphs.clear();
+  clustered_lights.clear();
+  lines.clear();
+  line_colors.clear();
+}
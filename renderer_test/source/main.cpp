@@ -93,7 +93,12 @@ WinMain(
 
 	g_hWindowDC = GetDC(g_hWnd);
 
-  opengl_initialize((opengl_parameters_t *)&g_hWindowDC);
+  if (!opengl_initialize((opengl_parameters_t *)&g_hWindowDC)) {
+    ReleaseDC(g_hWnd, g_hWindowDC);
+    DestroyWindow(g_hWnd);
+    return 1;
+  }
+
   app_initialize(client_width, client_height);
 
 	MSG msg;
@@ -0,0 +1,70 @@
+/**
+ * @file unittest.h
+ * @author khalilhenoud@gmail.com
+ * @brief behavior tests of the cpu side modules of the renderer, no opengl
+ * context or library involved.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#ifndef UNITTEST_H
+#define UNITTEST_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+struct unittest_t {
+  const char* name;
+  std::function<void()> run;
+};
+
+/// @brief records a failed check of the running test, the test goes on.
+void
+unittest_fail(const char* file, int line, const char* expression);
+
+#define CHECK(expression)                                                     \
+  do {                                                                        \
+    if (!(expression))                                                        \
+      unittest_fail(__FILE__, __LINE__, #expression);                         \
+  } while (0)
+
+/// @brief one per source file, each appends its tests in report order.
+void
+add_command_list_tests(std::vector<unittest_t>& tests);
+
+void
+add_culling_tests(std::vector<unittest_t>& tests);
+
+void
+add_jobs_tests(std::vector<unittest_t>& tests);
+
+void
+add_light_clusters_tests(std::vector<unittest_t>& tests);
+
+void
+add_mipmaps_tests(std::vector<unittest_t>& tests);
+
+void
+add_pipeline_tests(std::vector<unittest_t>& tests);
+
+void
+add_render_queue_tests(std::vector<unittest_t>& tests);
+
+void
+add_software_raster_tests(std::vector<unittest_t>& tests);
+
+/// @brief not built on windows, see CMakeLists.txt.
+void
+add_state_cache_tests(std::vector<unittest_t>& tests);
+
+void
+add_texture_cache_tests(std::vector<unittest_t>& tests);
+
+void
+add_texture_compression_tests(std::vector<unittest_t>& tests);
+
+#endif
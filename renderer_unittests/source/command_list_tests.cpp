@@ -0,0 +1,281 @@
+/**
+ * @file command_list_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief the renderer entry points the replay calls are replaced by stubs
+ * that record what reached them.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstring>
+#include <string>
+#include <renderer/command_list.h>
+#include <unittest.h>
+
+
+struct replayed_t {
+  std::string name;
+  uint32_t count = 0;
+  uint32_t index = 0;       // light index or texture id.
+  float value = 0.f;        // line width or point size.
+  float first = 0.f;        // first float of the array, or of the light.
+  color_t color = {};
+  int32_t has_matrix = 0;
+  matrix4f matrix = {};
+};
+
+static std::vector<replayed_t> replayed;
+// the pipelines are too large for the stack.
+static pipeline_t pipeline;
+
+static
+replayed_t&
+add_replayed(const char* name, uint32_t count, const pipeline_t* pipeline)
+{
+  replayed_t call;
+  call.name = name;
+  call.count = count;
+  call.has_matrix = pipeline != nullptr;
+  if (pipeline)
+    call.matrix = pipeline->modelview_stack[pipeline->modelview_index];
+  replayed.push_back(call);
+  return replayed.back();
+}
+
+extern "C" {
+
+void
+draw_meshes(
+  const mesh_render_data_t* mesh,
+  const uint32_t* texture_data,
+  uint32_t mesh_count,
+  pipeline_t* pipeline)
+{
+  replayed_t& call = add_replayed("draw_meshes", mesh_count, pipeline);
+  call.index = texture_data[mesh_count - 1];
+  call.first = (float)mesh[mesh_count - 1].vertex_count;
+}
+
+void
+draw_lines(
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float width,
+  pipeline_t* pipeline)
+{
+  replayed_t& call = add_replayed("draw_lines", vertices_count, pipeline);
+  call.value = width;
+  call.color = color;
+  call.first = vertices[0];
+}
+
+void
+draw_points(
+  const float* vertices,
+  uint32_t vertices_count,
+  color_t color,
+  float size,
+  pipeline_t* pipeline)
+{
+  replayed_t& call = add_replayed("draw_points", vertices_count, pipeline);
+  call.value = size;
+  call.color = color;
+  call.first = vertices[0];
+}
+
+void
+draw_unit_quads(
+  const unit_quad_t* uvs,
+  uint32_t uvs_count,
+  int32_t texture_id,
+  color_t tint,
+  pipeline_t* pipeline)
+{
+  replayed_t& call = add_replayed("draw_unit_quads", uvs_count, pipeline);
+  call.index = (uint32_t)texture_id;
+  call.color = tint;
+  call.first = uvs[0].data[0];
+}
+
+void
+set_light_properties(
+  uint32_t index,
+  renderer_light_t* light,
+  pipeline_t* pipeline)
+{
+  replayed_t& call = add_replayed("set_light_properties", 1, pipeline);
+  call.index = index;
+  call.first = light->position.data[0];
+}
+
+void
+enable_light(uint32_t index)
+{
+  add_replayed("enable_light", 0, nullptr).index = index;
+}
+
+void
+disable_light(uint32_t index)
+{
+  add_replayed("disable_light", 0, nullptr).index = index;
+}
+
+}
+
+static
+void
+reset_pipeline()
+{
+  pipeline_set_default(&pipeline);
+  set_matrix_mode(&pipeline, MODELVIEW);
+  load_identity(&pipeline);
+}
+
+static
+int32_t
+same_matrix(const matrix4f& a, const matrix4f& b)
+{
+  return !memcmp(&a, &b, sizeof(matrix4f));
+}
+
+static
+void
+test_replay_in_recording_order()
+{
+  command_list_t list;
+  float vertices[6] = { 1.f, 2.f, 3.f, 4.f, 5.f, 6.f };
+  float points[3] = { -7.f, 0.f, 0.f };
+  unit_quad_t quads[2] = { { { 0.25f } }, { { 0.5f } } };
+  color_t red = { { 1.f, 0.f, 0.f, 1.f } };
+  renderer_light_t light = {};
+  mesh_render_data_t mesh[2] = {};
+  uint32_t textures[2] = { 11, 12 };
+  matrix4f identity, translated;
+
+  mesh[1].vertex_count = 36;
+  light.position.data[0] = 9.f;
+  reset_pipeline();
+  command_list_initialize(&list, 0);
+
+  command_list_set_light_properties(&list, 2, &light, &pipeline);
+  command_list_enable_light(&list, 2);
+  command_list_draw_meshes(&list, mesh, textures, 2, &pipeline);
+  identity = pipeline.modelview_stack[pipeline.modelview_index];
+  post_translate(&pipeline, 0.f, 0.f, -5.f);
+  translated = pipeline.modelview_stack[pipeline.modelview_index];
+  command_list_draw_lines(&list, vertices, 2, red, 3.f, &pipeline);
+  command_list_draw_points(&list, points, 1, red, 4.f, nullptr);
+  command_list_draw_unit_quads(&list, quads, 2, 5, red, &pipeline);
+  command_list_disable_light(&list, 2);
+  CHECK(list.count == 7);
+
+  // the recorded arrays are copies.
+  vertices[0] = 0.f;
+  textures[1] = 0;
+  mesh[1].vertex_count = 0;
+  replayed.clear();
+  command_list_replay(&list, 1);
+
+  CHECK(replayed.size() == 7);
+  if (replayed.size() != 7) {
+    command_list_cleanup(&list);
+    return;
+  }
+
+  CHECK(replayed[0].name == "set_light_properties");
+  CHECK(replayed[0].index == 2 && replayed[0].first == 9.f);
+  CHECK(replayed[1].name == "enable_light" && replayed[1].index == 2);
+  CHECK(replayed[2].name == "draw_meshes" && replayed[2].count == 2);
+  CHECK(replayed[2].index == 12 && replayed[2].first == 36.f);
+  CHECK(replayed[3].name == "draw_lines" && replayed[3].count == 2);
+  CHECK(replayed[3].value == 3.f && replayed[3].first == 1.f);
+  CHECK(replayed[3].color.data[0] == 1.f && replayed[3].color.data[1] == 0.f);
+  CHECK(replayed[4].name == "draw_points" && replayed[4].count == 1);
+  CHECK(replayed[4].value == 4.f && replayed[4].first == -7.f);
+  CHECK(replayed[5].name == "draw_unit_quads" && replayed[5].count == 2);
+  CHECK(replayed[5].index == 5 && replayed[5].first == 0.25f);
+  CHECK(replayed[6].name == "disable_light" && replayed[6].index == 2);
+
+  // the matrix of each command is the modelview top when it was recorded.
+  CHECK(replayed[2].has_matrix);
+  CHECK(same_matrix(replayed[2].matrix, identity));
+  CHECK(replayed[3].has_matrix);
+  CHECK(same_matrix(replayed[3].matrix, translated));
+  CHECK(!replayed[4].has_matrix);
+  CHECK(same_matrix(replayed[5].matrix, translated));
+  command_list_cleanup(&list);
+}
+
+static
+void
+test_lists_replay_in_array_order()
+{
+  command_list_t lists[3];
+  reset_pipeline();
+
+  for (uint32_t i = 0; i < 3; ++i)
+    command_list_initialize(lists + i, 64);
+  // recorded out of order, the replay follows the array.
+  command_list_enable_light(lists + 2, 7);
+  command_list_enable_light(lists + 0, 1);
+  command_list_disable_light(lists + 2, 8);
+  command_list_enable_light(lists + 1, 4);
+
+  replayed.clear();
+  command_list_replay(lists, 3);
+  CHECK(replayed.size() == 4);
+  if (replayed.size() == 4) {
+    CHECK(replayed[0].index == 1);
+    CHECK(replayed[1].index == 4);
+    CHECK(replayed[2].index == 7 && replayed[2].name == "enable_light");
+    CHECK(replayed[3].index == 8 && replayed[3].name == "disable_light");
+  }
+
+  // cleared lists replay nothing and keep their memory.
+  command_list_clear(lists + 2);
+  CHECK(lists[2].count == 0 && lists[2].size == 0 && lists[2].capacity);
+  replayed.clear();
+  command_list_replay(lists + 2, 1);
+  CHECK(replayed.empty());
+
+  for (uint32_t i = 0; i < 3; ++i)
+    command_list_cleanup(lists + i);
+}
+
+static
+void
+test_list_grows()
+{
+  command_list_t list;
+  std::vector<float> vertices((size_t)3 * 1000, 1.f);
+  color_t white = { { 1.f, 1.f, 1.f, 1.f } };
+  reset_pipeline();
+
+  // each command is larger than the initial capacity.
+  command_list_initialize(&list, 16);
+  for (uint32_t i = 0; i < 10; ++i) {
+    vertices[0] = (float)i;
+    command_list_draw_lines(
+      &list, vertices.data(), 1000, white, 1.f, &pipeline);
+  }
+
+  replayed.clear();
+  command_list_replay(&list, 1);
+  CHECK(replayed.size() == 10);
+  for (uint32_t i = 0; i < replayed.size(); ++i)
+    CHECK(replayed[i].count == 1000 && replayed[i].first == (float)i);
+  command_list_cleanup(&list);
+}
+
+void
+add_command_list_tests(std::vector<unittest_t>& tests)
+{
+  tests.push_back({ "command_list/replay_in_recording_order",
+    test_replay_in_recording_order });
+  tests.push_back({ "command_list/lists_replay_in_array_order",
+    test_lists_replay_in_array_order });
+  tests.push_back({ "command_list/list_grows", test_list_grows });
+}
@@ -0,0 +1,171 @@
+/**
+ * @file culling_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <renderer/culling.h>
+#include <unittest.h>
+
+
+// the pipelines are too large for the stack.
+static pipeline_t pipeline;
+
+static
+renderer_bounds_t
+make_box(float x, float y, float z, float half)
+{
+  return { { x - half, y - half, z - half }, { x + half, y + half, z + half } };
+}
+
+/// @brief a 90 degrees frustum from 1 to 100 looking down -z.
+static
+void
+reset_pipeline(projection_mode_t mode)
+{
+  pipeline_set_default(&pipeline);
+  set_matrix_mode(&pipeline, MODELVIEW);
+  load_identity(&pipeline);
+  if (mode == PERSPECTIVE)
+    set_perspective(&pipeline, -1.f, 1.f, -1.f, 1.f, 1.f, 100.f);
+  else
+    set_orthographic(&pipeline, -10.f, 10.f, -10.f, 10.f, 1.f, 100.f);
+}
+
+/// @brief the known boxes are repeated so both the blocks of the simd path
+/// and the remainder see every case.
+static
+void
+check_known_boxes(
+  const std::vector<renderer_bounds_t>& known,
+  const std::vector<int32_t>& inside)
+{
+  std::vector<renderer_bounds_t> bounds;
+  std::vector<uint32_t> visible;
+  std::vector<uint32_t> expected;
+
+  for (uint32_t copy = 0; copy < 5; ++copy) {
+    for (uint32_t i = 0; i < known.size(); ++i) {
+      if (inside[i])
+        expected.push_back((uint32_t)bounds.size());
+      bounds.push_back(known[i]);
+    }
+  }
+
+  visible.resize(bounds.size());
+  visible.resize(
+    cull_bounds(
+      bounds.data(), (uint32_t)bounds.size(), &pipeline, visible.data()));
+  CHECK(visible == expected);
+}
+
+static
+void
+test_perspective_boxes()
+{
+  reset_pipeline(PERSPECTIVE);
+  check_known_boxes(
+    {
+      make_box(0.f, 0.f, -10.f, 1.f),       // centered.
+      make_box(0.f, 0.f, 5.f, 1.f),         // behind the camera.
+      make_box(-30.f, 0.f, -10.f, 1.f),     // left.
+      make_box(30.f, 0.f, -10.f, 1.f),      // right.
+      make_box(0.f, 30.f, -10.f, 1.f),      // above.
+      make_box(0.f, -30.f, -10.f, 1.f),     // below.
+      make_box(0.f, 0.f, -150.f, 1.f),      // past the far plane.
+      make_box(-10.5f, 0.f, -10.f, 1.f),    // straddles the left plane.
+      make_box(0.f, 0.f, -100.5f, 1.f),     // straddles the far plane.
+      make_box(0.f, 0.f, 0.f, 0.25f),       // in front of the near plane.
+      make_box(0.f, 0.f, -1.f, 0.25f),      // straddles the near plane.
+    },
+    { 1, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1 });
+}
+
+static
+void
+test_orthographic_boxes()
+{
+  reset_pipeline(ORTHOGRAPHIC);
+  check_known_boxes(
+    {
+      make_box(0.f, 0.f, -50.f, 1.f),
+      make_box(9.5f, 9.5f, -50.f, 1.f),     // in the corner.
+      make_box(12.f, 0.f, -50.f, 1.f),
+      make_box(0.f, -12.f, -50.f, 1.f),
+      // out of a perspective frustum, the sides of this one are parallel.
+      make_box(9.f, 0.f, -2.f, 0.5f),
+    },
+    { 1, 1, 0, 0, 1 });
+}
+
+static
+void
+test_boxes_follow_modelview()
+{
+  reset_pipeline(PERSPECTIVE);
+
+  // the boxes are in object space, the modelview places them in front.
+  post_translate(&pipeline, 0.f, 0.f, -20.f);
+  check_known_boxes(
+    {
+      make_box(0.f, 0.f, 0.f, 1.f),
+      make_box(0.f, 0.f, 30.f, 1.f),
+      make_box(0.f, 0.f, -90.f, 1.f),
+    },
+    { 1, 0, 0 });
+
+  // a pushed matrix is the one tested.
+  push_matrix(&pipeline);
+  post_translate(&pipeline, 0.f, 0.f, 25.f);
+  check_known_boxes(
+    {
+      make_box(0.f, 0.f, 0.f, 1.f),
+      make_box(0.f, 0.f, -10.f, 1.f),
+    },
+    { 0, 1 });
+}
+
+static
+void
+test_mesh_bounds()
+{
+  float vertices[] = {
+    1.f, 2.f, 3.f,
+    -4.f, 5.f, 0.f,
+    2.f, -1.f, 8.f };
+  renderer_vertex_t interleaved[2] = {
+    { { 0.f, 0.f, -1.f }, { 0.f, 0.f, 1.f }, { 0.f, 0.f } },
+    { { 3.f, -2.f, 1.f }, { 0.f, 0.f, 1.f }, { 1.f, 1.f } } };
+  mesh_render_data_t mesh[3] = {};
+  renderer_bounds_t bounds[3];
+
+  mesh[0].vertices = vertices;
+  mesh[0].vertex_count = 3;
+  mesh[1].interleaved = interleaved;
+  mesh[1].vertex_count = 2;
+  compute_mesh_bounds(mesh, 3, bounds);
+
+  CHECK(bounds[0].min[0] == -4.f && bounds[0].max[0] == 2.f);
+  CHECK(bounds[0].min[1] == -1.f && bounds[0].max[1] == 5.f);
+  CHECK(bounds[0].min[2] == 0.f && bounds[0].max[2] == 8.f);
+  CHECK(bounds[1].min[0] == 0.f && bounds[1].max[0] == 3.f);
+  CHECK(bounds[1].min[1] == -2.f && bounds[1].max[1] == 0.f);
+  CHECK(bounds[1].min[2] == -1.f && bounds[1].max[2] == 1.f);
+  // empty meshes get a degenerate box at the origin.
+  for (uint32_t j = 0; j < 3; ++j)
+    CHECK(bounds[2].min[j] == 0.f && bounds[2].max[j] == 0.f);
+}
+
+void
+add_culling_tests(std::vector<unittest_t>& tests)
+{
+  tests.push_back({ "culling/perspective_boxes", test_perspective_boxes });
+  tests.push_back({ "culling/orthographic_boxes", test_orthographic_boxes });
+  tests.push_back({ "culling/boxes_follow_modelview",
+    test_boxes_follow_modelview });
+  tests.push_back({ "culling/mesh_bounds", test_mesh_bounds });
+}
@@ -0,0 +1,84 @@
+/**
+ * @file jobs_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <atomic>
+#include <thread>
+#include <renderer/internal/jobs.h>
+#include <unittest.h>
+
+
+#define JOBS_THREADS              4
+
+struct loop_t {
+  std::vector<std::atomic<uint32_t>> calls;
+  std::thread::id caller;
+  std::atomic<uint32_t> foreign;    // calls made on another thread.
+};
+
+static
+void
+count_call(void* data, uint32_t index)
+{
+  loop_t* loop = (loop_t*)data;
+  ++loop->calls[index];
+  if (std::this_thread::get_id() != loop->caller)
+    ++loop->foreign;
+}
+
+/// @brief runs a loop of @a count indices, checks each was called once.
+static
+uint32_t
+run_loop(uint32_t count)
+{
+  loop_t loop;
+  loop.calls = std::vector<std::atomic<uint32_t>>(count);
+  loop.caller = std::this_thread::get_id();
+  loop.foreign = 0;
+
+  jobs_parallel_for(count, count_call, &loop);
+  for (uint32_t i = 0; i < count; ++i)
+    CHECK(loop.calls[i] == 1);
+  return loop.foreign;
+}
+
+static
+void
+test_calling_thread_before_initialize()
+{
+  CHECK(jobs_thread_count() == 1);
+  CHECK(run_loop(1000) == 0);
+}
+
+static
+void
+test_every_index_once()
+{
+  uint32_t sizes[] = { 0, 1, 2, 3, JOBS_THREADS, 7, 1000, 100000 };
+
+  jobs_initialize(JOBS_THREADS);
+  CHECK(jobs_thread_count() == JOBS_THREADS);
+  // back to back loops reuse the same workers.
+  for (uint32_t repeat = 0; repeat < 20; ++repeat) {
+    for (uint32_t size : sizes)
+      run_loop(size);
+  }
+  jobs_cleanup();
+
+  CHECK(jobs_thread_count() == 1);
+  CHECK(run_loop(100) == 0);
+}
+
+void
+add_jobs_tests(std::vector<unittest_t>& tests)
+{
+  tests.push_back({ "jobs/calling_thread_before_initialize",
+    test_calling_thread_before_initialize });
+  tests.push_back({ "jobs/every_index_once", test_every_index_once });
+}
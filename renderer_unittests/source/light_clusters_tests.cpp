@@ -0,0 +1,190 @@
+/**
+ * @file light_clusters_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cmath>
+#include <renderer/internal/light_clusters.h>
+#include <unittest.h>
+
+
+// the pipelines are too large for the stack.
+static pipeline_t pipeline;
+
+/// @brief a 90 degrees frustum from 1 to 100, the slices are 1 to 100 ^ (i /
+/// LIGHT_CLUSTERS_Z) deep.
+static
+void
+reset_pipeline()
+{
+  pipeline_set_default(&pipeline);
+  set_matrix_mode(&pipeline, MODELVIEW);
+  load_identity(&pipeline);
+  set_perspective(&pipeline, -1.f, 1.f, -1.f, 1.f, 1.f, 100.f);
+}
+
+/// @brief white, reaches sqrt(255) (about 16) units with a quadratic falloff.
+static
+renderer_light_t
+make_point_light(float x, float y, float z)
+{
+  renderer_light_t light = {};
+  light.type = RENDERER_LIGHT_TYPE_POINT;
+  light.position.data[0] = x;
+  light.position.data[1] = y;
+  light.position.data[2] = z;
+  light.diffuse.data[0] = light.diffuse.data[1] = 1.f;
+  light.diffuse.data[2] = light.diffuse.data[3] = 1.f;
+  light.attenuation_constant = 1.f;
+  light.attenuation_quadratic = 1.f;
+  return light;
+}
+
+static
+uint32_t
+get_cluster(uint32_t x, uint32_t y, uint32_t z)
+{
+  return (z * LIGHT_CLUSTERS_Y + y) * LIGHT_CLUSTERS_X + x;
+}
+
+static
+int32_t
+cluster_has_light(uint32_t cluster, uint32_t light)
+{
+  const uint32_t* record = light_clusters.records[cluster];
+  for (uint32_t i = 0; i < record[1]; ++i) {
+    if (light_clusters.indices[record[0] + i] == light)
+      return 1;
+  }
+  return 0;
+}
+
+static
+void
+test_find_known_points()
+{
+  renderer_light_t light = make_point_light(0.f, 0.f, -10.f);
+  float center_near[3] = { 0.f, 0.f, -1.f };
+  float bottom_left_far[3] = { -98.f, -98.f, -99.f };
+  float top_right[3] = { 9.9f, 9.9f, -10.5f };
+  float outside[3] = { -5000.f, 5000.f, -1000.f };
+  float behind[3] = { 0.f, 0.f, 5.f };
+  // the middle of slice 12 (which starts 10 units deep) and of tile (12, 6).
+  float depth = 10.f * powf(100.f, 0.5f / LIGHT_CLUSTERS_Z);
+  float inside[3] = {
+    depth * (-1.f + 2.f * 12.5f / LIGHT_CLUSTERS_X),
+    depth * (-1.f + 2.f * 6.5f / LIGHT_CLUSTERS_Y),
+    -depth };
+
+  reset_pipeline();
+  light_clusters_set(&light, 1, &pipeline);
+
+  CHECK(light_clusters_find(center_near) == get_cluster(8, 4, 0));
+  CHECK(
+    light_clusters_find(bottom_left_far) ==
+    get_cluster(0, 0, LIGHT_CLUSTERS_Z - 1));
+  CHECK(
+    light_clusters_find(top_right) ==
+    get_cluster(LIGHT_CLUSTERS_X - 1, LIGHT_CLUSTERS_Y - 1, 12));
+  CHECK(light_clusters_find(inside) == get_cluster(12, 6, 12));
+  // clamped to the grid.
+  CHECK(
+    light_clusters_find(outside) ==
+    get_cluster(0, LIGHT_CLUSTERS_Y - 1, LIGHT_CLUSTERS_Z - 1));
+  CHECK(light_clusters_find(behind) == get_cluster(8, 4, 0));
+  light_clusters_cleanup();
+}
+
+static
+void
+test_lights_binned_where_they_reach()
+{
+  renderer_light_t lights[2] = {
+    make_point_light(2.f, 1.f, -10.f), make_point_light(-60.f, 0.f, -70.f) };
+  float at_first[3] = { 2.f, 1.f, -10.f };
+  float at_second[3] = { -60.f, 0.f, -70.f };
+  float far_right[3] = { 80.f, 0.f, -90.f };
+  uint32_t cluster_first, cluster_second, cluster_far;
+  uint32_t version = light_clusters.version;
+
+  reset_pipeline();
+  light_clusters_set(lights, 2, &pipeline);
+  cluster_first = light_clusters_find(at_first);
+  cluster_second = light_clusters_find(at_second);
+  cluster_far = light_clusters_find(far_right);
+
+  CHECK(light_clusters.version == version + 1);
+  CHECK(light_clusters.light_count == 2);
+  CHECK(cluster_has_light(cluster_first, 0));
+  CHECK(!cluster_has_light(cluster_first, 1));
+  CHECK(cluster_has_light(cluster_second, 1));
+  CHECK(!cluster_has_light(cluster_second, 0));
+  CHECK(light_clusters.records[cluster_far][1] == 0);
+
+  // the lights are taken under the modelview top, both move 200 units away.
+  post_translate(&pipeline, 0.f, 0.f, -200.f);
+  light_clusters_set(lights, 2, &pipeline);
+  CHECK(light_clusters.index_count == 0);
+  light_clusters_cleanup();
+}
+
+static
+void
+test_directional_light_everywhere()
+{
+  renderer_light_t lights[2] = {
+    make_point_light(0.f, 0.f, -5.f), make_point_light(0.f, 0.f, 0.f) };
+  lights[1].type = RENDERER_LIGHT_TYPE_DIRECTIONAL;
+  lights[1].direction.data[2] = -1.f;
+
+  reset_pipeline();
+  light_clusters_set(lights, 2, &pipeline);
+  for (uint32_t i = 0; i < LIGHT_CLUSTERS_COUNT; ++i)
+    CHECK(cluster_has_light(i, 1));
+  light_clusters_cleanup();
+}
+
+static
+void
+test_strongest_first()
+{
+  renderer_light_t lights[3] = {
+    make_point_light(0.f, 0.f, -14.f),
+    make_point_light(0.f, 0.f, -11.f),
+    make_point_light(0.f, 0.f, -60.f) };
+  float eye[3] = { 0.f, 0.f, -10.f };
+  uint32_t selected[8];
+
+  reset_pipeline();
+  light_clusters_set(lights, 3, &pipeline);
+
+  // the third light is out of reach.
+  CHECK(light_clusters_strongest(eye, 8, selected) == 2);
+  CHECK(selected[0] == 1);
+  CHECK(selected[1] == 0);
+  CHECK(light_clusters_strongest(eye, 1, selected) == 1);
+  CHECK(selected[0] == 1);
+
+  // no lights, nothing selected.
+  light_clusters_set(nullptr, 0, &pipeline);
+  CHECK(light_clusters_strongest(eye, 8, selected) == 0);
+  light_clusters_cleanup();
+}
+
+void
+add_light_clusters_tests(std::vector<unittest_t>& tests)
+{
+  tests.push_back({ "light_clusters/find_known_points",
+    test_find_known_points });
+  tests.push_back({ "light_clusters/lights_binned_where_they_reach",
+    test_lights_binned_where_they_reach });
+  tests.push_back({ "light_clusters/directional_light_everywhere",
+    test_directional_light_everywhere });
+  tests.push_back({ "light_clusters/strongest_first",
+    test_strongest_first });
+}
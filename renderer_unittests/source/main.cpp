@@ -0,0 +1,79 @@
+/**
+ * @file main.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief runs the tests of every module and reports the failed checks, the
+ * exit code is 1 when any of them failed.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstdio>
+#include <cstring>
+#include <unittest.h>
+
+
+static uint32_t failed_checks = 0;
+
+void
+unittest_fail(const char* file, int line, const char* expression)
+{
+  ++failed_checks;
+  printf("  %s:%d: CHECK(%s)\n", file, line, expression);
+}
+
+static
+void
+print_usage(FILE* file)
+{
+  fprintf(
+    file,
+    "usage: renderer_unittests [options]\n"
+    "  --filter text            runs the tests whose name contains text\n");
+}
+
+int
+main(int argc, char** argv)
+{
+  const char* filter = nullptr;
+  std::vector<unittest_t> tests;
+  uint32_t failed = 0, ran = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+      filter = argv[++i];
+    } else {
+      print_usage(stderr);
+      return 1;
+    }
+  }
+
+  add_command_list_tests(tests);
+  add_culling_tests(tests);
+  add_jobs_tests(tests);
+  add_light_clusters_tests(tests);
+  add_mipmaps_tests(tests);
+  add_pipeline_tests(tests);
+  add_render_queue_tests(tests);
+  add_software_raster_tests(tests);
+#if !defined(_WIN32)
+  add_state_cache_tests(tests);
+#endif
+  add_texture_cache_tests(tests);
+  add_texture_compression_tests(tests);
+
+  for (const unittest_t& test : tests) {
+    uint32_t before = failed_checks;
+    if (filter && !strstr(test.name, filter))
+      continue;
+
+    test.run();
+    ++ran;
+    failed += failed_checks != before;
+    printf("%-48s %s\n", test.name, failed_checks != before ? "FAIL" : "ok");
+  }
+
+  printf("%u/%u test(s) passed\n", ran - failed, ran);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+/**
+ * @file mipmaps_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstdlib>
+#include <cstring>
+#include <renderer/internal/mipmaps.h>
+#include <unittest.h>
+
+
+static
+std::vector<uint8_t>
+make_pixels(uint32_t width, uint32_t height, uint32_t components)
+{
+  std::vector<uint8_t> pixels((size_t)width * height * components);
+  uint32_t state = 0x9e3779b9u;
+  for (uint8_t& pixel : pixels) {
+    state = state * 1664525u + 1013904223u;
+    pixel = (uint8_t)(state >> 24);
+  }
+  return pixels;
+}
+
+/// @brief the plain per byte box filter, what the sse2 path must reproduce.
+static
+std::vector<uint8_t>
+downsample_reference(
+  const std::vector<uint8_t>& source,
+  uint32_t width,
+  uint32_t height,
+  uint32_t components)
+{
+  uint32_t target_width = width > 1 ? width / 2 : 1;
+  uint32_t target_height = height > 1 ? height / 2 : 1;
+  uint32_t step_x = width > 1 ? 1 : 0, step_y = height > 1 ? 1 : 0;
+  std::vector<uint8_t> target(
+    (size_t)target_width * target_height * components);
+
+  for (uint32_t y = 0; y < target_height; ++y) {
+    for (uint32_t x = 0; x < target_width; ++x) {
+      for (uint32_t c = 0; c < components; ++c) {
+        uint32_t sum = 0;
+        for (uint32_t j = 0; j < 2; ++j) {
+          for (uint32_t i = 0; i < 2; ++i) {
+            size_t sx = (size_t)x * 2 * step_x + i * step_x;
+            size_t sy = (size_t)y * 2 * step_y + j * step_y;
+            sum += source[(sy * width + sx) * components + c];
+          }
+        }
+        target[((size_t)y * target_width + x) * components + c] =
+          (uint8_t)((sum + 2) >> 2);
+      }
+    }
+  }
+
+  return target;
+}
+
+static
+void
+test_box_matches_reference()
+{
+  // the sse2 path takes 1, 2 and 4 components 8 target bytes at a time, the
+  // odd widths leave a scalar remainder and 1 wide levels skip it.
+  uint32_t sizes[][2] = {
+    { 64, 64 }, { 37, 21 }, { 18, 6 }, { 1, 16 }, { 16, 1 }, { 2, 2 } };
+
+  for (uint32_t components = 1; components <= 4; ++components) {
+    for (const auto& size : sizes) {
+      uint32_t width = size[0], height = size[1];
+      uint32_t target_height = height > 1 ? height / 2 : 1;
+      std::vector<uint8_t> source = make_pixels(width, height, components);
+      std::vector<uint8_t> expected =
+        downsample_reference(source, width, height, components);
+      std::vector<uint8_t> target(expected.size());
+
+      mipmaps_downsample(
+        source.data(), width, height, components, MIPMAPS_FILTER_BOX,
+        target.data(), 0, target_height);
+      CHECK(target == expected);
+    }
+  }
+}
+
+static
+void
+test_row_ranges_compose()
+{
+  uint32_t width = 40, height = 30, components = 4;
+  std::vector<uint8_t> source = make_pixels(width, height, components);
+  std::vector<uint8_t> whole((size_t)20 * 15 * components);
+  std::vector<uint8_t> banded(whole.size());
+
+  // the bands the jobs split a level in give the same level.
+  mipmaps_downsample(
+    source.data(), width, height, components, MIPMAPS_FILTER_SRGB_ALPHA,
+    whole.data(), 0, 15);
+  mipmaps_downsample(
+    source.data(), width, height, components, MIPMAPS_FILTER_SRGB_ALPHA,
+    banded.data(), 0, 4);
+  mipmaps_downsample(
+    source.data(), width, height, components, MIPMAPS_FILTER_SRGB_ALPHA,
+    banded.data(), 4, 11);
+  CHECK(whole == banded);
+}
+
+static
+void
+test_srgb_keeps_uniform_colors()
+{
+  uint32_t values[] = { 0, 1, 17, 128, 200, 254, 255 };
+
+  for (uint32_t value : values) {
+    std::vector<uint8_t> source((size_t)8 * 8 * 4, (uint8_t)value);
+    std::vector<uint8_t> target((size_t)4 * 4 * 4);
+    mipmaps_downsample(
+      source.data(), 8, 8, 4, MIPMAPS_FILTER_SRGB_ALPHA, target.data(), 0, 4);
+    for (uint8_t texel : target)
+      CHECK(std::abs((int32_t)texel - (int32_t)value) <= 1);
+  }
+}
+
+static
+void
+test_srgb_averages_in_linear_space()
+{
+  // black and white average to linear 0.5, about 188 in srgb. alpha is a
+  // plain average.
+  uint8_t source[2 * 2 * 4] = {
+    0, 0, 0, 0,   255, 255, 255, 255,
+    0, 0, 0, 0,   255, 255, 255, 255 };
+  uint8_t target[4];
+
+  mipmaps_downsample(
+    source, 2, 2, 4, MIPMAPS_FILTER_SRGB_ALPHA, target, 0, 1);
+  for (uint32_t c = 0; c < 3; ++c)
+    CHECK(target[c] >= 187 && target[c] <= 189);
+  CHECK(target[3] == 128);
+}
+
+static
+void
+test_generate_chain()
+{
+  uint32_t width = 32, height = 8, components = 4;
+  std::vector<uint8_t> source = make_pixels(width, height, components);
+  std::vector<uint8_t> levels;
+  std::vector<uint8_t> swizzled(source);
+  mipmaps_chain_t chain;
+
+  mipmaps_layout(&chain, width, height, components);
+  CHECK(chain.level_count == 6);
+  CHECK(chain.width[5] == 1 && chain.height[5] == 1);
+  CHECK(chain.width[3] == 4 && chain.height[3] == 1);
+  CHECK(chain.offset[1] == (size_t)width * height * components);
+  CHECK(chain.size == chain.offset[5] + components);
+
+  levels.resize(chain.size);
+  mipmaps_generate(
+    &chain, source.data(), width, height, components, 1, MIPMAPS_FILTER_BOX,
+    0, levels.data());
+
+  // level 0 is swizzled, every level is the box filter of the one above.
+  mipmaps_swizzle(swizzled.data(), (size_t)width * height, components);
+  CHECK(!memcmp(levels.data(), swizzled.data(), swizzled.size()));
+  for (uint32_t level = 1; level < chain.level_count; ++level) {
+    const uint8_t* above = levels.data() + chain.offset[level - 1];
+    std::vector<uint8_t> expected = downsample_reference(
+      std::vector<uint8_t>(above, above + chain.offset[level] -
+        chain.offset[level - 1]),
+      chain.width[level - 1], chain.height[level - 1], components);
+    CHECK(!memcmp(
+      levels.data() + chain.offset[level], expected.data(), expected.size()));
+  }
+}
+
+void
+add_mipmaps_tests(std::vector<unittest_t>& tests)
+{
+  mipmaps_initialize();
+  tests.push_back({ "mipmaps/box_matches_reference",
+    test_box_matches_reference });
+  tests.push_back({ "mipmaps/row_ranges_compose", test_row_ranges_compose });
+  tests.push_back({ "mipmaps/srgb_keeps_uniform_colors",
+    test_srgb_keeps_uniform_colors });
+  tests.push_back({ "mipmaps/srgb_averages_in_linear_space",
+    test_srgb_averages_in_linear_space });
+  tests.push_back({ "mipmaps/generate_chain", test_generate_chain });
+}
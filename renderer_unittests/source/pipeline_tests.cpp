@@ -0,0 +1,200 @@
+/**
+ * @file pipeline_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief the pipeline kernels (sse, or avx when built with it) checked
+ * against the full matrix products of the math library.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <renderer/pipeline.h>
+#include <unittest.h>
+
+
+#define MATRIX_ERROR              1e-5f
+
+// the pipelines are too large for the stack.
+static pipeline_t pipeline;
+
+/// @brief a modelview top with no zero entries and a non trivial last row, so
+/// any term a kernel skips shows.
+static
+matrix4f
+make_matrix(float seed)
+{
+  matrix4f matrix;
+  for (uint32_t i = 0; i < 16; ++i)
+    matrix.data[i] = sinf(seed + (float)i * 0.7f) * 3.f + 0.25f;
+  return matrix;
+}
+
+static
+int32_t
+close_matrix(const matrix4f& a, const matrix4f& b)
+{
+  for (uint32_t i = 0; i < 16; ++i) {
+    float scale = std::max(1.f, std::fabs(b.data[i]));
+    if (std::fabs(a.data[i] - b.data[i]) > MATRIX_ERROR * scale)
+      return 0;
+  }
+  return 1;
+}
+
+static
+void
+reset_pipeline(const matrix4f& top)
+{
+  pipeline_set_default(&pipeline);
+  set_matrix_mode(&pipeline, MODELVIEW);
+  replace(&pipeline, &top);
+}
+
+/// @brief the post operations are matrix * top, the pre ones top * matrix.
+static
+void
+check_operation(
+  void (*operation)(pipeline_t*, float, float, float),
+  const matrix4f& matrix,
+  float x, float y, float z,
+  int32_t post)
+{
+  matrix4f top = make_matrix(x + y + z);
+  matrix4f expected =
+    post ? mult_m4f(&matrix, &top) : mult_m4f(&top, &matrix);
+  uint32_t version;
+
+  reset_pipeline(top);
+  version = get_matrix_version(&pipeline);
+  operation(&pipeline, x, y, z);
+  CHECK(close_matrix(get_matrix(&pipeline), expected));
+  CHECK(get_matrix_version(&pipeline) != version);
+}
+
+static
+void
+test_rotations_match_products()
+{
+  float angles[] = { 0.f, 0.3f, -1.2f, 3.14159265f };
+
+  for (float angle : angles) {
+    matrix4f rotation;
+    matrix4f top = make_matrix(angle);
+    void (*posts[3])(pipeline_t*, float) = {
+      post_rotate_x, post_rotate_y, post_rotate_z };
+    void (*pres[3])(pipeline_t*, float) = {
+      pre_rotate_x, pre_rotate_y, pre_rotate_z };
+    void (*rotations[3])(matrix4f*, float) = {
+      matrix4f_rotation_x, matrix4f_rotation_y, matrix4f_rotation_z };
+
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+      matrix4f expected;
+      rotations[axis](&rotation, angle);
+
+      expected = mult_m4f(&rotation, &top);
+      reset_pipeline(top);
+      posts[axis](&pipeline, angle);
+      CHECK(close_matrix(get_matrix(&pipeline), expected));
+
+      expected = mult_m4f(&top, &rotation);
+      reset_pipeline(top);
+      pres[axis](&pipeline, angle);
+      CHECK(close_matrix(get_matrix(&pipeline), expected));
+    }
+  }
+}
+
+static
+void
+test_translations_match_products()
+{
+  matrix4f translation;
+  matrix4f_translation(&translation, 1.5f, -4.f, 12.f);
+  check_operation(post_translate, translation, 1.5f, -4.f, 12.f, 1);
+  check_operation(pre_translate, translation, 1.5f, -4.f, 12.f, 0);
+}
+
+static
+void
+test_scales_match_products()
+{
+  matrix4f scale;
+  matrix4f_scale(&scale, 2.f, -0.5f, 7.f);
+  check_operation(post_scale, scale, 2.f, -0.5f, 7.f, 1);
+  check_operation(pre_scale, scale, 2.f, -0.5f, 7.f, 0);
+}
+
+static
+void
+test_multiplies_alias_the_top()
+{
+  matrix4f top = make_matrix(1.f);
+  matrix4f matrix = make_matrix(2.f);
+  matrix4f expected, result;
+
+  // the top is both an operand and the result.
+  expected = mult_m4f(&matrix, &top);
+  reset_pipeline(top);
+  post_multiply(&pipeline, &matrix);
+  CHECK(close_matrix(get_matrix(&pipeline), expected));
+
+  expected = mult_m4f(&top, &matrix);
+  reset_pipeline(top);
+  pre_multiply(&pipeline, &matrix);
+  CHECK(close_matrix(get_matrix(&pipeline), expected));
+
+  // and the top multiplied by itself.
+  expected = mult_m4f(&top, &top);
+  result = top;
+  pipeline_multiply(result.data, result.data, result.data);
+  CHECK(close_matrix(result, expected));
+}
+
+static
+void
+test_transforms_match_products()
+{
+  matrix4f top = make_matrix(3.f);
+  matrix4f first = make_matrix(4.f);
+  matrix4f matrices[3] = { first, make_matrix(5.f), top };
+  float points[4 * 5];
+  float result[3 * 5];
+
+  reset_pipeline(top);
+  transform_matrices(&pipeline, matrices, 3, matrices);
+  CHECK(close_matrix(matrices[0], mult_m4f(&top, &first)));
+  CHECK(close_matrix(matrices[2], mult_m4f(&top, &top)));
+
+  // strided points in, packed points out.
+  for (uint32_t i = 0; i < 4 * 5; ++i)
+    points[i] = (float)i - 7.5f;
+  transform_points(&pipeline, points, 4, 5, result, 0);
+  for (uint32_t i = 0; i < 5; ++i) {
+    for (uint32_t row = 0; row < 3; ++row) {
+      const float* m = top.data + row * 4;
+      const float* p = points + i * 4;
+      float expected = m[0] * p[0] + m[1] * p[1] + m[2] * p[2] + m[3];
+      CHECK(
+        std::fabs(result[i * 3 + row] - expected) <=
+        MATRIX_ERROR * std::max(1.f, std::fabs(expected)));
+    }
+  }
+}
+
+void
+add_pipeline_tests(std::vector<unittest_t>& tests)
+{
+  tests.push_back({ "pipeline/rotations_match_products",
+    test_rotations_match_products });
+  tests.push_back({ "pipeline/translations_match_products",
+    test_translations_match_products });
+  tests.push_back({ "pipeline/scales_match_products",
+    test_scales_match_products });
+  tests.push_back({ "pipeline/multiplies_alias_the_top",
+    test_multiplies_alias_the_top });
+  tests.push_back({ "pipeline/transforms_match_products",
+    test_transforms_match_products });
+}
@@ -0,0 +1,207 @@
+/**
+ * @file render_queue_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <algorithm>
+#include <renderer/render_queue.h>
+#include <unittest.h>
+
+
+static
+mesh_render_data_t
+make_mesh(float alpha, float red)
+{
+  mesh_render_data_t mesh = {};
+  for (color_t* color : { &mesh.ambient, &mesh.diffuse, &mesh.specular }) {
+    color->data[0] = red;
+    color->data[3] = alpha;
+  }
+  return mesh;
+}
+
+static
+void
+test_opaque_before_transparent()
+{
+  render_queue_t queue;
+  mesh_render_data_t mesh[4] = {
+    make_mesh(0.5f, 1.f), make_mesh(1.f, 1.f),
+    make_mesh(0.5f, 1.f), make_mesh(1.f, 1.f) };
+  uint32_t textures[4] = { 1, 9, 1, 9 };
+
+  render_queue_initialize(&queue, 1);
+  render_queue_push(&queue, mesh, textures, nullptr, 4);
+  render_queue_sort(&queue);
+
+  CHECK(queue.count == 4);
+  CHECK(queue.items[0].mesh == mesh + 1);
+  CHECK(queue.items[1].mesh == mesh + 3);
+  CHECK(queue.items[2].mesh == mesh + 0);
+  CHECK(queue.items[3].mesh == mesh + 2);
+  render_queue_cleanup(&queue);
+}
+
+static
+void
+test_opaque_front_to_back()
+{
+  render_queue_t queue;
+  mesh_render_data_t mesh[4] = {
+    make_mesh(1.f, 1.f), make_mesh(1.f, 1.f),
+    make_mesh(1.f, 1.f), make_mesh(1.f, 1.f) };
+  uint32_t textures[4] = { 3, 3, 3, 3 };
+  // behind the camera counts as distance 0.
+  float depths[4] = { 40.f, 2.5f, -7.f, 1000.f };
+
+  render_queue_initialize(&queue, 4);
+  render_queue_push(&queue, mesh, textures, depths, 4);
+  render_queue_sort(&queue);
+
+  CHECK(queue.items[0].mesh == mesh + 2);
+  CHECK(queue.items[1].mesh == mesh + 1);
+  CHECK(queue.items[2].mesh == mesh + 0);
+  CHECK(queue.items[3].mesh == mesh + 3);
+  render_queue_cleanup(&queue);
+}
+
+static
+void
+test_opaque_grouped_by_texture()
+{
+  render_queue_t queue;
+  mesh_render_data_t mesh[4] = {
+    make_mesh(1.f, 1.f), make_mesh(1.f, 1.f),
+    make_mesh(1.f, 1.f), make_mesh(1.f, 1.f) };
+  uint32_t textures[4] = { 7, 2, 7, 2 };
+  float depths[4] = { 1.f, 50.f, 2.f, 60.f };
+
+  render_queue_initialize(&queue, 4);
+  render_queue_push(&queue, mesh, textures, depths, 4);
+  render_queue_sort(&queue);
+
+  // the texture outranks the depth.
+  CHECK(queue.items[0].mesh == mesh + 1);
+  CHECK(queue.items[1].mesh == mesh + 3);
+  CHECK(queue.items[2].mesh == mesh + 0);
+  CHECK(queue.items[3].mesh == mesh + 2);
+  render_queue_cleanup(&queue);
+}
+
+static
+void
+test_transparent_back_to_front()
+{
+  render_queue_t queue;
+  mesh_render_data_t mesh[4] = {
+    make_mesh(0.5f, 1.f), make_mesh(0.5f, 0.2f),
+    make_mesh(0.5f, 1.f), make_mesh(0.5f, 0.2f) };
+  uint32_t textures[4] = { 1, 2, 3, 4 };
+  float depths[4] = { 5.f, 80.f, 20.f, 0.5f };
+
+  render_queue_initialize(&queue, 4);
+  render_queue_push(&queue, mesh, textures, depths, 4);
+  render_queue_sort(&queue);
+
+  // the depth outranks the texture and material.
+  CHECK(queue.items[0].mesh == mesh + 1);
+  CHECK(queue.items[1].mesh == mesh + 2);
+  CHECK(queue.items[2].mesh == mesh + 0);
+  CHECK(queue.items[3].mesh == mesh + 3);
+  render_queue_cleanup(&queue);
+}
+
+static
+void
+test_equal_keys_keep_order()
+{
+  render_queue_t queue;
+  std::vector<mesh_render_data_t> mesh(300, make_mesh(1.f, 1.f));
+  std::vector<uint32_t> textures(mesh.size(), 5);
+
+  // 2 batches, the second one grows the queue.
+  render_queue_initialize(&queue, 16);
+  render_queue_push(&queue, mesh.data(), textures.data(), nullptr, 100);
+  render_queue_push(&queue, mesh.data() + 100, textures.data(), nullptr, 200);
+  render_queue_sort(&queue);
+
+  CHECK(queue.count == 300);
+  for (uint32_t i = 0; i < queue.count; ++i)
+    CHECK(queue.items[i].mesh == mesh.data() + i);
+  render_queue_cleanup(&queue);
+}
+
+static
+void
+test_matches_stable_sort()
+{
+  render_queue_t queue;
+  std::vector<mesh_render_data_t> mesh;
+  std::vector<uint32_t> textures;
+  std::vector<float> depths;
+  std::vector<render_queue_item_t> expected;
+  uint32_t state = 0x2545f491u;
+
+  for (uint32_t i = 0; i < 5000; ++i) {
+    uint32_t values[3];
+    for (uint32_t& value : values) {
+      state = state * 1664525u + 1013904223u;
+      value = state >> 8;
+    }
+    mesh.push_back(
+      make_mesh((values[0] & 3) ? 1.f : 0.5f, (float)(values[0] % 5) / 4.f));
+    textures.push_back(values[1] % 6);
+    // few distinct depths so equal keys are common.
+    depths.push_back((float)(values[2] % 64) * 0.75f - 4.f);
+  }
+
+  render_queue_initialize(&queue, 0);
+  render_queue_push(
+    &queue, mesh.data(), textures.data(), depths.data(),
+    (uint32_t)mesh.size());
+  expected.assign(queue.items, queue.items + queue.count);
+  std::stable_sort(
+    expected.begin(), expected.end(),
+    [](const render_queue_item_t& a, const render_queue_item_t& b) {
+      return a.key < b.key;
+    });
+  render_queue_sort(&queue);
+
+  CHECK(queue.count == expected.size());
+  for (uint32_t i = 0; i < queue.count; ++i) {
+    CHECK(queue.items[i].key == expected[i].key);
+    CHECK(queue.items[i].mesh == expected[i].mesh);
+    CHECK(queue.items[i].texture_id == expected[i].texture_id);
+  }
+
+  // cleared and sorted again, the ping-pong buffers swapped the first time.
+  render_queue_clear(&queue);
+  render_queue_push(&queue, mesh.data(), textures.data(), depths.data(), 3);
+  render_queue_sort(&queue);
+  CHECK(queue.count == 3);
+  CHECK(queue.items[0].key <= queue.items[1].key);
+  CHECK(queue.items[1].key <= queue.items[2].key);
+  render_queue_cleanup(&queue);
+}
+
+void
+add_render_queue_tests(std::vector<unittest_t>& tests)
+{
+  tests.push_back({ "render_queue/opaque_before_transparent",
+    test_opaque_before_transparent });
+  tests.push_back({ "render_queue/opaque_front_to_back",
+    test_opaque_front_to_back });
+  tests.push_back({ "render_queue/opaque_grouped_by_texture",
+    test_opaque_grouped_by_texture });
+  tests.push_back({ "render_queue/transparent_back_to_front",
+    test_transparent_back_to_front });
+  tests.push_back({ "render_queue/equal_keys_keep_order",
+    test_equal_keys_keep_order });
+  tests.push_back({ "render_queue/matches_stable_sort",
+    test_matches_stable_sort });
+}
@@ -0,0 +1,331 @@
+/**
+ * @file software_raster_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief the tiled rasterizer checked against reference images computed per
+ * pixel center, single threaded and on the job pool.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstdlib>
+#include <cstring>
+#include <renderer/internal/jobs.h>
+#include <renderer/internal/software_raster.h>
+#include <unittest.h>
+
+
+// not a multiple of the tile size, the last row and column are partial.
+#define TARGET_WIDTH              150
+#define TARGET_HEIGHT             100
+#define RASTER_THREADS            4
+
+struct image_t {
+  std::vector<uint8_t> color;
+  std::vector<float> depth;
+};
+
+struct vertex_t {
+  float x;
+  float y;
+  float z;
+};
+
+static
+void
+add_triangle(
+  vertex_t a,
+  vertex_t b,
+  vertex_t c,
+  const float color[4],
+  raster_blend_t blend,
+  int32_t depth_test)
+{
+  raster_triangle_t* triangle = raster_append(1);
+  vertex_t vertices[3] = { a, b, c };
+
+  memset(triangle, 0, sizeof(raster_triangle_t));
+  for (uint32_t i = 0; i < 3; ++i) {
+    triangle->x[i] = vertices[i].x;
+    triangle->y[i] = vertices[i].y;
+    triangle->z[i] = vertices[i].z;
+    triangle->inv_w[i] = 1.f;
+    memcpy(triangle->color[i], color, sizeof(float) * 4);
+  }
+  triangle->blend = (uint8_t)blend;
+  triangle->depth_test = (uint8_t)depth_test;
+}
+
+/// @brief the rectangle [x0, x1) x [y0, y1) as 2 triangles.
+static
+void
+add_rectangle(
+  float x0, float y0, float x1, float y1, float z,
+  const float color[4],
+  raster_blend_t blend,
+  int32_t depth_test)
+{
+  add_triangle(
+    { x0, y0, z }, { x1, y0, z }, { x1, y1, z }, color, blend, depth_test);
+  add_triangle(
+    { x0, y0, z }, { x1, y1, z }, { x0, y1, z }, color, blend, depth_test);
+}
+
+/// @brief clears to opaque black, queues the triangles of @a fill then
+/// rasterizes them on @a threads threads.
+static
+image_t
+render(uint32_t threads, void (*fill)(void))
+{
+  image_t image;
+  renderer_software_target_t target;
+  float black[4] = { 0.f, 0.f, 0.f, 1.f };
+
+  image.color.resize((size_t)TARGET_WIDTH * TARGET_HEIGHT * 4);
+  image.depth.resize((size_t)TARGET_WIDTH * TARGET_HEIGHT);
+  target.color = image.color.data();
+  target.depth = image.depth.data();
+  target.width = TARGET_WIDTH;
+  target.height = TARGET_HEIGHT;
+
+  if (threads > 1)
+    jobs_initialize(threads);
+  raster_initialize(&target);
+  raster_clear(black);
+  fill();
+  raster_flush();
+  CHECK(raster_pending() == 0);
+  raster_cleanup();
+  if (threads > 1)
+    jobs_cleanup();
+
+  return image;
+}
+
+/// @brief returns the number of pixels more than 1 away from @a reference in
+/// any component.
+static
+uint32_t
+count_mismatches(
+  const image_t& image,
+  void (*reference)(uint32_t x, uint32_t y, int32_t* expected))
+{
+  uint32_t mismatches = 0;
+  for (uint32_t y = 0; y < TARGET_HEIGHT; ++y) {
+    for (uint32_t x = 0; x < TARGET_WIDTH; ++x) {
+      const uint8_t* pixel =
+        image.color.data() + ((size_t)y * TARGET_WIDTH + x) * 4;
+      int32_t expected[4];
+      int32_t mismatch = 0;
+      reference(x, y, expected);
+      for (uint32_t i = 0; i < 4; ++i)
+        mismatch |= expected[i] >= 0 && std::abs(pixel[i] - expected[i]) > 1;
+      mismatches += mismatch;
+    }
+  }
+  return mismatches;
+}
+
+static
+void
+set_expected(int32_t* expected, int32_t r, int32_t g, int32_t b, int32_t a)
+{
+  expected[0] = r;
+  expected[1] = g;
+  expected[2] = b;
+  expected[3] = a;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// half transparent blue over a square split in a fan around a pixel center,
+// the diagonals run through pixel centers. a pixel the shared edges give twice
+// or miss shows.
+static
+void
+fill_fan()
+{
+  float blue[4] = { 0.f, 0.f, 1.f, 0.5f };
+  vertex_t center = { 76.5f, 50.5f, 0.f };
+  vertex_t corners[4] = {
+    { 27.f, 1.f, 0.f }, { 126.f, 1.f, 0.f },
+    { 126.f, 100.f, 0.f }, { 27.f, 100.f, 0.f } };
+
+  for (uint32_t i = 0; i < 4; ++i)
+    add_triangle(
+      corners[i], corners[(i + 1) % 4], center, blue, RASTER_BLEND_ALPHA, 0);
+}
+
+static
+void
+reference_fan(uint32_t x, uint32_t y, int32_t* expected)
+{
+  if (x >= 27 && x < 126 && y >= 1)
+    set_expected(expected, 0, 0, 128, 191);
+  else
+    set_expected(expected, 0, 0, 0, 255);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// a triangle across the tiles and one mostly off the target. the vertices are
+// on the 1/16 grid so the snapping leaves them as is.
+static const vertex_t triangles[2][3] = {
+  { { 3.25f, 2.5f, 0.f }, { 141.75f, 30.0625f, 0.f },
+    { 60.5f, 97.1875f, 0.f } },
+  { { 120.f, 60.f, 0.f }, { 400.f, 80.f, 0.f }, { 130.f, 300.f, 0.f } } };
+
+static
+void
+fill_triangles()
+{
+  float red[4] = { 1.f, 0.f, 0.f, 1.f };
+  float green[4] = { 0.f, 1.f, 0.f, 1.f };
+  add_triangle(
+    triangles[0][0], triangles[0][1], triangles[0][2], red,
+    RASTER_BLEND_NONE, 0);
+  add_triangle(
+    triangles[1][0], triangles[1][1], triangles[1][2], green,
+    RASTER_BLEND_NONE, 0);
+}
+
+/// @brief 1 inside, 0 outside, -1 if the center is on an edge (the fill rule
+/// decides, see reference_fan).
+static
+int32_t
+get_coverage(const vertex_t* v, uint32_t x, uint32_t y)
+{
+  double px = x + 0.5, py = y + 0.5;
+  int32_t positive = 0, negative = 0;
+  for (uint32_t i = 0; i < 3; ++i) {
+    const vertex_t& a = v[i];
+    const vertex_t& b = v[(i + 1) % 3];
+    double edge = (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+    if (edge == 0.)
+      return -1;
+    positive += edge > 0.;
+    negative += edge < 0.;
+  }
+  return positive == 3 || negative == 3;
+}
+
+static
+void
+reference_triangles(uint32_t x, uint32_t y, int32_t* expected)
+{
+  int32_t first = get_coverage(triangles[0], x, y);
+  int32_t second = get_coverage(triangles[1], x, y);
+  set_expected(expected, 0, 0, 0, 255);
+  if (first < 0 || second < 0)
+    set_expected(expected, -1, -1, -1, -1);
+  else if (second)
+    expected[1] = 255;
+  else if (first)
+    expected[0] = 255;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// green at half depth, red behind it then blue in front of it.
+static
+void
+fill_depths()
+{
+  float red[4] = { 1.f, 0.f, 0.f, 1.f };
+  float green[4] = { 0.f, 1.f, 0.f, 1.f };
+  float blue[4] = { 0.f, 0.f, 1.f, 1.f };
+  add_rectangle(10.f, 10.f, 90.f, 90.f, 0.5f, green, RASTER_BLEND_NONE, 1);
+  add_rectangle(50.f, 20.f, 140.f, 80.f, 0.75f, red, RASTER_BLEND_NONE, 1);
+  add_rectangle(30.f, 40.f, 70.f, 99.f, 0.25f, blue, RASTER_BLEND_NONE, 1);
+}
+
+static
+void
+reference_depths(uint32_t x, uint32_t y, int32_t* expected)
+{
+  set_expected(expected, 0, 0, 0, 255);
+  if (x >= 30 && x < 70 && y >= 40 && y < 99)
+    expected[2] = 255;
+  else if (x >= 10 && x < 90 && y >= 10 && y < 90)
+    expected[1] = 255;
+  else if (x >= 50 && x < 140 && y >= 20 && y < 80)
+    expected[0] = 255;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static
+void
+fill_random()
+{
+  uint32_t state = 0x9e3779b9u;
+  auto next = [&state](float range) {
+    state = state * 1664525u + 1013904223u;
+    return (float)(state >> 8) / (float)(1u << 24) * range;
+  };
+
+  // overlapping, blended and depth tested, in and out of the target.
+  for (uint32_t i = 0; i < 3000; ++i) {
+    float x = next(TARGET_WIDTH + 40.f) - 20.f;
+    float y = next(TARGET_HEIGHT + 40.f) - 20.f;
+    float color[4] = { next(1.f), next(1.f), next(1.f), next(1.f) };
+    add_triangle(
+      { x, y, next(1.f) },
+      { x + next(60.f) - 30.f, y + next(60.f) - 30.f, next(1.f) },
+      { x + next(60.f) - 30.f, y + next(60.f) - 30.f, next(1.f) },
+      color,
+      (raster_blend_t)(i % 3),
+      (int32_t)(i % 2));
+  }
+}
+
+static
+void
+test_fan_covers_pixels_once()
+{
+  CHECK(count_mismatches(render(1, fill_fan), reference_fan) == 0);
+  CHECK(
+    count_mismatches(render(RASTER_THREADS, fill_fan), reference_fan) == 0);
+}
+
+static
+void
+test_triangles_match_reference()
+{
+  CHECK(
+    count_mismatches(render(1, fill_triangles), reference_triangles) == 0);
+  CHECK(
+    count_mismatches(
+      render(RASTER_THREADS, fill_triangles), reference_triangles) == 0);
+}
+
+static
+void
+test_depth_keeps_nearest()
+{
+  CHECK(count_mismatches(render(1, fill_depths), reference_depths) == 0);
+  CHECK(
+    count_mismatches(
+      render(RASTER_THREADS, fill_depths), reference_depths) == 0);
+}
+
+static
+void
+test_threads_match_single_thread()
+{
+  // the bins keep the submission order, blending included.
+  image_t single = render(1, fill_random);
+  image_t pooled = render(RASTER_THREADS, fill_random);
+  CHECK(single.color == pooled.color);
+  CHECK(single.depth == pooled.depth);
+}
+
+void
+add_software_raster_tests(std::vector<unittest_t>& tests)
+{
+  tests.push_back({ "software_raster/fan_covers_pixels_once",
+    test_fan_covers_pixels_once });
+  tests.push_back({ "software_raster/triangles_match_reference",
+    test_triangles_match_reference });
+  tests.push_back({ "software_raster/depth_keeps_nearest",
+    test_depth_keeps_nearest });
+  tests.push_back({ "software_raster/threads_match_single_thread",
+    test_threads_match_single_thread });
+}
@@ -0,0 +1,193 @@
+/**
+ * @file state_cache_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief the opengl entry points the state cache calls are replaced by stubs
+ * that count the calls, not built on windows (see CMakeLists.txt).
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <cstring>
+#include <renderer/internal/frame_stats.h>
+#include <renderer/internal/opengl_extensions.h>
+#include <renderer/internal/state_cache.h>
+#include <unittest.h>
+
+
+static uint32_t gl_calls = 0;
+static uint32_t matrix_loads = 0;
+static GLfloat loaded_matrix[16];
+
+// what the renderer defines, with the buffer objects left unsupported.
+frame_counters_t frame_counters;
+opengl_features_t opengl_features;
+gl_bind_buffer_t renderer_glBindBuffer;
+
+extern "C" {
+
+void APIENTRY glEnable(GLenum) { ++gl_calls; }
+void APIENTRY glDisable(GLenum) { ++gl_calls; }
+void APIENTRY glEnableClientState(GLenum) { ++gl_calls; }
+void APIENTRY glDisableClientState(GLenum) { ++gl_calls; }
+void APIENTRY glBindTexture(GLenum, GLuint) { ++gl_calls; }
+void APIENTRY glBlendFunc(GLenum, GLenum) { ++gl_calls; }
+void APIENTRY glLineWidth(GLfloat) { ++gl_calls; }
+void APIENTRY glPointSize(GLfloat) { ++gl_calls; }
+void APIENTRY glMatrixMode(GLenum) { ++gl_calls; }
+void APIENTRY glLoadIdentity(void) { ++gl_calls; }
+void APIENTRY glViewport(GLint, GLint, GLsizei, GLsizei) { ++gl_calls; }
+void APIENTRY glLightfv(GLenum, GLenum, const GLfloat*) { ++gl_calls; }
+
+void APIENTRY
+glFrustum(GLdouble, GLdouble, GLdouble, GLdouble, GLdouble, GLdouble)
+{
+  ++gl_calls;
+}
+
+void APIENTRY
+glOrtho(GLdouble, GLdouble, GLdouble, GLdouble, GLdouble, GLdouble)
+{
+  ++gl_calls;
+}
+
+void APIENTRY
+glLoadMatrixf(const GLfloat* m)
+{
+  ++gl_calls;
+  ++matrix_loads;
+  memcpy(loaded_matrix, m, sizeof(loaded_matrix));
+}
+
+}
+
+// the pipelines are too large for the stack.
+static pipeline_t pipeline;
+
+static
+void
+reset()
+{
+  state_cache_reset();
+  state_reset_counters();
+  memset(&frame_counters, 0, sizeof(frame_counters));
+  gl_calls = 0;
+  matrix_loads = 0;
+  pipeline_set_default(&pipeline);
+  set_matrix_mode(&pipeline, MODELVIEW);
+  load_identity(&pipeline);
+}
+
+static
+void
+test_redundant_states_skipped()
+{
+  uint64_t issued, skipped;
+  reset();
+
+  state_enable(GL_BLEND);
+  state_enable(GL_BLEND);
+  state_disable(GL_BLEND);
+  state_bind_texture(3);
+  state_bind_texture(3);
+  state_bind_texture(4);
+  state_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  state_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  state_line_width(2.f);
+  state_line_width(2.f);
+  state_get_counters(&issued, &skipped);
+
+  CHECK(gl_calls == 6);
+  CHECK(issued == 6);
+  CHECK(skipped == 4);
+  CHECK(frame_counters.texture_binds == 2);
+}
+
+static
+void
+test_reset_forgets_states()
+{
+  uint64_t issued, skipped;
+  reset();
+
+  state_enable(GL_LIGHTING);
+  state_bind_texture(9);
+  state_cache_reset();
+  state_enable(GL_LIGHTING);
+  state_bind_texture(9);
+
+  // the counters survive the reset.
+  state_get_counters(&issued, &skipped);
+  CHECK(gl_calls == 4);
+  CHECK(issued == 4 && skipped == 0);
+
+  // a deleted texture is no longer bound, binding the id again goes through.
+  state_forget_texture(9);
+  state_bind_texture(9);
+  CHECK(gl_calls == 5);
+}
+
+static
+void
+test_modelview_loads()
+{
+  reset();
+
+  state_load_modelview(&pipeline);
+  state_load_modelview(&pipeline);
+  CHECK(matrix_loads == 1);
+
+  // a changed top, then a pushed copy of it, are new matrices.
+  post_translate(&pipeline, 1.f, 2.f, 3.f);
+  state_load_modelview(&pipeline);
+  CHECK(matrix_loads == 2);
+  // column major, the translation is the last column.
+  CHECK(loaded_matrix[12] == 1.f && loaded_matrix[14] == 3.f);
+  push_matrix(&pipeline);
+  state_load_modelview(&pipeline);
+  CHECK(matrix_loads == 3);
+  pop_matrix(&pipeline);
+  state_load_modelview(&pipeline);
+  CHECK(matrix_loads == 4);
+  state_load_modelview(&pipeline);
+  CHECK(matrix_loads == 4);
+
+  // a loose matrix is not tracked, the pipeline top goes through after it.
+  state_load_modelview_matrix(pipeline.modelview_stack);
+  state_load_modelview(&pipeline);
+  CHECK(matrix_loads == 6);
+}
+
+static
+void
+test_reinitialized_pipeline_reloads()
+{
+  reset();
+
+  post_translate(&pipeline, 5.f, 0.f, 0.f);
+  state_load_modelview(&pipeline);
+  CHECK(matrix_loads == 1 && loaded_matrix[12] == 5.f);
+
+  // set up again at the same address and through the same calls, the slot
+  // and its version match the last load but the matrix does not.
+  memset(&pipeline, 0, sizeof(pipeline));
+  pipeline_set_default(&pipeline);
+  set_matrix_mode(&pipeline, MODELVIEW);
+  load_identity(&pipeline);
+  post_translate(&pipeline, -8.f, 0.f, 0.f);
+  state_load_modelview(&pipeline);
+  CHECK(matrix_loads == 2 && loaded_matrix[12] == -8.f);
+}
+
+void
+add_state_cache_tests(std::vector<unittest_t>& tests)
+{
+  tests.push_back({ "state_cache/redundant_states_skipped",
+    test_redundant_states_skipped });
+  tests.push_back({ "state_cache/reset_forgets_states",
+    test_reset_forgets_states });
+  tests.push_back({ "state_cache/modelview_loads", test_modelview_loads });
+  tests.push_back({ "state_cache/reinitialized_pipeline_reloads",
+    test_reinitialized_pipeline_reloads });
+}
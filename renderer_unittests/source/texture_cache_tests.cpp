@@ -0,0 +1,240 @@
+/**
+ * @file texture_cache_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief the gpu side of the cache (uploads and evictions) is replaced by
+ * stubs that hand out ids and record the evictions.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <renderer/texture_cache.h>
+#include <renderer/texture_compression.h>
+#include <unittest.h>
+
+
+static uint32_t next_texture = 0;
+static uint32_t uploads = 0;
+static uint32_t async_uploads = 0;
+static std::vector<uint32_t> evicted;
+
+extern "C" {
+
+uint32_t
+upload_to_gpu(
+  const char*,
+  const uint8_t*,
+  uint32_t,
+  uint32_t,
+  renderer_image_format_t)
+{
+  ++uploads;
+  return ++next_texture;
+}
+
+uint32_t
+upload_to_gpu_async(
+  const char*,
+  const uint8_t*,
+  uint32_t,
+  uint32_t,
+  renderer_image_format_t)
+{
+  ++async_uploads;
+  return ++next_texture;
+}
+
+uint32_t
+evict_from_gpu(uint32_t texture_id)
+{
+  evicted.push_back(texture_id);
+  return 1;
+}
+
+}
+
+/// @brief a 16x16 rgba texture with its mip chain.
+#define TEXTURE_BYTES             ((256 + 64 + 16 + 4 + 1) * 4)
+
+static uint8_t pixels[16 * 16 * 4];
+
+static
+void
+reset()
+{
+  texture_cache_cleanup();
+  uploads = async_uploads = 0;
+  evicted.clear();
+  for (uint32_t i = 0; i < sizeof(pixels); ++i)
+    pixels[i] = (uint8_t)i;
+}
+
+static
+uint32_t
+acquire(const char* path)
+{
+  return texture_cache_acquire(
+    path, pixels, 16, 16, RENDERER_OPENGL_RGBA, 0);
+}
+
+static
+void
+test_acquire_shares_textures()
+{
+  texture_cache_stats_t stats;
+  uint32_t first, second;
+  reset();
+
+  first = acquire("a.png");
+  CHECK(first && uploads == 1);
+  // a resident path needs no pixels.
+  second = texture_cache_acquire(
+    "a.png", nullptr, 16, 16, RENDERER_OPENGL_RGBA, 0);
+  CHECK(second == first && uploads == 1);
+  CHECK(!texture_cache_acquire(
+    "b.png", nullptr, 16, 16, RENDERER_OPENGL_RGBA, 0));
+  CHECK(acquire("b.png") != first && uploads == 2);
+
+  // the async flag picks the upload.
+  CHECK(texture_cache_acquire(
+    "c.png", pixels, 16, 16, RENDERER_OPENGL_RGBA, 1));
+  CHECK(async_uploads == 1 && uploads == 2);
+
+  texture_cache_get_stats(&stats);
+  CHECK(stats.textures == 3 && stats.referenced == 3);
+  CHECK(stats.hits == 1 && stats.misses == 3);
+  CHECK(stats.resident_bytes == 3 * TEXTURE_BYTES);
+  CHECK(stats.budget == UINT64_MAX);
+}
+
+static
+void
+test_content_keyed_textures()
+{
+  uint32_t first, second;
+  reset();
+
+  first = texture_cache_acquire(
+    nullptr, pixels, 16, 16, RENDERER_OPENGL_RGBA, 0);
+  second = texture_cache_acquire(
+    nullptr, pixels, 16, 16, RENDERER_OPENGL_RGBA, 0);
+  CHECK(first && second == first && uploads == 1);
+
+  // the same bytes under another layout, then other bytes.
+  CHECK(texture_cache_acquire(
+    nullptr, pixels, 8, 32, RENDERER_OPENGL_RGBA, 0) != first);
+  pixels[5] ^= 0xff;
+  CHECK(texture_cache_acquire(
+    nullptr, pixels, 16, 16, RENDERER_OPENGL_RGBA, 0) != first);
+  CHECK(uploads == 3);
+}
+
+static
+void
+test_references_counted()
+{
+  texture_cache_stats_t stats;
+  uint32_t texture;
+  reset();
+
+  texture = acquire("a.png");
+  acquire("a.png");
+  texture_cache_set_budget(0);
+
+  // still referenced once.
+  texture_cache_release(texture);
+  texture_cache_collect();
+  texture_cache_get_stats(&stats);
+  CHECK(stats.textures == 1 && stats.referenced == 1);
+  CHECK(evicted.empty());
+
+  // released textures stay resident until the collection.
+  texture_cache_release(texture);
+  texture_cache_get_stats(&stats);
+  CHECK(stats.textures == 1 && stats.referenced == 0);
+  texture_cache_collect();
+  texture_cache_get_stats(&stats);
+  CHECK(stats.textures == 0 && stats.resident_bytes == 0);
+  CHECK(stats.evictions == 1);
+  CHECK(evicted.size() == 1 && evicted[0] == texture);
+
+  // evicted, acquiring the path uploads it again.
+  CHECK(!texture_cache_acquire(
+    "a.png", nullptr, 16, 16, RENDERER_OPENGL_RGBA, 0));
+  CHECK(acquire("a.png") && uploads == 2);
+}
+
+static
+void
+test_least_recently_drawn_evicted()
+{
+  texture_cache_stats_t stats;
+  uint32_t textures[4];
+  reset();
+
+  // acquired a frame apart, then all released.
+  for (uint32_t i = 0; i < 4; ++i) {
+    const char* paths[4] = { "a.png", "b.png", "c.png", "d.png" };
+    textures[i] = acquire(paths[i]);
+    texture_cache_collect();
+  }
+  for (uint32_t i = 0; i < 4; ++i)
+    texture_cache_release(textures[i]);
+
+  // the first one is drawn again, the second is now the oldest.
+  texture_cache_touch(textures[0]);
+  texture_cache_set_budget(3 * TEXTURE_BYTES);
+  texture_cache_collect();
+  CHECK(evicted.size() == 1 && evicted[0] == textures[1]);
+
+  texture_cache_set_budget(TEXTURE_BYTES);
+  texture_cache_collect();
+  CHECK(evicted.size() == 3);
+  if (evicted.size() == 3)
+    CHECK(evicted[1] == textures[2] && evicted[2] == textures[3]);
+  texture_cache_get_stats(&stats);
+  CHECK(stats.textures == 1 && stats.resident_bytes == TEXTURE_BYTES);
+  CHECK(stats.budget == TEXTURE_BYTES);
+
+  // the cleanup deletes the rest, referenced or not.
+  acquire("e.png");
+  texture_cache_cleanup();
+  CHECK(evicted.size() == 5);
+}
+
+static
+void
+test_resident_bytes_estimated()
+{
+  texture_cache_stats_t stats;
+  reset();
+
+  // 3 components are padded to 4, 1x1 levels included.
+  texture_cache_acquire(nullptr, pixels, 4, 4, RENDERER_OPENGL_RGB, 0);
+  texture_cache_get_stats(&stats);
+  CHECK(stats.resident_bytes == (16 + 4 + 1) * 4);
+
+  // the compressed formats take their blocks.
+  texture_cache_acquire(nullptr, pixels, 16, 16, RENDERER_OPENGL_BC1, 0);
+  texture_cache_get_stats(&stats);
+  CHECK(
+    stats.resident_bytes ==
+    (16 + 4 + 1) * 4 +
+    texture_compression_size(16, 16, RENDERER_OPENGL_BC1));
+}
+
+void
+add_texture_cache_tests(std::vector<unittest_t>& tests)
+{
+  tests.push_back({ "texture_cache/acquire_shares_textures",
+    test_acquire_shares_textures });
+  tests.push_back({ "texture_cache/content_keyed_textures",
+    test_content_keyed_textures });
+  tests.push_back({ "texture_cache/references_counted",
+    test_references_counted });
+  tests.push_back({ "texture_cache/least_recently_drawn_evicted",
+    test_least_recently_drawn_evicted });
+  tests.push_back({ "texture_cache/resident_bytes_estimated",
+    test_resident_bytes_estimated });
+}
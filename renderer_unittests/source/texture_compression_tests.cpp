@@ -0,0 +1,184 @@
+/**
+ * @file texture_compression_tests.cpp
+ * @author khalilhenoud@gmail.com
+ * @brief
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <renderer/texture_compression.h>
+#include <unittest.h>
+
+
+#define IMAGE_SIZE                64
+// 2 interpolated colors between 565 endpoints, on a smooth block.
+#define COLOR_ERROR               16
+// one step of the 8 levels of a block spanning the whole range.
+#define NOISE_ERROR               36
+
+/// @brief a smooth rgba image, every block is close to a line in color space.
+static
+std::vector<uint8_t>
+make_gradient()
+{
+  std::vector<uint8_t> pixels((size_t)IMAGE_SIZE * IMAGE_SIZE * 4);
+  for (uint32_t y = 0; y < IMAGE_SIZE; ++y) {
+    for (uint32_t x = 0; x < IMAGE_SIZE; ++x) {
+      uint8_t* p = pixels.data() + ((size_t)y * IMAGE_SIZE + x) * 4;
+      p[0] = (uint8_t)(x * 4);
+      p[1] = (uint8_t)(y * 4);
+      p[2] = (uint8_t)(255 - (x + y) * 2);
+      p[3] = (uint8_t)(128 + x * 2 - y);
+    }
+  }
+  return pixels;
+}
+
+static
+std::vector<uint8_t>
+make_noise()
+{
+  std::vector<uint8_t> pixels((size_t)IMAGE_SIZE * IMAGE_SIZE * 4);
+  uint32_t state = 0x9e3779b9u;
+  for (uint8_t& pixel : pixels) {
+    state = state * 1664525u + 1013904223u;
+    pixel = (uint8_t)(state >> 24);
+  }
+  return pixels;
+}
+
+/// @brief encodes then decodes level 0, returns the largest difference of
+/// the components selected by @a mask. BC4 and BC5 must decode the components
+/// they drop to (0, 0, 255) in place of (g, b, a).
+static
+int32_t
+get_round_trip_error(
+  const std::vector<uint8_t>& pixels,
+  renderer_image_format_t format,
+  uint32_t mask)
+{
+  std::vector<uint8_t> blocks(
+    texture_compression_size(IMAGE_SIZE, IMAGE_SIZE, format));
+  std::vector<uint8_t> decoded(pixels.size());
+  int32_t error = 0;
+  int32_t single_channel =
+    format == RENDERER_OPENGL_BC4 || format == RENDERER_OPENGL_BC5;
+
+  texture_compress(
+    pixels.data(), IMAGE_SIZE, IMAGE_SIZE, RENDERER_OPENGL_RGBA, format,
+    blocks.data());
+  texture_decompress(
+    blocks.data(), IMAGE_SIZE, IMAGE_SIZE, format, decoded.data());
+
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    uint32_t c = i % 4;
+    if (mask & (1u << c))
+      error = std::max(error, std::abs((int32_t)decoded[i] - pixels[i]));
+    else if (single_channel)
+      CHECK(decoded[i] == (c == 3 ? 255 : 0));
+  }
+
+  return error;
+}
+
+static
+void
+test_sizes()
+{
+  // 8 or 16 bytes per 4x4 block, the levels under 4x4 still take a block.
+  CHECK(texture_compression_size(4, 4, RENDERER_OPENGL_BC1) == 8 + 8 + 8);
+  CHECK(texture_compression_size(4, 4, RENDERER_OPENGL_BC3) == 16 * 3);
+  CHECK(
+    texture_compression_size(64, 64, RENDERER_OPENGL_BC4) ==
+    (size_t)(256 + 64 + 16 + 4 + 1 + 1 + 1) * 8);
+  CHECK(
+    texture_compression_size(8, 4, RENDERER_OPENGL_BC5) ==
+    (size_t)(2 + 1 + 1 + 1) * 16);
+  CHECK(texture_compression_is_compressed(RENDERER_OPENGL_BC4));
+  CHECK(!texture_compression_is_compressed(RENDERER_OPENGL_RGBA));
+}
+
+static
+void
+test_bc1_error_bound()
+{
+  std::vector<uint8_t> pixels = make_gradient();
+  // opaque, bc1 would otherwise use its transparent black index.
+  for (size_t i = 3; i < pixels.size(); i += 4)
+    pixels[i] = 255;
+
+  CHECK(
+    get_round_trip_error(pixels, RENDERER_OPENGL_BC1, 0xf) <= COLOR_ERROR);
+}
+
+static
+void
+test_bc3_error_bound()
+{
+  // bc3 alpha is encoded like bc4.
+  CHECK(
+    get_round_trip_error(make_gradient(), RENDERER_OPENGL_BC3, 0xf) <=
+    COLOR_ERROR);
+  CHECK(
+    get_round_trip_error(make_noise(), RENDERER_OPENGL_BC3, 0x8) <=
+    NOISE_ERROR);
+}
+
+static
+void
+test_bc4_error_bound()
+{
+  // the gradient blocks span a few values, 8 levels cover them.
+  CHECK(get_round_trip_error(make_gradient(), RENDERER_OPENGL_BC4, 0x1) <= 2);
+  CHECK(
+    get_round_trip_error(make_noise(), RENDERER_OPENGL_BC4, 0x1) <=
+    NOISE_ERROR);
+}
+
+static
+void
+test_bc5_error_bound()
+{
+  CHECK(get_round_trip_error(make_gradient(), RENDERER_OPENGL_BC5, 0x3) <= 2);
+  CHECK(
+    get_round_trip_error(make_noise(), RENDERER_OPENGL_BC5, 0x3) <=
+    NOISE_ERROR);
+}
+
+static
+void
+test_solid_colors()
+{
+  std::vector<uint8_t> pixels((size_t)IMAGE_SIZE * IMAGE_SIZE * 4);
+  for (size_t i = 0; i < pixels.size(); i += 4) {
+    pixels[i + 0] = 37;
+    pixels[i + 1] = 201;
+    pixels[i + 2] = 90;
+    pixels[i + 3] = 255;
+  }
+
+  // the single channel formats are exact, bc1 is off by the 565 rounding at
+  // most.
+  CHECK(get_round_trip_error(pixels, RENDERER_OPENGL_BC1, 0xf) <= 4);
+  CHECK(get_round_trip_error(pixels, RENDERER_OPENGL_BC4, 0x1) == 0);
+  CHECK(get_round_trip_error(pixels, RENDERER_OPENGL_BC5, 0x3) == 0);
+}
+
+void
+add_texture_compression_tests(std::vector<unittest_t>& tests)
+{
+  tests.push_back({ "texture_compression/sizes", test_sizes });
+  tests.push_back({ "texture_compression/bc1_error_bound",
+    test_bc1_error_bound });
+  tests.push_back({ "texture_compression/bc3_error_bound",
+    test_bc3_error_bound });
+  tests.push_back({ "texture_compression/bc4_error_bound",
+    test_bc4_error_bound });
+  tests.push_back({ "texture_compression/bc5_error_bound",
+    test_bc5_error_bound });
+  tests.push_back({ "texture_compression/solid_colors", test_solid_colors });
+}